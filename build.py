@@ -58,7 +58,17 @@ parser.add_argument('--CXX_compiler',
                     type=str,
                     required=False)
 parser.add_argument('--OpenMP',
-                    help='Use OpenMP',
+                    help='Use OpenMP (default).',
+                    dest='OpenMP',
+                    action='store_true')
+parser.add_argument('--no_OpenMP',
+                    help='Build serial Pypeline, MKL and FFTW libraries.',
+                    dest='OpenMP',
+                    action='store_false')
+parser.set_defaults(OpenMP=True)
+parser.add_argument('--native',
+                    help=('Compile for the build host\'s instruction set. '
+                          'Binaries may not run on other machines.'),
                     action='store_true')
 parser.add_argument('--print',
                     help=('Only print commands that would have been executed '
@@ -81,6 +91,7 @@ cmake -DCMAKE_BUILD_TYPE="{args.lib}"              \
    {f'-DCMAKE_C_COMPILER="{args.C_compiler}"' if (args.C_compiler is not None) else ''} \
    {f'-DCMAKE_CXX_COMPILER="{args.CXX_compiler}"' if (args.CXX_compiler is not None) else ''} \
       -DPYPELINE_USE_OPENMP={str(args.OpenMP).upper()} \
+      -DPYPELINE_NATIVE={str(args.native).upper()} \
       "{project_root_dir}";
 make install;
 cd "{project_root_dir}";
@@ -0,0 +1,263 @@
+// ############################################################################
+// beamforming.hpp
+// ===============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Beamforming-related operations and tools.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_BEAMFORMING_HPP
+#define PYPELINE_PHASED_ARRAY_BEAMFORMING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+#include "eigen3/Eigen/Sparse"
+
+#include "pypeline/types.hpp"
+
+namespace pypeline { namespace phased_array { namespace beamforming {
+    /*
+     * Compute matched-beamforming (MB) weights.
+     *
+     * The sparsity pattern of the (N_antenna, N_beam) weight matrix only depends
+     * on station membership and the beam configuration: it is built once at
+     * construction in CSC form.
+     * Each call then only overwrites the non-zero values with
+     *
+     *     W[a, b] = exp(-j 2 \pi <p_a - mean(p), f_b> / wl),
+     *
+     * where p_a is the position of antenna a and f_b the focus direction of beam
+     * b as seen from the station of a.
+     * Phases are reduced modulo 2 \pi in double precision.
+     *
+     * Rows of the output are the antennas which belong to a configured station,
+     * in input order, so that they line up with the XYZ rows consumed by the
+     * Gram and field synthesis blocks. (See antenna_idx().)
+     * Columns are the beams sorted by BEAM_ID. (See beam_id().)
+     * The Python MatchedBeamformerBlock re-orders rows by (STATION_ID, ANTENNA_ID)
+     * and returns CSR weights, as the pandas-based implementation did.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include <vector>
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/beamforming.hpp"
+     *
+     *    namespace beamforming = pypeline::phased_array::beamforming;
+     *
+     *    std::vector<int64_t> antenna_station_id {0, 0, 1, 1};
+     *    std::vector<int64_t> station_id {0, 1}, beam_id {0, 1};
+     *    MatrixXX_t<double> focus_dir(2, 3);  // one (x, y, z) unit vector per (station, beam) pair.
+     *    focus_dir << 0, 0, 1,
+     *                 0, 0, 1;
+     *
+     *    beamforming::MatchedBeamformerBlock<double> mb(antenna_station_id, station_id, beam_id, focus_dir);
+     *
+     *    MatrixXX_t<double> XYZ = MatrixXX_t<double>::Random(4, 3);
+     *    const SpMatrixXX_t<cdouble_t> &W = mb(XYZ, 2.0);  // (4, 2)
+     */
+    template <typename TT>
+    class MatchedBeamformerBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            size_t m_N_antenna_in = 0;
+            std::vector<int64_t> m_beam_id {};       // (N_beam,) sorted BEAM_IDs.
+            std::vector<int64_t> m_antenna_idx {};   // (N_antenna,) XYZ row of each output row.
+
+            // Per non-zero entry of m_W, in CSC storage order.
+            std::vector<int> m_nz_antenna {};        // XYZ row.
+            std::vector<double> m_nz_focus {};       // (nnz, 3) focus direction.
+
+            SpMatrixXX_t<cTT> m_W {};
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * antenna_station_id : std::vector<int64_t>
+             *     (N_antenna,) STATION_ID of each antenna.
+             * station_id : std::vector<int64_t>
+             *     (N_info,) STATION_ID of each beam configuration entry.
+             * beam_id : std::vector<int64_t>
+             *     (N_info,) BEAM_ID of each beam configuration entry.
+             * focus_dir : Eigen::Ref<const MatrixXX_t<double>>
+             *     (N_info, 3) Cartesian unit vectors pointing at the focus of each
+             *     beam configuration entry.
+             */
+            MatchedBeamformerBlock(const std::vector<int64_t> &antenna_station_id,
+                                   const std::vector<int64_t> &station_id,
+                                   const std::vector<int64_t> &beam_id,
+                                   const Eigen::Ref<const MatrixXX_t<double>> &focus_dir):
+                m_N_antenna_in(antenna_station_id.size()) {
+                const size_t N_info = station_id.size();
+                if ((beam_id.size() != N_info) ||
+                    (static_cast<size_t>(focus_dir.rows()) != N_info) ||
+                    (focus_dir.cols() != 3)) {
+                    std::string msg = "Parameters[station_id, beam_id, focus_dir] are inconsistent.";
+                    throw std::runtime_error(msg);
+                }
+                if (N_info == 0) {
+                    std::string msg = "Parameter[beam_id] cannot be empty.";
+                    throw std::runtime_error(msg);
+                }
+
+                // BEAM_ID -> column.
+                m_beam_id = beam_id;
+                std::sort(m_beam_id.begin(), m_beam_id.end());
+                m_beam_id.erase(std::unique(m_beam_id.begin(), m_beam_id.end()), m_beam_id.end());
+                auto column = [&](const int64_t b) {
+                    return static_cast<int>(std::lower_bound(m_beam_id.begin(), m_beam_id.end(), b) - m_beam_id.begin());
+                };
+
+                // STATION_ID -> configuration entries.
+                std::map<int64_t, std::vector<int>> station_entries;
+                for (size_t i = 0; i < N_info; ++i) {
+                    station_entries[station_id[i]].push_back(static_cast<int>(i));
+                }
+
+                // Sparsity pattern: (column, output row, XYZ row, entry).
+                std::vector<std::tuple<int, int, int, int>> nz;
+                for (size_t a = 0; a < m_N_antenna_in; ++a) {
+                    auto it = station_entries.find(antenna_station_id[a]);
+                    if (it == station_entries.end()) { continue; }
+
+                    const int row = static_cast<int>(m_antenna_idx.size());
+                    m_antenna_idx.push_back(static_cast<int64_t>(a));
+                    for (const int i : it->second) {
+                        nz.emplace_back(column(beam_id[i]), row, static_cast<int>(a), i);
+                    }
+                }
+                std::sort(nz.begin(), nz.end());
+                for (size_t k = 1; k < nz.size(); ++k) {
+                    if ((std::get<0>(nz[k]) == std::get<0>(nz[k - 1])) &&
+                        (std::get<1>(nz[k]) == std::get<1>(nz[k - 1]))) {
+                        std::string msg = "Parameters[station_id, beam_id] contain duplicate (STATION_ID, BEAM_ID) pairs.";
+                        throw std::runtime_error(msg);
+                    }
+                }
+
+                const int N_antenna = static_cast<int>(m_antenna_idx.size());
+                const int N_beam = static_cast<int>(m_beam_id.size());
+                m_W.resize(N_antenna, N_beam);
+                m_W.reserve(static_cast<int>(nz.size()));
+                m_nz_antenna.reserve(nz.size());
+                m_nz_focus.reserve(3 * nz.size());
+                int col_prev = -1;
+                for (const auto &e : nz) {
+                    const int col = std::get<0>(e);
+                    for (; col_prev < col; ++col_prev) {
+                        m_W.startVec(col_prev + 1);
+                    }
+                    m_W.insertBack(std::get<1>(e), col) = cTT(1, 0);
+
+                    const int i = std::get<3>(e);
+                    m_nz_antenna.push_back(std::get<2>(e));
+                    m_nz_focus.push_back(focus_dir(i, 0));
+                    m_nz_focus.push_back(focus_dir(i, 1));
+                    m_nz_focus.push_back(focus_dir(i, 2));
+                }
+                for (; col_prev < N_beam - 1; ++col_prev) {
+                    m_W.startVec(col_prev + 1);
+                }
+                m_W.finalize();
+            }
+
+            /*
+             * Determine beamweights to apply to each (antenna, beam) pair.
+             *
+             * Parameters
+             * ----------
+             * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+             *     (N_antenna, 3) Cartesian antenna coordinates, in the same frame
+             *     as the focus directions and for the antennas given at construction.
+             * wl : double
+             *     Wave-length [m] at which to generate beamweights.
+             *
+             * Returns
+             * -------
+             * W : const SpMatrixXX_t<std::complex<TT>>&
+             *     (N_antenna, N_beam) synthesis beamweights.
+             *     The reference is valid until the next call.
+             */
+            const SpMatrixXX_t<cTT>& operator()(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                                const double wl) {
+                if (wl <= 0) {
+                    std::string msg = "Parameter[wl] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if ((static_cast<size_t>(XYZ.rows()) != m_N_antenna_in) || (XYZ.cols() != 3)) {
+                    std::string msg = "Parameter[XYZ] must have shape (N_antenna, 3).";
+                    throw std::runtime_error(msg);
+                }
+
+                const Eigen::RowVector3d center = XYZ.template cast<double>().colwise().mean();
+                const int N_nz = static_cast<int>(m_nz_antenna.size());
+                cTT *W = m_W.valuePtr();
+
+                #ifdef _OPENMP
+                #pragma omp parallel for
+                #endif
+                for (int k = 0; k < N_nz; ++k) {
+                    const int a = m_nz_antenna[k];
+                    const double *f = m_nz_focus.data() + 3 * k;
+                    double phase = (((static_cast<double>(XYZ(a, 0)) - center[0]) * f[0]) +
+                                    ((static_cast<double>(XYZ(a, 1)) - center[1]) * f[1]) +
+                                    ((static_cast<double>(XYZ(a, 2)) - center[2]) * f[2])) / wl;
+                    phase = 2 * M_PI * (phase - std::round(phase));
+                    W[k] = cTT(static_cast<TT>(std::cos(phase)), static_cast<TT>(-std::sin(phase)));
+                }
+
+                return m_W;
+            }
+
+            /*
+             * Returns
+             * -------
+             * antenna_idx : const std::vector<int64_t>&
+             *     (N_antenna,) input antenna (i.e. XYZ row) of each row of W.
+             */
+            const std::vector<int64_t>& antenna_idx() const {
+                return m_antenna_idx;
+            }
+
+            /*
+             * Returns
+             * -------
+             * beam_id : const std::vector<int64_t>&
+             *     (N_beam,) BEAM_ID of each column of W.
+             */
+            const std::vector<int64_t>& beam_id() const {
+                return m_beam_id;
+            }
+
+            size_t N_antenna() const {
+                return m_antenna_idx.size();
+            }
+
+            size_t N_beam() const {
+                return m_beam_id.size();
+            }
+
+            size_t N_nonzero() const {
+                return m_nz_antenna.size();
+            }
+    };
+}}}
+
+#endif //PYPELINE_PHASED_ARRAY_BEAMFORMING_HPP
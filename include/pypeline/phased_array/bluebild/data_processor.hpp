@@ -0,0 +1,469 @@
+// ############################################################################
+// data_processor.hpp
+// ==================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Data processors.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_BLUEBILD_DATA_PROCESSOR_HPP
+#define PYPELINE_PHASED_ARRAY_BLUEBILD_DATA_PROCESSOR_HPP
+
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+
+#include "pypeline/types.hpp"
+#include "pypeline/util/math/linalg.hpp"
+
+namespace pypeline { namespace phased_array { namespace bluebild { namespace data_processor {
+    namespace _detail {
+        namespace linalg = pypeline::util::math::linalg;
+
+        /*
+         * Per-channel state, kept across calls so that buffers are only
+         * re-allocated when the number of working beams changes.
+         */
+        template <typename TT>
+        struct ChannelState {
+            std::vector<Eigen::Index> idx {};          // idx[k] = BEAM index of the k-th working beam.
+            MatrixXX_t<std::complex<TT>> S {};         // (N_work, N_work) compacted visibilities.
+            MatrixXX_t<std::complex<TT>> G {};         // (N_work, N_work) compacted Gram matrix.
+            std::unique_ptr<linalg::WarmStartEigh<TT>> solver {};
+        };
+
+        /*
+         * Build the compacted index map of working beams.
+         *
+         * A beam is deemed broken if the sum of its row and column in S are
+         * numerically identical (numpy.isclose() with default tolerances), which
+         * is notably the case of all-zero rows/columns.
+         *
+         * Returns the number of working beams.
+         */
+        template <typename TT>
+        size_t compact(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &S,
+                       std::vector<Eigen::Index> &idx) {
+            using cTT = std::complex<TT>;
+            const Eigen::Matrix<cTT, 1, Eigen::Dynamic> col_sum = S.colwise().sum();
+            const Eigen::Matrix<cTT, Eigen::Dynamic, 1> row_sum = S.rowwise().sum();
+
+            idx.clear();
+            for (Eigen::Index i = 0; i < S.rows(); ++i) {
+                const TT tol = static_cast<TT>(1e-8 + 1e-5 * std::abs(row_sum[i]));
+                if (std::abs(col_sum[i] - row_sum[i]) > tol) {
+                    idx.push_back(i);
+                }
+            }
+            return idx.size();
+        }
+
+        /*
+         * out = X[idx][:, idx]
+         */
+        template <typename TT>
+        void gather(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &X,
+                    const std::vector<Eigen::Index> &idx,
+                    MatrixXX_t<std::complex<TT>> &out) {
+            const Eigen::Index N = idx.size();
+            out.resize(N, N);  // no-op if the shape did not change.
+            for (Eigen::Index i = 0; i < N; ++i) {
+                for (Eigen::Index j = 0; j < N; ++j) {
+                    out(i, j) = X(idx[i], idx[j]);
+                }
+            }
+        }
+
+        template <typename TT>
+        void validate(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &S,
+                      const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &G) {
+            if (S.rows() != S.cols()) {
+                std::string msg = "Parameter[S] must be square.";
+                throw std::runtime_error(msg);
+            }
+            if ((G.rows() != S.rows()) || (G.cols() != S.cols())) {
+                std::string msg = "Parameters[S, G] are inconsistent.";
+                throw std::runtime_error(msg);
+            }
+        }
+    }
+
+    /*
+     * Data processor for computing intensity fields.
+     *
+     * For each (S, G) pair, broken beams are removed through a compacted index
+     * map, the N_eig leading eigenpairs of S V = G V D are computed, and the
+     * eigenvectors are scattered back to (N_beam, N_eig) row-major layout, as
+     * expected by FourierFieldSynthesizerBlock.
+     *
+     * Compacted buffers are kept per frequency channel and re-used across calls.
+     * Channels are processed in parallel by process_batch().
+     *
+     * This object is not thread-safe.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/bluebild/data_processor.hpp"
+     *
+     *    namespace data_processor = pypeline::phased_array::bluebild::data_processor;
+     *
+     *    data_processor::IntensityFieldDataProcessorBlock<double> I_dp(12, {0.0, 20.0});
+     *
+     *    MatrixXX_t<cdouble_t> S = ..., G = ...;  // (N_beam, N_beam)
+     *    ArrayX_t<double> D(12);
+     *    MatrixXX_t<cdouble_t> V(N_beam, 12);
+     *    ArrayX_t<int64_t> cluster_idx(12);
+     *    I_dp(S, G, D.data(), V.data(), cluster_idx.data());
+     */
+    template <typename TT>
+    class IntensityFieldDataProcessorBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            size_t m_N_eig = 0;
+            ArrayX_t<TT> m_centroids {};
+            bool m_warm_start = false;
+            std::vector<_detail::ChannelState<TT>> m_channel {};
+
+            void reserve(const size_t N_channel) {
+                if (m_channel.size() < N_channel) {
+                    m_channel.resize(N_channel);
+                }
+                for (size_t i = 0; i < N_channel; ++i) {
+                    if (m_warm_start && (m_channel[i].solver == nullptr)) {
+                        m_channel[i].solver.reset(new _detail::linalg::WarmStartEigh<TT>(m_N_eig));
+                    }
+                }
+            }
+
+            /*
+             * Leading eigenpairs of the working sub-problem, or zeros if S is broken beyond use.
+             */
+            _detail::linalg::EigenPairs<TT> decompose(const Eigen::Ref<const MatrixXX_t<cTT>> &S,
+                                                      const Eigen::Ref<const MatrixXX_t<cTT>> &G,
+                                                      _detail::ChannelState<TT> &state) const {
+                if ((S.array().abs() <= static_cast<TT>(1e-8)).all()) {
+                    _detail::linalg::EigenPairs<TT> DV;
+                    DV.D = ArrayX_t<TT>::Zero(m_N_eig);
+                    DV.V = MatrixXX_t<cTT>::Zero(S.rows(), m_N_eig);
+                    return DV;
+                }
+
+                if (state.solver != nullptr) {
+                    return (*state.solver)(S, G, 1, 0);
+                }
+                return _detail::linalg::eigh<TT>(S, G, 1, m_N_eig);
+            }
+
+            /*
+             * Process one (S, G) pair using the state of a given channel.
+             *
+             * D : (N_eig,) output buffer.
+             * V : (N_beam, N_eig) row-major output buffer.
+             * cluster_idx : (N_eig,) output buffer.
+             */
+            void process(const Eigen::Ref<const MatrixXX_t<cTT>> &S,
+                         const Eigen::Ref<const MatrixXX_t<cTT>> &G,
+                         _detail::ChannelState<TT> &state,
+                         TT *D, cTT *V, int64_t *cluster_idx) const {
+                _detail::validate<TT>(S, G);
+                const size_t N_beam = S.rows();
+                const size_t N_work = _detail::compact<TT>(S, state.idx);
+
+                Eigen::Map<ArrayX_t<TT>> D_out(D, m_N_eig);
+                Eigen::Map<MatrixXX_t<cTT>> V_out(V, N_beam, m_N_eig);
+                Eigen::Map<ArrayX_t<int64_t>> cluster_out(cluster_idx, m_N_eig);
+
+                if (N_work == N_beam) {  // Fast path: no broken beams.
+                    _detail::linalg::EigenPairs<TT> DV = decompose(S, G, state);
+                    D_out = DV.D;
+                    V_out = DV.V;
+                } else {
+                    _detail::gather<TT>(S, state.idx, state.S);
+                    _detail::gather<TT>(G, state.idx, state.G);
+                    _detail::linalg::EigenPairs<TT> DV = decompose(state.S, state.G, state);
+                    D_out = DV.D;
+                    V_out.setZero();
+                    for (size_t k = 0; k < N_work; ++k) {
+                        V_out.row(state.idx[k]) = DV.V.row(k);
+                    }
+                }
+
+                // Energy-level clustering.
+                for (size_t k = 0; k < m_N_eig; ++k) {
+                    Eigen::Index c = 0;
+                    (m_centroids - D_out[k]).abs().minCoeff(&c);
+                    cluster_out[k] = c;
+                }
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * N_eig : size_t
+             *     Number of eigenpairs to output after PCA decomposition.
+             * cluster_centroids : std::vector<TT>
+             *     Intensity centroids for energy-level clustering.
+             * warm_start : bool
+             *     Seed the fPCA decomposition of each channel with the eigenvectors
+             *     of its previous call. (See linalg::WarmStartEigh.)
+             *     Only valid if visibility matrices are positive-semidefinite.
+             */
+            IntensityFieldDataProcessorBlock(const size_t N_eig,
+                                             const std::vector<TT> &cluster_centroids,
+                                             const bool warm_start = false):
+                m_N_eig(N_eig), m_warm_start(warm_start) {
+                if (N_eig == 0) {
+                    std::string msg = "Parameter[N_eig] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if (cluster_centroids.empty()) {
+                    std::string msg = "Parameter[cluster_centroids] cannot be empty.";
+                    throw std::runtime_error(msg);
+                }
+
+                m_centroids = Eigen::Map<const ArrayX_t<TT>>(cluster_centroids.data(), cluster_centroids.size());
+            }
+
+            /*
+             * fPCA decomposition and data formatting for FieldSynthesizerBlock objects.
+             *
+             * Parameters
+             * ----------
+             * S : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_beam) visibility matrix.
+             * G : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_beam) Gram matrix.
+             * D : TT*
+             *     (N_eig,) buffer to which positive eigenvalues are written.
+             * V : std::complex<TT>*
+             *     (N_beam, N_eig) row-major buffer to which eigenvectors are written.
+             *     Rows of broken beams are set to 0.
+             * cluster_idx : int64_t*
+             *     (N_eig,) buffer to which cluster indices of each eigenpair are written.
+             */
+            void operator()(const Eigen::Ref<const MatrixXX_t<cTT>> &S,
+                            const Eigen::Ref<const MatrixXX_t<cTT>> &G,
+                            TT *D, cTT *V, int64_t *cluster_idx) {
+                reserve(1);
+                process(S, G, m_channel[0], D, V, cluster_idx);
+            }
+
+            /*
+             * Process many frequency channels in parallel.
+             *
+             * Channel i re-uses the buffers (and warm-start seeds) of the i-th
+             * channel of previous process_batch() calls.
+             *
+             * Parameters
+             * ----------
+             * S : const std::complex<TT>*
+             *     (N_channel, N_beam, N_beam) visibility matrices.
+             * G : const std::complex<TT>*
+             *     (N_channel, N_beam, N_beam) Gram matrices.
+             * N_channel : size_t
+             * N_beam : size_t
+             * D : TT*
+             *     (N_channel, N_eig) output buffer.
+             * V : std::complex<TT>*
+             *     (N_channel, N_beam, N_eig) output buffer.
+             * cluster_idx : int64_t*
+             *     (N_channel, N_eig) output buffer.
+             */
+            void process_batch(const cTT *S, const cTT *G,
+                               const size_t N_channel, const size_t N_beam,
+                               TT *D, cTT *V, int64_t *cluster_idx) {
+                reserve(N_channel);
+
+                const size_t N_SG = N_beam * N_beam;
+                const size_t N_V = N_beam * m_N_eig;
+                std::exception_ptr error = nullptr;
+                std::atomic<bool> failed(false);
+
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (int i = 0; i < static_cast<int>(N_channel); ++i) {
+                    if (failed) { continue; }
+                    try {
+                        Eigen::Map<const MatrixXX_t<cTT>> S_i(S + i * N_SG, N_beam, N_beam);
+                        Eigen::Map<const MatrixXX_t<cTT>> G_i(G + i * N_SG, N_beam, N_beam);
+                        process(S_i, G_i, m_channel[i],
+                                D + i * m_N_eig, V + i * N_V, cluster_idx + i * m_N_eig);
+                    } catch (...) {
+                        #ifdef _OPENMP
+                        #pragma omp critical
+                        #endif
+                        {
+                            if (error == nullptr) { error = std::current_exception(); }
+                        }
+                        failed = true;
+                    }
+                }
+
+                if (error != nullptr) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            /*
+             * Release per-channel buffers and warm-start seeds.
+             */
+            void reset() {
+                m_channel.clear();
+            }
+
+            size_t N_eig() const {
+                return m_N_eig;
+            }
+
+            const ArrayX_t<TT>& cluster_centroids() const {
+                return m_centroids;
+            }
+
+            bool warm_start() const {
+                return m_warm_start;
+            }
+    };
+
+    /*
+     * Data processor for computing sensitivity fields.
+     *
+     * Outputs (1 / D^{2}, V), where (D, V) are the N_eig leading eigenpairs of G.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/bluebild/data_processor.hpp"
+     *
+     *    namespace data_processor = pypeline::phased_array::bluebild::data_processor;
+     *
+     *    data_processor::SensitivityFieldDataProcessorBlock<double> S_dp(12);
+     *
+     *    MatrixXX_t<cdouble_t> G = ...;  // (N_beam, N_beam)
+     *    ArrayX_t<double> D(12);
+     *    MatrixXX_t<cdouble_t> V(N_beam, 12);
+     *    S_dp(G, D.data(), V.data());
+     */
+    template <typename TT>
+    class SensitivityFieldDataProcessorBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            size_t m_N_eig = 0;
+
+            void process(const Eigen::Ref<const MatrixXX_t<cTT>> &G,
+                         TT *D, cTT *V) const {
+                if (G.rows() != G.cols()) {
+                    std::string msg = "Parameter[G] must be square.";
+                    throw std::runtime_error(msg);
+                }
+
+                _detail::linalg::EigenPairs<TT> DV = _detail::linalg::eigh<TT>(G, 1, m_N_eig);
+                Eigen::Map<ArrayX_t<TT>>(D, m_N_eig) = DV.D.square().inverse();
+                Eigen::Map<MatrixXX_t<cTT>>(V, G.rows(), m_N_eig) = DV.V;
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * N_eig : size_t
+             *     Number of eigenpairs to output after PCA decomposition.
+             */
+            SensitivityFieldDataProcessorBlock(const size_t N_eig):
+                m_N_eig(N_eig) {
+                if (N_eig == 0) {
+                    std::string msg = "Parameter[N_eig] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * G : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_beam) Gram matrix.
+             * D : TT*
+             *     (N_eig,) buffer to which 1 / D^{2} is written.
+             * V : std::complex<TT>*
+             *     (N_beam, N_eig) row-major buffer to which eigenvectors are written.
+             */
+            void operator()(const Eigen::Ref<const MatrixXX_t<cTT>> &G,
+                            TT *D, cTT *V) const {
+                process(G, D, V);
+            }
+
+            /*
+             * Process many frequency channels in parallel.
+             *
+             * Parameters
+             * ----------
+             * G : const std::complex<TT>*
+             *     (N_channel, N_beam, N_beam) Gram matrices.
+             * N_channel : size_t
+             * N_beam : size_t
+             * D : TT*
+             *     (N_channel, N_eig) output buffer.
+             * V : std::complex<TT>*
+             *     (N_channel, N_beam, N_eig) output buffer.
+             */
+            void process_batch(const cTT *G,
+                               const size_t N_channel, const size_t N_beam,
+                               TT *D, cTT *V) const {
+                const size_t N_G = N_beam * N_beam;
+                const size_t N_V = N_beam * m_N_eig;
+                std::exception_ptr error = nullptr;
+                std::atomic<bool> failed(false);
+
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (int i = 0; i < static_cast<int>(N_channel); ++i) {
+                    if (failed) { continue; }
+                    try {
+                        Eigen::Map<const MatrixXX_t<cTT>> G_i(G + i * N_G, N_beam, N_beam);
+                        process(G_i, D + i * m_N_eig, V + i * N_V);
+                    } catch (...) {
+                        #ifdef _OPENMP
+                        #pragma omp critical
+                        #endif
+                        {
+                            if (error == nullptr) { error = std::current_exception(); }
+                        }
+                        failed = true;
+                    }
+                }
+
+                if (error != nullptr) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            size_t N_eig() const {
+                return m_N_eig;
+            }
+    };
+}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_BLUEBILD_DATA_PROCESSOR_HPP
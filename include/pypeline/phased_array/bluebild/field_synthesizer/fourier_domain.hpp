@@ -15,12 +15,16 @@
 #include <array>
 #include <cmath>
 #include <complex>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "eigen3/Eigen/Eigen"
 #include "xtensor/xtensor.hpp"
@@ -31,13 +35,12 @@
 
 #include "pypeline/types.hpp"
 #include "pypeline/util/argcheck.hpp"
+#include "pypeline/util/cache.hpp"
 #include "pypeline/util/math/fourier.hpp"
 #include "pypeline/util/math/func.hpp"
 #include "pypeline/util/math/linalg.hpp"
 #include "pypeline/util/math/sphere.hpp"
-
-#include <iostream>
-#include "xtensor/xio.hpp"
+#include "pypeline/util/simd.hpp"
 
 namespace argcheck = pypeline::util::argcheck;
 namespace array = pypeline::util::array;
@@ -45,10 +48,56 @@ namespace fourier = pypeline::util::math::fourier;
 namespace func = pypeline::util::math::func;
 namespace linalg = pypeline::util::math::linalg;
 namespace sphere = pypeline::util::math::sphere;
+namespace simd = pypeline::util::simd;
 
 namespace pypeline { namespace phased_array { namespace bluebild { namespace field_synthesizer { namespace fourier_domain {
     /*
-     * TODO: docstring + documentation.
+     * Field synthesizer based on PeriodicSynthesis.
+     *
+     * C++ counterpart of
+     * :py:class:`~pypeline.phased_array.bluebild.field_synthesizer.fourier_domain.ReferenceFourierFieldSynthesizerBlock`.
+     *
+     * operator() evaluates the field statistics of (N_beam, N_eig)
+     * eigenvectors in the Fourier Series (FS) domain of the BFSF azimuthal
+     * angle: (N_eig, N_height, N_samples) FS-domain statistics can be summed
+     * over time, and synthesize() then interpolates them once onto the
+     * (N_height, N_width) pixel grid.
+     *
+     * The FS-domain kernel depends on the antenna positions only up to a
+     * rotation around the BFSF z-axis: as the Earth rotates, the kernel is
+     * phase-shifted, and only re-generated once the rotation exceeds the
+     * window's margin.
+     *
+     * Thread safety
+     * -------------
+     * The FS-domain kernel is immutable once generated, and shared by
+     * reference counting: re-generation publishes a new kernel, while calls
+     * still holding the old one finish with it.
+     * Mutable state (E_FS, field statistics) lives in a Workspace.
+     * Several threads may hence call the Workspace overloads of operator()
+     * and synthesize() concurrently on the same object, provided each thread
+     * uses its own Workspace: the kernel is held once in memory, not once
+     * per thread.
+     * Overloads without a Workspace use an internal one, and must not be
+     * called concurrently.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    FourierFieldSynthesizerBlock<float> bb(wl, grid_colat, grid_lon, N_FS, T, R,
+     *                                          N_eig, N_antenna, 1, fourier::planning_effort::NONE);
+     *
+     *    #pragma omp parallel
+     *    {
+     *        auto ws = bb.workspace();
+     *
+     *        #pragma omp for
+     *        for (size_t t = 0; t < N_time; ++t) {
+     *            auto stat = bb(V[t], XYZ[t], W[t], ws);  // (N_eig, N_height, N_samples), view into ws.
+     *            // ... accumulate stat ...
+     *        }
+     *    }
      */
     template <typename TT>
     class FourierFieldSynthesizerBlock {
@@ -57,14 +106,51 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
             static constexpr bool is_float = std::is_same<TT, float>::value;
             using cTT = std::complex<TT>;
 
+        public:
+            /*
+             * FS-domain kernel, evaluated at (N_antenna, 3) BFSF antenna positions XYZ.
+             *
+             * Never modified once published.
+             */
+            struct Kernel {
+                xt::xtensor<TT, 2> XYZ;                      // Antenna positions at kernel eval time.
+                MatrixXX_t<TT> XYZ_pinv;                     // (2, N_antenna) pseudo-inverse of XYZ[:, :2].
+                std::unique_ptr<fourier::FFTW_FFS<TT>> FSK;  // Fourier Series Kernel, in FSK->data_in(), if evaluated.
+                pypeline::util::cache::Blob FSK_cached;      // Fourier Series Kernel, if mapped from the kernel cache.
+
+                /*
+                 * (N_antenna, N_height * N_samples) Fourier Series Kernel.
+                 */
+                const cTT* data() const {
+                    if (FSK_cached) {
+                        return reinterpret_cast<const cTT*>(FSK_cached.data());
+                    }
+                    return FSK->data_in();
+                }
+            };
+
+            /*
+             * Per-thread scratch space of operator() and synthesize().
+             *
+             * Obtained from :cpp:func:`workspace`, and only valid for the object which created it.
+             * All temporaries of operator() live here: once sized, calls do not
+             * allocate on the heap (Eigen's GEMM packing buffers aside).
+             */
+            struct Workspace {
+                std::unique_ptr<fourier::FFTW_FFS<TT>> FST;  // Field STatistics compute/storage.
+                xt::xtensor<TT, 2> XYZ;                      // (N_antenna, 3) BFSF antenna positions.
+                xt::xtensor<cTT, 1> mod;                     // (N_samples,) FS-domain phase shift.
+                Eigen::Matrix<cTT, Eigen::Dynamic, 1> WFSK;  // (N_beam * N_height * N_samples,) W^{T} FSK, grown on demand.
+            };
+
+        private:
             // block_0_parameters
-            size_t m_wl = 0;
+            double m_wl = 0;
             size_t m_N_antenna = 0;
             size_t m_N_eig = 0;
             xt::xtensor<TT, 2> m_grid_colat;
             xt::xtensor<TT, 2> m_grid_lon;
             xt::xtensor<TT, 2> m_R;
-            std::unique_ptr<xt::xtensor<TT, 2>> m_XYZk = nullptr;  // Antenna positions at kernel eval time.
 
             // block_1_parameters
             TT m_alpha_window = 0;
@@ -73,10 +159,16 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
             TT m_mps = 0;  // max_phase_shift
             size_t m_N_FS = 0;
             size_t m_N_samples = 0;
+            xt::xtensor<TT, 2> m_pix_smpl;  // (3, N_height * N_samples) pixel directions at FS sample points.
+            xt::xtensor<TT, 1> m_window;    // (N_samples,) Tukey window at FS sample points.
 
             // Resources
-            std::unique_ptr<fourier::FFTW_FFS<TT>> m_FSK; // Fourier Series Kernel compute/storage.
-            std::unique_ptr<fourier::FFTW_FFS<TT>> m_FST; // Field STatistics compute/storage.
+            size_t m_N_threads = 1;
+            fourier::planning_effort m_effort = fourier::planning_effort::NONE;
+            std::shared_ptr<const Kernel> m_kernel = nullptr;  // Access through std::atomic_{load, store}().
+            std::unique_ptr<std::mutex> m_kernel_mutex = std::make_unique<std::mutex>();  // Serializes kernel re-generation.
+            Workspace m_workspace {};                          // Used by overloads without a Workspace.
+            std::shared_ptr<pypeline::util::cache::FileCache> m_kernel_cache = nullptr;  // Optional kernel store.
 
             template <typename E_colat, typename E_lon, typename E_R>
             void set_block_0_parameters(const double wl,
@@ -173,34 +265,43 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
 
             void allocate_resources(const size_t N_threads,
                                     fourier::planning_effort effort) {
-                std::vector<size_t> shape_FSK {m_N_antenna * m_grid_colat.size(), m_N_samples};
-                m_FSK = std::make_unique<fourier::FFTW_FFS<TT>>(shape_FSK, 1,
-                                                                m_T, m_Tc, m_N_FS,
-                                                                true, N_threads, effort);
+                m_N_threads = N_threads;
+                m_effort = effort;
 
-                std::vector<size_t> shape_FST {m_N_eig * m_grid_colat.size(), m_N_samples};
-                m_FST = std::make_unique<fourier::FFTW_FFS<TT>>(shape_FST, 1,
-                                                                m_T, m_Tc, m_N_FS,
-                                                                true, N_threads, effort);
+                // Kernel inputs which do not depend on antenna positions.
+                const size_t N_height = m_grid_colat.size();
+                xt::xtensor<TT, 1> lon_smpl {fourier::ffs_sample(m_T, m_N_FS, m_Tc, m_N_samples)};
+                auto px_xyz = sphere::pol2cart(
+                                xt::xtensor<TT, 1> {1},
+                                m_grid_colat,
+                                xt::reshape_view(lon_smpl,
+                                                 std::vector<size_t> {1, m_N_samples}));
+                xt::xtensor<TT, 3> pix_smpl {xt::stack(std::move(px_xyz), 0)};
+                m_pix_smpl = xt::reshape_view(pix_smpl, std::vector<size_t> {3, N_height * m_N_samples});
+
+                func::Tukey tukey(m_T, m_Tc, m_alpha_window);
+                m_window = tukey(lon_smpl);
+
+                // The kernel is allocated on first use.
+                m_workspace = workspace();
             }
 
-            double phase_shift(xt::xtensor<TT, 2> &XYZ) {
+            double phase_shift(const Kernel &kernel,
+                               xt::xtensor<TT, 2> &XYZ) const {
                 Eigen::Map<MatrixXX_t<TT>> _XYZ(XYZ.data(), m_N_antenna, 3);
-                Eigen::Map<MatrixXX_t<TT>> _mXYZ(m_XYZk->data(), m_N_antenna, 3);
 
-                MatrixXX_t<TT> R_T = (_mXYZ.leftCols(2)
-                                      .fullPivHouseholderQr()
-                                      .solve(_XYZ.leftCols(2)));
-                xt::xtensor<TT, 2> R {{R_T(0, 0), R_T(1, 0), 0},
-                                      {R_T(0, 1), R_T(1, 1), 0},
-                                      {        0,         0, 1}};
+                // Least-squares rotation from kernel.XYZ[:, :2] to XYZ[:, :2].
+                Eigen::Matrix<TT, 2, 2> R_T;
+                R_T.noalias() = kernel.XYZ_pinv.lazyProduct(_XYZ.leftCols(2));
 
-                const double theta = linalg::z_rot2angle(R);
-                std::cout << theta << std::endl;
+                // linalg::z_rot2angle(R) of R = [[R_T^{T}, 0], [0, 1]], without materializing R.
+                const double cos_angle = std::max<double>(-1, std::min<double>(1, R_T(0, 0)));
+                const double sin_angle = std::max<double>(-1, std::min<double>(1, R_T(0, 1)));
+                const double theta = (sin_angle >= 0) ? std::acos(cos_angle) : -std::acos(cos_angle);
                 return theta;
             }
 
-            bool regen_required(const double shift) {
+            bool regen_required(const double shift) const {
                 const double lhs = -0.1 * (M_PI / 180); // Slightly below 0 [rad] due to numerical rounding.
                 if ((lhs <= shift) && (shift <= m_mps)) {
                     return false;
@@ -209,100 +310,221 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
                 }
             }
 
-            void regen_kernel(xt::xtensor<TT, 2> &XYZ) {
-                xt::xtensor<TT, 1> lon_smpl {fourier::ffs_sample(m_T, m_N_FS, m_Tc, m_N_samples)};
+            /*
+             * Byte string describing all inputs of regen_kernel(XYZ).
+             */
+            std::string kernel_key(xt::xtensor<TT, 2> &XYZ) const {
+                std::string key("FourierFieldSynthesizerBlock::FSK");
+                auto append = [&key](const void *data, const size_t size) {
+                    key.append(reinterpret_cast<const char*>(data), size);
+                };
+
+                const uint64_t header[] = {sizeof(TT), m_N_antenna,
+                                           m_grid_colat.size(), m_N_FS, m_N_samples};
+                append(header, sizeof(header));
+                append(&m_wl, sizeof(m_wl));
+                const TT param[] = {m_T, m_Tc, m_alpha_window};
+                append(param, sizeof(param));
+                append(m_grid_colat.data(), m_grid_colat.size() * sizeof(TT));
+                append(XYZ.data(), XYZ.size() * sizeof(TT));
+                return key;
+            }
+
+            /*
+             * Evaluate a new kernel at BFSF antenna positions XYZ.
+             *
+             * The published kernel is left untouched: concurrent calls keep using it.
+             */
+            std::shared_ptr<const Kernel> regen_kernel(xt::xtensor<TT, 2> &XYZ) {
+                const size_t N_height = m_grid_colat.size();
+                const size_t size_FSK = m_N_antenna * N_height * m_N_samples * sizeof(cTT);
+
+                auto kernel = std::make_shared<Kernel>();
+                kernel->XYZ = XYZ;
+                { // Thin QR of XYZ[:, :2]: phase_shift() then only costs a (2, N_antenna) x (N_antenna, 2) product.
+                    Eigen::Map<MatrixXX_t<TT>> _XYZ(XYZ.data(), m_N_antenna, 3);
+                    Eigen::HouseholderQR<MatrixXX_t<TT>> QR(_XYZ.leftCols(2));
+                    MatrixXX_t<TT> Q = QR.householderQ() * MatrixXX_t<TT>::Identity(m_N_antenna, 2);
+                    kernel->XYZ_pinv = (QR.matrixQR().topLeftCorner(2, 2)
+                                        .template triangularView<Eigen::Upper>()
+                                        .solve(Q.transpose()));
+                }
+
+                std::string key;
+                if (m_kernel_cache != nullptr) {
+                    key = kernel_key(XYZ);
+                    kernel->FSK_cached = m_kernel_cache->load(key, size_FSK);
+                    if (kernel->FSK_cached) {  // Used in place: no FFT plan nor copy.
+                        return kernel;
+                    }
+                }
+
+                std::vector<size_t> shape_FSK {m_N_antenna * N_height, m_N_samples};
+                kernel->FSK = std::make_unique<fourier::FFTW_FFS<TT>>(shape_FSK, 1,
+                                                                      m_T, m_Tc, m_N_FS,
+                                                                      true, m_N_threads, m_effort);
+                fourier::FFTW_FFS<TT> &FSK = *(kernel->FSK);
 
-                auto px_xyz = sphere::pol2cart(
-                                xt::xtensor<TT, 1> {1},
-                                m_grid_colat,
-                                xt::reshape_view(lon_smpl,
-                                                 std::vector<size_t> {1, m_N_samples}));
-                xt::xtensor<TT, 3> pix_smpl {xt::stack(std::move(px_xyz), 0)};
                 // m_N_samples assumes imaging is performed with XYZ centered at the origin.
                 xt::xtensor<TT, 2> XYZ_c {XYZ - xt::mean(XYZ, {0})};
 
-                const size_t N_height = m_grid_colat.size();
-                Eigen::Map<MatrixXX_t<TT>> _pix_smpl(pix_smpl.data(), 3, N_height * m_N_samples);
+                Eigen::Map<const MatrixXX_t<TT>> _pix_smpl(m_pix_smpl.data(), 3, N_height * m_N_samples);
                 Eigen::Map<MatrixXX_t<TT>> _XYZ_c(XYZ_c.data(), m_N_antenna, 3);
-                Eigen::Map<ArrayXX_t<cTT>> _FSK((m_FSK->view_in()).data(), m_N_antenna, N_height * m_N_samples);
+                Eigen::Map<ArrayXX_t<cTT>> _FSK((FSK.view_in()).data(), m_N_antenna, N_height * m_N_samples);
                 std::complex<TT> _1j(0, 1);
-                _FSK = ((_1j * static_cast<TT>(2 * M_PI / m_wl) * _XYZ_c) *
-                         _pix_smpl).array().exp();
-                // TODO: exp() might be faster with explicit MKL?
+                // Evaluated in place: no (N_antenna, N_height * N_samples) temporary.
+                _FSK.matrix().noalias() = ((_1j * static_cast<TT>(2 * M_PI / m_wl) * _XYZ_c) *
+                                           _pix_smpl);
+                // exp() and windowing in one vectorized pass.
+                simd::exp_imag(FSK.data_in(), m_window.data(), m_N_antenna * N_height, m_N_samples, 1);
+                FSK.ffs();
+
+                if (m_kernel_cache != nullptr) {
+                    m_kernel_cache->store(key, FSK.data_in(), size_FSK);
+                }
+                return kernel;
+            }
 
-                func::Tukey tukey(m_T, m_Tc, m_alpha_window);
-                xt::xtensor<TT, 1> window {tukey(lon_smpl)};
-                m_FSK->view_in().multiplies_assign(window);
-                m_FSK->ffs();
-                m_XYZk = std::make_unique<xt::xtensor<TT, 2>>(XYZ);
+            /*
+             * Kernel valid at BFSF antenna positions XYZ, and the phase shift to apply to it.
+             *
+             * At most one thread re-generates the kernel: others needing a new
+             * kernel wait for it, then use it if valid for their XYZ.
+             */
+            std::tuple<std::shared_ptr<const Kernel>, TT> acquire_kernel(xt::xtensor<TT, 2> &XYZ) {
+                std::shared_ptr<const Kernel> kernel = std::atomic_load(&m_kernel);
+                TT shift = std::numeric_limits<TT>::infinity();
+                if (kernel != nullptr) {
+                    shift = phase_shift(*kernel, XYZ);
+                }
+                if (!regen_required(shift)) {
+                    return std::make_tuple(kernel, shift);
+                }
+
+                std::lock_guard<std::mutex> lock(*m_kernel_mutex);
+                kernel = std::atomic_load(&m_kernel);  // Possibly re-generated while waiting.
+                if (kernel != nullptr) {
+                    shift = phase_shift(*kernel, XYZ);
+                    if (!regen_required(shift)) {
+                        return std::make_tuple(kernel, shift);
+                    }
+                }
+
+                kernel = regen_kernel(XYZ);
+                std::atomic_store(&m_kernel, kernel);
+                return std::make_tuple(kernel, TT(0));
+            }
+
+            /*
+             * ICRS -> BFSF antenna positions, written to (N_antenna, 3) bfsf_XYZ.
+             */
+            void to_bfsf(xt::xtensor<TT, 2> &XYZ,
+                         xt::xtensor<TT, 2> &bfsf_XYZ) const {
+                Eigen::Map<MatrixXX_t<TT>> _XYZ(XYZ.data(), m_N_antenna, 3);
+                Eigen::Map<const MatrixXX_t<TT>> _R(m_R.data(), 3, 3);
+                Eigen::Map<MatrixXX_t<TT>> _bfsf_XYZ(bfsf_XYZ.data(), m_N_antenna, 3);
+                _bfsf_XYZ.noalias() = _XYZ.lazyProduct(_R.transpose());
             }
 
-            std::vector<size_t> shape_W(xt::xtensor<cTT, 2> &W) {
-                std::vector<size_t> shape(2);
-                std::copy(W.shape().begin(), W.shape().end(), shape.begin());
-                return shape;
+            std::array<size_t, 2> shape_W(xt::xtensor<cTT, 2> &W) const {
+                return {W.shape()[0], W.shape()[1]};
             }
 
-            std::vector<size_t> shape_W(SpMatrixXX_t<cTT> &W) {
-                std::vector<size_t> shape(2);
-                shape[0] = W.rows();
-                shape[1] = W.cols();
-                return shape;
+            std::array<size_t, 2> shape_W(SpMatrixXX_t<cTT> &W) const {
+                return {static_cast<size_t>(W.rows()), static_cast<size_t>(W.cols())};
             }
 
             template <typename E_W>
             void validate_shapes(xt::xtensor<cTT, 2> &V,
                                  xt::xtensor<TT, 2> &XYZ,
-                                 E_W &W) {
+                                 E_W &W) const {
                 const size_t N_beam = V.shape()[0];
 
-                std::vector<size_t> shape_V(V.dimension());
-                std::copy(V.shape().begin(), V.shape().end(), shape_V.begin());
-                if (shape_V != std::vector<size_t> {N_beam, m_N_eig}) {
+                if (V.shape()[1] != m_N_eig) {
                     std::string msg = "Parameter[V] does not have shape (N_beam, N_eig).";
                     throw std::runtime_error(msg);
                 }
 
-                std::vector<size_t> shape_XYZ(XYZ.dimension());
-                std::copy(XYZ.shape().begin(), XYZ.shape().end(), shape_XYZ.begin());
-                if (shape_XYZ != std::vector<size_t> {m_N_antenna, 3}) {
+                if ((XYZ.shape()[0] != m_N_antenna) || (XYZ.shape()[1] != 3)) {
                     std::string msg = "Parameter[XYZ] does not have shape (N_antenna, 3).";
                     throw std::runtime_error(msg);
                 }
 
-                const std::vector<size_t> _shape_W {shape_W(W)};
-                if (_shape_W != std::vector<size_t> {m_N_antenna, N_beam}) {
+                if (shape_W(W) != std::array<size_t, 2> {m_N_antenna, N_beam}) {
                     std::string msg = "Parameters[V, W] have inconsistent dimensions.";
                     throw std::runtime_error(msg);
                 }
             }
 
-            void compute_EFS(xt::xtensor<cTT, 2> &V,
-                             xt::xtensor<cTT, 2> &W) {
+            /*
+             * Grow ws.WFSK to hold (N_beam, N_height * N_samples) values.
+             */
+            cTT* reserve_WFSK(Workspace &ws, const size_t N_beam) const {
+                const size_t N_cells = N_beam * m_grid_colat.size() * m_N_samples;
+                if (static_cast<size_t>(ws.WFSK.size()) < N_cells) {
+                    ws.WFSK.resize(N_cells);
+                }
+                return ws.WFSK.data();
+            }
+
+            void compute_EFS(const Kernel &kernel,
+                             Workspace &ws,
+                             xt::xtensor<cTT, 2> &V,
+                             xt::xtensor<cTT, 2> &W) const {
                 const size_t N_beam = V.shape()[0];
                 const size_t N_height = m_grid_colat.size();
 
                 Eigen::Map<MatrixXX_t<cTT>> _V(V.data(), N_beam, m_N_eig);
                 Eigen::Map<MatrixXX_t<cTT>> _W(W.data(), m_N_antenna, N_beam);
-                Eigen::Map<MatrixXX_t<cTT>> _FSK(m_FSK->data_in(), m_N_antenna, N_height * m_N_samples);
-                Eigen::Map<MatrixXX_t<cTT>> _E_FS(m_FST->data_in(), m_N_eig, N_height * m_N_samples);
+                Eigen::Map<const MatrixXX_t<cTT>> _FSK(kernel.data(), m_N_antenna, N_height * m_N_samples);
+                Eigen::Map<MatrixXX_t<cTT>> _E_FS(ws.FST->data_in(), m_N_eig, N_height * m_N_samples);
+                Eigen::Map<MatrixXX_t<cTT>> _WFSK(reserve_WFSK(ws, N_beam), N_beam, N_height * m_N_samples);
 
-                _E_FS = _V.transpose() * (_W.transpose() * _FSK);
+                _WFSK.noalias() = _W.transpose() * _FSK;
+                _E_FS.noalias() = _V.transpose() * _WFSK;
             }
 
-            void compute_EFS(xt::xtensor<cTT, 2> &V,
-                             SpMatrixXX_t<cTT> &W) {
+            void compute_EFS(const Kernel &kernel,
+                             Workspace &ws,
+                             xt::xtensor<cTT, 2> &V,
+                             SpMatrixXX_t<cTT> &W) const {
                 const size_t N_beam = V.shape()[0];
                 const size_t N_height = m_grid_colat.size();
 
                 Eigen::Map<MatrixXX_t<cTT>> _V(V.data(), N_beam, m_N_eig);
-                Eigen::Map<MatrixXX_t<cTT>> _FSK(m_FSK->data_in(), m_N_antenna, N_height * m_N_samples);
-                Eigen::Map<MatrixXX_t<cTT>> _E_FS(m_FST->data_in(), m_N_eig, N_height * m_N_samples);
+                Eigen::Map<const MatrixXX_t<cTT>> _FSK(kernel.data(), m_N_antenna, N_height * m_N_samples);
+                Eigen::Map<MatrixXX_t<cTT>> _E_FS(ws.FST->data_in(), m_N_eig, N_height * m_N_samples);
+                Eigen::Map<MatrixXX_t<cTT>> _WFSK(reserve_WFSK(ws, N_beam), N_beam, N_height * m_N_samples);
 
-                _E_FS = _V.transpose() * (W.transpose() * _FSK);
+                _WFSK.noalias() = W.transpose() * _FSK;
+                _E_FS.noalias() = _V.transpose() * _WFSK;
             }
 
         public:
+            /*
+             * Parameters
+             * ----------
+             * wl : double
+             *     Wavelength [m] of observations.
+             * grid_colat : xt::xexpression
+             *     (N_height, 1) BFSF polar angles [rad].
+             * grid_lon : xt::xexpression
+             *     (1, N_width) equi-spaced BFSF azimuthal angles [rad].
+             * N_FS : size_t
+             *     :math:`2\pi`-periodic kernel bandwidth (odd-valued).
+             * T : double
+             *     Kernel periodicity [rad] to use for imaging, in (0, 2\pi].
+             * R : xt::xexpression
+             *     (3, 3) ICRS -> BFSF rotation matrix.
+             * N_eig : size_t
+             *     Number of eigenvectors given to operator().
+             * N_antenna : size_t
+             *     Number of antennas given to operator().
+             * N_threads : size_t
+             *     Number of threads used by the kernel's and default Workspaces' FFTs.
+             * effort : fourier::planning_effort
+             *     FFTW planning effort.
+             */
             template <typename E_colat, typename E_lon, typename E_R>
             FourierFieldSynthesizerBlock(const double wl,
                                          E_colat &&grid_colat,
@@ -320,71 +542,124 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
                 allocate_resources(N_threads, effort);
             }
 
+            /*
+             * Persist kernels across runs.
+             *
+             * The FS-domain kernel is a pure function of (BFSF antenna positions,
+             * wl, grid_colat, N_FS, T, Tc, alpha_window): after every
+             * re-generation, it is stored in `cache`, and later re-generations
+             * with identical inputs (by this or other objects/processes) map it
+             * from there instead: the kernel is then read in place from the
+             * cache file, neither copied nor planned.
+             *
+             * Parameters
+             * ----------
+             * cache : std::shared_ptr<pypeline::util::cache::FileCache>
+             *     Kernel store, or nullptr to disable caching.
+             */
+            void set_kernel_cache(std::shared_ptr<pypeline::util::cache::FileCache> cache) {
+                m_kernel_cache = std::move(cache);
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * N_beam : size_t
+             *     Number of beams of subsequent calls, if known.
+             *     (Default: 0, i.e. buffers depending on it are allocated by the first call.)
+             *
+             * Returns
+             * -------
+             * ws : Workspace
+             *     Scratch space for one thread's calls to operator() and synthesize().
+             *     Holds (N_eig + N_beam) * N_height * N_samples complex values.
+             */
+            Workspace workspace(const size_t N_beam = 0) const {
+                Workspace ws;
+                std::vector<size_t> shape_FST {m_N_eig * m_grid_colat.size(), m_N_samples};
+                ws.FST = std::make_unique<fourier::FFTW_FFS<TT>>(shape_FST, 1,
+                                                                 m_T, m_Tc, m_N_FS,
+                                                                 true, m_N_threads, m_effort);
+                ws.XYZ = xt::zeros<TT>({m_N_antenna, size_t(3)});
+                ws.mod = xt::zeros<cTT>({m_N_samples});
+                reserve_WFSK(ws, N_beam);
+                return ws;
+            }
+
+            /*
+             * Returns
+             * -------
+             * kernel : std::shared_ptr<const Kernel>
+             *     Current kernel, or nullptr if none was generated yet.
+             *     The kernel stays valid for as long as it is held, even if re-generated meanwhile.
+             */
+            std::shared_ptr<const Kernel> kernel() const {
+                return std::atomic_load(&m_kernel);
+            }
+
             /*
              * W: xt::xtensor<cTT, 2>&
              *    SpMatrixXX_t<cTT>&
+             *
+             * Thread-safe w.r.t. calls using other Workspaces.
+             * The output is a view into `ws`, valid until its next use.
              */
             template <typename E_W>
             auto operator()(xt::xtensor<cTT, 2> &V,
                             xt::xtensor<TT, 2> &XYZ,
-                            E_W &W) {
+                            E_W &W,
+                            Workspace &ws) {
                 validate_shapes(V, XYZ, W);
 
                 // icrs_XYZ -> bfsf_XYZ
-                Eigen::Map<MatrixXX_t<TT>> _XYZ(XYZ.data(), m_N_antenna, 3);
-                Eigen::Map<MatrixXX_t<TT>> _R(m_R.data(), 3, 3);
-
-                xt::xtensor<TT, 2> bfsf_XYZ {xt::zeros<TT>(std::vector<size_t>{m_N_antenna, 3})};
-                Eigen::Map<MatrixXX_t<TT>> _bfsf_XYZ(bfsf_XYZ.data(), m_N_antenna, 3);
-                _bfsf_XYZ = _XYZ * _R.transpose();
+                to_bfsf(XYZ, ws.XYZ);
 
                 // Phase shift + kernel evaluation
-                TT shift = std::numeric_limits<TT>::infinity();
-                if (m_XYZk != nullptr) {
-                    shift = phase_shift(bfsf_XYZ);
-                }
-                if (regen_required(shift)) {
-                    regen_kernel(bfsf_XYZ);
-                    shift = 0;
-                }
+                std::shared_ptr<const Kernel> kernel;
+                TT shift;
+                std::tie(kernel, shift) = acquire_kernel(ws.XYZ);
 
                 cTT _1j(0, 1);
                 const int N = (static_cast<int>(m_N_FS) - 1) / 2;
-                const int Q = m_N_samples - m_N_FS;
 
                 // Eigenfunctions (Fourier domain)
-                compute_EFS(V, W);
-                auto E_FS = m_FST->view_in();  // (N_eig * N_height, N_samples)
+                compute_EFS(*kernel, ws, V, W);  // (N_eig * N_height, N_samples) in ws.FST->data_in()
                 cTT base = std::exp(-_1j * static_cast<TT>((2 * M_PI * shift) / m_T));
-                xt::xtensor<TT, 1> exponent = xt::concatenate(
-                                                std::make_tuple(
-                                                  xt::arange<int>(-N, N + 1),
-                                                  xt::zeros<int>({Q})));
-                xt::xtensor<cTT, 1> mod {xt::pow(base, exponent)};
-                E_FS.multiplies_assign(mod);
+                for (int q = 0; q < static_cast<int>(m_N_samples); ++q) {  // exponent = [-N, ..., N, 0 x (N_samples - N_FS)]
+                    const int exponent = (q < static_cast<int>(m_N_FS)) ? (q - N) : 0;
+                    ws.mod(q) = std::pow(base, static_cast<TT>(exponent));
+                }
+                const size_t N_height = m_grid_colat.size();
+                simd::multiply(ws.FST->data_in(), ws.mod.data(), m_N_eig * N_height, m_N_samples, 1);
 
                 // Field Statistics
-                m_FST->iffs();
-                auto E_Ny = m_FST->view_out();
-                // auto _I_Ny = m_FST->view_out();
-                // _I_Ny.assign(xt::square(xt::abs(E_Ny)));
-
-                // _I_Ny is a complex-valued container: extract its real part only.
-                const size_t N_height = m_grid_colat.size();
+                ws.FST->iffs();
                 const size_t N_cells = m_N_eig * N_height * m_N_samples;
-                auto I_Ny = xt::adapt(reinterpret_cast<TT*>(m_FST->data_out()),
+                simd::abs2(ws.FST->data_out(), N_cells);
+
+                // |E_Ny|^{2} is stored in the real parts of a complex-valued container: extract them only.
+                auto I_Ny = xt::adapt(reinterpret_cast<TT*>(ws.FST->data_out()),
                                       N_cells, xt::no_ownership(),
-                                      std::vector<size_t> {m_N_eig, N_height, m_N_samples},
-                                      std::vector<size_t> {2 * m_N_samples * N_height,
-                                                           2 * m_N_samples,
-                                                           2});
-                I_Ny.assign(xt::square(xt::abs(E_Ny)));
+                                      std::array<size_t, 3> {m_N_eig, N_height, m_N_samples},
+                                      std::array<size_t, 3> {2 * m_N_samples * N_height,
+                                                             2 * m_N_samples,
+                                                             2});
                 I_Ny.reshape({m_N_eig, N_height, m_N_samples}); // because of simd instructions
                 return I_Ny;
             }
 
+            template <typename E_W>
+            auto operator()(xt::xtensor<cTT, 2> &V,
+                            xt::xtensor<TT, 2> &XYZ,
+                            E_W &W) {
+                return (*this)(V, XYZ, W, m_workspace);
+            }
+
+            /*
+             * Thread-safe w.r.t. calls using other Workspaces.
+             */
             template <typename E_stat>
-            xt::xtensor<TT, 3> synthesize(E_stat &&stat) {
+            xt::xtensor<TT, 3> synthesize(E_stat &&stat, Workspace &ws) {
                 const size_t N_level = stat.shape()[0];
                 const size_t N_height = m_grid_colat.size();
                 const size_t N_width = m_grid_lon.size();
@@ -402,12 +677,12 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
                     }
                 }
 
-                { // Fill m_FST->view_in() with statistics + go to FS domain.
-                    m_FST->view_in() = 0;
+                { // Fill ws.FST->view_in() with statistics + go to FS domain.
+                    ws.FST->view_in() = 0;
                     const size_t N_cells = N_level * N_height * m_N_samples;
-                    xt::adapt(m_FST->data_in(), N_cells, xt::no_ownership(),
+                    xt::adapt(ws.FST->data_in(), N_cells, xt::no_ownership(),
                               std::vector<size_t> {N_level, N_height, m_N_samples}) = stat;
-                    m_FST->ffs();
+                    ws.FST->ffs();
                 }
 
                 std::vector<size_t> shape_transform {N_level * N_height, m_N_FS};
@@ -418,11 +693,11 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
                                                       N_width,
                                                       true, 1, fourier::planning_effort::NONE);
 
-                { // Fill transform.in() with m_FST->view_out() + fs_interp()
+                { // Fill transform.in() with ws.FST->view_out() + fs_interp()
                     const size_t N_cells = N_level * N_height * m_N_samples;
                     const auto& idx = array::index(shape_transform.size(), 1, xt::range(0, m_N_FS));
                     const auto& transform_in = xt::strided_view(
-                        xt::adapt(m_FST->data_out(), N_cells, xt::no_ownership(),
+                        xt::adapt(ws.FST->data_out(), N_cells, xt::no_ownership(),
                                   std::vector<size_t> {N_level * N_height, m_N_samples}), idx);
                     transform.in(transform_in);
                     transform.fs_interp();
@@ -449,6 +724,11 @@ namespace pypeline { namespace phased_array { namespace bluebild { namespace fie
                 return field;
             }
 
+            template <typename E_stat>
+            xt::xtensor<TT, 3> synthesize(E_stat &&stat) {
+                return synthesize(std::forward<E_stat>(stat), m_workspace);
+            }
+
             std::string __repr__() {
                 std::stringstream msg;
                 msg << "FourierFieldSynthesizerBlock<" << ((is_float) ? "float" : "double") << ">("
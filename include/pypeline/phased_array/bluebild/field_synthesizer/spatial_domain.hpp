@@ -0,0 +1,232 @@
+// ############################################################################
+// spatial_domain.hpp
+// ==================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Field synthesizers that work in the spatial domain.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_BLUEBILD_FIELD_SYNTHESIZER_SPATIAL_DOMAIN
+#define PYPELINE_PHASED_ARRAY_BLUEBILD_FIELD_SYNTHESIZER_SPATIAL_DOMAIN
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "eigen3/Eigen/Eigen"
+#include "eigen3/Eigen/Sparse"
+
+#include "pypeline/types.hpp"
+
+namespace pypeline { namespace phased_array { namespace bluebild { namespace field_synthesizer { namespace spatial_domain {
+    /*
+     * Field synthesizer based on StandardSynthesis.
+     *
+     * Field statistics are evaluated tile-by-tile over the pixel grid:
+     * for each tile of N_tile pixels, the (N_antenna, N_tile) steering matrix
+     *
+     *     P[a, p] = exp(j 2 \pi <XYZ_a - mean(XYZ), r_p> / wl)
+     *
+     * is formed, reduced to E = V^{T} W^{T} P, and |E|^{2} is written to the
+     * output.
+     * N_tile is chosen such that P fits in L2 cache, hence memory use does not
+     * grow with the grid size.
+     * Tiles are processed in parallel.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/bluebild/field_synthesizer/spatial_domain.hpp"
+     *
+     *    namespace spatial_domain = pypeline::phased_array::bluebild::field_synthesizer::spatial_domain;
+     *
+     *    const size_t N_antenna = 48, N_beam = 4, N_eig = 3, N_pixel = 512 * 512;
+     *    MatrixXX_t<double> grid = MatrixXX_t<double>::Random(3, N_pixel);
+     *    spatial_domain::SpatialFieldSynthesizerBlock<double> synth(2.0, grid);
+     *
+     *    MatrixXX_t<cdouble_t> V = MatrixXX_t<cdouble_t>::Random(N_beam, N_eig);
+     *    MatrixXX_t<double> XYZ = 100 * MatrixXX_t<double>::Random(N_antenna, 3);
+     *    MatrixXX_t<cdouble_t> W = MatrixXX_t<cdouble_t>::Random(N_antenna, N_beam);
+     *
+     *    MatrixXX_t<double> stat = synth(V, XYZ, W);  // (N_eig, N_pixel)
+     */
+    template <typename TT>
+    class SpatialFieldSynthesizerBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            // Steering tile budget [bytes].
+            static constexpr size_t L2_budget = 256 * 1024;
+
+            double m_wl = 0;
+            MatrixXX_t<TT> m_grid {};  // (N_pixel, 3) unit pixel vectors.
+
+            size_t tile_size(const size_t N_antenna) const {
+                const size_t N_tile = L2_budget / (N_antenna * sizeof(cTT));
+                return std::max<size_t>(16, std::min<size_t>(4096, N_tile - (N_tile % 16)));
+            }
+
+            void validate(const Eigen::Ref<const MatrixXX_t<cTT>> &V,
+                          const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                          const size_t N_antenna,
+                          const size_t N_beam) const {
+                if (XYZ.cols() != 3) {
+                    std::string msg = "Parameter[XYZ] must have shape (N_antenna, 3).";
+                    throw std::runtime_error(msg);
+                }
+                if ((static_cast<size_t>(XYZ.rows()) != N_antenna) ||
+                    (static_cast<size_t>(V.rows()) != N_beam) ||
+                    (N_antenna == 0) || (V.cols() == 0)) {
+                    std::string msg = "Parameters[V, XYZ, W] are inconsistent.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * V : (N_beam, N_eig) eigenvectors.
+             * XYZ : (N_antenna, 3) antenna positions.
+             * W : (N_antenna, N_beam) dense or sparse beamweights.
+             *
+             * Returns
+             * -------
+             * stat : (N_eig, N_pixel) field statistics.
+             */
+            template <typename E_W>
+            MatrixXX_t<TT> synthesize_tiles(const Eigen::Ref<const MatrixXX_t<cTT>> &V,
+                                            const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                            const E_W &W) const {
+                const int N_antenna = static_cast<int>(XYZ.rows());
+                const int N_beam = static_cast<int>(V.rows());
+                const int N_eig = static_cast<int>(V.cols());
+                const int N_pixel = static_cast<int>(m_grid.rows());
+                const int N_tile = static_cast<int>(tile_size(N_antenna));
+                const int N_block = (N_pixel + N_tile - 1) / N_tile;
+
+                // Phases are expressed in cycles: XYZ / wl.
+                const MatrixXX_t<TT> XYZ_c = ((XYZ.rowwise() - XYZ.colwise().mean()) / static_cast<TT>(m_wl));
+                const MatrixXX_t<cTT> V_T = V.transpose();
+                const auto W_T = W.transpose();
+
+                MatrixXX_t<TT> stat(N_eig, N_pixel);
+
+                #ifdef _OPENMP
+                #pragma omp parallel
+                #endif
+                {
+                    ArrayXX_t<TT> phase(N_antenna, N_tile);
+                    MatrixXX_t<cTT> P(N_antenna, N_tile);
+                    MatrixXX_t<cTT> PW(N_beam, N_tile);
+                    MatrixXX_t<cTT> E(N_eig, N_tile);
+
+                    #ifdef _OPENMP
+                    #pragma omp for schedule(dynamic)
+                    #endif
+                    for (int b = 0; b < N_block; ++b) {
+                        const int p0 = b * N_tile;
+                        const int N_px = std::min(N_tile, N_pixel - p0);
+
+                        auto _phase = phase.leftCols(N_px);
+                        _phase = (XYZ_c * m_grid.middleRows(p0, N_px).transpose()).array();
+                        _phase = static_cast<TT>(2 * M_PI) * (_phase - _phase.round());
+
+                        auto _P = P.leftCols(N_px);
+                        _P.real() = _phase.cos().matrix();
+                        _P.imag() = _phase.sin().matrix();
+
+                        auto _PW = PW.leftCols(N_px);
+                        _PW.noalias() = W_T * _P;
+
+                        auto _E = E.leftCols(N_px);
+                        _E.noalias() = V_T * _PW;
+
+                        stat.middleCols(p0, N_px) = _E.cwiseAbs2();
+                    }
+                }
+
+                return stat;
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * wl : double
+             *     Wave-length [m] of observations.
+             * pix_grid : Eigen::Ref<const MatrixXX_t<TT>>
+             *     (3, N_pixel) pixel vectors.
+             */
+            SpatialFieldSynthesizerBlock(const double wl,
+                                         const Eigen::Ref<const MatrixXX_t<TT>> &pix_grid):
+                m_wl(wl) {
+                if (wl <= 0) {
+                    std::string msg = "Parameter[wl] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if ((pix_grid.rows() != 3) || (pix_grid.cols() == 0)) {
+                    std::string msg = "Parameter[pix_grid] must have shape (3, N_pixel).";
+                    throw std::runtime_error(msg);
+                }
+
+                m_grid = pix_grid.transpose();
+                m_grid.rowwise().normalize();
+            }
+
+            /*
+             * Compute instantaneous field statistics.
+             *
+             * Parameters
+             * ----------
+             * V : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_eig) complex-valued eigenvectors.
+             * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+             *     (N_antenna, 3) Cartesian instrument geometry, in the same
+             *     reference frame as pix_grid.
+             * W : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_antenna, N_beam) synthesis beamweights.
+             *
+             * Returns
+             * -------
+             * stat : MatrixXX_t<TT>
+             *     (N_eig, N_pixel) field statistics.
+             */
+            MatrixXX_t<TT> operator()(const Eigen::Ref<const MatrixXX_t<cTT>> &V,
+                                      const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                      const Eigen::Ref<const MatrixXX_t<cTT>> &W) const {
+                validate(V, XYZ, W.rows(), W.cols());
+                return synthesize_tiles(V, XYZ, W);
+            }
+
+            /*
+             * Same as above, with sparse beamweights.
+             *
+             * W : const SpMatrixXX_t<std::complex<TT>>&
+             *     (N_antenna, N_beam) synthesis beamweights.
+             */
+            MatrixXX_t<TT> operator()(const Eigen::Ref<const MatrixXX_t<cTT>> &V,
+                                      const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                      const SpMatrixXX_t<cTT> &W) const {
+                validate(V, XYZ, W.rows(), W.cols());
+                return synthesize_tiles(V, XYZ, W);
+            }
+
+            double wl() const {
+                return m_wl;
+            }
+
+            size_t N_pixel() const {
+                return static_cast<size_t>(m_grid.rows());
+            }
+    };
+}}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_BLUEBILD_FIELD_SYNTHESIZER_SPATIAL_DOMAIN
@@ -0,0 +1,545 @@
+// ############################################################################
+// parameter_estimator.hpp
+// =======================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Streaming parameter estimators.
+ *
+ * Eigenproblems are solved as data is collected: only a bounded-size sketch
+ * of the resulting energy levels is kept in memory, irrespective of the
+ * number of epochs scanned.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_BLUEBILD_PARAMETER_ESTIMATOR_HPP
+#define PYPELINE_PHASED_ARRAY_BLUEBILD_PARAMETER_ESTIMATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/data_processor.hpp"
+#include "pypeline/util/math/linalg.hpp"
+
+namespace pypeline { namespace phased_array { namespace bluebild { namespace parameter_estimator {
+    namespace _detail {
+        namespace linalg = pypeline::util::math::linalg;
+        namespace dp = pypeline::phased_array::bluebild::data_processor;
+
+        /*
+         * Uniform random sample of bounded size from a stream (Vitter's algorithm R).
+         */
+        class Reservoir {
+            private:
+                size_t m_capacity = 0;
+                uint64_t m_N_seen = 0;
+                std::vector<double> m_sample {};
+                std::mt19937_64 m_rng;
+
+            public:
+                Reservoir(const size_t capacity, const uint64_t seed):
+                    m_capacity(capacity), m_rng(seed) {
+                    m_sample.reserve(capacity);
+                }
+
+                void push(const double x) {
+                    ++m_N_seen;
+                    if (m_sample.size() < m_capacity) {
+                        m_sample.push_back(x);
+                    } else {
+                        std::uniform_int_distribution<uint64_t> dist(0, m_N_seen - 1);
+                        const uint64_t k = dist(m_rng);
+                        if (k < m_capacity) {
+                            m_sample[k] = x;
+                        }
+                    }
+                }
+
+                void clear() {
+                    m_N_seen = 0;
+                    m_sample.clear();
+                }
+
+                const std::vector<double>& sample() const {
+                    return m_sample;
+                }
+
+                uint64_t N_seen() const {
+                    return m_N_seen;
+                }
+        };
+
+        /*
+         * Exact 1-D k-means.
+         *
+         * Optimal clusters of sorted data are contiguous, hence
+         *     E[k][j] = min_{i <= j} E[k - 1][i - 1] + SSE(x[i..j]).
+         * The optimal split point is monotone in j, so each layer is filled by
+         * divide-and-conquer in O(n log n).
+         *
+         * Returns the (k,) cluster means in increasing order.
+         */
+        inline std::vector<double> kmeans_1d(std::vector<double> x, const size_t k) {
+            const size_t n = x.size();
+            if (n < k) {
+                std::string msg = "Not enough energy levels were collected to form N_level clusters.";
+                throw std::runtime_error(msg);
+            }
+            std::sort(x.begin(), x.end());
+
+            std::vector<double> cs(n + 1, 0), cs2(n + 1, 0);  // centered prefix sums.
+            const double shift = x[n / 2];
+            for (size_t i = 0; i < n; ++i) {
+                const double y = x[i] - shift;
+                cs[i + 1] = cs[i] + y;
+                cs2[i + 1] = cs2[i] + (y * y);
+            }
+            auto sse = [&](const size_t i, const size_t j) {  // x[i..j], inclusive.
+                const double m = static_cast<double>(j - i + 1);
+                const double s = cs[j + 1] - cs[i];
+                return std::max<double>((cs2[j + 1] - cs2[i]) - (s * s) / m, 0);
+            };
+
+            const double inf = std::numeric_limits<double>::infinity();
+            std::vector<double> E_prev(n), E(n);
+            std::vector<std::vector<size_t>> split(k, std::vector<size_t>(n, 0));  // first index of last cluster.
+            for (size_t j = 0; j < n; ++j) {
+                E_prev[j] = sse(0, j);
+            }
+
+            for (size_t c = 1; c < k; ++c) {
+                std::fill(E.begin(), E.end(), inf);
+                std::vector<size_t> &s_c = split[c];
+
+                // Fill E[j] for j in [j_lo, j_hi], knowing split[j] in [i_lo, i_hi].
+                std::vector<std::tuple<size_t, size_t, size_t, size_t>> stack {std::make_tuple(c, n - 1, c, n - 1)};
+                while (!stack.empty()) {
+                    size_t j_lo, j_hi, i_lo, i_hi;
+                    std::tie(j_lo, j_hi, i_lo, i_hi) = stack.back();
+                    stack.pop_back();
+
+                    const size_t j = (j_lo + j_hi) / 2;
+                    size_t best_i = std::max(i_lo, c);
+                    double best = inf;
+                    for (size_t i = std::max(i_lo, c); i <= std::min(i_hi, j); ++i) {
+                        const double e = E_prev[i - 1] + sse(i, j);
+                        if (e < best) {
+                            best = e;
+                            best_i = i;
+                        }
+                    }
+                    E[j] = best;
+                    s_c[j] = best_i;
+
+                    if (j > j_lo) { stack.emplace_back(j_lo, j - 1, i_lo, best_i); }
+                    if (j < j_hi) { stack.emplace_back(j + 1, j_hi, best_i, i_hi); }
+                }
+                std::swap(E, E_prev);
+            }
+
+            std::vector<double> centroid(k);
+            size_t j = n;
+            for (size_t c = k; c-- > 0;) {
+                const size_t i = ((c > 0) ? split[c][j - 1] : 0);
+                centroid[c] = shift + (cs[j] - cs[i]) / static_cast<double>(j - i);
+                j = i;
+            }
+            return centroid;
+        }
+    }
+
+    /*
+     * Parameter estimator for computing intensity fields.
+     *
+     * Each (S, G) pair is decomposed on collection; only log-eigenvalues are
+     * retained, in a uniform reservoir sample of at most N_sketch elements.
+     * Cluster centroids are obtained by exact 1-D k-means on the sample.
+     *
+     * Memory usage is O(N_level + N_sketch), independent of the number of
+     * collected epochs.
+     *
+     * This object is not thread-safe.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/bluebild/parameter_estimator.hpp"
+     *
+     *    namespace parameter_estimator = pypeline::phased_array::bluebild::parameter_estimator;
+     *
+     *    parameter_estimator::IntensityFieldParameterEstimator<double> I_est(4, 0.95);
+     *    for (...) {  // epochs
+     *        MatrixXX_t<cdouble_t> S = ..., G = ...;
+     *        I_est.collect(S, G);
+     *    }
+     *
+     *    size_t N_eig;
+     *    std::vector<double> centroid;
+     *    std::tie(N_eig, centroid) = I_est.infer_parameters();
+     */
+    template <typename TT>
+    class IntensityFieldParameterEstimator {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            size_t m_N_level = 0;
+            double m_sigma = 1;
+            uint64_t m_N_data = 0;
+            uint64_t m_N_eig_total = 0;
+            _detail::Reservoir m_sketch;
+
+            // Compacted buffers, re-used across calls.
+            std::vector<Eigen::Index> m_idx {};
+            MatrixXX_t<cTT> m_S {};
+            MatrixXX_t<cTT> m_G {};
+
+            /*
+             * Positive eigenvalues of a (S, G) pair, with broken beams removed.
+             */
+            ArrayX_t<TT> decompose(const Eigen::Ref<const MatrixXX_t<cTT>> &S,
+                                   const Eigen::Ref<const MatrixXX_t<cTT>> &G,
+                                   std::vector<Eigen::Index> &idx,
+                                   MatrixXX_t<cTT> &S_c,
+                                   MatrixXX_t<cTT> &G_c) const {
+                _detail::dp::_detail::validate<TT>(S, G);
+                const size_t N_beam = S.rows();
+                const size_t N_work = _detail::dp::_detail::compact<TT>(S, idx);
+
+                if (N_work == N_beam) {
+                    if ((S.array().abs() <= static_cast<TT>(1e-8)).all()) { return ArrayX_t<TT>(0); }
+                    return _detail::linalg::eigh<TT>(S, G, m_sigma, 0).D;
+                }
+
+                _detail::dp::_detail::gather<TT>(S, idx, S_c);
+                _detail::dp::_detail::gather<TT>(G, idx, G_c);
+                if ((S_c.array().abs() <= static_cast<TT>(1e-8)).all()) { return ArrayX_t<TT>(0); }
+                return _detail::linalg::eigh<TT>(S_c, G_c, m_sigma, 0).D;
+            }
+
+            void update(const ArrayX_t<TT> &D) {
+                ++m_N_data;
+                for (Eigen::Index k = 0; k < D.size(); ++k) {
+                    if (D[k] > 0) {
+                        ++m_N_eig_total;
+                        m_sketch.push(std::log(static_cast<double>(D[k])));
+                    }
+                }
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * N_level : size_t
+             *     Number of clustered energy levels to output.
+             * sigma : double
+             *     Normalized energy ratio for fPCA decomposition.
+             * N_sketch : size_t
+             *     Maximum number of energy levels retained for clustering.
+             * seed : uint64_t
+             *     Seed of the reservoir sampler.
+             */
+            IntensityFieldParameterEstimator(const size_t N_level,
+                                             const double sigma,
+                                             const size_t N_sketch = 16384,
+                                             const uint64_t seed = 0):
+                m_N_level(N_level), m_sigma(sigma), m_sketch(N_sketch, seed) {
+                if (N_level == 0) {
+                    std::string msg = "Parameter[N_level] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if (!((0 < sigma) && (sigma <= 1))) {
+                    std::string msg = "Parameter[sigma] must lie in (0,1].";
+                    throw std::runtime_error(msg);
+                }
+                if (N_sketch < N_level) {
+                    std::string msg = "Parameter[N_sketch] must be at least N_level.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Decompose a (S, G) pair and add its energy levels to the sketch.
+             *
+             * Parameters
+             * ----------
+             * S : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_beam) visibility matrix.
+             * G : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_beam) Gram matrix.
+             */
+            void collect(const Eigen::Ref<const MatrixXX_t<cTT>> &S,
+                         const Eigen::Ref<const MatrixXX_t<cTT>> &G) {
+                update(decompose(S, G, m_idx, m_S, m_G));
+            }
+
+            /*
+             * Decompose many (S, G) pairs in parallel.
+             *
+             * The sketch is updated in input order, so results do not depend on
+             * thread scheduling.
+             *
+             * Parameters
+             * ----------
+             * S : const std::complex<TT>*
+             *     (N_data, N_beam, N_beam) visibility matrices.
+             * G : const std::complex<TT>*
+             *     (N_data, N_beam, N_beam) Gram matrices.
+             * N_data : size_t
+             * N_beam : size_t
+             */
+            void collect_batch(const cTT *S, const cTT *G,
+                               const size_t N_data, const size_t N_beam) {
+                const size_t N_SG = N_beam * N_beam;
+                std::vector<ArrayX_t<TT>> D(N_data);
+                std::exception_ptr error = nullptr;
+                std::atomic<bool> failed(false);
+
+                #ifdef _OPENMP
+                #pragma omp parallel
+                #endif
+                {
+                    std::vector<Eigen::Index> idx;
+                    MatrixXX_t<cTT> S_c, G_c;
+
+                    #ifdef _OPENMP
+                    #pragma omp for schedule(dynamic)
+                    #endif
+                    for (int i = 0; i < static_cast<int>(N_data); ++i) {
+                        if (failed) { continue; }
+                        try {
+                            Eigen::Map<const MatrixXX_t<cTT>> S_i(S + i * N_SG, N_beam, N_beam);
+                            Eigen::Map<const MatrixXX_t<cTT>> G_i(G + i * N_SG, N_beam, N_beam);
+                            D[i] = decompose(S_i, G_i, idx, S_c, G_c);
+                        } catch (...) {
+                            #ifdef _OPENMP
+                            #pragma omp critical
+                            #endif
+                            {
+                                if (error == nullptr) { error = std::current_exception(); }
+                            }
+                            failed = true;
+                        }
+                    }
+                }
+
+                if (error != nullptr) {
+                    std::rethrow_exception(error);
+                }
+                for (const auto &D_i : D) {
+                    update(D_i);
+                }
+            }
+
+            /*
+             * Estimate parameters given collected data.
+             *
+             * Returns
+             * -------
+             * N_eig : size_t
+             *     Number of eigenpairs to use: the average number of energy
+             *     levels per epoch, but at least N_level.
+             * cluster_centroid : std::vector<double>
+             *     (N_level,) intensity field cluster centroids, in decreasing order.
+             */
+            std::tuple<size_t, std::vector<double>> infer_parameters() const {
+                if (m_N_data == 0) {
+                    std::string msg = "No data has been collected.";
+                    throw std::runtime_error(msg);
+                }
+
+                std::vector<double> centroid = _detail::kmeans_1d(m_sketch.sample(), m_N_level);
+                for (auto &c : centroid) {
+                    c = std::exp(c);
+                }
+                std::reverse(centroid.begin(), centroid.end());
+
+                // For extremely small telescopes or datasets that are mostly 'broken', we can have (N_eig < N_level).
+                // N_eig is then raised to N_level: trailing energy levels are (close to) all-0.
+                const size_t N_eig = std::max<size_t>((m_N_eig_total + m_N_data - 1) / m_N_data, m_N_level);
+                return std::make_tuple(N_eig, centroid);
+            }
+
+            /*
+             * Forget all collected data.
+             */
+            void reset() {
+                m_N_data = 0;
+                m_N_eig_total = 0;
+                m_sketch.clear();
+            }
+
+            size_t N_level() const {
+                return m_N_level;
+            }
+
+            double sigma() const {
+                return m_sigma;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N_data : uint64_t
+             *     Number of collected epochs.
+             */
+            uint64_t N_data() const {
+                return m_N_data;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N_sketch : size_t
+             *     Number of energy levels currently held in the sketch.
+             */
+            size_t N_sketch() const {
+                return m_sketch.sample().size();
+            }
+    };
+
+    /*
+     * Parameter estimator for computing sensitivity fields.
+     *
+     * Only the number of collected epochs and energy levels are tracked, so
+     * memory usage is O(1).
+     *
+     * This object is not thread-safe.
+     */
+    template <typename TT>
+    class SensitivityFieldParameterEstimator {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            double m_sigma = 1;
+            uint64_t m_N_data = 0;
+            uint64_t m_N_eig_total = 0;
+
+            size_t N_positive(const Eigen::Ref<const MatrixXX_t<cTT>> &G) const {
+                if (G.rows() != G.cols()) {
+                    std::string msg = "Parameter[G] must be square.";
+                    throw std::runtime_error(msg);
+                }
+
+                const ArrayX_t<TT> D = _detail::linalg::eigh<TT>(G, m_sigma, 0).D;
+                return (D > 0).count();
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * sigma : double
+             *     Normalized energy ratio for fPCA decomposition.
+             */
+            SensitivityFieldParameterEstimator(const double sigma):
+                m_sigma(sigma) {
+                if (!((0 < sigma) && (sigma <= 1))) {
+                    std::string msg = "Parameter[sigma] must lie in (0,1].";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * G : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (N_beam, N_beam) Gram matrix.
+             */
+            void collect(const Eigen::Ref<const MatrixXX_t<cTT>> &G) {
+                m_N_eig_total += N_positive(G);
+                ++m_N_data;
+            }
+
+            /*
+             * Decompose many Gram matrices in parallel.
+             *
+             * Parameters
+             * ----------
+             * G : const std::complex<TT>*
+             *     (N_data, N_beam, N_beam) Gram matrices.
+             * N_data : size_t
+             * N_beam : size_t
+             */
+            void collect_batch(const cTT *G,
+                               const size_t N_data, const size_t N_beam) {
+                const size_t N_G = N_beam * N_beam;
+                uint64_t N_eig_total = 0;
+                std::exception_ptr error = nullptr;
+                std::atomic<bool> failed(false);
+
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic) reduction(+:N_eig_total)
+                #endif
+                for (int i = 0; i < static_cast<int>(N_data); ++i) {
+                    if (failed) { continue; }
+                    try {
+                        Eigen::Map<const MatrixXX_t<cTT>> G_i(G + i * N_G, N_beam, N_beam);
+                        N_eig_total += N_positive(G_i);
+                    } catch (...) {
+                        #ifdef _OPENMP
+                        #pragma omp critical
+                        #endif
+                        {
+                            if (error == nullptr) { error = std::current_exception(); }
+                        }
+                        failed = true;
+                    }
+                }
+
+                if (error != nullptr) {
+                    std::rethrow_exception(error);
+                }
+                m_N_eig_total += N_eig_total;
+                m_N_data += N_data;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N_eig : size_t
+             *     Number of eigenpairs to use.
+             */
+            size_t infer_parameters() const {
+                if (m_N_data == 0) {
+                    std::string msg = "No data has been collected.";
+                    throw std::runtime_error(msg);
+                }
+
+                return (m_N_eig_total + m_N_data - 1) / m_N_data;
+            }
+
+            void reset() {
+                m_N_data = 0;
+                m_N_eig_total = 0;
+            }
+
+            double sigma() const {
+                return m_sigma;
+            }
+
+            uint64_t N_data() const {
+                return m_N_data;
+            }
+    };
+}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_BLUEBILD_PARAMETER_ESTIMATOR_HPP
@@ -0,0 +1,419 @@
+// ############################################################################
+// instrument.hpp
+// ==============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Instrument-related operations.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_INSTRUMENT_HPP
+#define PYPELINE_PHASED_ARRAY_INSTRUMENT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+
+#include "pypeline/types.hpp"
+
+namespace pypeline { namespace phased_array { namespace instrument {
+    namespace _detail {
+        // Earth rotation rate [rad/s] w.r.t. UT1 seconds (IAU 2000 ERA definition).
+        constexpr double EARTH_ROTATION_RATE = 2 * M_PI * 1.00273781191135448 / 86400.0;
+
+        /*
+         * Active rotation of angle `theta` [rad] around the Z-axis.
+         */
+        inline Eigen::Matrix3d Rz(const double theta) {
+            const double c = std::cos(theta);
+            const double s = std::sin(theta);
+
+            Eigen::Matrix3d R;
+            R << c, -s, 0,
+                 s,  c, 0,
+                 0,  0, 1;
+            return R;
+        }
+
+        inline double cross(const Eigen::Vector2d &o,
+                            const Eigen::Vector2d &a,
+                            const Eigen::Vector2d &b) {
+            return ((a[0] - o[0]) * (b[1] - o[1])) - ((a[1] - o[1]) * (b[0] - o[0]));
+        }
+
+        /*
+         * Convex hull of a 2D point cloud (Andrew's monotone chain).
+         *
+         * Returns
+         * -------
+         * hull : std::vector<Eigen::Vector2d>
+         *     Hull vertices in counter-clockwise order, without collinear points.
+         */
+        inline std::vector<Eigen::Vector2d> convex_hull(std::vector<Eigen::Vector2d> p) {
+            std::sort(p.begin(), p.end(),
+                      [](const Eigen::Vector2d &a, const Eigen::Vector2d &b) {
+                          return (a[0] < b[0]) || ((a[0] == b[0]) && (a[1] < b[1]));
+                      });
+            p.erase(std::unique(p.begin(), p.end()), p.end());
+            if (p.size() < 3) { return p; }
+
+            std::vector<Eigen::Vector2d> hull(2 * p.size());
+            size_t k = 0;
+            for (size_t i = 0; i < p.size(); ++i) {  // lower hull
+                while ((k >= 2) && (cross(hull[k - 2], hull[k - 1], p[i]) <= 0)) { --k; }
+                hull[k++] = p[i];
+            }
+            for (size_t i = p.size() - 1, t = k + 1; i > 0; --i) {  // upper hull
+                while ((k >= t) && (cross(hull[k - 2], hull[k - 1], p[i - 1]) <= 0)) { --k; }
+                hull[k++] = p[i - 1];
+            }
+            hull.resize(k - 1);
+            return hull;
+        }
+
+        /*
+         * Diameter of a convex polygon (rotating calipers).
+         */
+        inline double polygon_diameter(const std::vector<Eigen::Vector2d> &hull) {
+            const size_t N = hull.size();
+            if (N < 2) { return 0; }
+            if (N == 2) { return (hull[0] - hull[1]).norm(); }
+
+            double d2_max = 0;
+            for (size_t i = 0, j = 1; i < N; ++i) {
+                const Eigen::Vector2d &a = hull[i];
+                const Eigen::Vector2d &b = hull[(i + 1) % N];
+                while (std::abs(cross(a, b, hull[(j + 1) % N])) > std::abs(cross(a, b, hull[j]))) {
+                    j = (j + 1) % N;
+                }
+                d2_max = std::max({d2_max, (a - hull[j]).squaredNorm(), (b - hull[j]).squaredNorm()});
+            }
+            return std::sqrt(d2_max);
+        }
+    }
+
+    /*
+     * Maximum distance between two points of a point cloud.
+     *
+     * 2D point clouds are reduced to their convex hull, whose diameter is then
+     * found in linear time with rotating calipers.
+     * 3D point clouds are scanned pairwise without forming the (N_point, N_point)
+     * distance matrix.
+     *
+     * Parameters
+     * ----------
+     * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+     *     (N_point, 2) or (N_point, 3) Cartesian coordinates.
+     *
+     * Returns
+     * -------
+     * baseline : double
+     *     Largest pairwise distance.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/instrument.hpp"
+     *
+     *    namespace instrument = pypeline::phased_array::instrument;
+     *
+     *    MatrixXX_t<double> XY(4, 2);
+     *    XY << 0, 0,
+     *          1, 0,
+     *          1, 1,
+     *          0.5, 0.5;
+     *    double d = instrument::max_baseline<double>(XY);  // sqrt(2)
+     */
+    template <typename TT>
+    double max_baseline(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+
+        const int N_point = static_cast<int>(XYZ.rows());
+        if (XYZ.cols() == 2) {
+            std::vector<Eigen::Vector2d> p(N_point);
+            for (int i = 0; i < N_point; ++i) {
+                p[i] << static_cast<double>(XYZ(i, 0)), static_cast<double>(XYZ(i, 1));
+            }
+            return _detail::polygon_diameter(_detail::convex_hull(std::move(p)));
+        } else if (XYZ.cols() == 3) {
+            const MatrixXX_t<double> P = XYZ.template cast<double>();
+            double d2_max = 0;
+
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(dynamic) reduction(max: d2_max)
+            #endif
+            for (int i = 0; i < N_point; ++i) {
+                for (int j = i + 1; j < N_point; ++j) {
+                    d2_max = std::max(d2_max, (P.row(i) - P.row(j)).squaredNorm());
+                }
+            }
+            return std::sqrt(d2_max);
+        } else {
+            std::string msg = "Parameter[XYZ] must have shape (N_point, 2) or (N_point, 3).";
+            throw std::runtime_error(msg);
+        }
+    }
+
+    /*
+     * Batched ITRS -> ICRS antenna positions over an observation window.
+     *
+     * The ITRS -> ICRS rotation is factored as
+     *
+     *     R(t) = Q(t) Rz(w t),
+     *
+     * where Rz(w t) is the Earth rotation at the IAU 2000 ERA rate w, and Q(t)
+     * gathers precession, nutation and polar motion.
+     * Q(t) varies slowly, and is obtained by SLERP between anchor epochs whose
+     * full rotations are supplied at construction.
+     * Positions at any epoch in the window are then a single 3x3 rotation of the
+     * ITRS layout.
+     * Epochs outside the anchor range use the nearest anchor's Q(t).
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include <vector>
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/instrument.hpp"
+     *
+     *    namespace instrument = pypeline::phased_array::instrument;
+     *
+     *    MatrixXX_t<double> XYZ = MatrixXX_t<double>::Random(10, 3);
+     *    std::vector<double> anchor_time {0, 600};  // [s]
+     *    MatrixXX_t<double> anchor_rot(6, 3);        // stacked (3, 3) ITRS -> ICRS rotations.
+     *    anchor_rot << MatrixXX_t<double>::Identity(3, 3),
+     *                  instrument::_detail::Rz(600 * instrument::_detail::EARTH_ROTATION_RATE);
+     *
+     *    instrument::EarthBoundInstrumentGeometryBlock<double> geom(XYZ, anchor_time, anchor_rot);
+     *
+     *    std::vector<double> t {0, 150, 300, 450};
+     *    std::vector<double> icrs_XYZ(t.size() * 10 * 3);
+     *    geom.process_batch(t.data(), t.size(), icrs_XYZ.data());
+     */
+    template <typename TT>
+    class EarthBoundInstrumentGeometryBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+
+            MatrixXX_t<double> m_XYZ {};              // (N_antenna, 3) ITRS layout.
+            std::vector<double> m_anchor_time {};     // (N_anchor,) strictly increasing [s].
+            std::vector<Eigen::Quaterniond> m_Q {};   // (N_anchor,) slow rotation Q(t).
+
+            Eigen::Quaterniond slow_rotation(const double t) const {
+                const size_t N_anchor = m_anchor_time.size();
+                if (t <= m_anchor_time.front()) { return m_Q.front(); }
+                if (t >= m_anchor_time.back()) { return m_Q.back(); }
+
+                const size_t k = static_cast<size_t>(std::upper_bound(m_anchor_time.begin(), m_anchor_time.end(), t) -
+                                                     m_anchor_time.begin()) - 1;
+                if (k + 1 >= N_anchor) { return m_Q.back(); }
+                const double alpha = (t - m_anchor_time[k]) / (m_anchor_time[k + 1] - m_anchor_time[k]);
+                return m_Q[k].slerp(alpha, m_Q[k + 1]);
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * XYZ : Eigen::Ref<const MatrixXX_t<double>>
+             *     (N_antenna, 3) ITRS antenna positions [m].
+             * anchor_time : std::vector<double>
+             *     (N_anchor,) strictly increasing anchor epochs [s], w.r.t. an
+             *     arbitrary UT1 reference.
+             * anchor_rot : Eigen::Ref<const MatrixXX_t<double>>
+             *     (3 * N_anchor, 3) vertically-stacked ITRS -> ICRS rotation
+             *     matrices at each anchor epoch.
+             */
+            EarthBoundInstrumentGeometryBlock(const Eigen::Ref<const MatrixXX_t<double>> &XYZ,
+                                              const std::vector<double> &anchor_time,
+                                              const Eigen::Ref<const MatrixXX_t<double>> &anchor_rot):
+                m_XYZ(XYZ), m_anchor_time(anchor_time) {
+                if ((XYZ.rows() == 0) || (XYZ.cols() != 3)) {
+                    std::string msg = "Parameter[XYZ] must have shape (N_antenna > 0, 3).";
+                    throw std::runtime_error(msg);
+                }
+                const size_t N_anchor = anchor_time.size();
+                if (N_anchor == 0) {
+                    std::string msg = "Parameter[anchor_time] cannot be empty.";
+                    throw std::runtime_error(msg);
+                }
+                for (size_t k = 1; k < N_anchor; ++k) {
+                    if (!(anchor_time[k - 1] < anchor_time[k])) {
+                        std::string msg = "Parameter[anchor_time] must be strictly increasing.";
+                        throw std::runtime_error(msg);
+                    }
+                }
+                if ((static_cast<size_t>(anchor_rot.rows()) != 3 * N_anchor) || (anchor_rot.cols() != 3)) {
+                    std::string msg = "Parameter[anchor_rot] must have shape (3 * N_anchor, 3).";
+                    throw std::runtime_error(msg);
+                }
+
+                m_Q.reserve(N_anchor);
+                for (size_t k = 0; k < N_anchor; ++k) {
+                    const Eigen::Matrix3d R = anchor_rot.block<3, 3>(3 * k, 0);
+                    const Eigen::Matrix3d Q = R * _detail::Rz(-_detail::EARTH_ROTATION_RATE * anchor_time[k]);
+
+                    // Project onto SO(3) to absorb rounding in the supplied matrices.
+                    Eigen::JacobiSVD<Eigen::Matrix3d> svd(Q, Eigen::ComputeFullU | Eigen::ComputeFullV);
+                    Eigen::Matrix3d D = Eigen::Matrix3d::Identity();
+                    D(2, 2) = (svd.matrixU() * svd.matrixV().transpose()).determinant();
+                    Eigen::Quaterniond q(svd.matrixU() * D * svd.matrixV().transpose());
+
+                    if ((k > 0) && (m_Q.back().dot(q) < 0)) {  // shortest-path SLERP
+                        q.coeffs() *= -1;
+                    }
+                    m_Q.push_back(q.normalized());
+                }
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * t : double
+             *     Epoch [s], in the same reference as anchor_time.
+             *
+             * Returns
+             * -------
+             * R : Eigen::Matrix3d
+             *     ITRS -> ICRS rotation matrix.
+             */
+            Eigen::Matrix3d rotation(const double t) const {
+                return slow_rotation(t).toRotationMatrix() * _detail::Rz(_detail::EARTH_ROTATION_RATE * t);
+            }
+
+            /*
+             * Determine antenna positions in ICRS.
+             *
+             * Parameters
+             * ----------
+             * t : double
+             *     Epoch [s], in the same reference as anchor_time.
+             *
+             * Returns
+             * -------
+             * XYZ : MatrixXX_t<TT>
+             *     (N_antenna, 3) ICRS antenna positions [m].
+             */
+            MatrixXX_t<TT> operator()(const double t) const {
+                return (m_XYZ * rotation(t).transpose()).template cast<TT>();
+            }
+
+            /*
+             * Determine antenna positions in ICRS at several epochs.
+             *
+             * Parameters
+             * ----------
+             * t : const double*
+             *     (N_time,) epochs [s], in the same reference as anchor_time.
+             * N_time : size_t
+             * XYZ : TT*
+             *     (N_time, N_antenna, 3) buffer to which ICRS antenna positions
+             *     [m] are written.
+             */
+            void process_batch(const double *t,
+                               const size_t N_time,
+                               TT *XYZ) const {
+                const int N_antenna = static_cast<int>(m_XYZ.rows());
+                const int N = static_cast<int>(N_time);
+
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (int i = 0; i < N; ++i) {
+                    Eigen::Map<MatrixXX_t<TT>> out(XYZ + (static_cast<size_t>(i) * N_antenna * 3), N_antenna, 3);
+                    out = (m_XYZ * rotation(t[i]).transpose()).template cast<TT>();
+                }
+            }
+
+            /*
+             * Rotation matrix from ICRS to the local Bluebild FastSynthesis
+             * Frame (BFSF).
+             *
+             * Each antenna's trajectory is sampled N_interval times during the
+             * observation, and fitted by a plane z = ax + by + c.
+             * The BFSF Z-axis is co-linear to the average plane normal.
+             *
+             * Parameters
+             * ----------
+             * t_start : double
+             *     Start of the observation period [s].
+             * t_end : double
+             *     End of the observation period [s].
+             *
+             * Returns
+             * -------
+             * R : Eigen::Matrix3d
+             *     ICRS -> BFSF rotation matrix.
+             */
+            Eigen::Matrix3d icrs2bfsf_rot(const double t_start,
+                                          const double t_end) const {
+                if (t_start > t_end) {
+                    std::string msg = "Parameter[t_start] must precede Parameter[t_end].";
+                    throw std::runtime_error(msg);
+                }
+
+                constexpr int N_interval = 20;
+                std::vector<Eigen::Matrix3d> R(N_interval);
+                for (int k = 0; k < N_interval; ++k) {
+                    R[k] = rotation(t_start + ((t_end - t_start) / (N_interval - 1)) * k);
+                }
+
+                const int N_antenna = static_cast<int>(m_XYZ.rows());
+                Eigen::Vector3d abc_sum = Eigen::Vector3d::Zero();
+                #ifdef _OPENMP
+                #pragma omp parallel
+                #endif
+                {
+                    Eigen::Vector3d abc_local = Eigen::Vector3d::Zero();
+                    Eigen::Matrix<double, N_interval, 3> A;
+                    Eigen::Matrix<double, N_interval, 1> b;
+
+                    #ifdef _OPENMP
+                    #pragma omp for schedule(static)
+                    #endif
+                    for (int i = 0; i < N_antenna; ++i) {
+                        const Eigen::Vector3d itrs_xyz = m_XYZ.row(i).transpose();
+                        for (int k = 0; k < N_interval; ++k) {
+                            const Eigen::Vector3d xyz = R[k] * itrs_xyz;
+                            A.row(k) << xyz[0], xyz[1], 1;
+                            b[k] = xyz[2];
+                        }
+                        abc_local += A.colPivHouseholderQr().solve(b);
+                    }
+
+                    #ifdef _OPENMP
+                    #pragma omp critical
+                    #endif
+                    abc_sum += abc_local;
+                }
+
+                const Eigen::Vector3d abc = abc_sum / N_antenna;
+                const double a = abc[0], b = abc[1];
+                Eigen::Matrix3d bfsf;
+                bfsf.row(2) << a, b, -1;
+                bfsf.row(1) << b, -a, 0;
+                bfsf.row(0) = bfsf.row(2).cross(bfsf.row(1));
+                bfsf.rowwise().normalize();
+                return bfsf;
+            }
+
+            size_t N_antenna() const {
+                return static_cast<size_t>(m_XYZ.rows());
+            }
+
+            size_t N_anchor() const {
+                return m_anchor_time.size();
+            }
+    };
+}}}
+
+#endif //PYPELINE_PHASED_ARRAY_INSTRUMENT_HPP
@@ -0,0 +1,336 @@
+// ############################################################################
+// correlator.hpp
+// ==============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Streaming FX correlator.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_UTIL_DATA_GEN_CORRELATOR_HPP
+#define PYPELINE_PHASED_ARRAY_UTIL_DATA_GEN_CORRELATOR_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+#include "fftw3.h"
+
+#include "pypeline/types.hpp"
+
+namespace pypeline { namespace phased_array { namespace util { namespace data_gen { namespace correlator {
+    /*
+     * Transform real-valued antenna time-series to a stream of visibility matrices.
+     *
+     * Samples are buffered until a block of N_fft time-samples is available.
+     * Each block is then
+     *
+     * 1. windowed and transposed to stream-major order;
+     * 2. Fourier-transformed with a single batched real->complex FFTW plan;
+     * 3. gathered per frequency band into (N_stream, N_bin[b]) matrices X_b and
+     *    correlated as S_b += X_b X_b^{H} (upper triangle only).
+     *
+     * Bins above N_fft / 2 are obtained through Hermitian symmetry of the
+     * spectrum of real signals.
+     * Bands are processed in parallel.
+     *
+     * This object is not thread-safe.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include <vector>
+     *    #include "pypeline/phased_array/util/data_gen/correlator.hpp"
+     *
+     *    namespace correlator = pypeline::phased_array::util::data_gen::correlator;
+     *
+     *    const size_t N_stream = 6, N_fft = 2400;
+     *    std::vector<double> window(N_fft, 1.0);    // rectangular window
+     *    std::vector<int> bin_band(N_fft, -1);      // bins [70, 80) -> band 0
+     *    std::fill(bin_band.begin() + 70, bin_band.begin() + 80, 0);
+     *
+     *    correlator::FXCorrelator<double> fx(N_stream, window, bin_band, 1);
+     *
+     *    std::vector<double> x(N_stream * 10 * N_fft);  // (N_sample, N_stream) samples
+     *    fx.push(x.data(), 10 * N_fft);
+     *    while (fx.N_ready() > 0) {
+     *        auto S = fx.pop();  // (N_band,) x (N_stream, N_stream)
+     *    }
+     */
+    template <typename TT>
+    class FXCorrelator {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            static constexpr bool is_float = std::is_same<TT, float>::value;
+            using cTT = std::complex<TT>;
+            using fftw_plan_t = std::conditional_t<is_float, fftwf_plan, fftw_plan>;
+
+            size_t m_N_stream = 0;
+            size_t m_N_fft = 0;
+            size_t m_N_freq = 0;  // N_fft / 2 + 1
+            std::vector<TT> m_window;
+            std::vector<std::vector<int>> m_band_bins;
+
+            TT *m_block = nullptr;        // (N_stream, N_fft) windowed samples
+            cTT *m_spectrum = nullptr;    // (N_stream, N_freq)
+            fftw_plan_t m_plan = nullptr;
+            size_t m_fill = 0;            // Number of samples in m_block.
+
+            std::deque<std::vector<MatrixXX_t<cTT>>> m_ready;
+
+            void allocate_plan(const unsigned int effort) {
+                const int n = static_cast<int>(m_N_fft);
+                const int N_freq = static_cast<int>(m_N_freq);
+                const int howmany = static_cast<int>(m_N_stream);
+
+                if (is_float) {
+                    m_plan = reinterpret_cast<fftw_plan_t>(
+                        fftwf_plan_many_dft_r2c(1, &n, howmany,
+                                                reinterpret_cast<float*>(m_block), nullptr, 1, n,
+                                                reinterpret_cast<fftwf_complex*>(m_spectrum), nullptr, 1, N_freq,
+                                                effort | FFTW_DESTROY_INPUT));
+                } else {
+                    m_plan = reinterpret_cast<fftw_plan_t>(
+                        fftw_plan_many_dft_r2c(1, &n, howmany,
+                                               reinterpret_cast<double*>(m_block), nullptr, 1, n,
+                                               reinterpret_cast<fftw_complex*>(m_spectrum), nullptr, 1, N_freq,
+                                               effort | FFTW_DESTROY_INPUT));
+                }
+
+                if (m_plan == nullptr) {
+                    std::string msg = "Could not plan real->complex transform.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            void release() {
+                if (m_plan != nullptr) {
+                    if (is_float) {
+                        fftwf_destroy_plan(reinterpret_cast<fftwf_plan>(m_plan));
+                    } else {
+                        fftw_destroy_plan(reinterpret_cast<fftw_plan>(m_plan));
+                    }
+                }
+                fftw_free(m_block);
+                fftw_free(m_spectrum);
+                m_plan = nullptr;
+                m_block = nullptr;
+                m_spectrum = nullptr;
+            }
+
+            void process_block() {
+                if (is_float) {
+                    fftwf_execute(reinterpret_cast<fftwf_plan>(m_plan));
+                } else {
+                    fftw_execute(reinterpret_cast<fftw_plan>(m_plan));
+                }
+
+                const int N_band = static_cast<int>(m_band_bins.size());
+                std::vector<MatrixXX_t<cTT>> S(N_band);
+
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (int b = 0; b < N_band; ++b) {
+                    const std::vector<int> &bins = m_band_bins[b];
+                    const int N_bin = static_cast<int>(bins.size());
+
+                    MatrixXX_t<cTT> X(m_N_stream, N_bin);
+                    for (size_t i = 0; i < m_N_stream; ++i) {
+                        const cTT *spectrum = m_spectrum + i * m_N_freq;
+                        for (int k = 0; k < N_bin; ++k) {
+                            const size_t bin = static_cast<size_t>(bins[k]);
+                            X(i, k) = ((bin < m_N_freq) ?
+                                       spectrum[bin] :
+                                       std::conj(spectrum[m_N_fft - bin]));
+                        }
+                    }
+
+                    MatrixXX_t<cTT> S_b = MatrixXX_t<cTT>::Zero(m_N_stream, m_N_stream);
+                    S_b.template selfadjointView<Eigen::Upper>().rankUpdate(X);
+                    S[b] = S_b.template selfadjointView<Eigen::Upper>();
+                }
+
+                m_ready.push_back(std::move(S));
+                m_fill = 0;
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * N_stream : size_t
+             *     Number of antenna streams.
+             * window : std::vector<TT>
+             *     (N_fft,) window applied to each block prior to the FFT.
+             *     N_fft determines the block length.
+             * bin_band : std::vector<int>
+             *     (N_fft,) band index of every FFT bin, or -1 if the bin is unused.
+             * N_band : size_t
+             *     Number of frequency bands.
+             * effort : unsigned int
+             *     FFTW planning flags.
+             */
+            FXCorrelator(const size_t N_stream,
+                         const std::vector<TT> &window,
+                         const std::vector<int> &bin_band,
+                         const size_t N_band,
+                         const unsigned int effort = FFTW_ESTIMATE):
+                m_N_stream(N_stream), m_N_fft(window.size()),
+                m_N_freq(window.size() / 2 + 1), m_window(window),
+                m_band_bins(N_band) {
+                if (N_stream == 0) {
+                    std::string msg = "Parameter[N_stream] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if (m_N_fft == 0) {
+                    std::string msg = "Parameter[window] cannot be empty.";
+                    throw std::runtime_error(msg);
+                }
+                if (bin_band.size() != m_N_fft) {
+                    std::string msg = "Parameters[window, bin_band] must have the same length.";
+                    throw std::runtime_error(msg);
+                }
+                for (size_t k = 0; k < m_N_fft; ++k) {
+                    const int b = bin_band[k];
+                    if ((b < -1) || (b >= static_cast<int>(N_band))) {
+                        std::string msg = "Parameter[bin_band] must contain values in {-1, ..., N_band - 1}.";
+                        throw std::runtime_error(msg);
+                    }
+                    if (b >= 0) {
+                        m_band_bins[b].push_back(static_cast<int>(k));
+                    }
+                }
+
+                m_block = reinterpret_cast<TT*>(fftw_malloc(sizeof(TT) * m_N_stream * m_N_fft));
+                m_spectrum = reinterpret_cast<cTT*>(fftw_malloc(sizeof(cTT) * m_N_stream * m_N_freq));
+                if ((m_block == nullptr) || (m_spectrum == nullptr)) {
+                    release();
+                    std::string msg = "Could not allocate FFT buffers.";
+                    throw std::runtime_error(msg);
+                }
+
+                try {
+                    allocate_plan(effort);
+                } catch (...) {
+                    release();
+                    throw;
+                }
+            }
+
+            FXCorrelator(const FXCorrelator &) = delete;
+            FXCorrelator& operator=(const FXCorrelator &) = delete;
+
+            ~FXCorrelator() {
+                release();
+            }
+
+            /*
+             * Ingest antenna samples.
+             *
+             * Complete blocks are correlated immediately; a trailing partial block
+             * is kept until the next call.
+             *
+             * Parameters
+             * ----------
+             * x : const TT*
+             *     (N_sample, N_stream) row-major samples.
+             * N_sample : size_t
+             */
+            void push(const TT *x, const size_t N_sample) {
+                size_t n = 0;
+                while (n < N_sample) {
+                    const size_t N_copy = std::min(N_sample - n, m_N_fft - m_fill);
+
+                    // (time, stream) -> (stream, time) + window.
+                    for (size_t i = 0; i < m_N_stream; ++i) {
+                        TT *dst = m_block + i * m_N_fft + m_fill;
+                        const TT *src = x + n * m_N_stream + i;
+                        const TT *w = m_window.data() + m_fill;
+                        for (size_t t = 0; t < N_copy; ++t) {
+                            dst[t] = w[t] * src[t * m_N_stream];
+                        }
+                    }
+
+                    m_fill += N_copy;
+                    n += N_copy;
+                    if (m_fill == m_N_fft) {
+                        process_block();
+                    }
+                }
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Number of visibility sets waiting to be popped.
+             */
+            size_t N_ready() const {
+                return m_ready.size();
+            }
+
+            /*
+             * Returns
+             * -------
+             * S : std::vector<MatrixXX_t<std::complex<TT>>>
+             *     (N_band,) x (N_stream, N_stream) visibility matrices of the oldest block.
+             */
+            std::vector<MatrixXX_t<cTT>> pop() {
+                if (m_ready.empty()) {
+                    std::string msg = "No visibility matrices available.";
+                    throw std::runtime_error(msg);
+                }
+
+                std::vector<MatrixXX_t<cTT>> S = std::move(m_ready.front());
+                m_ready.pop_front();
+                return S;
+            }
+
+            /*
+             * Drop buffered samples and pending visibility matrices.
+             */
+            void reset() {
+                m_fill = 0;
+                m_ready.clear();
+            }
+
+            /*
+             * Returns
+             * -------
+             * N_stream : size_t
+             */
+            size_t N_stream() const {
+                return m_N_stream;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N_fft : size_t
+             *     Block length.
+             */
+            size_t N_fft() const {
+                return m_N_fft;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N_band : size_t
+             */
+            size_t N_band() const {
+                return m_band_bins.size();
+            }
+    };
+}}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_UTIL_DATA_GEN_CORRELATOR_HPP
@@ -0,0 +1,391 @@
+// ############################################################################
+// visibility.hpp
+// ==============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Visibility generation utilities.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_UTIL_DATA_GEN_VISIBILITY_HPP
+#define PYPELINE_PHASED_ARRAY_UTIL_DATA_GEN_VISIBILITY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "eigen3/Eigen/Eigen"
+
+#include "pypeline/types.hpp"
+
+namespace pypeline { namespace phased_array { namespace util { namespace data_gen { namespace visibility {
+    namespace _detail {
+        /*
+         * SplitMix64 finalizer: decorrelates (seed, stream) pairs so that every
+         * stream can own an independent generator.
+         */
+        inline uint64_t mix_seed(const uint64_t seed, const uint64_t stream) {
+            uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (stream + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        /*
+         * a[k] = amp * exp(1j * phase[k]), written as interleaved (re, im) pairs.
+         *
+         * std::{sin, cos} are opaque calls that prevent vectorization without
+         * -ffast-math. Arguments are instead reduced to [-pi/4, pi/4] (3-term
+         * Cody-Waite, exact for |phase| < 2^20 pi/2 and limited by the precision
+         * of `phase` itself beyond) and evaluated with the fdlibm minimax
+         * kernels. The loop body is branch-free so the compiler emits packed
+         * instructions.
+         */
+        template <typename TT>
+        void cis(const TT *phase, std::complex<TT> *a, const size_t N, const TT amp) {
+            constexpr double _2_pi = 6.36619772367581382433e-01;
+            constexpr double pio2_1 = 1.57079632673412561417e+00;
+            constexpr double pio2_2 = 6.07710050630396597660e-11;
+            constexpr double pio2_3 = 2.02226624879595063154e-21;
+            constexpr double round = 6755399441055744.0;  // 1.5 * 2^52
+
+            constexpr double S1 = -1.66666666666666324348e-01, S2 =  8.33333333332248946124e-03,
+                             S3 = -1.98412698298579493134e-04, S4 =  2.75573137070700676789e-06,
+                             S5 = -2.50507602534068634195e-08, S6 =  1.58969099521155010221e-10;
+            constexpr double C1 =  4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                             C3 =  2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                             C5 =  2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+
+            TT *out = reinterpret_cast<TT*>(a);
+
+            #ifdef _OPENMP
+            #pragma omp simd
+            #endif
+            for (size_t k = 0; k < N; ++k) {
+                const double x = phase[k];
+                const double n = (x * _2_pi + round) - round;
+                const int q = static_cast<int>(n);
+                const double r = ((x - n * pio2_1) - n * pio2_2) - n * pio2_3;
+                const double r2 = r * r;
+
+                const double s = r + r * r2 * (S1 + r2 * (S2 + r2 * (S3 + r2 * (S4 + r2 * (S5 + r2 * S6)))));
+                const double c = (1 - 0.5 * r2) + r2 * r2 * (C1 + r2 * (C2 + r2 * (C3 + r2 * (C4 + r2 * (C5 + r2 * C6)))));
+
+                // Quadrant q (mod 4): (cos, sin) = (c, s), (-s, c), (-c, -s), (s, -c)
+                const double cos_x = (q & 1) ? s : c;
+                const double sin_x = (q & 1) ? c : s;
+                out[2 * k]     = amp * static_cast<TT>(((q + 1) & 2) ? -cos_x : cos_x);
+                out[2 * k + 1] = amp * static_cast<TT>((q & 2) ? -sin_x : sin_x);
+            }
+        }
+    }
+
+    /*
+     * Compute noiseless visibility matrix.
+     *
+     * S = W^{H} A^{H} diag(I) A W, with A[k, i] = exp(1j * 2 \pi / wl * <s_k, p_i>).
+     *
+     * Sources are processed in tiles of `N_tile` rows: the (N_src, N_antenna)
+     * steering matrix A is never formed in full.
+     * Each tile is projected onto the beams through the sparse `W` before
+     * being accumulated into (the lower half of) S, in parallel across tiles.
+     *
+     * Parameters
+     * ----------
+     * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+     *     (N_antenna, 3) Cartesian antenna coordinates.
+     * W : SpMatrixXX_t<std::complex<TT>>
+     *     (N_antenna, N_beam) synthesis beamweights.
+     * src_xyz : Eigen::Ref<const MatrixXX_t<TT>>
+     *     (N_src, 3) Cartesian source directions (same frame as `XYZ`).
+     * intensity : Eigen::Ref<const ArrayX_t<TT>>
+     *     (N_src,) non-negative source intensities.
+     * wl : double
+     *     Wave-length [m] at which to generate visibilities.
+     * N_tile : size_t
+     *     Number of sources processed at once.
+     *
+     * Returns
+     * -------
+     * S : MatrixXX_t<std::complex<TT>>
+     *     (N_beam, N_beam) visibility matrix.
+     */
+    template <typename TT>
+    MatrixXX_t<std::complex<TT>> sky_visibility(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                                const SpMatrixXX_t<std::complex<TT>> &W,
+                                                const Eigen::Ref<const MatrixXX_t<TT>> &src_xyz,
+                                                const Eigen::Ref<const ArrayX_t<TT>> &intensity,
+                                                const double wl,
+                                                const size_t N_tile = 256) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+        using cTT = std::complex<TT>;
+
+        if (wl <= 0) {
+            std::string msg = "Parameter[wl] must be positive.";
+            throw std::runtime_error(msg);
+        }
+        if (N_tile == 0) {
+            std::string msg = "Parameter[N_tile] must be positive.";
+            throw std::runtime_error(msg);
+        }
+        if ((XYZ.cols() != 3) || (XYZ.rows() != W.rows())) {
+            std::string msg = "Parameters[XYZ, W] are inconsistent.";
+            throw std::runtime_error(msg);
+        }
+        if ((src_xyz.cols() != 3) || (src_xyz.rows() != intensity.size())) {
+            std::string msg = "Parameters[src_xyz, intensity] are inconsistent.";
+            throw std::runtime_error(msg);
+        }
+        if ((intensity < 0).any()) {
+            std::string msg = "Parameter[intensity] must be non-negative.";
+            throw std::runtime_error(msg);
+        }
+
+        const int N_antenna = static_cast<int>(XYZ.rows());
+        const int N_beam = static_cast<int>(W.cols());
+        const int N_src = static_cast<int>(src_xyz.rows());
+        const int N_block = static_cast<int>((N_src + N_tile - 1) / N_tile);
+
+        /*
+         * A common offset of all antennas multiplies each row of A by a unit
+         * phasor, which cancels in A^{H} diag(I) A: positions are centered (in
+         * double precision) to keep phases small.
+         */
+        MatrixXX_t<TT> P;
+        {
+            MatrixXX_t<double> _P = XYZ.template cast<double>();
+            _P.rowwise() -= _P.colwise().mean();
+            P = (((2 * M_PI) / wl) * _P).template cast<TT>();
+        }
+
+        MatrixXX_t<cTT> S = MatrixXX_t<cTT>::Zero(N_beam, N_beam);
+
+        #ifdef _OPENMP
+        #pragma omp parallel
+        #endif
+        {
+            MatrixXX_t<cTT> S_local = MatrixXX_t<cTT>::Zero(N_beam, N_beam);
+            MatrixXX_t<TT> phase;
+            MatrixXX_t<cTT> A, B;
+
+            #ifdef _OPENMP
+            #pragma omp for schedule(dynamic)
+            #endif
+            for (int b = 0; b < N_block; ++b) {
+                const int start = b * static_cast<int>(N_tile);
+                const int N = std::min(static_cast<int>(N_tile), N_src - start);
+
+                phase.noalias() = src_xyz.middleRows(start, N) * P.transpose();
+                A.resize(N, N_antenna);
+                for (int k = 0; k < N; ++k) {  // sqrt(I) folded into A: S += B^{H} B
+                    _detail::cis<TT>(&phase(k, 0), &A(k, 0), N_antenna,
+                                     std::sqrt(intensity(start + k)));
+                }
+
+                B = A * W;
+                S_local.template selfadjointView<Eigen::Lower>().rankUpdate(B.adjoint());
+            }
+
+            #ifdef _OPENMP
+            #pragma omp critical
+            #endif
+            S += S_local;
+        }
+
+        return S.template selfadjointView<Eigen::Lower>();
+    }
+
+    /*
+     * Draw a sample from the Wishart distribution.
+     *
+     * The sample is obtained with the `Bartlett Decomposition`_
+     * X = (L A) (L A)^{H}, where L L^{H} = V and A is lower-triangular with
+     * A[i, i] ~ sqrt(chi2(n - i)) and A[i, j < i] ~ N(0, 1).
+     * Row i of A is drawn from its own generator seeded by (seed, i): results
+     * do not depend on the number of threads.
+     *
+     * .. _Bartlett Decomposition: https://en.wikipedia.org/wiki/Wishart_distribution#Bartlett_decomposition
+     *
+     * Parameters
+     * ----------
+     * V : MatrixXX_t<std::complex<TT>>
+     *     (p, p) positive-semidefinite Hermitian scale matrix.
+     * n : size_t
+     *     Degrees of freedom. (n > p)
+     * seed : uint64_t
+     *     Random seed.
+     *
+     * Returns
+     * -------
+     * X : MatrixXX_t<std::complex<TT>>
+     *     (p, p) sample.
+     */
+    template <typename TT>
+    MatrixXX_t<std::complex<TT>> wishart(const MatrixXX_t<std::complex<TT>> &V,
+                                         const size_t n,
+                                         const uint64_t seed) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+        using cTT = std::complex<TT>;
+
+        const int p = static_cast<int>(V.rows());
+        if (V.cols() != p) {
+            std::string msg = "Parameter[V] must be square.";
+            throw std::runtime_error(msg);
+        }
+        if (n <= static_cast<size_t>(p)) {
+            std::string msg = "Parameter[n] must be greater than " + std::to_string(p) + ".";
+            throw std::runtime_error(msg);
+        }
+
+        // V may be singular (noiseless data): factor through its eigen-decomposition.
+        Eigen::SelfAdjointEigenSolver<MatrixXX_t<cTT>> eig(V);
+        const Eigen::Matrix<TT, Eigen::Dynamic, 1> D = eig.eigenvalues().cwiseMax(TT(0)).cwiseSqrt();
+        const MatrixXX_t<cTT> L = eig.eigenvectors() * D.template cast<cTT>().asDiagonal();
+
+        MatrixXX_t<cTT> A = MatrixXX_t<cTT>::Zero(p, p);
+
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for (int i = 0; i < p; ++i) {
+            std::mt19937_64 rng(_detail::mix_seed(seed, i));
+            std::chi_squared_distribution<TT> chi2(static_cast<TT>(n - i));
+            std::normal_distribution<TT> normal(0, 1);
+
+            A(i, i) = std::sqrt(chi2(rng));
+            for (int j = 0; j < i; ++j) {
+                A(i, j) = normal(rng);
+            }
+        }
+
+        const MatrixXX_t<cTT> LA = L * A.template triangularView<Eigen::Lower>();
+        MatrixXX_t<cTT> X = MatrixXX_t<cTT>::Zero(p, p);
+        X.template selfadjointView<Eigen::Lower>().rankUpdate(LA);
+        return X.template selfadjointView<Eigen::Lower>();
+    }
+
+    /*
+     * Generate synthetic visibility matrices.
+     *
+     * Visibilities are drawn from W(S_sky + S_noise, N_sample) / N_sample, where
+     * S_noise = sum(I) / (2 SNR) * W^{H} W.
+     *
+     * Successive calls draw from distinct random streams derived from `seed`,
+     * hence a run is fully reproducible from its seed.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/util/data_gen/visibility.hpp"
+     *
+     *    namespace vis = pypeline::phased_array::util::data_gen::visibility;
+     *
+     *    MatrixXX_t<double> src_xyz(1, 3);  src_xyz << 0, 0, 1;
+     *    ArrayX_t<double> intensity(1);     intensity << 1;
+     *    vis::VisibilityGeneratorBlock<double> S_gen(src_xyz, intensity,
+     *                                                1568001,  // N_sample
+     *                                                1e3,      // SNR (linear)
+     *                                                0);       // seed
+     *
+     *    MatrixXX_t<double> XYZ = MatrixXX_t<double>::Random(10, 3);
+     *    SpMatrixXX_t<cdouble_t> W = MatrixXX_t<cdouble_t>::Identity(10, 10).sparseView();
+     *    auto S = S_gen(XYZ, W, 2.0);  // (10, 10)
+     */
+    template <typename TT>
+    class VisibilityGeneratorBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            MatrixXX_t<TT> m_src_xyz;
+            ArrayX_t<TT> m_intensity;
+            size_t m_N_sample = 0;
+            double m_SNR = 0;
+            uint64_t m_seed = 0;
+            uint64_t m_epoch = 0;
+            size_t m_N_tile = 0;
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * src_xyz : Eigen::Ref<const MatrixXX_t<TT>>
+             *     (N_src, 3) Cartesian ICRS source directions.
+             * intensity : Eigen::Ref<const ArrayX_t<TT>>
+             *     (N_src,) non-negative source intensities.
+             * N_sample : size_t
+             *     Number of time-samples integrated per visibility matrix.
+             * SNR : double
+             *     Signal-to-Noise-Ratio (linear scale). Can be infinite.
+             * seed : uint64_t
+             *     Random seed.
+             * N_tile : size_t
+             *     Number of sources processed at once.
+             */
+            VisibilityGeneratorBlock(const Eigen::Ref<const MatrixXX_t<TT>> &src_xyz,
+                                     const Eigen::Ref<const ArrayX_t<TT>> &intensity,
+                                     const size_t N_sample,
+                                     const double SNR,
+                                     const uint64_t seed,
+                                     const size_t N_tile = 256):
+                m_src_xyz(src_xyz), m_intensity(intensity),
+                m_N_sample(N_sample), m_SNR(SNR), m_seed(seed), m_N_tile(N_tile) {
+                if ((src_xyz.cols() != 3) || (src_xyz.rows() != intensity.size())) {
+                    std::string msg = "Parameters[src_xyz, intensity] are inconsistent.";
+                    throw std::runtime_error(msg);
+                }
+                if (N_sample == 0) {
+                    std::string msg = "Parameter[N_sample] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if (!(SNR > 0)) {
+                    std::string msg = "Parameter[SNR] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+             *     (N_antenna, 3) ICRS instrument geometry.
+             * W : SpMatrixXX_t<std::complex<TT>>
+             *     (N_antenna, N_beam) synthesis beamweights.
+             * wl : double
+             *     Wave-length [m] at which to generate visibilities.
+             *
+             * Returns
+             * -------
+             * S : MatrixXX_t<std::complex<TT>>
+             *     (N_beam, N_beam) visibility matrix.
+             */
+            MatrixXX_t<cTT> operator()(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                       const SpMatrixXX_t<cTT> &W,
+                                       const double wl) {
+                MatrixXX_t<cTT> V = sky_visibility<TT>(XYZ, W, m_src_xyz, m_intensity,
+                                                       wl, m_N_tile);
+
+                if (std::isfinite(m_SNR)) {
+                    const TT noise_var = static_cast<TT>(m_intensity.sum() / (2 * m_SNR));
+                    const SpMatrixXX_t<cTT> WhW = W.adjoint() * W;
+                    V += noise_var * MatrixXX_t<cTT>(WhW);
+                }
+
+                const uint64_t seed = _detail::mix_seed(m_seed, m_epoch++);
+                MatrixXX_t<cTT> S = wishart<TT>(V, m_N_sample, seed);
+                S /= static_cast<TT>(m_N_sample);
+                return S;
+            }
+    };
+}}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_UTIL_DATA_GEN_VISIBILITY_HPP
@@ -0,0 +1,392 @@
+// ############################################################################
+// gram.hpp
+// ========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Gram-related operations and tools.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_UTIL_GRAM_HPP
+#define PYPELINE_PHASED_ARRAY_UTIL_GRAM_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+
+#include "pypeline/types.hpp"
+
+namespace pypeline { namespace phased_array { namespace util { namespace gram {
+    namespace _detail {
+        using geometry_t = Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>;
+
+        /*
+         * Beamforming weights in packed column-major form.
+         *
+         * Only non-zero (antenna, beam) pairs are stored: beam `s` owns entries
+         * [offset[s], offset[s + 1]) of `antenna`/`weight`.
+         */
+        template <typename TT>
+        struct packed_weights {
+            size_t N_antenna = 0;
+            std::vector<int> offset;
+            std::vector<int> antenna;
+            std::vector<std::complex<TT>> weight;
+
+            bool operator==(const packed_weights<TT> &other) const {
+                return ((N_antenna == other.N_antenna) &&
+                        (offset == other.offset) &&
+                        (antenna == other.antenna) &&
+                        (weight == other.weight));
+            }
+        };
+
+        template <typename TT>
+        packed_weights<TT> pack(const SpMatrixXX_t<std::complex<TT>> &W) {
+            packed_weights<TT> P;
+            P.N_antenna = static_cast<size_t>(W.rows());
+            P.offset.reserve(W.cols() + 1);
+            P.antenna.reserve(W.nonZeros());
+            P.weight.reserve(W.nonZeros());
+
+            P.offset.push_back(0);
+            for (int s = 0; s < W.outerSize(); ++s) {
+                for (typename SpMatrixXX_t<std::complex<TT>>::InnerIterator it(W, s); it; ++it) {
+                    if (it.value() != std::complex<TT>(0, 0)) {
+                        P.antenna.push_back(it.row());
+                        P.weight.push_back(it.value());
+                    }
+                }
+                P.offset.push_back(static_cast<int>(P.antenna.size()));
+            }
+            return P;
+        }
+
+        /*
+         * Antenna positions relative to their centroid.
+         *
+         * Computed in double precision: raw ICRS/ITRS coordinates are O(1e6) [m]
+         * and would otherwise lose all sub-wavelength resolution in single precision.
+         */
+        template <typename TT>
+        geometry_t center(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ) {
+            geometry_t P = XYZ.template cast<double>();
+            P.rowwise() -= P.colwise().mean();
+            return P;
+        }
+
+        inline void fnv1a(uint64_t &h, const void *data, const size_t N_byte) {
+            const unsigned char *ptr = reinterpret_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < N_byte; ++i) {
+                h ^= ptr[i];
+                h *= 1099511628211ULL;
+            }
+        }
+
+        template <typename TT>
+        uint64_t hash(const packed_weights<TT> &P, const double wl) {
+            uint64_t h = 14695981039346656037ULL;
+            fnv1a(h, &P.N_antenna, sizeof(P.N_antenna));
+            fnv1a(h, &wl, sizeof(wl));
+            fnv1a(h, P.offset.data(), P.offset.size() * sizeof(int));
+            fnv1a(h, P.antenna.data(), P.antenna.size() * sizeof(int));
+            fnv1a(h, P.weight.data(), P.weight.size() * sizeof(std::complex<TT>));
+            return h;
+        }
+
+        /*
+         * Largest antenna displacement [m] left after optimally aligning `P` onto
+         * `Q` with an orthogonal transform (Kabsch).
+         *
+         * Both point sets must be centered and describe the same antennas in the
+         * same order.
+         */
+        inline double alignment_residual(const geometry_t &P, const geometry_t &Q) {
+            const Eigen::Matrix3d H = Q.transpose() * P;
+            Eigen::JacobiSVD<Eigen::Matrix3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+            const Eigen::Matrix3d R = svd.matrixV() * svd.matrixU().transpose();
+
+            // Reflections preserve baseline lengths too: no det(R) correction needed.
+            const geometry_t QR = Q * R.transpose();
+            return std::sqrt((P - QR).rowwise().squaredNorm().maxCoeff());
+        }
+
+        template <typename TT>
+        MatrixXX_t<std::complex<TT>> gram(const geometry_t &P,
+                                          const packed_weights<TT> &W,
+                                          const double wl) {
+            using cTT = std::complex<TT>;
+            const int N_beam = static_cast<int>(W.offset.size()) - 1;
+            const size_t N_nz = W.antenna.size();
+
+            // Gather positions/weights per beam so the inner loop is unit-stride.
+            // Positions are pre-scaled by 2pi/wl: the sinc argument is then a plain norm.
+            const double scale = (2 * M_PI) / wl;
+            std::vector<TT> x(N_nz), y(N_nz), z(N_nz), w_re(N_nz), w_im(N_nz);
+            for (size_t k = 0; k < N_nz; ++k) {
+                const int i = W.antenna[k];
+                x[k] = static_cast<TT>(scale * P(i, 0));
+                y[k] = static_cast<TT>(scale * P(i, 1));
+                z[k] = static_cast<TT>(scale * P(i, 2));
+                w_re[k] = W.weight[k].real();
+                w_im[k] = W.weight[k].imag();
+            }
+
+            const TT eps = std::numeric_limits<TT>::epsilon();
+            const TT _4pi = static_cast<TT>(4 * M_PI);
+            MatrixXX_t<cTT> G(N_beam, N_beam);
+
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(dynamic)
+            #endif
+            for (int s = 0; s < N_beam; ++s) {
+                for (int t = s; t < N_beam; ++t) {
+                    TT acc_re = 0, acc_im = 0;
+                    for (int i = W.offset[s]; i < W.offset[s + 1]; ++i) {
+                        const TT xi = x[i], yi = y[i], zi = z[i];
+                        TT re = 0, im = 0;
+
+                        #ifdef _OPENMP
+                        #pragma omp simd reduction(+:re, im)
+                        #endif
+                        for (int j = W.offset[t]; j < W.offset[t + 1]; ++j) {
+                            const TT dx = xi - x[j];
+                            const TT dy = yi - y[j];
+                            const TT dz = zi - z[j];
+                            const TT r = std::sqrt(dx * dx + dy * dy + dz * dz);
+                            const TT k = (r > eps) ? (std::sin(r) / r) : static_cast<TT>(1);
+                            re += w_re[j] * k;
+                            im += w_im[j] * k;
+                        }
+
+                        // conj(W_is) * (re + 1j * im)
+                        acc_re += w_re[i] * re + w_im[i] * im;
+                        acc_im += w_re[i] * im - w_im[i] * re;
+                    }
+
+                    if (s == t) {
+                        G(s, s) = cTT(_4pi * acc_re, 0);
+                    } else {
+                        G(s, t) = cTT(_4pi * acc_re, _4pi * acc_im);
+                        G(t, s) = std::conj(G(s, t));
+                    }
+                }
+            }
+            return G;
+        }
+
+        template <typename TT>
+        void validate(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                      const SpMatrixXX_t<std::complex<TT>> &W,
+                      const double wl) {
+            if (wl <= 0) {
+                std::string msg = "Parameter[wl] must be positive.";
+                throw std::runtime_error(msg);
+            }
+            if (XYZ.cols() != 3) {
+                std::string msg = "Parameter[XYZ] must have shape (N_antenna, 3).";
+                throw std::runtime_error(msg);
+            }
+            if (XYZ.rows() != W.rows()) {
+                std::string msg = "Parameters[XYZ, W] are inconsistent.";
+                throw std::runtime_error(msg);
+            }
+        }
+    }
+
+    /*
+     * Compute Gram matrix.
+     *
+     * G = W^{H} G_{1} W, with G_{1}[i, j] = 4 \pi sinc(2 \norm{p_{i} - p_{j}} / wl).
+     *
+     * Only the non-zero entries of `W` are visited and G_{1} is never formed:
+     * each of the N_beam * (N_beam + 1) / 2 upper-triangular coefficients is a
+     * sum over the antenna pairs that contribute to it.
+     * For block-diagonal beamformers (one beam per station) this reduces memory
+     * from O(N_antenna^2) to O(N_antenna + N_beam^2).
+     *
+     * Parameters
+     * ----------
+     * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+     *     (N_antenna, 3) Cartesian antenna coordinates in any reference frame.
+     * W : SpMatrixXX_t<std::complex<TT>>
+     *     (N_antenna, N_beam) synthesis beamweights.
+     * wl : double
+     *     Wave-length [m] at which to compute the Gram.
+     *
+     * Returns
+     * -------
+     * G : MatrixXX_t<std::complex<TT>>
+     *     (N_beam, N_beam) Gram matrix.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/util/gram.hpp"
+     *
+     *    namespace gram = pypeline::phased_array::util::gram;
+     *
+     *    MatrixXX_t<double> XYZ = MatrixXX_t<double>::Random(100, 3);
+     *    SpMatrixXX_t<cdouble_t> W = MatrixXX_t<cdouble_t>::Identity(100, 100).sparseView();
+     *
+     *    auto G = gram::gram<double>(XYZ, W, 2.0);  // (100, 100)
+     */
+    template <typename TT>
+    MatrixXX_t<std::complex<TT>> gram(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                      const SpMatrixXX_t<std::complex<TT>> &W,
+                                      const double wl) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+        _detail::validate<TT>(XYZ, W, wl);
+
+        return _detail::gram<TT>(_detail::center<TT>(XYZ), _detail::pack<TT>(W), wl);
+    }
+
+    /*
+     * Compute Gram matrices, re-using previous results when possible.
+     *
+     * G only depends on antenna positions through baseline lengths, which
+     * are invariant to rotations of the array: the Earth-rotated geometries
+     * produced by EarthBoundInstrumentGeometryBlock at successive epochs share
+     * the same Gram matrix provided the beamweights are identical.
+     *
+     * The last `N_entry` (geometry, W, wl) triplets are kept.
+     * A cached result is re-used if `W` and `wl` match exactly and the query
+     * geometry can be rigidly aligned onto the cached one to within
+     * `tol * wl` [m] per antenna.
+     *
+     * Beamweights that track a fixed sky direction (e.g. matched beamforming
+     * in ICRS) change with every epoch and therefore never hit the cache; the
+     * sparse kernel is still used in that case.
+     *
+     * This object is not thread-safe.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/phased_array/util/gram.hpp"
+     *
+     *    namespace gram = pypeline::phased_array::util::gram;
+     *
+     *    MatrixXX_t<double> XYZ = MatrixXX_t<double>::Random(100, 3);
+     *    SpMatrixXX_t<cdouble_t> W = MatrixXX_t<cdouble_t>::Identity(100, 100).sparseView();
+     *
+     *    gram::GramBlock<double> gr(4);
+     *    auto G1 = gr(XYZ, W, 2.0);  // computed
+     *
+     *    Eigen::Matrix3d R = Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+     *    MatrixXX_t<double> XYZ_rot = XYZ * R.transpose();
+     *    auto G2 = gr(XYZ_rot, W, 2.0);  // fetched from cache
+     */
+    template <typename TT>
+    class GramBlock {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            struct entry {
+                uint64_t key;
+                double wl;
+                _detail::geometry_t XYZ;
+                _detail::packed_weights<TT> W;
+                MatrixXX_t<cTT> G;
+            };
+
+            size_t m_N_entry = 0;
+            double m_tol = 0;
+            std::list<entry> m_cache;  // Most-recently used first.
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * N_entry : size_t
+             *     Number of Gram matrices to keep. (0 disables caching.)
+             * tol : double
+             *     Largest antenna displacement [wl] tolerated between geometries
+             *     considered identical.
+             */
+            GramBlock(const size_t N_entry = 16, const double tol = 1e-6):
+                m_N_entry(N_entry), m_tol(tol) {
+                if (tol < 0) {
+                    std::string msg = "Parameter[tol] must be non-negative.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * XYZ : Eigen::Ref<const MatrixXX_t<TT>>
+             *     (N_antenna, 3) Cartesian antenna coordinates in any reference frame.
+             * W : SpMatrixXX_t<std::complex<TT>>
+             *     (N_antenna, N_beam) synthesis beamweights.
+             * wl : double
+             *     Wave-length [m] at which to compute the Gram.
+             *
+             * Returns
+             * -------
+             * G : MatrixXX_t<std::complex<TT>>
+             *     (N_beam, N_beam) Gram matrix.
+             */
+            MatrixXX_t<cTT> operator()(const Eigen::Ref<const MatrixXX_t<TT>> &XYZ,
+                                       const SpMatrixXX_t<cTT> &W,
+                                       const double wl) {
+                _detail::validate<TT>(XYZ, W, wl);
+
+                _detail::geometry_t P = _detail::center<TT>(XYZ);
+                _detail::packed_weights<TT> PW = _detail::pack<TT>(W);
+                const uint64_t key = _detail::hash<TT>(PW, wl);
+
+                for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+                    if ((it->key == key) && (it->wl == wl) && (it->W == PW) &&
+                        (_detail::alignment_residual(P, it->XYZ) <= m_tol * wl)) {
+                        m_cache.splice(m_cache.begin(), m_cache, it);
+                        return m_cache.front().G;
+                    }
+                }
+
+                MatrixXX_t<cTT> G = _detail::gram<TT>(P, PW, wl);
+                if (m_N_entry > 0) {
+                    if (m_cache.size() == m_N_entry) {
+                        m_cache.pop_back();
+                    }
+                    m_cache.push_front(entry {key, wl, std::move(P), std::move(PW), G});
+                }
+                return G;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Number of cached Gram matrices.
+             */
+            size_t size() const {
+                return m_cache.size();
+            }
+
+            /*
+             * Drop all cached Gram matrices.
+             */
+            void clear() {
+                m_cache.clear();
+            }
+    };
+}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_UTIL_GRAM_HPP
@@ -0,0 +1,686 @@
+// ############################################################################
+// archive.hpp
+// ===========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Append-only, chunked archives of spherical image cubes.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_UTIL_IO_ARCHIVE_HPP
+#define PYPELINE_PHASED_ARRAY_UTIL_IO_ARCHIVE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "xtensor/xadapt.hpp"
+
+#include "pypeline/phased_array/util/io/image.hpp"
+#include "pypeline/util/argcheck.hpp"
+#include "pypeline/util/mmap.hpp"
+
+namespace pypeline { namespace phased_array { namespace util { namespace io { namespace archive {
+    enum class codec: uint32_t {
+        NONE,         // Raw native-endian samples.
+        SHUFFLE_RLE   // Byte-shuffle followed by run-length encoding. (Lossless)
+    };
+
+    /*
+     * Byte-shuffle + PackBits-style run-length coding.
+     *
+     * Shuffling groups the k-th byte of every sample together: exponent bytes
+     * of smooth or sparse images form long runs which RLE then collapses.
+     *
+     * RLE control byte `c`:
+     * * c < 128: copy the next (c + 1) bytes verbatim;
+     * * c >= 128: repeat the next byte (c - 125) times.
+     */
+    namespace rle {
+        inline void shuffle(const char *in, char *out, const size_t N, const size_t itemsize) {
+            for (size_t b = 0; b < itemsize; ++b) {
+                for (size_t i = 0; i < N; ++i) {
+                    out[b * N + i] = in[i * itemsize + b];
+                }
+            }
+        }
+
+        inline void unshuffle(const char *in, char *out, const size_t N, const size_t itemsize) {
+            for (size_t b = 0; b < itemsize; ++b) {
+                for (size_t i = 0; i < N; ++i) {
+                    out[i * itemsize + b] = in[b * N + i];
+                }
+            }
+        }
+
+        inline std::vector<char> encode(const char *in, const size_t N_bytes) {
+            std::vector<char> out;
+            out.reserve(N_bytes / 2);
+
+            size_t i = 0;
+            while (i < N_bytes) {
+                size_t run = 1;
+                while ((i + run < N_bytes) && (run < 130) && (in[i + run] == in[i])) {
+                    ++run;
+                }
+
+                if (run >= 3) {
+                    out.push_back(static_cast<char>(run + 125));
+                    out.push_back(in[i]);
+                    i += run;
+                } else {  // literal block: stop before next run of 3.
+                    size_t N_lit = 0;
+                    while ((i + N_lit < N_bytes) && (N_lit < 128)) {
+                        if ((i + N_lit + 2 < N_bytes) &&
+                            (in[i + N_lit] == in[i + N_lit + 1]) &&
+                            (in[i + N_lit] == in[i + N_lit + 2])) {
+                            break;
+                        }
+                        ++N_lit;
+                    }
+                    out.push_back(static_cast<char>(N_lit - 1));
+                    out.insert(out.end(), in + i, in + i + N_lit);
+                    i += N_lit;
+                }
+            }
+            return out;
+        }
+
+        inline void decode(const char *in, const size_t N_in, char *out, const size_t N_out) {
+            size_t i = 0, j = 0;
+            while (i < N_in) {
+                const unsigned int c = static_cast<unsigned char>(in[i++]);
+                if (c < 128) {
+                    const size_t N = c + 1;
+                    if ((i + N > N_in) || (j + N > N_out)) { break; }
+                    std::memcpy(out + j, in + i, N);
+                    i += N;
+                    j += N;
+                } else {
+                    const size_t N = c - 125;
+                    if ((i >= N_in) || (j + N > N_out)) { break; }
+                    std::memset(out + j, in[i++], N);
+                    j += N;
+                }
+            }
+
+            if ((i != N_in) || (j != N_out)) {
+                std::string msg = "Corrupt RLE stream.";
+                throw std::runtime_error(msg);
+            }
+        }
+    }
+
+    /*
+     * Returns
+     * -------
+     * itemsize : size_t
+     *     Size [bytes] of samples stored in archive `path`.
+     */
+    inline size_t itemsize(const std::string &path);
+
+    /*
+     * Append-only archive of (N_level, ...) image planes defined on a common grid.
+     *
+     * Planes typically index time intervals or frequency channels.
+     * Each plane is split into (level, band) tiles, where bands are groups of
+     * `band_size` consecutive grid rows (colatitudes) for (3, N_height, N_width)
+     * grids, or `band_size` consecutive points for (3, N_point) grids.
+     * Tiles are stored as independent chunks with their own header and can be
+     * compressed losslessly.
+     *
+     * File layout (native byte order)
+     * -------------------------------
+     * [file header | grid | chunk header | payload | chunk header | payload | ...]
+     *
+     * The file is memory-mapped for reading: tiles are decoded directly from
+     * the page cache without reading whole planes.
+     * Appending a plane only writes at the end of the file. If a write is
+     * interrupted, the incomplete plane is ignored when reopening the archive
+     * and overwritten by the next append.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/phased_array/util/io/archive.hpp"
+     *    #include "pypeline/phased_array/util/io/image.hpp"
+     *
+     *    namespace archive = pypeline::phased_array::util::io::archive;
+     *    namespace image = pypeline::phased_array::util::io::image;
+     *
+     *    auto A = archive::SphericalImageArchive<float>::create("/tmp/cube.pia", grid, N_level);
+     *    for (...) {
+     *        image::SphericalImageContainer<float> I = ...;  // (N_level, N_height, N_width)
+     *        A.append(I, time);
+     *    }
+     *
+     *    archive::SphericalImageArchive<float> B("/tmp/cube.pia");
+     *    std::vector<float> tile(B.tile_size(0));
+     *    B.read_tile(3, 0, 0, tile.data());  // (plane=3, level=0, band=0)
+     *    auto J = B.read_plane(3);            // (N_level, N_height, N_width) container.
+     */
+    template <typename T>
+    class SphericalImageArchive {
+        private:
+            struct file_header {
+                char magic[8];
+                uint32_t version;
+                uint32_t itemsize;
+                uint64_t rank_grid;
+                uint64_t shape_grid[3];
+                uint64_t N_level;
+                uint64_t band_size;
+                uint32_t codec;
+                uint32_t reserved;
+                uint64_t offset_grid;
+                uint64_t offset_chunks;
+            };
+
+            struct chunk_header {
+                char magic[4];
+                uint32_t codec;
+                uint64_t plane;
+                uint32_t level;
+                uint32_t band;
+                double tag;
+                uint64_t raw_size;
+                uint64_t stored_size;
+            };
+
+            static constexpr char file_magic[8] = {'P', 'Y', 'P', 'L', 'A', 'R', 'C', '\0'};
+            static constexpr char chunk_magic[4] = {'C', 'H', 'N', 'K'};
+            static constexpr uint32_t file_version = 1;
+
+            std::string m_path {};
+            file_header m_header {};
+            std::shared_ptr<pypeline::util::mmap::MappedFile> m_file;
+            std::vector<size_t> m_chunks {};  // offset of chunk headers, indexed by (plane, level, band).
+            std::vector<double> m_tags {};
+            size_t m_end = 0;                 // end of last complete plane.
+
+            size_t N_row() const {
+                return m_header.shape_grid[1];
+            }
+
+            size_t N_col() const {
+                return ((m_header.rank_grid == 3) ? m_header.shape_grid[2] : 1);
+            }
+
+            size_t chunk_index(const size_t plane, const size_t level, const size_t band) const {
+                return (plane * N_level() + level) * N_band() + band;
+            }
+
+            void check_index(const size_t plane, const size_t level, const size_t band) const {
+                if (plane >= N_plane()) {
+                    std::string msg = "Parameter[plane] must lie in {0, ..., " + std::to_string(N_plane()) + " - 1}.";
+                    throw std::runtime_error(msg);
+                }
+                if (level >= N_level()) {
+                    std::string msg = "Parameter[level] must lie in {0, ..., " + std::to_string(N_level()) + " - 1}.";
+                    throw std::runtime_error(msg);
+                }
+                if (band >= N_band()) {
+                    std::string msg = "Parameter[band] must lie in {0, ..., " + std::to_string(N_band()) + " - 1}.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * (Re-)map file and validate its header.
+             */
+            void map() {
+                namespace mmap = pypeline::util::mmap;
+                m_file = std::make_shared<mmap::MappedFile>(m_path, mmap::access_mode::READ_ONLY);
+                const char *base = reinterpret_cast<const char*>(m_file->data());
+                const size_t file_size = m_file->size();
+
+                std::string msg = "File '" + m_path + "' is not a SphericalImageArchive.";
+                if (file_size < sizeof(file_header)) {
+                    throw std::runtime_error(msg);
+                }
+                std::memcpy(&m_header, base, sizeof(file_header));
+                if (!std::equal(file_magic, file_magic + 8, m_header.magic) ||
+                    (m_header.version != file_version) ||
+                    (m_header.rank_grid < 2) || (m_header.rank_grid > 3) ||
+                    (m_header.band_size == 0) || (m_header.N_level == 0)) {
+                    throw std::runtime_error(msg);
+                }
+                if (m_header.itemsize != sizeof(T)) {
+                    msg = ("File '" + m_path + "' stores " + std::to_string(8 * m_header.itemsize) +
+                           "-bit floats, but Type[T] is " + std::to_string(8 * sizeof(T)) + "-bit.");
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * (Re-)map file and rebuild the chunk index.
+             * Only complete planes are indexed.
+             */
+            void load() {
+                map();
+                const char *base = reinterpret_cast<const char*>(m_file->data());
+                const size_t file_size = m_file->size();
+
+                m_chunks.clear();
+                m_tags.clear();
+                m_end = m_header.offset_chunks;
+                const size_t N_chunk_plane = N_level() * N_band();
+
+                std::vector<size_t> plane_chunks;
+                size_t offset = m_header.offset_chunks;
+                while (offset + sizeof(chunk_header) <= file_size) {
+                    chunk_header ch;
+                    std::memcpy(&ch, base + offset, sizeof(chunk_header));
+                    const size_t expected = plane_chunks.size();
+                    if (!std::equal(chunk_magic, chunk_magic + 4, ch.magic) ||
+                        (ch.plane != m_tags.size()) ||
+                        (ch.level * N_band() + ch.band != expected) ||
+                        (offset + sizeof(chunk_header) + ch.stored_size > file_size)) {
+                        break;  // torn write: drop incomplete plane.
+                    }
+
+                    plane_chunks.push_back(offset);
+                    offset += sizeof(chunk_header) + ch.stored_size;
+                    if (plane_chunks.size() == N_chunk_plane) {
+                        m_chunks.insert(m_chunks.end(), plane_chunks.begin(), plane_chunks.end());
+                        m_tags.push_back(ch.tag);
+                        plane_chunks.clear();
+                        m_end = offset;
+                    }
+                }
+            }
+
+            SphericalImageArchive() = default;
+
+        public:
+            /*
+             * Open existing archive.
+             *
+             * Parameters
+             * ----------
+             * path : std::string
+             */
+            explicit SphericalImageArchive(const std::string &path): m_path(path) {
+                static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+                load();
+            }
+
+            /*
+             * Create empty archive.
+             *
+             * Parameters
+             * ----------
+             * path : std::string
+             *     File to create. Existing files are overwritten.
+             * grid : xt::xexpression
+             *     (3, N_height, N_width) or (3, N_point) Cartesian coordinates of the sky.
+             * N_level : size_t
+             *     Number of images per plane.
+             * band_size : size_t
+             *     Number of grid rows (or points) per tile.
+             * compress : bool
+             *     If true, tiles are compressed losslessly when it reduces their size.
+             *
+             * Returns
+             * -------
+             * A : SphericalImageArchive<T>
+             */
+            template <typename E>
+            static SphericalImageArchive<T> create(const std::string &path,
+                                                   E &&grid,
+                                                   const size_t N_level,
+                                                   const size_t band_size = 64,
+                                                   const bool compress = true) {
+                static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+
+                namespace argcheck = pypeline::util::argcheck;
+                namespace mmap = pypeline::util::mmap;
+                if (!argcheck::has_floats(grid)) {
+                    std::string msg = "Parameter[grid] must be real-valued.";
+                    throw std::runtime_error(msg);
+                }
+                if (!(((grid.dimension() == 2) || (grid.dimension() == 3)) &&
+                      (grid.shape()[0] == 3))) {
+                    std::string msg = "Parameter[grid] must have shape (3, N_height, N_width) or (3, N_point).";
+                    throw std::runtime_error(msg);
+                }
+                if (N_level == 0) {
+                    std::string msg = "Parameter[N_level] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if (band_size == 0) {
+                    std::string msg = "Parameter[band_size] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+
+                file_header header {};
+                std::copy(file_magic, file_magic + 8, header.magic);
+                header.version = file_version;
+                header.itemsize = sizeof(T);
+                header.rank_grid = grid.dimension();
+                std::copy(grid.shape().begin(), grid.shape().end(), header.shape_grid);
+                header.N_level = N_level;
+                header.band_size = band_size;
+                header.codec = static_cast<uint32_t>(compress ? codec::SHUFFLE_RLE : codec::NONE);
+                header.offset_grid = mmap::align_up(sizeof(file_header), 64);
+
+                std::vector<size_t> shape_grid(grid.shape().begin(), grid.shape().end());
+                std::vector<T> grid_buffer(grid.size());
+                auto grid_view = xt::adapt(grid_buffer.data(), grid_buffer.size(), xt::no_ownership(), shape_grid);
+                grid_view = grid;
+                header.offset_chunks = mmap::align_up(header.offset_grid + grid_buffer.size() * sizeof(T), 64);
+
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file) {
+                    std::string msg = "Could not open file '" + path + "' for writing.";
+                    throw std::runtime_error(msg);
+                }
+                const std::vector<char> zeros(64, '\0');
+                file.write(reinterpret_cast<const char*>(&header), sizeof(file_header));
+                file.write(zeros.data(), header.offset_grid - sizeof(file_header));
+                file.write(reinterpret_cast<const char*>(grid_buffer.data()), grid_buffer.size() * sizeof(T));
+                file.write(zeros.data(), header.offset_chunks - (header.offset_grid + grid_buffer.size() * sizeof(T)));
+                file.close();
+                if (!file) {
+                    std::string msg = "Could not write to file '" + path + "'.";
+                    throw std::runtime_error(msg);
+                }
+
+                return SphericalImageArchive<T>(path);
+            }
+
+            size_t N_plane() const {
+                return m_tags.size();
+            }
+
+            size_t N_level() const {
+                return m_header.N_level;
+            }
+
+            size_t N_band() const {
+                return (N_row() + m_header.band_size - 1) / m_header.band_size;
+            }
+
+            size_t band_size() const {
+                return m_header.band_size;
+            }
+
+            bool is_gridded() const {
+                return m_header.rank_grid == 3;
+            }
+
+            const std::string& path() const {
+                return m_path;
+            }
+
+            /*
+             * Returns
+             * -------
+             * tags : std::vector<double>
+             *     User-provided label (ex: time, frequency) of each plane.
+             */
+            const std::vector<double>& tags() const {
+                return m_tags;
+            }
+
+            /*
+             * Returns
+             * -------
+             * shape : std::vector<size_t>
+             *     Shape of tiles in band `band`: (N_row_band, N_width) or (N_point_band,).
+             */
+            std::vector<size_t> tile_shape(const size_t band) const {
+                const size_t start = band * m_header.band_size;
+                const size_t N = std::min<size_t>(m_header.band_size, N_row() - std::min(start, N_row()));
+                if (is_gridded()) {
+                    return {N, N_col()};
+                } else {
+                    return {N};
+                }
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Number of samples in tiles of band `band`.
+             */
+            size_t tile_size(const size_t band) const {
+                size_t N = 1;
+                for (const size_t &s : tile_shape(band)) { N *= s; }
+                return N;
+            }
+
+            /*
+             * Returns
+             * -------
+             * grid : const T*
+             *     Row-major (3, ...) grid, referencing the mapped file.
+             *     Only valid while :cpp:func:`mapping` is alive.
+             */
+            const T* grid_data() const {
+                return reinterpret_cast<const T*>(reinterpret_cast<const char*>(m_file->data()) +
+                                                  m_header.offset_grid);
+            }
+
+            std::vector<size_t> grid_shape() const {
+                return std::vector<size_t>(m_header.shape_grid, m_header.shape_grid + m_header.rank_grid);
+            }
+
+            /*
+             * Returns
+             * -------
+             * mapping : std::shared_ptr<void>
+             *     Handle keeping the current file mapping (hence :cpp:func:`grid_data`) alive.
+             */
+            std::shared_ptr<void> mapping() const {
+                return m_file;
+            }
+
+            /*
+             * Decode one tile.
+             *
+             * Parameters
+             * ----------
+             * plane : size_t
+             * level : size_t
+             * band : size_t
+             * out : T*
+             *     Buffer of at least tile_size(band) elements.
+             *
+             * Notes
+             * -----
+             * Thread-safe: tiles can be decoded concurrently.
+             */
+            void read_tile(const size_t plane, const size_t level, const size_t band, T *out) const {
+                check_index(plane, level, band);
+
+                const char *base = reinterpret_cast<const char*>(m_file->data());
+                const size_t offset = m_chunks[chunk_index(plane, level, band)];
+                chunk_header ch;
+                std::memcpy(&ch, base + offset, sizeof(chunk_header));
+                const char *payload = base + offset + sizeof(chunk_header);
+                const size_t N = tile_size(band);
+                if (ch.raw_size != N * sizeof(T)) {
+                    std::string msg = "File '" + m_path + "' has a corrupt chunk.";
+                    throw std::runtime_error(msg);
+                }
+
+                if (static_cast<codec>(ch.codec) == codec::NONE) {
+                    std::memcpy(out, payload, ch.raw_size);
+                } else {
+                    std::vector<char> shuffled(ch.raw_size);
+                    rle::decode(payload, ch.stored_size, shuffled.data(), ch.raw_size);
+                    rle::unshuffle(shuffled.data(), reinterpret_cast<char*>(out), N, sizeof(T));
+                }
+            }
+
+            /*
+             * Decode a full plane.
+             *
+             * Parameters
+             * ----------
+             * plane : size_t
+             *
+             * Returns
+             * -------
+             * I : SphericalImageContainer<T>
+             *     (N_level, ...) in-memory container.
+             */
+            image::SphericalImageContainer<T> read_plane(const size_t plane) const {
+                check_index(plane, 0, 0);
+
+                const size_t N_px = N_row() * N_col();
+                std::shared_ptr<T> buffer(new T[(3 + N_level()) * N_px], std::default_delete<T[]>());
+                T *grid = buffer.get();
+                T *data = grid + 3 * N_px;
+                std::copy(grid_data(), grid_data() + 3 * N_px, grid);
+
+                const int N_task = static_cast<int>(N_level() * N_band());
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (int task = 0; task < N_task; ++task) {
+                    const size_t level = task / N_band();
+                    const size_t band = task % N_band();
+                    read_tile(plane, level, band,
+                              data + (level * N_px) + (band * m_header.band_size * N_col()));
+                }
+
+                std::vector<size_t> shape_image = grid_shape();
+                shape_image[0] = N_level();
+                return image::SphericalImageContainer<T>(data, shape_image, grid, grid_shape(), buffer);
+            }
+
+            /*
+             * Append plane to the archive.
+             *
+             * Parameters
+             * ----------
+             * I : SphericalImageContainer<T>
+             *     (N_level, ...) images defined on the archive's grid.
+             * tag : double
+             *     User-provided label of the plane (ex: time, frequency).
+             *
+             * Returns
+             * -------
+             * plane : size_t
+             *     Index of the new plane.
+             */
+            size_t append(image::SphericalImageContainer<T> &I,
+                          const double tag = std::numeric_limits<double>::quiet_NaN()) {
+                auto image = I.image();
+                std::vector<size_t> shape_image = grid_shape();
+                shape_image[0] = N_level();
+                if ((image.dimension() != shape_image.size()) ||
+                    !std::equal(shape_image.begin(), shape_image.end(), image.shape().begin())) {
+                    std::string msg = "Parameter[I] must have shape (N_level, ...) and share the archive's grid.";
+                    throw std::runtime_error(msg);
+                }
+
+                const size_t plane = N_plane();
+                const size_t N_px = N_row() * N_col();
+                const T *data = image.data();
+
+                // Encode tiles in parallel, write them sequentially.
+                const int N_task = static_cast<int>(N_level() * N_band());
+                std::vector<std::vector<char>> payloads(N_task);
+                std::vector<codec> codecs(N_task, codec::NONE);
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (int task = 0; task < N_task; ++task) {
+                    const size_t level = task / N_band();
+                    const size_t band = task % N_band();
+                    const char *tile = reinterpret_cast<const char*>(data + (level * N_px) +
+                                                                     (band * m_header.band_size * N_col()));
+                    const size_t N = tile_size(band);
+                    const size_t raw_size = N * sizeof(T);
+
+                    if (static_cast<codec>(m_header.codec) == codec::SHUFFLE_RLE) {
+                        std::vector<char> shuffled(raw_size);
+                        rle::shuffle(tile, shuffled.data(), N, sizeof(T));
+                        payloads[task] = rle::encode(shuffled.data(), raw_size);
+                        if (payloads[task].size() < raw_size) {
+                            codecs[task] = codec::SHUFFLE_RLE;
+                            continue;
+                        }
+                    }
+                    payloads[task].assign(tile, tile + raw_size);
+                }
+
+                std::fstream file(m_path, std::ios::binary | std::ios::in | std::ios::out);
+                if (!file) {
+                    std::string msg = "Could not open file '" + m_path + "' for writing.";
+                    throw std::runtime_error(msg);
+                }
+                file.seekp(static_cast<std::streamoff>(m_end));
+                size_t end = m_end;
+                std::vector<size_t> plane_chunks(N_task);
+                for (int task = 0; task < N_task; ++task) {
+                    chunk_header ch {};
+                    std::copy(chunk_magic, chunk_magic + 4, ch.magic);
+                    ch.codec = static_cast<uint32_t>(codecs[task]);
+                    ch.plane = plane;
+                    ch.level = static_cast<uint32_t>(task / N_band());
+                    ch.band = static_cast<uint32_t>(task % N_band());
+                    ch.tag = tag;
+                    ch.raw_size = tile_size(ch.band) * sizeof(T);
+                    ch.stored_size = payloads[task].size();
+
+                    plane_chunks[task] = end;
+                    file.write(reinterpret_cast<const char*>(&ch), sizeof(chunk_header));
+                    file.write(payloads[task].data(), payloads[task].size());
+                    end += sizeof(chunk_header) + payloads[task].size();
+                }
+                file.close();
+                if (!file || (truncate(m_path.c_str(), static_cast<off_t>(end)) != 0)) {
+                    std::string msg = "Could not write to file '" + m_path + "'.";
+                    throw std::runtime_error(msg);
+                }
+
+                // Extend the index in place: re-scanning the file would make
+                // each append O(N_chunk).
+                map();
+                m_chunks.insert(m_chunks.end(), plane_chunks.begin(), plane_chunks.end());
+                m_tags.push_back(tag);
+                m_end = end;
+                return plane;
+            }
+    };
+
+    template <typename T>
+    constexpr char SphericalImageArchive<T>::file_magic[8];
+
+    template <typename T>
+    constexpr char SphericalImageArchive<T>::chunk_magic[4];
+
+    inline size_t itemsize(const std::string &path) {
+        namespace mmap = pypeline::util::mmap;
+        mmap::MappedFile file(path, mmap::access_mode::READ_ONLY);
+        const char *base = reinterpret_cast<const char*>(file.data());
+        // (magic, version, itemsize) prefix shared by all versions.
+        if ((file.size() < 16) || (std::strncmp(base, "PYPLARC", 8) != 0)) {
+            std::string msg = "File '" + path + "' is not a SphericalImageArchive.";
+            throw std::runtime_error(msg);
+        }
+        uint32_t N;
+        std::memcpy(&N, base + 12, sizeof(uint32_t));
+        return N;
+    }
+}}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_UTIL_IO_ARCHIVE_HPP
@@ -0,0 +1,457 @@
+// ############################################################################
+// fits.hpp
+// ========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Streaming FITS import/export of spherical images.
+ *
+ * Files follow the layout of :py:meth:`~pypeline.phased_array.util.io.image.SphericalImage.to_fits`:
+ *
+ * * Primary HDU: (2, ...) float64 [colat, lon] coordinates [deg] of the grid,
+ *   with the image class name stored under keyword IMG_TYPE;
+ * * ImageHDU 'IMAGE': (N_image, ...) data cube.
+ *
+ * Data is converted to/from big-endian by fixed-size chunks, hence memory
+ * usage does not depend on the image size.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_UTIL_IO_FITS_HPP
+#define PYPELINE_PHASED_ARRAY_UTIL_IO_FITS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pypeline/phased_array/util/io/image.hpp"
+
+namespace pypeline { namespace phased_array { namespace util { namespace io { namespace fits {
+    constexpr size_t block_size = 2880;
+    constexpr size_t card_size = 80;
+    constexpr size_t chunk_size = 1 << 22;  // [bytes] Streaming granularity.
+
+    /*
+     * Reverse byte order of `N` contiguous items of width sizeof(T) in-place.
+     *
+     * No-op on big-endian hosts.
+     * The loop has no dependencies across iterations and is vectorized by the
+     * compiler (byte shuffles) at -O3.
+     */
+    template <typename T>
+    void swap_to_big_endian(T *x, const size_t N) {
+        #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        static_assert((sizeof(T) == 4) || (sizeof(T) == 8), "Only 32/64-bit items can be swapped.");
+        using UINT = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+
+        UINT *u = reinterpret_cast<UINT*>(x);
+        for (size_t i = 0; i < N; ++i) {
+            if (sizeof(T) == 4) {
+                u[i] = static_cast<UINT>(__builtin_bswap32(static_cast<uint32_t>(u[i])));
+            } else {
+                u[i] = static_cast<UINT>(__builtin_bswap64(static_cast<uint64_t>(u[i])));
+            }
+        }
+        #else
+        (void) x;
+        (void) N;
+        #endif
+    }
+
+    /*
+     * Format an 80-character header card.
+     *
+     * Parameters
+     * ----------
+     * key : std::string
+     *     Keyword (at most 8 characters).
+     * value : std::string
+     *     Pre-formatted value: fixed-format logicals/numbers are right-justified
+     *     to column 30, strings (already quoted) start at column 11.
+     * comment : std::string
+     */
+    inline std::string card(const std::string &key,
+                            const std::string &value = "",
+                            const std::string &comment = "") {
+        std::string c = key;
+        c.resize(8, ' ');
+        if (!value.empty()) {
+            std::string v = value;
+            if (v[0] != '\'') {
+                v.insert(0, std::max<int>(0, 20 - static_cast<int>(v.size())), ' ');
+            }
+            c += "= " + v;
+            if (!comment.empty()) {
+                c += " / " + comment;
+            }
+        }
+        c.resize(card_size, ' ');
+        return c;
+    }
+
+    inline std::string quote(const std::string &s) {
+        std::string q = s;
+        q.resize(std::max<size_t>(8, s.size()), ' ');
+        return "'" + q + "'";
+    }
+
+    /*
+     * Parsed header + location of the data block of one HDU.
+     */
+    struct hdu_info {
+        std::map<std::string, std::string> header {};
+        std::vector<size_t> shape {};  // C-order (slowest axis first).
+        int bitpix = 0;
+        size_t data_offset = 0;        // [bytes] from start of file.
+        size_t data_size = 0;          // [bytes] without padding.
+
+        std::string get(const std::string &key) const {
+            auto it = header.find(key);
+            return ((it == header.end()) ? std::string() : it->second);
+        }
+    };
+
+    inline size_t padded(const size_t N_bytes) {
+        return ((N_bytes + block_size - 1) / block_size) * block_size;
+    }
+
+    /*
+     * Parse HDU starting at current position of `file`.
+     * On return, `file` is positioned at the start of the next HDU.
+     */
+    inline hdu_info read_hdu(std::ifstream &file, const std::string &path) {
+        hdu_info hdu;
+        char block[block_size];
+        bool end = false;
+
+        while (!end) {
+            if (!file.read(block, block_size)) {
+                std::string msg = "File '" + path + "' is not a valid FITS file: truncated header.";
+                throw std::runtime_error(msg);
+            }
+
+            for (size_t i = 0; (i < block_size / card_size) && !end; ++i) {
+                std::string c(block + i * card_size, card_size);
+                std::string key = c.substr(0, 8);
+                key.erase(key.find_last_not_of(' ') + 1);
+
+                if (key == "END") {
+                    end = true;
+                } else if (c.compare(8, 2, "= ") == 0) {
+                    std::string value = c.substr(10);
+                    size_t start = value.find_first_not_of(' ');
+                    if (start == std::string::npos) {
+                        value.clear();
+                    } else if (value[start] == '\'') {  // string: up to closing quote, '' escapes a quote.
+                        std::string s;
+                        for (size_t j = start + 1; j < value.size(); ++j) {
+                            if (value[j] == '\'') {
+                                if ((j + 1 < value.size()) && (value[j + 1] == '\'')) {
+                                    s += '\'';
+                                    ++j;
+                                } else {
+                                    break;
+                                }
+                            } else {
+                                s += value[j];
+                            }
+                        }
+                        s.erase(s.find_last_not_of(' ') + 1);
+                        value = s;
+                    } else {
+                        value = value.substr(start, value.find('/', start) - start);
+                        value.erase(value.find_last_not_of(' ') + 1);
+                    }
+                    hdu.header[key] = value;
+                }
+            }
+        }
+
+        if (hdu.get("BITPIX").empty() || hdu.get("NAXIS").empty()) {
+            std::string msg = "File '" + path + "' is not a valid FITS file: missing BITPIX/NAXIS.";
+            throw std::runtime_error(msg);
+        }
+        hdu.bitpix = std::stoi(hdu.get("BITPIX"));
+        const int N_axis = std::stoi(hdu.get("NAXIS"));
+        for (int i = N_axis; i >= 1; --i) {
+            hdu.shape.push_back(std::stoull(hdu.get("NAXIS" + std::to_string(i))));
+        }
+
+        size_t N_item = 1;
+        for (const size_t &s : hdu.shape) { N_item *= s; }
+        if (N_axis == 0) { N_item = 0; }
+        const size_t PCOUNT = (hdu.get("PCOUNT").empty() ? 0 : std::stoull(hdu.get("PCOUNT")));
+        const size_t GCOUNT = (hdu.get("GCOUNT").empty() ? 1 : std::stoull(hdu.get("GCOUNT")));
+        hdu.data_size = (std::abs(hdu.bitpix) / 8) * GCOUNT * (PCOUNT + N_item);
+        hdu.data_offset = static_cast<size_t>(file.tellg());
+
+        file.seekg(static_cast<std::streamoff>(hdu.data_offset + padded(hdu.data_size)));
+        return hdu;
+    }
+
+    /*
+     * Locate primary HDU and ImageHDU 'IMAGE' of a spherical image file.
+     *
+     * Returns
+     * -------
+     * hdus : std::pair<hdu_info, hdu_info>
+     *     (primary, image) HDUs.
+     */
+    inline std::pair<hdu_info, hdu_info> scan(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::string msg = "Could not open file '" + path + "'.";
+            throw std::runtime_error(msg);
+        }
+        file.seekg(0, std::ios::end);
+        const size_t file_size = static_cast<size_t>(file.tellg());
+        file.seekg(0, std::ios::beg);
+
+        hdu_info primary = read_hdu(file, path);
+        if (primary.get("SIMPLE") != "T") {
+            std::string msg = "File '" + path + "' is not a valid FITS file: SIMPLE != T.";
+            throw std::runtime_error(msg);
+        }
+
+        while (static_cast<size_t>(file.tellg()) < file_size) {
+            hdu_info ext = read_hdu(file, path);
+            if (ext.get("EXTNAME") == "IMAGE") {
+                return std::make_pair(primary, ext);
+            }
+        }
+
+        std::string msg = "File '" + path + "' has no 'IMAGE' extension.";
+        throw std::runtime_error(msg);
+    }
+
+    /*
+     * Write spherical image to FITS file.
+     *
+     * Parameters
+     * ----------
+     * path : std::string
+     *     File to create. Existing files are overwritten.
+     * I : SphericalImageContainer<T>
+     * img_type : std::string
+     *     Value of keyword IMG_TYPE: name of the Python class used to interpret the file.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/phased_array/util/io/image.hpp"
+     *    #include "pypeline/phased_array/util/io/fits.hpp"
+     *
+     *    namespace image = pypeline::phased_array::util::io::image;
+     *    namespace fits = pypeline::phased_array::util::io::fits;
+     *
+     *    auto I = image::SphericalImageContainer<float>::open_mapped("/tmp/cube.sic");
+     *    fits::write("/tmp/cube.fits", I);  // Readable with pypeline.phased_array.util.io.image.from_fits()
+     */
+    template <typename T>
+    void write(const std::string &path,
+               const image::SphericalImageContainer<T> &I,
+               const std::string &img_type = "SphericalImage") {
+        static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::string msg = "Could not open file '" + path + "' for writing.";
+            throw std::runtime_error(msg);
+        }
+
+        auto write_header = [&file](const std::vector<std::string> &cards) {
+            std::string header;
+            for (const std::string &c : cards) { header += c; }
+            header += card("END");
+            header.resize(padded(header.size()), ' ');
+            file.write(header.data(), header.size());
+        };
+        auto write_padding = [&file](const size_t N_bytes) {
+            const std::string pad(padded(N_bytes) - N_bytes, '\0');
+            file.write(pad.data(), pad.size());
+        };
+
+        auto grid = I.grid();
+        auto image = I.image();
+        const std::vector<size_t> shape_grid(grid.shape().begin(), grid.shape().end());
+        const std::vector<size_t> shape_image(image.shape().begin(), image.shape().end());
+        const size_t N_px = grid.size() / 3;
+
+        // Primary HDU: (2, ...) [colat, lon] in degrees.
+        std::vector<std::string> cards {
+            card("SIMPLE", "T", "conforms to FITS standard"),
+            card("BITPIX", "-64", "array data type"),
+            card("NAXIS", std::to_string(shape_grid.size()), "number of array dimensions")};
+        for (size_t i = shape_grid.size(); i-- > 1;) {
+            cards.push_back(card("NAXIS" + std::to_string(shape_grid.size() - i), std::to_string(shape_grid[i])));
+        }
+        cards.push_back(card("NAXIS" + std::to_string(shape_grid.size()), "2"));
+        cards.push_back(card("EXTEND", "T"));
+        cards.push_back(card("IMG_TYPE", quote(img_type), "SphericalImage subclass"));
+        write_header(cards);
+
+        const T *x = grid.data();
+        const T *y = x + N_px;
+        const T *z = y + N_px;
+        const size_t N_chunk = chunk_size / sizeof(double);
+        std::vector<double> buffer(N_chunk);
+        for (int coord = 0; coord < 2; ++coord) {
+            for (size_t start = 0; start < N_px; start += N_chunk) {
+                const size_t N = std::min(N_chunk, N_px - start);
+                for (size_t i = 0; i < N; ++i) {
+                    const double xx = x[start + i], yy = y[start + i], zz = z[start + i];
+                    buffer[i] = ((coord == 0) ?
+                                 std::atan2(std::sqrt((xx * xx) + (yy * yy)), zz) :
+                                 std::atan2(yy, xx)) * (180.0 / M_PI);
+                }
+                swap_to_big_endian(buffer.data(), N);
+                file.write(reinterpret_cast<const char*>(buffer.data()), N * sizeof(double));
+            }
+        }
+        write_padding(2 * N_px * sizeof(double));
+
+        // ImageHDU: (N_image, ...) data cube.
+        cards = {
+            card("XTENSION", quote("IMAGE"), "Image extension"),
+            card("BITPIX", std::to_string(-8 * static_cast<int>(sizeof(T))), "array data type"),
+            card("NAXIS", std::to_string(shape_image.size()), "number of array dimensions")};
+        for (size_t i = shape_image.size(); i-- > 0;) {
+            cards.push_back(card("NAXIS" + std::to_string(shape_image.size() - i), std::to_string(shape_image[i])));
+        }
+        cards.push_back(card("PCOUNT", "0", "number of parameters"));
+        cards.push_back(card("GCOUNT", "1", "number of groups"));
+        cards.push_back(card("EXTNAME", quote("IMAGE"), "extension name"));
+        write_header(cards);
+
+        const T *data = image.data();
+        const size_t N_image = image.size();
+        const size_t N_chunk_im = chunk_size / sizeof(T);
+        std::vector<T> buffer_im(N_chunk_im);
+        for (size_t start = 0; start < N_image; start += N_chunk_im) {
+            const size_t N = std::min(N_chunk_im, N_image - start);
+            std::copy(data + start, data + start + N, buffer_im.begin());
+            swap_to_big_endian(buffer_im.data(), N);
+            file.write(reinterpret_cast<const char*>(buffer_im.data()), N * sizeof(T));
+        }
+        write_padding(N_image * sizeof(T));
+
+        if (!file) {
+            std::string msg = "Could not write to file '" + path + "'.";
+            throw std::runtime_error(msg);
+        }
+    }
+
+    /*
+     * Stream FITS data block to `out`, converting to host byte order and Type[T].
+     */
+    template <typename T, typename F>
+    void read_block(std::ifstream &file, const size_t offset, const size_t N, T *out) {
+        file.seekg(static_cast<std::streamoff>(offset));
+        const size_t N_chunk = chunk_size / sizeof(F);
+        std::vector<F> buffer(std::min(N_chunk, N));
+        for (size_t start = 0; start < N; start += N_chunk) {
+            const size_t N_read = std::min(N_chunk, N - start);
+            file.read(reinterpret_cast<char*>(buffer.data()), N_read * sizeof(F));
+            swap_to_big_endian(buffer.data(), N_read);  // involution
+            std::copy(buffer.begin(), buffer.begin() + N_read, out + start);
+        }
+    }
+
+    /*
+     * Read spherical image from FITS file.
+     *
+     * Files written by astropy via :py:meth:`~pypeline.phased_array.util.io.image.SphericalImage.to_fits` are supported.
+     *
+     * Parameters
+     * ----------
+     * path : std::string
+     * hdus : std::pair<hdu_info, hdu_info>
+     *     (primary, image) HDUs of `path`, as returned by scan().
+     *     Lets callers inspect the header (ex: IMG_TYPE) without parsing it twice.
+     *
+     * Returns
+     * -------
+     * I : SphericalImageContainer<T>
+     *     In-memory container. The data cube is converted to Type[T] if required.
+     */
+    template <typename T>
+    image::SphericalImageContainer<T> read(const std::string &path,
+                                           const std::pair<hdu_info, hdu_info> &hdus) {
+        static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+
+        const hdu_info &primary = hdus.first, &im = hdus.second;
+        for (const hdu_info *hdu : {&primary, &im}) {
+            if (!((hdu->bitpix == -32) || (hdu->bitpix == -64))) {
+                std::string msg = "File '" + path + "': only floating-point HDUs are supported.";
+                throw std::runtime_error(msg);
+            }
+            const std::string bscale = hdu->get("BSCALE"), bzero = hdu->get("BZERO");
+            if ((!bscale.empty() && (std::stod(bscale) != 1)) ||
+                (!bzero.empty() && (std::stod(bzero) != 0))) {
+                std::string msg = "File '" + path + "': scaled HDUs (BSCALE/BZERO) are not supported.";
+                throw std::runtime_error(msg);
+            }
+        }
+        if (primary.shape.empty() || (primary.shape[0] != 2)) {
+            std::string msg = "File '" + path + "': primary HDU must have shape (2, ...).";
+            throw std::runtime_error(msg);
+        }
+
+        std::vector<size_t> shape_grid(primary.shape);
+        shape_grid[0] = 3;
+        size_t N_px = 1, N_image = 1;
+        for (size_t i = 1; i < shape_grid.size(); ++i) { N_px *= shape_grid[i]; }
+        for (const size_t &s : im.shape) { N_image *= s; }
+
+        std::shared_ptr<T> buffer(new T[3 * N_px + N_image], std::default_delete<T[]>());
+        T *grid = buffer.get();
+        T *data = grid + 3 * N_px;
+
+        std::ifstream file(path, std::ios::binary);
+        if (im.bitpix == -32) {
+            read_block<T, float>(file, im.data_offset, N_image, data);
+        } else {
+            read_block<T, double>(file, im.data_offset, N_image, data);
+        }
+
+        // [colat, lon] -> (x, y, z). `grid` temporarily holds angles in its (y, z) planes.
+        T *colat = grid + N_px;
+        T *lon = grid + 2 * N_px;
+        if (primary.bitpix == -32) {
+            read_block<T, float>(file, primary.data_offset, 2 * N_px, colat);
+        } else {
+            read_block<T, double>(file, primary.data_offset, 2 * N_px, colat);
+        }
+        for (size_t i = 0; i < N_px; ++i) {
+            const double c = static_cast<double>(colat[i]) * (M_PI / 180.0);
+            const double l = static_cast<double>(lon[i]) * (M_PI / 180.0);
+            grid[i] = static_cast<T>(std::sin(c) * std::cos(l));
+            colat[i] = static_cast<T>(std::sin(c) * std::sin(l));
+            lon[i] = static_cast<T>(std::cos(c));
+        }
+
+        if (!file) {
+            std::string msg = "Could not read from file '" + path + "'.";
+            throw std::runtime_error(msg);
+        }
+        return image::SphericalImageContainer<T>(data, im.shape, grid, shape_grid, buffer);
+    }
+
+    template <typename T>
+    image::SphericalImageContainer<T> read(const std::string &path) {
+        return read<T>(path, scan(path));
+    }
+}}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_UTIL_IO_FITS_HPP
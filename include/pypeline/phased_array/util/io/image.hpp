@@ -11,20 +11,38 @@
 #ifndef PYPELINE_PHASED_ARRAY_UTIL_IO_IMAGE
 #define PYPELINE_PHASED_ARRAY_UTIL_IO_IMAGE
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "xtensor/xadapt.hpp"
 #include "xtensor/xarray.hpp"
-#include "xtensor/xstrided_view.hpp"
 
 #include "pypeline/util/argcheck.hpp"
+#include "pypeline/util/mmap.hpp"
 
 namespace pypeline { namespace phased_array { namespace util { namespace io { namespace image {
     /*
      * In-memory container for storing real-valued images defined on :math:`\mathbb{S}^{2}`.
      *
+     * Three storage modes are available:
+     *
+     * * owned: (image, grid) are copied to a private buffer at construction time;
+     * * adopted: (image, grid) reference external row-major contiguous buffers
+     *   whose lifetime is tied to the container through an opaque owner handle.
+     *   No copies are made;
+     * * memory-mapped: (image, grid) live in a file on disk and are paged in/out
+     *   on demand by the kernel. See :cpp:func:`create_mapped` and
+     *   :cpp:func:`open_mapped`.
+     *
+     * Copying a container is cheap: all copies share the same storage.
+     *
      * This class is not meant to be subclassed: prefer encapsulating an instance in your objects instead.
      *
      * Examples
@@ -49,13 +67,128 @@ namespace pypeline { namespace phased_array { namespace util { namespace io { na
      *    auto gr = xt::stack(sphere::pol2cart(r, colat, lon), 0);  // grid of shape (3, 768, 1024)
      *
      *    const auto& I = image::SphericalImageContainer<float>(im, gr);  // (im, gr) internally stored as float.
+     *
+     *    // Adopt existing buffers: no copies.
+     *    auto im_d = std::make_shared<xt::xarray<double>>(im);
+     *    auto gr_d = std::make_shared<xt::xarray<double>>(gr);
+     *    const auto& J = image::SphericalImageContainer<double>(im_d->data(), {5, 768, 1024},
+     *                                                            gr_d->data(), {3, 768, 1024},
+     *                                                            std::make_shared<std::pair<decltype(im_d), decltype(gr_d)>>(im_d, gr_d));
+     *
+     *    // File-backed data cube, filled in-place.
+     *    auto K = image::SphericalImageContainer<float>::create_mapped("/tmp/cube.sic", 5, gr);
+     *    K.image() = im;
+     *    K.flush();
+     *
+     *    const auto& L = image::SphericalImageContainer<float>::open_mapped("/tmp/cube.sic");
      */
     template <typename T>
     class SphericalImageContainer {
         private:
-            xt::xarray<T> m_image;
-            xt::xarray<T> m_grid;
-            bool m_is_gridded;
+            /*
+             * On-disk layout of memory-mapped containers:
+             *
+             * [header | padding | grid | padding | image]
+             *
+             * Both data blocks are page-aligned and stored in native byte order.
+             */
+            struct mapped_header {
+                char magic[8];
+                uint32_t version;
+                uint32_t itemsize;
+                uint64_t rank_image;
+                uint64_t shape_image[3];
+                uint64_t rank_grid;
+                uint64_t shape_grid[3];
+                uint64_t offset_grid;
+                uint64_t offset_image;
+            };
+            static constexpr char mapped_magic[8] = {'P', 'Y', 'P', 'L', 'S', 'I', 'C', '\0'};
+            static constexpr uint32_t mapped_version = 1;
+            static constexpr size_t mapped_alignment = 4096;
+
+            std::shared_ptr<void> m_owner;  // keeps (m_image_data, m_grid_data) alive.
+            T *m_image_data = nullptr;
+            T *m_grid_data = nullptr;
+            std::vector<size_t> m_image_shape;
+            std::vector<size_t> m_grid_shape;
+            bool m_is_gridded = false;
+            bool m_is_writable = true;
+            std::string m_path {};
+
+            static size_t prod(const std::vector<size_t> &shape) {
+                size_t N = 1;
+                for (const size_t &s : shape) { N *= s; }
+                return N;
+            }
+
+            void assert_writable() const {
+                if (!m_is_writable) {
+                    std::string msg = "Container is read-only: access its data through a const reference.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Validate (image, grid) shapes and store them in canonical form:
+             * a single image is always reported with a leading axis of length 1.
+             */
+            void set_shapes(const std::vector<size_t> &shape_image,
+                            const std::vector<size_t> &shape_grid) {
+                if (!((shape_grid.size() == 2) ||
+                      (shape_grid.size() == 3))) {
+                    std::string msg = "Parameter[grid] must have shape (3, N_height, N_width) or (3, N_point).";
+                    throw std::runtime_error(msg);
+                }
+                if (shape_grid[0] != 3) {
+                    std::string msg = "Parameter[grid] must have shape (3, N_height, N_width) or (3, N_point).";
+                    throw std::runtime_error(msg);
+                }
+                m_grid_shape = shape_grid;
+
+                if (shape_grid.size() == 2) {  // N_point mode
+                    std::string msg = "Parameter[image] must have shape (N_point,) or (N_image, N_point).";
+                    const size_t N_point = shape_grid[1];
+                    m_is_gridded = false;
+
+                    if (shape_image.size() == 1) {
+                        if (shape_image[0] != N_point) {
+                            throw std::runtime_error(msg);
+                        }
+                        m_image_shape = {1, N_point};
+                    } else if (shape_image.size() == 2) {
+                        if (shape_image[1] != N_point) {
+                            throw std::runtime_error(msg);
+                        }
+                        m_image_shape = shape_image;
+                    } else {
+                        throw std::runtime_error(msg);
+                    }
+                } else {  // (N_height, N_width) mode
+                    std::string msg = "Parameter[image] must have shape (N_height, N_width) or (N_image, N_height, N_width).";
+                    const size_t N_height = shape_grid[1];
+                    const size_t N_width = shape_grid[2];
+                    m_is_gridded = true;
+
+                    if (shape_image.size() == 2) {
+                        if (!((shape_image[0] == N_height) &&
+                              (shape_image[1] == N_width))) {
+                            throw std::runtime_error(msg);
+                        }
+                        m_image_shape = {1, N_height, N_width};
+                    } else if (shape_image.size() == 3) {
+                        if (!((shape_image[1] == N_height) &&
+                              (shape_image[2] == N_width))) {
+                            throw std::runtime_error(msg);
+                        }
+                        m_image_shape = shape_image;
+                    } else {
+                        throw std::runtime_error(msg);
+                    }
+                }
+            }
+
+            SphericalImageContainer() = default;
 
         public:
             /*
@@ -79,7 +212,7 @@ namespace pypeline { namespace phased_array { namespace util { namespace io { na
              *
              * Note
              * ----
-             * The image and grid are stored internally with scalar type T.
+             * The image and grid are copied to a single buffer and stored internally with scalar type T.
              * Only floating-point types are accepted.
              */
             template <typename E1, typename E2>
@@ -91,78 +224,283 @@ namespace pypeline { namespace phased_array { namespace util { namespace io { na
                     std::string msg = "Parameter[grid] must be real-valued.";
                     throw std::runtime_error(msg);
                 }
-                if (!((grid.shape().size() == 2) ||
-                      (grid.shape().size() == 3))) {
-                    std::string msg = "Parameter[grid] must have shape (3, N_height, N_width) or (3, N_point).";
+                if (!argcheck::has_floats(image)) {
+                    std::string msg = "Parameter[image] must be real-valued.";
                     throw std::runtime_error(msg);
                 }
-                if (grid.shape()[0] != 3) {
-                    std::string msg = "Parameter[grid] must have shape (3, N_height, N_width) or (3, N_point).";
+
+                std::vector<size_t> shape_image(image.shape().begin(), image.shape().end());
+                std::vector<size_t> shape_grid(grid.shape().begin(), grid.shape().end());
+                set_shapes(shape_image, shape_grid);
+
+                const size_t N_image = prod(m_image_shape);
+                const size_t N_grid = prod(m_grid_shape);
+                std::shared_ptr<T> buffer(new T[N_image + N_grid], std::default_delete<T[]>());
+                m_owner = buffer;
+                m_grid_data = buffer.get();
+                m_image_data = buffer.get() + N_grid;
+
+                auto grid_out = xt::adapt(m_grid_data, N_grid, xt::no_ownership(), shape_grid);
+                grid_out = grid;
+                auto image_out = xt::adapt(m_image_data, N_image, xt::no_ownership(), shape_image);
+                image_out = image;
+            }
+
+            /*
+             * Adopt external buffers without copying them.
+             *
+             * Parameters
+             * ----------
+             * image : T*
+             *     Row-major contiguous data cube.
+             *     See the expression-based constructor for allowed shapes.
+             * shape_image : std::vector<size_t>
+             * grid : T*
+             *     Row-major contiguous (3, ...) Cartesian coordinates of the sky on which the data-points are defined.
+             * shape_grid : std::vector<size_t>
+             * owner : std::shared_ptr<void>
+             *     Handle keeping (image, grid) alive for the lifetime of the container.
+             *     Can be empty if the caller guarantees the buffers outlive the container.
+             * writable : bool
+             *     If false, the container is flagged read-only.
+             */
+            SphericalImageContainer(T *image,
+                                    const std::vector<size_t> &shape_image,
+                                    T *grid,
+                                    const std::vector<size_t> &shape_grid,
+                                    std::shared_ptr<void> owner,
+                                    const bool writable = true):
+                m_owner(std::move(owner)), m_image_data(image),
+                m_grid_data(grid), m_is_writable(writable) {
+                static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+
+                if ((image == nullptr) || (grid == nullptr)) {
+                    std::string msg = "Parameters[image, grid] must point to valid buffers.";
                     throw std::runtime_error(msg);
                 }
-                m_grid = grid;
+                set_shapes(shape_image, shape_grid);
+            }
 
-                if (!argcheck::has_floats(image)) {
-                    std::string msg = "Parameter[image] must be real-valued.";
+            /*
+             * Create a file-backed container.
+             *
+             * The image is zero-initialized; the grid is copied to disk.
+             *
+             * Parameters
+             * ----------
+             * path : std::string
+             *     File to create. Existing files are overwritten.
+             * N_image : size_t
+             *     Number of images in the data cube.
+             * grid : xt::xexpression
+             *     (3, ...) Cartesian coordinates of the sky on which the data-points are defined.
+             *
+             * Returns
+             * -------
+             * I : SphericalImageContainer<T>
+             *     (N_image, ...) writable container.
+             */
+            template <typename E>
+            static SphericalImageContainer<T> create_mapped(const std::string &path,
+                                                            const size_t N_image,
+                                                            E &&grid) {
+                static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+
+                namespace argcheck = pypeline::util::argcheck;
+                namespace mmap = pypeline::util::mmap;
+                if (!argcheck::has_floats(grid)) {
+                    std::string msg = "Parameter[grid] must be real-valued.";
+                    throw std::runtime_error(msg);
+                }
+                if (N_image == 0) {
+                    std::string msg = "Parameter[N_image] must be positive.";
                     throw std::runtime_error(msg);
                 }
-                if (grid.shape().size() == 2) {  // N_point mode
-                    std::string msg = "Parameter[image] must have shapae (N_point,) or (N_image, N_point).";
-                    auto N_point = grid.shape()[grid.shape().size() - 1];
-                    m_is_gridded = false;
 
-                    if (image.shape().size() == 1) {
-                        if (image.shape()[0] != N_point) {
-                            throw std::runtime_error(msg);
-                        }
+                SphericalImageContainer<T> I;
+                std::vector<size_t> shape_grid(grid.shape().begin(), grid.shape().end());
+                std::vector<size_t> shape_image(shape_grid.begin() + 1, shape_grid.end());
+                shape_image.insert(shape_image.begin(), N_image);
+                I.set_shapes(shape_image, shape_grid);
 
-                        m_image = xt::reshape_view(image, std::vector<size_t>{1, static_cast<size_t>(N_point)});
-                    } else if (image.shape().size() == 2) {
-                        if (image.shape()[1] != N_point) {
-                            throw std::runtime_error(msg);
-                        }
-                        m_image = image;
-                    } else {
-                        throw std::runtime_error(msg);
-                    }
-                } else {  // (N_height, N_width) mode
-                    std::string msg = "Parameter[image] must have shape (N_height, N_width) or (N_image, N_height, N_width).";
-                    auto N_height = grid.shape()[1];
-                    auto N_width = grid.shape()[2];
-                    m_is_gridded = true;
+                const size_t N_grid = prod(I.m_grid_shape);
+                const size_t N_im = prod(I.m_image_shape);
+                const size_t offset_grid = mmap::align_up(sizeof(mapped_header), mapped_alignment);
+                const size_t offset_image = mmap::align_up(offset_grid + N_grid * sizeof(T), mapped_alignment);
+                const size_t file_size = offset_image + N_im * sizeof(T);
 
-                    if (image.shape().size() == 2) {
-                        if (!((image.shape()[0] == N_height) &&
-                              (image.shape()[1] == N_width))) {
-                            throw std::runtime_error(msg);
-                        }
+                auto file = std::make_shared<mmap::MappedFile>(path, mmap::access_mode::CREATE, file_size);
+                char *base = reinterpret_cast<char*>(file->data());
 
-                        m_image = xt::reshape_view(image, std::vector<size_t>{1, static_cast<size_t>(N_height), static_cast<size_t>(N_width)});
-                    } else if (image.shape().size() == 3) {
-                        if (!((image.shape()[1] == N_height) &&
-                              (image.shape()[2] == N_width))) {
-                            throw std::runtime_error(msg);
-                        }
+                mapped_header header {};
+                std::copy(mapped_magic, mapped_magic + 8, header.magic);
+                header.version = mapped_version;
+                header.itemsize = sizeof(T);
+                header.rank_image = I.m_image_shape.size();
+                std::copy(I.m_image_shape.begin(), I.m_image_shape.end(), header.shape_image);
+                header.rank_grid = I.m_grid_shape.size();
+                std::copy(I.m_grid_shape.begin(), I.m_grid_shape.end(), header.shape_grid);
+                header.offset_grid = offset_grid;
+                header.offset_image = offset_image;
+                std::memcpy(base, &header, sizeof(mapped_header));
 
-                        m_image = image;
-                    } else {
-                        throw std::runtime_error(msg);
-                    }
+                I.m_owner = file;
+                I.m_grid_data = reinterpret_cast<T*>(base + offset_grid);
+                I.m_image_data = reinterpret_cast<T*>(base + offset_image);  // ftruncate() zero-fills.
+                I.m_path = path;
+
+                auto grid_out = xt::adapt(I.m_grid_data, N_grid, xt::no_ownership(), shape_grid);
+                grid_out = grid;
+                return I;
+            }
+
+            /*
+             * Map a container previously created with :cpp:func:`create_mapped`.
+             *
+             * Parameters
+             * ----------
+             * path : std::string
+             * writable : bool
+             *     If true, modifications to the image are written back to disk.
+             *
+             * Returns
+             * -------
+             * I : SphericalImageContainer<T>
+             */
+            static SphericalImageContainer<T> open_mapped(const std::string &path,
+                                                          const bool writable = false) {
+                static_assert(std::is_floating_point<T>::value, "Only {float, double} are allowed for Type[T].");
+
+                namespace mmap = pypeline::util::mmap;
+                auto file = std::make_shared<mmap::MappedFile>(path,
+                                                               (writable ?
+                                                                mmap::access_mode::READ_WRITE :
+                                                                mmap::access_mode::READ_ONLY));
+                char *base = reinterpret_cast<char*>(file->data());
+
+                mapped_header header;
+                if (file->size() < sizeof(mapped_header)) {
+                    std::string msg = "File '" + path + "' is not a SphericalImageContainer.";
+                    throw std::runtime_error(msg);
+                }
+                std::memcpy(&header, base, sizeof(mapped_header));
+                if (!std::equal(mapped_magic, mapped_magic + 8, header.magic) ||
+                    (header.version != mapped_version)) {
+                    std::string msg = "File '" + path + "' is not a SphericalImageContainer.";
+                    throw std::runtime_error(msg);
                 }
+                if (header.itemsize != sizeof(T)) {
+                    std::string msg = ("File '" + path + "' stores " +
+                                       std::to_string(8 * header.itemsize) +
+                                       "-bit floats, but Type[T] is " +
+                                       std::to_string(8 * sizeof(T)) + "-bit.");
+                    throw std::runtime_error(msg);
+                }
+                if ((header.rank_image < 2) || (header.rank_image > 3) ||
+                    (header.rank_grid < 2) || (header.rank_grid > 3)) {
+                    std::string msg = "File '" + path + "' has a corrupt header.";
+                    throw std::runtime_error(msg);
+                }
+
+                std::vector<size_t> shape_image(header.shape_image, header.shape_image + header.rank_image);
+                std::vector<size_t> shape_grid(header.shape_grid, header.shape_grid + header.rank_grid);
+                if ((header.offset_grid + prod(shape_grid) * sizeof(T) > file->size()) ||
+                    (header.offset_image + prod(shape_image) * sizeof(T) > file->size())) {
+                    std::string msg = "File '" + path + "' is truncated.";
+                    throw std::runtime_error(msg);
+                }
+
+                SphericalImageContainer<T> I(reinterpret_cast<T*>(base + header.offset_image), shape_image,
+                                             reinterpret_cast<T*>(base + header.offset_grid), shape_grid,
+                                             file, writable);
+                I.m_path = path;
+                return I;
             }
 
-            const xt::xarray<T>& image() {
-                return m_image;
+            /*
+             * Returns
+             * -------
+             * image : xt::xexpression
+             *     (N_image, ...) writable view on the data cube.
+             *
+             * Notes
+             * -----
+             * Containers flagged read-only (ex: read-only memory maps) throw:
+             * access them through a const reference instead.
+             */
+            auto image() {
+                assert_writable();
+                return xt::adapt(m_image_data, prod(m_image_shape), xt::no_ownership(), m_image_shape);
             }
 
-            const xt::xarray<T>& grid() {
-                return m_grid;
+            /*
+             * Returns
+             * -------
+             * image : xt::xexpression
+             *     (N_image, ...) read-only view on the data cube.
+             */
+            auto image() const {
+                const T *data = m_image_data;
+                return xt::adapt(data, prod(m_image_shape), xt::no_ownership(), m_image_shape);
+            }
+
+            /*
+             * Returns
+             * -------
+             * grid : xt::xexpression
+             *     (3, ...) writable view on the Cartesian coordinates of the sky.
+             *
+             * Notes
+             * -----
+             * Containers flagged read-only throw: access them through a const reference instead.
+             */
+            auto grid() {
+                assert_writable();
+                return xt::adapt(m_grid_data, prod(m_grid_shape), xt::no_ownership(), m_grid_shape);
+            }
+
+            /*
+             * Returns
+             * -------
+             * grid : xt::xexpression
+             *     (3, ...) read-only view on the Cartesian coordinates of the sky.
+             */
+            auto grid() const {
+                const T *data = m_grid_data;
+                return xt::adapt(data, prod(m_grid_shape), xt::no_ownership(), m_grid_shape);
             }
 
             bool is_gridded() {
                 return m_is_gridded;
             }
+
+            bool is_writable() const {
+                return m_is_writable;
+            }
+
+            /*
+             * Returns
+             * -------
+             * path : std::string
+             *     Backing file of memory-mapped containers, empty string otherwise.
+             */
+            const std::string& path() {
+                return m_path;
+            }
+
+            /*
+             * Write memory-mapped data to disk. No-op for in-memory containers.
+             */
+            void flush() {
+                namespace mmap = pypeline::util::mmap;
+                if (!m_path.empty()) {
+                    std::static_pointer_cast<mmap::MappedFile>(m_owner)->flush();
+                }
+            }
     };
+
+    template <typename T>
+    constexpr char SphericalImageContainer<T>::mapped_magic[8];
 }}}}}
 
 #endif //PYPELINE_PHASED_ARRAY_UTIL_IO_IMAGE
@@ -0,0 +1,522 @@
+// ############################################################################
+// ms.hpp
+// ======
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Columnar, memory-mapped cache of Measurement Set visibilities.
+ */
+
+#ifndef PYPELINE_PHASED_ARRAY_UTIL_IO_MS_HPP
+#define PYPELINE_PHASED_ARRAY_UTIL_IO_MS_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+
+#include "pypeline/types.hpp"
+#include "pypeline/util/mmap.hpp"
+
+namespace pypeline { namespace phased_array { namespace util { namespace io { namespace ms {
+    /*
+     * Returns
+     * -------
+     * itemsize : size_t
+     *     Size [bytes] of the real/imaginary parts of visibilities stored in cache `path`.
+     */
+    inline size_t itemsize(const std::string &path);
+
+    /*
+     * Dense on-disk visibility cache.
+     *
+     * Visibilities of a fixed set of N_beam beams are stored as a
+     * (N_time, N_channel, N_pair) array, where the last axis enumerates the
+     * N_pair = N_beam (N_beam + 1) / 2 beam pairs (i <= j) of the
+     * upper-triangle in row-major order.
+     * Every (time, channel) slab has a companion bitmap with one bit per pair:
+     * set bits mark visibilities that were flagged or absent from the source
+     * table. Such visibilities are stored as 0.
+     *
+     * File layout (native byte order, sections 64-byte aligned, data page-aligned)
+     * ---------------------------------------------------------------------------
+     * [file header | time (N_time,) | channel (N_channel,) | beam_id (N_beam,) |
+     *  data (N_time, N_channel, N_pair) | flag (N_time, N_channel, N_word)]
+     *
+     * Once written, visibility matrices are gathered directly from the
+     * memory-mapped file: re-reading a dataset is bound by disk bandwidth.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/phased_array/util/io/ms.hpp"
+     *
+     *    namespace ms = pypeline::phased_array::util::io::ms;
+     *
+     *    std::vector<double> time = ..., channel = ...;  // MJD, [Hz]
+     *    std::vector<int64_t> beam_id = {0, 1, 2, 5};
+     *    auto C = ms::VisibilityCache<float>::create("/tmp/obs.pvc", time, channel, beam_id);
+     *    for (size_t t = 0; t < time.size(); ++t) {
+     *        C.write(t, N_entry, ant1, ant2, data, flag);  // rows of the MAIN table at time[t]
+     *    }
+     *    C.flush();
+     *
+     *    ms::VisibilityCache<float> D("/tmp/obs.pvc");
+     *    auto S = D.visibility(3, 0);          // (N_beam, N_beam) at (time=3, channel=0)
+     *    auto S_sub = D.visibility(3, 0, {1, 5});  // (2, 2) restricted to beams {1, 5}
+     */
+    template <typename TT>
+    class VisibilityCache {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            struct file_header {
+                char magic[8];
+                uint32_t version;
+                uint32_t itemsize;
+                uint64_t N_time;
+                uint64_t N_channel;
+                uint64_t N_beam;
+                uint64_t N_pair;
+                uint64_t N_word;
+                uint64_t offset_time;
+                uint64_t offset_channel;
+                uint64_t offset_beam;
+                uint64_t offset_data;
+                uint64_t offset_flag;
+            };
+
+            static constexpr char file_magic[8] = {'P', 'Y', 'P', 'L', 'V', 'I', 'S', '\0'};
+            static constexpr uint32_t file_version = 1;
+
+            std::string m_path {};
+            file_header m_header {};
+            std::shared_ptr<pypeline::util::mmap::MappedFile> m_file;
+            std::vector<double> m_time {};
+            std::vector<double> m_channel {};
+            std::vector<int64_t> m_beam_id {};
+            std::unordered_map<int64_t, size_t> m_beam_idx {};
+
+            char* base() const {
+                return reinterpret_cast<char*>(m_file->data());
+            }
+
+            size_t slab_index(const size_t time, const size_t channel) const {
+                if (time >= N_time()) {
+                    std::string msg = "Parameter[time] must lie in {0, ..., " + std::to_string(N_time()) + " - 1}.";
+                    throw std::runtime_error(msg);
+                }
+                if (channel >= N_channel()) {
+                    std::string msg = "Parameter[channel] must lie in {0, ..., " + std::to_string(N_channel()) + " - 1}.";
+                    throw std::runtime_error(msg);
+                }
+                return time * N_channel() + channel;
+            }
+
+            cTT* slab(const size_t time, const size_t channel) const {
+                return (reinterpret_cast<cTT*>(base() + m_header.offset_data) +
+                        slab_index(time, channel) * N_pair());
+            }
+
+            uint64_t* slab_flag(const size_t time, const size_t channel) const {
+                return (reinterpret_cast<uint64_t*>(base() + m_header.offset_flag) +
+                        slab_index(time, channel) * m_header.N_word);
+            }
+
+            static size_t file_size(const file_header &header) {
+                return header.offset_flag + (header.N_time * header.N_channel * header.N_word * sizeof(uint64_t));
+            }
+
+            void load(const bool writable) {
+                namespace mmap = pypeline::util::mmap;
+                m_file = std::make_shared<mmap::MappedFile>(m_path, (writable ?
+                                                                     mmap::access_mode::READ_WRITE :
+                                                                     mmap::access_mode::READ_ONLY));
+                std::string msg = "File '" + m_path + "' is not a VisibilityCache.";
+                if (m_file->size() < sizeof(file_header)) {
+                    throw std::runtime_error(msg);
+                }
+                std::memcpy(&m_header, base(), sizeof(file_header));
+                if (!std::equal(file_magic, file_magic + 8, m_header.magic) ||
+                    (m_header.version != file_version) ||
+                    (m_header.N_pair != m_header.N_beam * (m_header.N_beam + 1) / 2) ||
+                    (m_header.N_word != (m_header.N_pair + 63) / 64) ||
+                    (m_file->size() < file_size(m_header))) {
+                    throw std::runtime_error(msg);
+                }
+                if (m_header.itemsize != sizeof(TT)) {
+                    msg = ("File '" + m_path + "' stores " + std::to_string(8 * m_header.itemsize) +
+                           "-bit floats, but Type[TT] is " + std::to_string(8 * sizeof(TT)) + "-bit.");
+                    throw std::runtime_error(msg);
+                }
+
+                const double *time = reinterpret_cast<const double*>(base() + m_header.offset_time);
+                const double *channel = reinterpret_cast<const double*>(base() + m_header.offset_channel);
+                const int64_t *beam_id = reinterpret_cast<const int64_t*>(base() + m_header.offset_beam);
+                m_time.assign(time, time + N_time());
+                m_channel.assign(channel, channel + N_channel());
+                m_beam_id.assign(beam_id, beam_id + N_beam());
+
+                m_beam_idx.clear();
+                for (size_t i = 0; i < N_beam(); ++i) {
+                    m_beam_idx[m_beam_id[i]] = i;
+                }
+            }
+
+        public:
+            /*
+             * Open existing cache.
+             *
+             * Parameters
+             * ----------
+             * path : std::string
+             * writable : bool
+             *     If true, the cache can be filled with :cpp:func:`write`.
+             */
+            explicit VisibilityCache(const std::string &path,
+                                     const bool writable = false):
+                m_path(path) {
+                load(writable);
+            }
+
+            /*
+             * Create empty cache.
+             *
+             * All visibilities are initially 0 and flagged.
+             *
+             * Parameters
+             * ----------
+             * path : std::string
+             *     File to create. Existing files are overwritten.
+             * time : std::vector<double>
+             *     (N_time,) observation times.
+             * channel : std::vector<double>
+             *     (N_channel,) channel center frequencies [Hz].
+             * beam_id : std::vector<int64_t>
+             *     (N_beam,) distinct beam identifiers.
+             *     Their order defines the row/column order of visibility matrices.
+             *
+             * Returns
+             * -------
+             * C : VisibilityCache<TT>
+             *     Writable cache.
+             */
+            static VisibilityCache<TT> create(const std::string &path,
+                                              const std::vector<double> &time,
+                                              const std::vector<double> &channel,
+                                              const std::vector<int64_t> &beam_id) {
+                namespace mmap = pypeline::util::mmap;
+                if (time.empty() || channel.empty() || beam_id.empty()) {
+                    std::string msg = "Parameters[time, channel, beam_id] cannot be empty.";
+                    throw std::runtime_error(msg);
+                }
+                std::vector<int64_t> unique_id(beam_id);
+                std::sort(unique_id.begin(), unique_id.end());
+                if (std::adjacent_find(unique_id.begin(), unique_id.end()) != unique_id.end()) {
+                    std::string msg = "Parameter[beam_id] must contain distinct values.";
+                    throw std::runtime_error(msg);
+                }
+
+                file_header header {};
+                std::copy(file_magic, file_magic + 8, header.magic);
+                header.version = file_version;
+                header.itemsize = sizeof(TT);
+                header.N_time = time.size();
+                header.N_channel = channel.size();
+                header.N_beam = beam_id.size();
+                header.N_pair = header.N_beam * (header.N_beam + 1) / 2;
+                header.N_word = (header.N_pair + 63) / 64;
+                header.offset_time = mmap::align_up(sizeof(file_header), 64);
+                header.offset_channel = mmap::align_up(header.offset_time + header.N_time * sizeof(double), 64);
+                header.offset_beam = mmap::align_up(header.offset_channel + header.N_channel * sizeof(double), 64);
+                header.offset_data = mmap::align_up(header.offset_beam + header.N_beam * sizeof(int64_t), 4096);
+                header.offset_flag = mmap::align_up(header.offset_data + (header.N_time * header.N_channel *
+                                                                          header.N_pair * sizeof(cTT)), 64);
+
+                {  // Data section is left sparse: ftruncate() zero-fills it.
+                    mmap::MappedFile file(path, mmap::access_mode::CREATE, file_size(header));
+                    char *ptr = reinterpret_cast<char*>(file.data());
+                    std::memcpy(ptr, &header, sizeof(file_header));
+                    std::memcpy(ptr + header.offset_time, time.data(), time.size() * sizeof(double));
+                    std::memcpy(ptr + header.offset_channel, channel.data(), channel.size() * sizeof(double));
+                    std::memcpy(ptr + header.offset_beam, beam_id.data(), beam_id.size() * sizeof(int64_t));
+                    std::memset(ptr + header.offset_flag, 0xFF, file_size(header) - header.offset_flag);
+                    file.flush();
+                }
+
+                return VisibilityCache<TT>(path, true);
+            }
+
+            /*
+             * Store the visibilities of one time slot.
+             *
+             * Entries referencing beams outside the cache are ignored.
+             * Entries with beam_1[k] > beam_2[k] are stored conjugated at (beam_2[k], beam_1[k]).
+             * Flagged entries are stored as 0.
+             *
+             * Parameters
+             * ----------
+             * time : size_t
+             *     Time index.
+             * N_entry : size_t
+             *     Number of rows in the MAIN table at this time.
+             * beam_1 : const int64_t*
+             *     (N_entry,) first beam identifier of each row.
+             * beam_2 : const int64_t*
+             *     (N_entry,) second beam identifier of each row.
+             * data : const std::complex<TT>*
+             *     (N_entry, N_channel) row-major visibilities.
+             * flag : const bool*
+             *     (N_entry, N_channel) row-major flags.
+             */
+            void write(const size_t time,
+                       const size_t N_entry,
+                       const int64_t *beam_1,
+                       const int64_t *beam_2,
+                       const cTT *data,
+                       const bool *flag) {
+                if (!m_file->writable()) {
+                    std::string msg = "Cache '" + m_path + "' was opened read-only.";
+                    throw std::runtime_error(msg);
+                }
+                slab_index(time, 0);
+
+                // (row -> pair) map shared by all channels.
+                std::vector<int64_t> pair(N_entry, -1);
+                std::vector<bool> swap(N_entry, false);
+                for (size_t k = 0; k < N_entry; ++k) {
+                    auto it_1 = m_beam_idx.find(beam_1[k]);
+                    auto it_2 = m_beam_idx.find(beam_2[k]);
+                    if ((it_1 != m_beam_idx.end()) && (it_2 != m_beam_idx.end())) {
+                        const size_t i = std::min(it_1->second, it_2->second);
+                        const size_t j = std::max(it_1->second, it_2->second);
+                        pair[k] = static_cast<int64_t>(pair_index(i, j));
+                        swap[k] = (it_1->second > it_2->second);
+                    }
+                }
+
+                const size_t N_ch = N_channel();
+                for (size_t c = 0; c < N_ch; ++c) {
+                    cTT *d = slab(time, c);
+                    uint64_t *f = slab_flag(time, c);
+                    for (size_t k = 0; k < N_entry; ++k) {
+                        if (pair[k] < 0) { continue; }
+
+                        const size_t p = static_cast<size_t>(pair[k]);
+                        const uint64_t bit = uint64_t(1) << (p % 64);
+                        if (flag[k * N_ch + c]) {
+                            d[p] = 0;
+                            f[p / 64] |= bit;
+                        } else {
+                            const cTT &v = data[k * N_ch + c];
+                            d[p] = (swap[k] ? std::conj(v) : v);
+                            f[p / 64] &= ~bit;
+                        }
+                    }
+                }
+            }
+
+            /*
+             * Synchronously write pending changes to disk.
+             */
+            void flush() {
+                m_file->flush();
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * i : size_t
+             * j : size_t
+             *     Beam indices with i <= j.
+             *
+             * Returns
+             * -------
+             * p : size_t
+             *     Position of beam pair (i, j) along the last axis of the data section.
+             */
+            size_t pair_index(const size_t i, const size_t j) const {
+                return i * N_beam() - (i * (i - 1)) / 2 + (j - i);
+            }
+
+            /*
+             * Gather a visibility matrix.
+             *
+             * Parameters
+             * ----------
+             * time : size_t
+             * channel : size_t
+             * beam_id : std::vector<int64_t>
+             *     (N_beam_sel,) beams to extract, in output order.
+             *     If empty, all beams are extracted in cache order.
+             *
+             * Returns
+             * -------
+             * S : MatrixXX_t<std::complex<TT>>
+             *     (N_beam_sel, N_beam_sel) Hermitian visibility matrix.
+             *
+             * Notes
+             * -----
+             * Thread-safe: matrices can be gathered concurrently.
+             */
+            MatrixXX_t<cTT> visibility(const size_t time,
+                                       const size_t channel,
+                                       const std::vector<int64_t> &beam_id = {}) const {
+                const cTT *d = slab(time, channel);
+
+                if (beam_id.empty()) {  // Rows of the upper-triangle are contiguous.
+                    const size_t N = N_beam();
+                    MatrixXX_t<cTT> S(N, N);
+                    for (size_t i = 0; i < N; ++i) {
+                        std::copy(d + pair_index(i, i), d + pair_index(i, i) + (N - i), S.data() + i * N + i);
+                    }
+                    S.template triangularView<Eigen::StrictlyLower>() = S.adjoint();
+                    return S;
+                }
+
+                const size_t N = beam_id.size();
+                std::vector<size_t> idx(N);
+                for (size_t i = 0; i < N; ++i) {
+                    idx[i] = beam_index(beam_id[i]);
+                }
+
+                MatrixXX_t<cTT> S(N, N);
+                for (size_t i = 0; i < N; ++i) {
+                    for (size_t j = i; j < N; ++j) {
+                        const size_t a = idx[i], b = idx[j];
+                        S(i, j) = ((a <= b) ? d[pair_index(a, b)] : std::conj(d[pair_index(b, a)]));
+                    }
+                }
+                S.template triangularView<Eigen::StrictlyLower>() = S.adjoint();
+                return S;
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * time : size_t
+             * channel : size_t
+             *
+             * Returns
+             * -------
+             * data : const std::complex<TT>*
+             *     (N_pair,) upper-triangular visibilities, referencing the mapped file.
+             *     Only valid while :cpp:func:`mapping` is alive.
+             */
+            const cTT* data(const size_t time, const size_t channel) const {
+                return slab(time, channel);
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * time : size_t
+             * channel : size_t
+             *
+             * Returns
+             * -------
+             * flag : const uint64_t*
+             *     (N_word,) bitmap of flagged pairs, referencing the mapped file.
+             *     Bit (p % 64) of word (p / 64) is set if pair p is flagged.
+             *     Only valid while :cpp:func:`mapping` is alive.
+             */
+            const uint64_t* flag(const size_t time, const size_t channel) const {
+                return slab_flag(time, channel);
+            }
+
+            /*
+             * Returns
+             * -------
+             * mapping : std::shared_ptr<void>
+             *     Handle keeping the file mapping (hence :cpp:func:`data` and :cpp:func:`flag`) alive.
+             */
+            std::shared_ptr<void> mapping() const {
+                return m_file;
+            }
+
+            /*
+             * Parameters
+             * ----------
+             * beam_id : int64_t
+             *
+             * Returns
+             * -------
+             * idx : size_t
+             *     Row/column of `beam_id` in full visibility matrices.
+             */
+            size_t beam_index(const int64_t beam_id) const {
+                auto it = m_beam_idx.find(beam_id);
+                if (it == m_beam_idx.end()) {
+                    std::string msg = "Beam " + std::to_string(beam_id) + " is not part of cache '" + m_path + "'.";
+                    throw std::runtime_error(msg);
+                }
+                return it->second;
+            }
+
+            const std::vector<double>& time() const {
+                return m_time;
+            }
+
+            const std::vector<double>& channel() const {
+                return m_channel;
+            }
+
+            const std::vector<int64_t>& beam_id() const {
+                return m_beam_id;
+            }
+
+            size_t N_time() const {
+                return m_header.N_time;
+            }
+
+            size_t N_channel() const {
+                return m_header.N_channel;
+            }
+
+            size_t N_beam() const {
+                return m_header.N_beam;
+            }
+
+            size_t N_pair() const {
+                return m_header.N_pair;
+            }
+
+            size_t N_word() const {
+                return m_header.N_word;
+            }
+
+            const std::string& path() const {
+                return m_path;
+            }
+    };
+
+    template <typename TT>
+    constexpr char VisibilityCache<TT>::file_magic[8];
+
+    inline size_t itemsize(const std::string &path) {
+        namespace mmap = pypeline::util::mmap;
+        mmap::MappedFile file(path, mmap::access_mode::READ_ONLY);
+        const char *base = reinterpret_cast<const char*>(file.data());
+        // (magic, version, itemsize) prefix shared by all versions.
+        if ((file.size() < 16) || (std::strncmp(base, "PYPLVIS", 8) != 0)) {
+            std::string msg = "File '" + path + "' is not a VisibilityCache.";
+            throw std::runtime_error(msg);
+        }
+        uint32_t N;
+        std::memcpy(&N, base + 12, sizeof(uint32_t));
+        return N;
+    }
+}}}}}
+
+#endif //PYPELINE_PHASED_ARRAY_UTIL_IO_MS_HPP
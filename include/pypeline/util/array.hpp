@@ -16,9 +16,13 @@
 #include <string>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "eigen3/Eigen/Eigen"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xstrided_view.hpp"
 
 namespace pypeline { namespace util { namespace array {
     /*
@@ -73,6 +77,228 @@ namespace pypeline { namespace util { namespace array {
         return idx_struct;
     }
 
+    /*
+     * Scatter-add engine behind :cpp:func:`cluster_layers_augment`.
+     *
+     * Source layers are grouped by destination once at construction time, so
+     * that every destination layer is owned by a single thread during
+     * clustering.
+     * Tensors are seen as (N_outer, K, N_inner) cubes laid out in row-major
+     * order, where K is the length of the compression axis: each
+     * (outer, destination) pair is an independent task made of contiguous
+     * length-N_inner vector additions.
+     * When the compression axis is outermost, N_outer = 1 and each task adds
+     * entire layers together.
+     *
+     * Tasks are distributed over threads with OpenMP when available.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include <vector>
+     *    #include "pypeline/util/array.hpp"
+     *
+     *    namespace array = pypeline::util::array;
+     *
+     *    const std::vector<size_t> idx {0, 1, 1};
+     *    const size_t N = 2, N_inner = 4;
+     *    std::vector<double> x(idx.size() * N_inner, 1), y(N * N_inner, 0);
+     *    std::vector<double> w {1, 2, 3};
+     *
+     *    array::LayerClusterer clusterer(idx, N);
+     *    clusterer.augment(x.data(), y.data(), 1, N_inner);             // y = {1, 1, 1, 1, 2, 2, 2, 2}
+     *    clusterer.augment(x.data(), y.data(), 1, N_inner, w.data());  // y = {2, 2, 2, 2, 7, 7, 7, 7}
+     */
+    class LayerClusterer {
+        private:
+            size_t m_N = 0;
+            size_t m_K = 0;
+            std::vector<size_t> m_offset {};  // (N + 1,) m_source[m_offset[n]:m_offset[n + 1]] map to layer n.
+            std::vector<size_t> m_source {};  // (K,) source layers, sorted by destination.
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * idx : std::vector<size_t>
+             *     (K,) cluster indices.
+             * N : size_t
+             *     Total number of levels along compression axis.
+             */
+            LayerClusterer(const std::vector<size_t> &idx, const size_t N):
+                m_N(N), m_K(idx.size()), m_offset(N + 1, 0), m_source(idx.size()) {
+                if (N == 0) {
+                    std::string msg = "Parameter[N] must be non-zero.";
+                    throw std::runtime_error(msg);
+                }
+                for (size_t k = 0; k < m_K; ++k) {
+                    if (idx[k] >= N) {
+                        std::string msg = "Parameter[idx] contains out-of-bound entries w.r.t Parameter[N].";
+                        throw std::runtime_error(msg);
+                    }
+                    m_offset[idx[k] + 1] += 1;
+                }
+
+                // Counting sort of source layers by destination.
+                for (size_t n = 0; n < N; ++n) {
+                    m_offset[n + 1] += m_offset[n];
+                }
+                std::vector<size_t> cursor(m_offset.begin(), m_offset.end() - 1);
+                for (size_t k = 0; k < m_K; ++k) {
+                    m_source[cursor[idx[k]]++] = k;
+                }
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Total number of levels along compression axis.
+             */
+            size_t N() const {
+                return m_N;
+            }
+
+            /*
+             * Returns
+             * -------
+             * K : size_t
+             *     Number of source layers.
+             */
+            size_t K() const {
+                return m_K;
+            }
+
+            /*
+             * Compute ``buffer[o, idx[k], :] += weights[k] * x[o, k, :]``.
+             *
+             * Parameters
+             * ----------
+             * x : const T*
+             *     (N_outer, K, N_inner) row-major tensor.
+             * buffer : T*
+             *     (N_outer, N, N_inner) row-major tensor to increment.
+             * N_outer : size_t
+             *     Product of dimensions before the compression axis.
+             * N_inner : size_t
+             *     Product of dimensions after the compression axis.
+             * weights : const T*
+             *     (K,) per-layer weights.
+             *     If :cpp:`nullptr` (default), layers are added without scaling.
+             */
+            template <typename T>
+            void augment(const T *x,
+                         T *buffer,
+                         const size_t N_outer,
+                         const size_t N_inner,
+                         const T *weights = nullptr) const {
+                using vector_t = Eigen::Array<T, Eigen::Dynamic, 1>;
+                const long N_task = static_cast<long>(N_outer * m_N);
+
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (long task = 0; task < N_task; ++task) {
+                    const size_t o = static_cast<size_t>(task) / m_N;
+                    const size_t n = static_cast<size_t>(task) % m_N;
+                    if (m_offset[n] == m_offset[n + 1]) {
+                        continue;
+                    }
+
+                    Eigen::Map<vector_t> y(buffer + (o * m_N + n) * N_inner, N_inner);
+                    for (size_t s = m_offset[n]; s < m_offset[n + 1]; ++s) {
+                        const size_t k = m_source[s];
+                        Eigen::Map<const vector_t> x_k(x + (o * m_K + k) * N_inner, N_inner);
+                        if (weights == nullptr) {
+                            y += x_k;
+                        } else {
+                            y += weights[k] * x_k;
+                        }
+                    }
+                }
+            }
+    };
+
+    /*
+     * Determine if an array's memory can be accessed directly.
+     *
+     * Holds for containers and adaptors exposing both :cpp:`data()` and
+     * :cpp:`strides()`, but not for lazy xexpressions.
+     */
+    template <typename E, typename = void>
+    struct has_raw_memory : std::false_type {};
+
+    template <typename E>
+    struct has_raw_memory<E, decltype(std::declval<E&>().data(),
+                                      std::declval<E&>().strides(),
+                                      void())> : std::true_type {};
+
+    /*
+     * Return true if array is stored contiguously in row-major order.
+     *
+     * Axes of length 1 are ignored since their strides are arbitrary.
+     *
+     * Parameters
+     * ----------
+     * x : xt::xcontainer
+     *     Array to test. Must satisfy :cpp:class:`has_raw_memory`.
+     *
+     * Returns
+     * -------
+     * is_contiguous : bool
+     */
+    template <typename E>
+    bool is_row_major_contiguous(E &&x) {
+        const auto& shape = x.shape();
+        const auto& strides = x.strides();
+
+        size_t stride = 1;
+        for (size_t i = x.dimension(); i-- > 0;) {
+            const size_t len_dim = static_cast<size_t>(shape[i]);
+            if (len_dim != 1) {
+                if (static_cast<size_t>(strides[i]) != stride) {
+                    return false;
+                }
+                stride *= len_dim;
+            }
+        }
+        return true;
+    }
+
+    template <typename E, typename F, typename T>
+    bool cluster_layers_augment_raw(E &x,
+                                    const LayerClusterer &clusterer,
+                                    const size_t axis,
+                                    F *buffer,
+                                    const T *weights,
+                                    std::true_type) {
+        if (!(is_row_major_contiguous(x) && is_row_major_contiguous(*buffer))) {
+            return false;
+        }
+
+        size_t N_outer = 1, N_inner = 1;
+        for (size_t i = 0; i < axis; ++i) {
+            N_outer *= static_cast<size_t>(x.shape()[i]);
+        }
+        for (size_t i = axis + 1; i < x.dimension(); ++i) {
+            N_inner *= static_cast<size_t>(x.shape()[i]);
+        }
+
+        clusterer.augment(x.data(), buffer->data(), N_outer, N_inner, weights);
+        return true;
+    }
+
+    template <typename E, typename F, typename T>
+    bool cluster_layers_augment_raw(E &,
+                                    const LayerClusterer &,
+                                    const size_t,
+                                    F *,
+                                    const T *,
+                                    std::false_type) {
+        return false;
+    }
+
     /*
      * Additive tensor compression along an axis.
      *
@@ -88,6 +314,15 @@ namespace pypeline { namespace util { namespace array {
      *     Dimension along which to compress.
      * buffer : *xt::xexpression
      *     (..., N, ...) array to increment.
+     * weights : std::vector<T>
+     *     (K,) per-layer weights, where T is the dtype of `x`.
+     *     If empty (default), layers are added without scaling.
+     *
+     * Notes
+     * -----
+     * If `x` and `buffer` are row-major contiguous containers, compression is
+     * done by :cpp:class:`LayerClusterer` directly on their memory.
+     * Otherwise a (slower) strided-view implementation is used.
      *
      * Examples
      * --------
@@ -111,13 +346,18 @@ namespace pypeline { namespace util { namespace array {
      *
      *    array_t y = xt::zeros<T>({5, 4, 5});
      *    array::cluster_layers_augment(x, idx, N, axis, &y);
+     *
+     *    // Same, but scale each layer of `x` beforehand.
+     *    const std::vector<T> w {1, 0.5, 0.25};
+     *    array::cluster_layers_augment(x, idx, N, axis, &y, w);
      */
     template <typename E, typename F>
     void cluster_layers_augment(E &&x,
                                 std::vector<size_t> idx,
                                 const size_t N,
                                 const size_t axis,
-                                F *buffer) {
+                                F *buffer,
+                                const std::vector<typename std::decay_t<E>::value_type> &weights = {}) {
         if (N == 0) {
             std::string msg = "Parameter[N] must be non-zero.";
             throw std::runtime_error(msg);
@@ -137,6 +377,10 @@ namespace pypeline { namespace util { namespace array {
             std::string msg = "Parameter[idx] contains out-of-bound entries w.r.t Parameter[N].";
             throw std::runtime_error(msg);
         }
+        if (!(weights.empty() || (weights.size() == idx.size()))) {
+            std::string msg = "Parameters[idx, weights] must have the same length.";
+            throw std::runtime_error(msg);
+        }
 
         using TE = typename std::decay_t<E>::value_type;
         using TF = typename std::decay_t<F>::value_type;
@@ -151,6 +395,15 @@ namespace pypeline { namespace util { namespace array {
             throw std::runtime_error(msg);
         }
 
+        const TE *w = (weights.empty() ? nullptr : weights.data());
+        const LayerClusterer clusterer(idx, N);
+        using raw_memory_t = std::integral_constant<bool,
+                                                    has_raw_memory<std::decay_t<E>>::value &&
+                                                    has_raw_memory<F>::value>;
+        if (cluster_layers_augment_raw(x, clusterer, axis, buffer, w, raw_memory_t())) {
+            return;
+        }
+
         for (size_t i = 0; i < idx.size(); ++i) {
             auto idx_x = index(x.dimension(), axis, i);
             auto view_x = xt::strided_view(x, idx_x);
@@ -158,7 +411,11 @@ namespace pypeline { namespace util { namespace array {
             auto idx_buffer = index(buffer->dimension(), axis, idx[i]);
             auto view_buffer = xt::strided_view(*buffer, idx_buffer);
 
-            view_buffer.plus_assign(view_x);
+            if (w == nullptr) {
+                view_buffer.plus_assign(view_x);
+            } else {
+                view_buffer.plus_assign(w[i] * view_x);
+            }
         }
     }
 
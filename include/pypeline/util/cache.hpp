@@ -0,0 +1,448 @@
+// ############################################################################
+// cache.hpp
+// =========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Persistent, content-addressed caches.
+ */
+
+#ifndef PYPELINE_UTIL_CACHE_HPP
+#define PYPELINE_UTIL_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "pypeline/util/mmap.hpp"
+
+namespace pypeline { namespace util { namespace cache {
+    /*
+     * Read-only view of a cached blob, mapped from its file.
+     *
+     * Blob files are never modified once written, only replaced or deleted:
+     * the view stays valid for as long as it is held, even if the blob is
+     * evicted or overwritten meanwhile.
+     * Objects are move-only. Default-constructed views are empty (cache misses).
+     */
+    class Blob {
+        private:
+            std::unique_ptr<pypeline::util::mmap::MappedFile> m_file = nullptr;
+            const void *m_data = nullptr;
+            size_t m_size = 0;
+
+        public:
+            Blob() = default;
+
+            Blob(std::unique_ptr<pypeline::util::mmap::MappedFile> file,
+                 const size_t offset,
+                 const size_t size):
+                m_file(std::move(file)), m_size(size) {
+                m_data = reinterpret_cast<const char*>(m_file->data()) + offset;
+            }
+
+            /*
+             * Returns
+             * -------
+             * hit : bool
+             *     true if the view holds a blob.
+             */
+            explicit operator bool() const {
+                return m_file != nullptr;
+            }
+
+            /*
+             * Returns
+             * -------
+             * data : const void*
+             *     Start of the blob, or nullptr if empty.
+             */
+            const void* data() const {
+                return m_data;
+            }
+
+            /*
+             * Returns
+             * -------
+             * size : size_t
+             *     Size [bytes] of the blob.
+             */
+            size_t size() const {
+                return m_size;
+            }
+    };
+
+    /*
+     * Directory of binary blobs addressed by the content of their key.
+     *
+     * A key is an arbitrary byte string describing all inputs of the
+     * computation that produced a blob: equal keys imply equal blobs.
+     * Blobs are stored in `<directory>/<hash(key)>.pcache` together with
+     * their key, which is compared in full on lookup (hash collisions are
+     * misses).
+     *
+     * The directory is kept under a size budget: after every insertion,
+     * least-recently used blobs are deleted until the budget is met.
+     * Truncated or otherwise invalid files are deleted on lookup.
+     *
+     * The cache is best-effort: I/O failures during insertion leave the
+     * cache unchanged, and are reported by return values, not exceptions.
+     * Several processes can share a directory: blobs are written to
+     * temporary files, then renamed. Temporary files count towards the
+     * budget, and those left behind by processes which died while writing
+     * are deleted by evict().
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/util/cache.hpp"
+     *
+     *    namespace cache = pypeline::util::cache;
+     *
+     *    cache::FileCache C("/tmp/pypeline_cache", size_t(4) << 30);  // 4 GiB
+     *
+     *    std::vector<double> x(1000);
+     *    const std::string key = "sin(linspace(0, 1, 1000))";
+     *    if (!C.load(key, x.data(), x.size() * sizeof(double))) {
+     *        // ... compute x ...
+     *        C.store(key, x.data(), x.size() * sizeof(double));
+     *    }
+     *
+     *    // Without copy: view of the blob's file.
+     *    cache::Blob blob = C.load(key, x.size() * sizeof(double));
+     *    if (blob) {
+     *        const double *y = reinterpret_cast<const double*>(blob.data());
+     *    }
+     */
+    class FileCache {
+        private:
+            struct file_header {
+                char magic[8];
+                uint32_t version;
+                uint32_t reserved;
+                uint64_t N_key;
+                uint64_t N_data;
+                uint64_t offset_key;
+                uint64_t offset_data;
+            };
+
+            static constexpr const char *file_suffix = ".pcache";
+
+            std::string m_dir {};
+            size_t m_budget = 0;
+
+            static const char* file_magic() {
+                return "PYPLBLB";
+            }
+
+            static uint64_t hash(const std::string &key) {
+                uint64_t h = 14695981039346656037ull;  // FNV-1a
+                for (const char c : key) {
+                    h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+                }
+                return h;
+            }
+
+            std::string path(const std::string &key) const {
+                char name[17];
+                std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash(key)));
+                return m_dir + "/" + name + file_suffix;
+            }
+
+            static size_t file_size(const file_header &header) {
+                return header.offset_data + header.N_data;
+            }
+
+            /*
+             * true if key and data sections lie within a file of `size` bytes.
+             * Sizes come from untrusted headers: sums are checked before they can overflow.
+             */
+            static bool fits(const file_header &header, const size_t size) {
+                return ((header.offset_key >= sizeof(file_header)) &&
+                        (header.offset_key <= size) && (header.N_key <= size - header.offset_key) &&
+                        (header.offset_data <= size) && (header.N_data <= size - header.offset_data));
+            }
+
+            static bool has_suffix(const std::string &name) {
+                const size_t N = std::strlen(file_suffix);
+                return (name.size() > N) && (name.compare(name.size() - N, N, file_suffix) == 0);
+            }
+
+            /*
+             * true if `name` is a temporary file of store(), i.e. `<hash>.pcache.tmp<pid>_<n>`.
+             * Its writer's process ID is then written to `pid`.
+             */
+            static bool is_tmp(const std::string &name, pid_t &pid) {
+                const std::string tag = std::string(file_suffix) + ".tmp";
+                const size_t at = name.find(tag);
+                if ((at == std::string::npos) || (at == 0)) {
+                    return false;
+                }
+                try {
+                    pid = static_cast<pid_t>(std::stol(name.substr(at + tag.size())));
+                } catch (const std::exception&) {
+                    return false;
+                }
+                return true;
+            }
+
+            /*
+             * true if the temporary file of writer `pid`, last modified at
+             * `mtime`, will never be renamed.
+             *
+             * Writers in other PID namespaces (containers, other hosts sharing
+             * the directory) cannot be probed: their files are only stale once
+             * left untouched for an hour.
+             */
+            static bool is_stale(const pid_t pid, const time_t mtime) {
+                const double age = std::difftime(std::time(nullptr), mtime);
+                const bool dead = (kill(pid, 0) != 0) && (errno == ESRCH);
+                return (dead && (age > 60)) || (age > 3600);
+            }
+
+            /*
+             * Scan the directory.
+             *
+             * Parameters
+             * ----------
+             * total : size_t&
+             *     Size [bytes] of all blobs and temporary files.
+             * sweep : bool
+             *     Delete stale temporary files (and do not count them).
+             *
+             * Returns
+             * -------
+             * entry : std::vector<std::tuple<time_t, size_t, std::string>>
+             *     (last use, size, path) of all blobs.
+             */
+            std::vector<std::tuple<time_t, size_t, std::string>> scan(size_t &total,
+                                                                      const bool sweep) const {
+                std::vector<std::tuple<time_t, size_t, std::string>> entry;
+                total = 0;
+                DIR *dir = opendir(m_dir.c_str());
+                if (dir == nullptr) {
+                    return entry;
+                }
+
+                for (struct dirent *e = readdir(dir); e != nullptr; e = readdir(dir)) {
+                    const std::string name(e->d_name);
+                    const std::string file_path = m_dir + "/" + name;
+                    pid_t pid = 0;
+                    struct stat info;
+                    if (has_suffix(name)) {
+                        if (stat(file_path.c_str(), &info) == 0) {
+                            entry.emplace_back(info.st_mtime, static_cast<size_t>(info.st_size), file_path);
+                            total += static_cast<size_t>(info.st_size);
+                        }
+                    } else if (is_tmp(name, pid) && (stat(file_path.c_str(), &info) == 0)) {
+                        if (!(sweep && is_stale(pid, info.st_mtime) && (unlink(file_path.c_str()) == 0))) {
+                            total += static_cast<size_t>(info.st_size);
+                        }
+                    }
+                }
+                closedir(dir);
+                return entry;
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * directory : std::string
+             *     Cache directory. Created if absent.
+             * budget : size_t
+             *     Maximum size [bytes] of the directory's content.
+             */
+            FileCache(const std::string &directory,
+                      const size_t budget):
+                m_dir(directory), m_budget(budget) {
+                if ((mkdir(directory.c_str(), 0755) != 0) && (errno != EEXIST)) {
+                    std::string msg = "Could not create directory '" + directory + "': " + std::strerror(errno);
+                    throw std::runtime_error(msg);
+                }
+
+                struct stat info;
+                if ((stat(directory.c_str(), &info) != 0) || !S_ISDIR(info.st_mode)) {
+                    std::string msg = "Parameter[directory] must be a directory.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Map the blob associated with `key`.
+             *
+             * Parameters
+             * ----------
+             * key : std::string
+             * size : size_t
+             *     Expected blob size [bytes].
+             *
+             * Returns
+             * -------
+             * blob : Blob
+             *     Read-only view of the blob, empty if the cache holds no such blob.
+             */
+            Blob load(const std::string &key, const size_t size) const {
+                namespace mmap = pypeline::util::mmap;
+                const std::string file_path = path(key);
+                if (access(file_path.c_str(), R_OK) != 0) {
+                    return Blob();
+                }
+
+                Blob blob;
+                try {
+                    auto file = std::make_unique<mmap::MappedFile>(file_path, mmap::access_mode::READ_ONLY);
+                    const char *base = reinterpret_cast<const char*>(file->data());
+
+                    file_header header;
+                    bool valid = (file->size() >= sizeof(file_header));
+                    if (valid) {
+                        std::memcpy(&header, base, sizeof(file_header));
+                        valid = ((std::strncmp(header.magic, file_magic(), 8) == 0) &&
+                                 fits(header, file->size()) &&
+                                 (header.N_key == key.size()) &&
+                                 (std::memcmp(base + header.offset_key, key.data(), key.size()) == 0));
+                    }
+                    if (!valid) {  // Corrupt file, or hash collision: the newer blob wins.
+                        unlink(file_path.c_str());
+                        return Blob();
+                    }
+                    if (header.N_data != size) {
+                        return Blob();
+                    }
+                    blob = Blob(std::move(file), header.offset_data, size);
+                } catch (const std::runtime_error&) {  // File vanished (concurrent eviction), ...
+                    return Blob();
+                }
+
+                utimes(file_path.c_str(), nullptr);  // Most-recently used.
+                return blob;
+            }
+
+            /*
+             * Copy the blob associated with `key` to `out`.
+             *
+             * Parameters
+             * ----------
+             * key : std::string
+             * out : void*
+             *     Buffer of `size` bytes.
+             * size : size_t
+             *     Expected blob size [bytes].
+             *
+             * Returns
+             * -------
+             * hit : bool
+             *     false if the cache holds no such blob, in which case `out` is unchanged.
+             */
+            bool load(const std::string &key, void *out, const size_t size) const {
+                const Blob blob = load(key, size);
+                if (blob) {
+                    std::memcpy(out, blob.data(), size);
+                }
+                return static_cast<bool>(blob);
+            }
+
+            /*
+             * Associate `key` with the blob [data, data + size).
+             *
+             * Returns
+             * -------
+             * stored : bool
+             *     false if the blob exceeds the budget or could not be written.
+             */
+            bool store(const std::string &key, const void *data, const size_t size) {
+                namespace mmap = pypeline::util::mmap;
+
+                file_header header {};
+                std::strncpy(header.magic, file_magic(), 8);
+                header.version = 1;
+                header.N_key = key.size();
+                header.N_data = size;
+                header.offset_key = mmap::align_up(sizeof(file_header), 64);
+                header.offset_data = mmap::align_up(header.offset_key + header.N_key, 4096);
+                if ((size > m_budget) || (key.size() > m_budget) || (file_size(header) > m_budget)) {
+                    return false;
+                }
+
+                const std::string file_path = path(key);
+                static std::atomic<uint64_t> N_store {0};
+                const std::string tmp_path = (file_path + ".tmp" + std::to_string(getpid()) +
+                                              "_" + std::to_string(N_store++));
+                try {
+                    mmap::MappedFile file(tmp_path, mmap::access_mode::CREATE, file_size(header));
+                    char *base = reinterpret_cast<char*>(file.data());
+                    std::memcpy(base, &header, sizeof(file_header));
+                    std::memcpy(base + header.offset_key, key.data(), key.size());
+                    std::memcpy(base + header.offset_data, data, size);
+                    file.flush();
+                } catch (const std::runtime_error&) {
+                    unlink(tmp_path.c_str());
+                    return false;
+                }
+                if (std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+                    unlink(tmp_path.c_str());
+                    return false;
+                }
+
+                evict();
+                return true;
+            }
+
+            /*
+             * Delete stale temporary files, then least-recently used blobs until the budget is met.
+             */
+            void evict() {
+                size_t total = 0;
+                auto entry = scan(total, true);
+
+                std::sort(entry.begin(), entry.end());
+                for (auto it = entry.begin(); (total > m_budget) && (it != entry.end()); ++it) {
+                    if (unlink(std::get<2>(*it).c_str()) == 0) {
+                        total -= std::get<1>(*it);
+                    }
+                }
+            }
+
+            /*
+             * Returns
+             * -------
+             * size : size_t
+             *     Current size [bytes] of the cache's content, temporary files included.
+             */
+            size_t size() const {
+                size_t total = 0;
+                scan(total, false);
+                return total;
+            }
+
+            size_t budget() const {
+                return m_budget;
+            }
+
+            const std::string& directory() const {
+                return m_dir;
+            }
+    };
+}}}
+
+#endif //PYPELINE_UTIL_CACHE_HPP
@@ -12,6 +12,8 @@
 #define PYPELINE_UTIL_CPP_PY3_INTEROP_HPP
 
 #include <algorithm>
+#include <complex>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -96,6 +98,9 @@ namespace pypeline { namespace util { namespace cpp_py3_interop {
     auto xtensor_to_numpy(E &&_x, bool take_ownership = true) {
         using EE = typename std::decay_t<E>;
         using T = typename EE::value_type;
+        static_assert(!(std::is_rvalue_reference<E&&>::value &&
+                        std::is_const<std::remove_reference_t<E>>::value),
+                      "Moving from a const tensor deep-copies it: drop the const qualifier at the call site.");
 
         /*
          * pybind11::array_t<T>() used below takes ownership of
@@ -166,6 +171,47 @@ namespace pypeline { namespace util { namespace cpp_py3_interop {
         }
     }
 
+    /*
+     * Reference C++ tensor from Python3 as NumPy array whose lifetime is tied to a Python object.
+     *
+     * Useful to expose buffers owned by a bound C++ instance: the NumPy view
+     * holds a reference to `base`, hence the instance cannot be
+     * garbage-collected while the view is alive.
+     *
+     * Parameters
+     * ----------
+     * x : xexpression
+     *     C++ tensor with contiguous or strided memory.
+     * base : pybind11::handle
+     *     Python object owning `x`'s memory.
+     * writable : bool
+     *     If false, the NumPy view is flagged read-only.
+     *
+     * Returns
+     * -------
+     * x : pybind11::array_t<T>
+     */
+    template <typename E>
+    auto xtensor_to_numpy(E &&x, pybind11::handle base, bool writable) {
+        using EE = typename std::decay_t<E>;
+        using T = std::remove_const_t<typename EE::value_type>;
+
+        std::vector<ssize_t> shape_x(x.dimension());
+        std::copy(x.shape().begin(), x.shape().end(), shape_x.begin());
+
+        std::vector<ssize_t> strides_x(x.dimension());
+        for (size_t i = 0; i < x.dimension(); ++i) {
+            strides_x[i] = x.strides()[i] * sizeof(T);
+        }
+
+        const T *data = x.data();  // Read-only views: see `writable`.
+        auto x_py = pybind11::array_t<T>(shape_x, strides_x, data, base);
+        if (!writable) {
+            x_py.attr("setflags")(pybind11::arg("write") = false);
+        }
+        return x_py;
+    }
+
     /*
      * Reference NumPy array from C++ as Xtensor container.
      *
@@ -299,6 +345,185 @@ namespace pypeline { namespace util { namespace cpp_py3_interop {
         return xview;
     }
 
+    /*
+     * Compile-time type tag.
+     *
+     * Generic lambdas receive a `dtype_tag<T>` to know which scalar type they
+     * are instantiated for: `using T = typename decltype(tag)::type;`.
+     */
+    template <typename T>
+    struct dtype_tag {
+        using type = T;
+    };
+
+    /*
+     * Compile-time list of scalar types to instantiate bindings for.
+     */
+    template <typename... Ts>
+    struct dtype_list {};
+
+    using real_dtypes = dtype_list<float, double>;
+    using float_dtypes = dtype_list<float, double, std::complex<float>, std::complex<double>>;
+    using all_dtypes = dtype_list<int32_t, int64_t, uint32_t, uint64_t,
+                                  float, double, std::complex<float>, std::complex<double>>;
+
+    namespace _detail {
+        template <typename F, typename... Extra>
+        void def_dtypes(pybind11::module &, const char *, const char *,
+                        F &&, dtype_list<>, const Extra &...) {}
+
+        template <typename F, typename T, typename... Ts, typename... Extra>
+        void def_dtypes(pybind11::module &m, const char *name, const char *doc,
+                        F &&make, dtype_list<T, Ts...>, const Extra &... extra) {
+            if (sizeof...(Ts) == 0) {
+                m.def(name, make(dtype_tag<T>()), extra..., pybind11::doc(doc));
+            } else {
+                m.def(name, make(dtype_tag<T>()), extra...);
+            }
+            def_dtypes(m, name, doc, std::forward<F>(make), dtype_list<Ts...>(), extra...);
+        }
+    }
+
+    /*
+     * Register one overload of a function per scalar type.
+     *
+     * Overloads are tried in order by PyBind11: combined with `.noconvert()`
+     * arguments, NumPy arrays are dispatched to the overload matching their
+     * dtype without any casts/copies.
+     *
+     * Parameters
+     * ----------
+     * m : pybind11::module
+     * name : const char*
+     *     Python function name.
+     * dtypes : dtype_list<Ts...>
+     *     Scalar types to instantiate.
+     * make : callable
+     *     Generic functor mapping `dtype_tag<T>` to the function to bind.
+     * doc : const char*
+     *     Docstring, attached to the last overload.
+     * extra : pybind11::arg, ...
+     *     Argument specifications, shared by all overloads.
+     *
+     * Examples
+     * --------
+     * .. literal_block:: cpp
+     *
+     *    template <typename T>
+     *    void _test(pybind11::array_t<T> x) {
+     *        auto xview = cpp_py3_interop::numpy_to_xview<T>(x);
+     *        xview += T(1);
+     *    }
+     *
+     *    PYBIND11_MODULE(example, m) {
+     *        cpp_py3_interop::def_dtypes(m, "test", cpp_py3_interop::all_dtypes(),
+     *                                    [](auto tag) { return &_test<typename decltype(tag)::type>; },
+     *                                    "test(x)",
+     *                                    pybind11::arg("x").noconvert().none(false));
+     *    }
+     */
+    template <typename... Ts, typename F, typename... Extra>
+    void def_dtypes(pybind11::module &m, const char *name, dtype_list<Ts...> dtypes,
+                    F &&make, const char *doc, const Extra &... extra) {
+        _detail::def_dtypes(m, name, doc, std::forward<F>(make), dtypes, extra...);
+    }
+
+    /*
+     * Call generic functor on NumPy array, dispatching on its dtype at runtime.
+     *
+     * No copies are made: `f` receives a (possibly strided) view with the exact
+     * dtype of `x`.
+     *
+     * Parameters
+     * ----------
+     * x : pybind11::array
+     *     Array with dtype in {float32, float64, complex64, complex128}.
+     * f : callable
+     *     Generic functor `f(pybind11::array_t<T> x)`.
+     *     All instantiations must have the same return type, ex: void or pybind11::object.
+     *
+     * Returns
+     * -------
+     * out : return value of `f`.
+     */
+    template <typename F>
+    auto dispatch_dtype(pybind11::array x, F &&f) -> decltype(f(std::declval<pybind11::array_t<float>>())) {
+        if (pybind11::isinstance<pybind11::array_t<float>>(x)) {
+            return f(pybind11::array_t<float>::ensure(x));
+        } else if (pybind11::isinstance<pybind11::array_t<double>>(x)) {
+            return f(pybind11::array_t<double>::ensure(x));
+        } else if (pybind11::isinstance<pybind11::array_t<std::complex<float>>>(x)) {
+            return f(pybind11::array_t<std::complex<float>>::ensure(x));
+        } else if (pybind11::isinstance<pybind11::array_t<std::complex<double>>>(x)) {
+            return f(pybind11::array_t<std::complex<double>>::ensure(x));
+        } else {
+            std::string msg = ("Parameter[x] must have dtype {float32, float64, complex64, complex128}, not " +
+                               std::string(pybind11::str(x.dtype())) + ".");
+            throw std::runtime_error(msg);
+        }
+    }
+
+    /*
+     * Raw memory descriptor exported through the Python buffer protocol.
+     *
+     * Instances keep the object owning the memory alive, and are exposed to
+     * Python via :cpp:func:`buffer_view_bindings`: `memoryview(v)` or
+     * `numpy.asarray(v)` then reference the C++ memory directly.
+     */
+    struct buffer_view {
+        pybind11::object owner;
+        void *ptr = nullptr;
+        ssize_t itemsize = 0;
+        std::string format {};
+        std::vector<ssize_t> shape {};
+        std::vector<ssize_t> strides {};  // [bytes]
+        bool readonly = false;
+    };
+
+    /*
+     * Describe xtensor container memory as a :cpp:class:`buffer_view`.
+     *
+     * Parameters
+     * ----------
+     * x : xexpression
+     *     Container with raw memory, i.e. providing data() and strides().
+     * owner : pybind11::object
+     *     Python object owning `x`'s memory.
+     * writable : bool
+     */
+    template <typename E>
+    buffer_view make_buffer_view(E &&x, pybind11::object owner, const bool writable = true) {
+        using T = typename std::decay_t<E>::value_type;
+
+        buffer_view view;
+        view.owner = owner;
+        view.ptr = const_cast<void*>(reinterpret_cast<const void*>(x.data()));
+        view.itemsize = sizeof(T);
+        view.format = pybind11::format_descriptor<T>::format();
+        view.shape.assign(x.shape().begin(), x.shape().end());
+        for (size_t i = 0; i < x.dimension(); ++i) {
+            view.strides.push_back(x.strides()[i] * sizeof(T));
+        }
+        view.readonly = !writable;
+        return view;
+    }
+
+    /*
+     * Register :cpp:class:`buffer_view` in a module. Must be called once per module.
+     */
+    inline void buffer_view_bindings(pybind11::module &m, const char *class_name = "BufferView") {
+        pybind11::class_<buffer_view>(m, class_name, pybind11::buffer_protocol(), R"EOF(
+Zero-copy handle on C++ memory, exported through the buffer protocol.
+
+Use :py:class:`memoryview` or :py:func:`numpy.asarray` to access the data.
+)EOF")
+            .def_buffer([](buffer_view &view) {
+                return pybind11::buffer_info(view.ptr, view.itemsize, view.format,
+                                             static_cast<ssize_t>(view.shape.size()),
+                                             view.shape, view.strides, view.readonly);
+            });
+    }
+
     /*
      * Transform Python signed index to C++ unsigned index.
      *
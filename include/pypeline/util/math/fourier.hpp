@@ -35,6 +35,8 @@
 
 #include "pypeline/util/argcheck.hpp"
 #include "pypeline/util/array.hpp"
+#include "pypeline/util/runtime.hpp"
+#include "pypeline/util/simd.hpp"
 
 namespace pypeline { namespace util { namespace math { namespace fourier {
     enum class planning_effort: unsigned int {
@@ -304,7 +306,10 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
             size_t m_axis = 0;
             std::vector<size_t> m_shape {};
 
+            // FFTW threads are OpenMP threads (libfftw3_omp): without OpenMP,
+            // FFTW runs serially like the rest of Pypeline.
             void setup_threads(const size_t N_threads) {
+                #ifdef _OPENMP
                 if (is_float) {
                     fftwf_init_threads();
                     fftwf_plan_with_nthreads(N_threads);
@@ -312,9 +317,11 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
                     fftw_init_threads();
                     fftw_plan_with_nthreads(N_threads);
                 }
+                #endif
+                (void) N_threads;
             }
 
-            void allocate_buffers(const bool inplace) {
+            void allocate_buffers(const bool inplace, const size_t N_threads) {
                 size_t N_cells = 1;
                 for (size_t len_dim : m_shape) {N_cells *= len_dim;}
 
@@ -334,8 +341,12 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
                     throw std::runtime_error(msg);
                 }
 
-                view_in() = 0;
-                view_out() = 0;
+                // Pages are placed on the NUMA nodes of the threads which transform them.
+                namespace runtime = pypeline::util::runtime;
+                runtime::first_touch(m_data_in, sizeof(std::complex<T>) * N_cells, N_threads);
+                if (!inplace) {
+                    runtime::first_touch(m_data_out, sizeof(std::complex<T>) * N_cells, N_threads);
+                }
             }
 
             void allocate_plans(const planning_effort effort) {
@@ -451,8 +462,8 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
                     throw std::runtime_error(msg);
                 }
 
+                allocate_buffers(inplace, N_threads);
                 setup_threads(N_threads);
-                allocate_buffers(inplace);
                 allocate_plans(effort);
             }
 
@@ -745,9 +756,17 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
 
             size_t m_axis = 0;
             std::vector<size_t> m_shape {};
+            size_t m_N_outer = 1;  // prod(shape[:axis])
+            size_t m_N_inner = 1;  // prod(shape[axis + 1:])
             FFTW_FFT<TT> m_transform;
-            xt::xarray<std::complex<TT>> m_mod_1;
-            xt::xarray<std::complex<TT>> m_mod_2;
+
+            // (N_samples,) modulation vectors, applied along `axis` by modulate().
+            std::vector<std::complex<TT>> m_mod_1;
+            std::vector<std::complex<TT>> m_mod_2;
+            std::vector<std::complex<TT>> m_mod_1_conj;
+            std::vector<std::complex<TT>> m_mod_2_conj;
+            std::vector<std::complex<TT>> m_mod_1_scaled;       // mod_1 / N_samples
+            std::vector<std::complex<TT>> m_mod_2_conj_scaled;  // conj(mod_2) * N_samples
 
             void compute_modulation_vectors(const double T,
                                             const double T_c,
@@ -778,12 +797,28 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
                               xt::arange<int>(-M, 0)));
                 }
 
-                std::vector<size_t> shape_view(m_shape.size());
-                std::fill(shape_view.begin(), shape_view.end(), 1);
-                shape_view[m_axis] = N_samples;
+                xt::xtensor<std::complex<TT>, 1> mod_1 {xt::pow(B_1, -E_1)};
+                xt::xtensor<std::complex<TT>, 1> mod_2 {xt::pow(B_2, -N * E_2)};
+                m_mod_1.assign(mod_1.begin(), mod_1.end());
+                m_mod_2.assign(mod_2.begin(), mod_2.end());
+                m_mod_1_conj.resize(N_samples);
+                m_mod_2_conj.resize(N_samples);
+                m_mod_1_scaled.resize(N_samples);
+                m_mod_2_conj_scaled.resize(N_samples);
+                for (int k = 0; k < N_samples; ++k) {
+                    m_mod_1_conj[k] = std::conj(m_mod_1[k]);
+                    m_mod_2_conj[k] = std::conj(m_mod_2[k]);
+                    m_mod_1_scaled[k] = m_mod_1[k] / static_cast<TT>(N_samples);
+                    m_mod_2_conj_scaled[k] = m_mod_2_conj[k] * static_cast<TT>(N_samples);
+                }
+            }
 
-                m_mod_1 = xt::reshape_view(xt::pow(B_1, -E_1), std::vector<size_t> {shape_view});
-                m_mod_2 = xt::reshape_view(xt::pow(B_2, -N * E_2), std::vector<size_t> {shape_view});
+            /*
+             * x[..., k, ...] *= mod[k] along `axis`, for x one of {data_in(), data_out()}.
+             */
+            void modulate(std::complex<TT> *x,
+                          const std::vector<std::complex<TT>> &mod) {
+                pypeline::util::simd::multiply(x, mod.data(), m_N_outer, m_shape[m_axis], m_N_inner);
             }
 
         public:
@@ -836,6 +871,10 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
                     throw std::runtime_error(msg);
                 }
 
+                for (size_t i = 0; i < m_shape.size(); ++i) {
+                    if (i < m_axis) { m_N_outer *= m_shape[i]; }
+                    if (i > m_axis) { m_N_inner *= m_shape[i]; }
+                }
                 compute_modulation_vectors(T, T_c, N_FS);
             }
 
@@ -910,17 +949,16 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
              * :math:`\left[ x_{-N}^{FS}, \ldots, x_{N}^{FS}, 0, \ldots, 0 \right] \in \mathbb{C}^{N_samples}`.
              */
             void ffs() {
-                view_in().multiplies_assign(m_mod_2);
+                modulate(data_in(), m_mod_2);
                 m_transform.fft();
 
                 const bool out_of_place = (data_in() != data_out());
                 if (out_of_place) {
                     // Undo in-place modulation by `m_mod_2`.
-                    view_in().multiplies_assign(xt::conj(m_mod_2));
+                    modulate(data_in(), m_mod_2_conj);
                 }
 
-                const TT N_samples = static_cast<int>(m_shape[m_axis]);
-                view_out().multiplies_assign(m_mod_1 / N_samples);
+                modulate(data_out(), m_mod_1_scaled);
             }
 
             /*
@@ -933,17 +971,16 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
              * :math:`\left[ x_{-N}^{FS}, \ldots, x_{N}^{FS}, 0, \ldots, 0 \right] \in \mathbb{C}^{N_samples}`.
              */
             void ffs_r() {
-                view_out().multiplies_assign(m_mod_2);
+                modulate(data_out(), m_mod_2);
                 m_transform.fft_r();
 
                 const bool out_of_place = (data_in() != data_out());
                 if (out_of_place) {
                     // Undo in-place modulation by `m_mod_2`.
-                    view_out().multiplies_assign(xt::conj(m_mod_2));
+                    modulate(data_out(), m_mod_2_conj);
                 }
 
-                const TT N_samples = static_cast<int>(m_shape[m_axis]);
-                view_in().multiplies_assign(m_mod_1 / N_samples);
+                modulate(data_in(), m_mod_1_scaled);
             }
 
             /*
@@ -957,17 +994,16 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
              * the same order specified by :cpp:func:`ffs_sample`.
              */
             void iffs() {
-                view_in().multiplies_assign(xt::conj(m_mod_1));
+                modulate(data_in(), m_mod_1_conj);
                 m_transform.ifft();
 
                 const bool out_of_place = (data_in() != data_out());
                 if (out_of_place) {
                     // Undo in-place modulataion by `m_mod_1`.
-                    view_in().multiplies_assign(m_mod_1);
+                    modulate(data_in(), m_mod_1);
                 }
 
-                const TT N_samples = static_cast<int>(m_shape[m_axis]);
-                view_out().multiplies_assign(xt::conj(m_mod_2) * N_samples);
+                modulate(data_out(), m_mod_2_conj_scaled);
             }
 
             /*
@@ -981,17 +1017,16 @@ namespace pypeline { namespace util { namespace math { namespace fourier {
              * the same order specified by :cpp:func:`ffs_sample`.
              */
             void iffs_r() {
-                view_out().multiplies_assign(xt::conj(m_mod_1));
+                modulate(data_out(), m_mod_1_conj);
                 m_transform.ifft_r();
 
                 const bool out_of_place = (data_in() != data_out());
                 if (out_of_place) {
                     // Undo in-place modulataion by `m_mod_1`.
-                    view_out().multiplies_assign(m_mod_1);
+                    modulate(data_out(), m_mod_1);
                 }
 
-                const TT N_samples = static_cast<int>(m_shape[m_axis]);
-                view_in().multiplies_assign(xt::conj(m_mod_2) * N_samples);
+                modulate(data_in(), m_mod_2_conj_scaled);
             }
 
             std::string __repr__() {
@@ -17,11 +17,11 @@
 #include <string>
 
 #include "xtensor/xarray.hpp"
-#include "xtensor/xindex_view.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xeval.hpp"
 
 #include "pypeline/util/argcheck.hpp"
+#include "pypeline/util/simd.hpp"
 
 namespace pypeline { namespace util { namespace math { namespace func {
     /*
@@ -111,19 +111,7 @@ namespace pypeline { namespace util { namespace math { namespace func {
 
                 xt::xarray<double> y {x - m_beta + (0.5 * m_T)};
                 xt::xarray<double> amplitude {xt::zeros<double>(y.shape())};
-
-                double lim_left = 0.5 * m_T * m_alpha;
-                xt::xarray<bool> mask_left {(0 <= y) && (y < lim_left)};
-                xt::xarray<double> sqrt_amp_left {xt::sin(M_PI / (m_T * m_alpha) * xt::filter(y, mask_left))};
-                xt::filter(amplitude, mask_left) = xt::square(sqrt_amp_left);
-
-                double lim_right = m_T - (0.5 * m_T * m_alpha);
-                xt::xarray<bool> mask_right {(lim_right < y) & (y <= m_T)};
-                xt::xarray<double> sqrt_amp_right {xt::sin(M_PI / (m_T * m_alpha) * (m_T - xt::filter(y, mask_right)))};
-                xt::filter(amplitude, mask_right) = xt::square(sqrt_amp_right);
-
-                xt::xarray<bool> mask_middle {(lim_left <= y) && (y <= lim_right)};
-                xt::filter(amplitude, mask_middle) = 1;
+                pypeline::util::simd::tukey(y.data(), amplitude.data(), y.size(), m_T, m_alpha);
 
                 return amplitude;
             }
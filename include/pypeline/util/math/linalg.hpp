@@ -13,13 +13,24 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <complex>
+#include <exception>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "eigen3/Eigen/Eigen"
+#include "mkl_lapacke.h"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xnorm.hpp"
 
+#include "pypeline/types.hpp"
 #include "pypeline/util/argcheck.hpp"
 
 namespace pypeline { namespace util { namespace math { namespace linalg {
@@ -157,6 +168,777 @@ namespace pypeline { namespace util { namespace math { namespace linalg {
                                   {p20, p21, p22}};
         return R;
     }
+
+    /*
+     * Eigenpairs of a (generalized) Hermitian eigenvalue problem.
+     */
+    template <typename TT>
+    struct EigenPairs {
+        ArrayX_t<TT> D;                    // (N,) eigenvalues in decreasing order.
+        MatrixXX_t<std::complex<TT>> V;    // (M, N) eigenvectors.
+    };
+
+    namespace _detail {
+        inline lapack_int heevr(const char range, const char uplo, const lapack_int n, cfloat_t *a,
+                                const float vl, const float vu, const lapack_int il, const lapack_int iu,
+                                lapack_int *m, float *w, cfloat_t *z, const lapack_int ldz, lapack_int *isuppz) {
+            return LAPACKE_cheevr(LAPACK_ROW_MAJOR, 'V', range, uplo, n, reinterpret_cast<MKL_Complex8*>(a), n,
+                                  vl, vu, il, iu, 0, m, w, reinterpret_cast<MKL_Complex8*>(z), ldz, isuppz);
+        }
+
+        inline lapack_int heevr(const char range, const char uplo, const lapack_int n, cdouble_t *a,
+                                const double vl, const double vu, const lapack_int il, const lapack_int iu,
+                                lapack_int *m, double *w, cdouble_t *z, const lapack_int ldz, lapack_int *isuppz) {
+            return LAPACKE_zheevr(LAPACK_ROW_MAJOR, 'V', range, uplo, n, reinterpret_cast<MKL_Complex16*>(a), n,
+                                  vl, vu, il, iu, 0, m, w, reinterpret_cast<MKL_Complex16*>(z), ldz, isuppz);
+        }
+
+        /*
+         * Partial eigendecomposition of a Hermitian matrix with LAPACK ?heevr.
+         *
+         * Only the `uplo` triangle of `A` is referenced.
+         * If N_top > 0, the N_top largest eigenpairs are computed.
+         * Otherwise all eigenpairs with strictly positive eigenvalues are computed.
+         *
+         * Eigenpairs are returned in decreasing eigenvalue order.
+         */
+        template <typename TT>
+        EigenPairs<TT> top_eigh(MatrixXX_t<std::complex<TT>> &&A,
+                                const char uplo,
+                                const size_t N_top) {
+            using cTT = std::complex<TT>;
+            const lapack_int M = static_cast<lapack_int>(A.rows());
+            const char range = ((N_top > 0) ? 'I' : 'V');
+            const lapack_int il = ((N_top > 0) ? (M - static_cast<lapack_int>(N_top) + 1) : 1);
+            const lapack_int N_col = ((N_top > 0) ? static_cast<lapack_int>(N_top) : M);
+
+            ArrayX_t<TT> w(M);
+            MatrixXX_t<cTT> Z(M, N_col);
+            std::vector<lapack_int> isuppz(2 * M);
+            lapack_int N_found = 0;
+            const lapack_int info = heevr(range, uplo, M, A.data(),
+                                          TT(0), std::numeric_limits<TT>::max(), il, M,
+                                          &N_found, w.data(), Z.data(), N_col, isuppz.data());
+            if (info != 0) {
+                std::string msg = "?heevr() failed with info=" + std::to_string(info) + ".";
+                throw std::runtime_error(msg);
+            }
+
+            EigenPairs<TT> out;
+            out.D = w.head(N_found).reverse();
+            out.V = Z.leftCols(N_found).rowwise().reverse();
+            return out;
+        }
+
+        /*
+         * Map standard-form eigenpairs of C = L^{-1} A L^{-H} to output format.
+         *
+         * DV : top eigenpairs of C in decreasing order. (Modified in-place.)
+         * L : lower-triangular Cholesky factor of B, or nullptr if B = I.
+         * energy : trace(C)
+         *
+         * Near-zero eigenvalues are discarded, followed by energy selection,
+         * back-transformation v = L^{-H} w and zero-padding to N (if N > 0).
+         */
+        template <typename TT>
+        EigenPairs<TT> finalize(EigenPairs<TT> &&DV,
+                                const MatrixXX_t<std::complex<TT>> *L,
+                                const TT energy,
+                                const double tau,
+                                const size_t N,
+                                const size_t M) {
+            using cTT = std::complex<TT>;
+
+            size_t N_keep = 0;
+            TT cumsum = 0;
+            while ((N_keep < static_cast<size_t>(DV.D.size())) && (DV.D[N_keep] > 0)) {
+                cumsum += DV.D[N_keep];
+                if (std::min<TT>(cumsum / energy, 1) > tau) { break; }
+                ++N_keep;
+            }
+            if (N > 0) {
+                N_keep = std::min(N_keep, N);
+            }
+            DV.D.conservativeResize(N_keep);
+            DV.V.conservativeResize(M, N_keep);
+
+            if (L != nullptr) {  // w = L^{H} v
+                L->adjoint().template triangularView<Eigen::Upper>().solveInPlace(DV.V);
+            }
+
+            if (N > 0) {  // Padding
+                EigenPairs<TT> padded;
+                padded.D = ArrayX_t<TT>::Zero(N);
+                padded.V = MatrixXX_t<cTT>::Zero(M, N);
+                padded.D.head(N_keep) = DV.D;
+                padded.V.leftCols(N_keep) = DV.V;
+                return padded;
+            }
+            return std::move(DV);
+        }
+
+        template <typename TT>
+        void validate(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A,
+                      const MatrixXX_t<std::complex<TT>> *L,
+                      const double tau) {
+            if (A.cols() != A.rows()) {
+                std::string msg = "Parameter[A] must be square.";
+                throw std::runtime_error(msg);
+            }
+            if ((L != nullptr) && (L->rows() != A.rows())) {
+                std::string msg = "Parameters[A, B] must have the same shape.";
+                throw std::runtime_error(msg);
+            }
+            if (!((0 < tau) && (tau <= 1))) {
+                std::string msg = "Parameter[tau] must be in (0, 1].";
+                throw std::runtime_error(msg);
+            }
+        }
+
+        /*
+         * True if A is positive-semidefinite up to round-off, i.e. if
+         * A + delta I admits a Cholesky factorization, with
+         * delta = M * eps * trace(|diag(A)|) >= M * eps * ||A||_{2} for PSD A.
+         *
+         * Only the lower triangle of A is referenced.
+         */
+        template <typename TT>
+        bool is_psd(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A) {
+            using cTT = std::complex<TT>;
+            const TT scale = A.diagonal().real().cwiseAbs().sum();
+            const TT delta = A.rows() * std::numeric_limits<TT>::epsilon() * scale;
+
+            MatrixXX_t<cTT> A_shift = A;
+            A_shift.diagonal().array() += cTT(delta, 0);
+            Eigen::LLT<MatrixXX_t<cTT>, Eigen::Lower> A_llt(A_shift);
+            return A_llt.info() == Eigen::Success;
+        }
+
+        /*
+         * Top eigenpairs of C+ = L^{-1} A+ L^{-H} in decreasing order, where
+         * A+ is the positive-semidefinite part of A.
+         *
+         * If N_top > 0 and A is PSD, then C+ = L^{-1} A L^{-H} and only the
+         * N_top leading eigenpairs of C are computed.
+         * Otherwise A's positive spectrum is extracted first, which requires
+         * all its positive eigenpairs.
+         *
+         * L : (M, M) lower-triangular Cholesky factor of B, or nullptr if B = I.
+         * N_top : number of eigenpairs to compute. (0 = all non-zero.)
+         * energy : set to trace(C+).
+         */
+        template <typename TT>
+        EigenPairs<TT> eigh_std(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A,
+                                const MatrixXX_t<std::complex<TT>> *L,
+                                const size_t N_top,
+                                TT &energy) {
+            using cTT = std::complex<TT>;
+            const size_t M = A.rows();
+
+            if ((N_top > 0) && is_psd<TT>(A)) {
+                // (A, B) -> C = L^{-1} A L^{-H}
+                MatrixXX_t<cTT> C = A.template selfadjointView<Eigen::Lower>();
+                if (L != nullptr) {
+                    L->template triangularView<Eigen::Lower>().solveInPlace(C);
+                    C.adjointInPlace();
+                    L->template triangularView<Eigen::Lower>().solveInPlace(C);
+                }
+                energy = C.trace().real();
+
+                // Drop the (round-off) non-positive tail, as A+ would have.
+                EigenPairs<TT> DV = top_eigh<TT>(std::move(C), 'L', std::min(N_top, M));
+                Eigen::Index K = 0;
+                while ((K < DV.D.size()) && (DV.D[K] > 0)) { ++K; }
+                DV.D.conservativeResize(K);
+                DV.V.conservativeResize(M, K);
+                return DV;
+            }
+
+            // A: keep positive spectrum only, as A+ = Y Y^{H}.
+            EigenPairs<TT> A_pos = top_eigh<TT>(MatrixXX_t<cTT>(A), 'L', 0);
+            const size_t K = A_pos.D.size();
+            if (K == 0) {
+                energy = 0;
+                return A_pos;
+            }
+            MatrixXX_t<cTT> Y = A_pos.V * A_pos.D.sqrt().matrix().asDiagonal();
+
+            // (A+, B) -> C+ = L^{-1} A+ L^{-H}, of rank <= K.
+            if (L != nullptr) {
+                L->template triangularView<Eigen::Lower>().solveInPlace(Y);
+            }
+            energy = Y.squaredNorm();
+            MatrixXX_t<cTT> C = MatrixXX_t<cTT>::Zero(M, M);
+            C.template selfadjointView<Eigen::Lower>().rankUpdate(Y);
+
+            return top_eigh<TT>(std::move(C), 'L', ((N_top > 0) ? std::min(N_top, K) : K));
+        }
+
+        /*
+         * Shared implementation of the eigh() family.
+         *
+         * L : (M, M) lower-triangular Cholesky factor of B, or nullptr if B = I.
+         */
+        template <typename TT>
+        EigenPairs<TT> eigh(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A,
+                            const MatrixXX_t<std::complex<TT>> *L,
+                            const double tau,
+                            const size_t N) {
+            validate<TT>(A, L, tau);
+
+            TT energy = 0;
+            EigenPairs<TT> DV = eigh_std<TT>(A, L, N, energy);
+            return finalize<TT>(std::move(DV), L, energy, tau, N, A.rows());
+        }
+
+        template <typename TT>
+        MatrixXX_t<std::complex<TT>> cholesky(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &B) {
+            if (B.rows() != B.cols()) {
+                std::string msg = "Parameter[B] must be square.";
+                throw std::runtime_error(msg);
+            }
+
+            Eigen::LLT<MatrixXX_t<std::complex<TT>>, Eigen::Lower> B_llt(B);
+            if (B_llt.info() != Eigen::Success) {
+                std::string msg = "Parameter[B] is not positive-definite.";
+                throw std::runtime_error(msg);
+            }
+            return B_llt.matrixL();
+        }
+    }
+
+    /*
+     * Solve a generalized Hermitian eigenvalue problem, keeping only the leading eigenpairs.
+     *
+     * Finds (D, V), solution of A V = B V D, where the negative spectrum of A
+     * is discarded beforehand.
+     *
+     * Only the requested eigenpairs are computed (LAPACK ?heevr with index range)
+     * after reduction to standard form through the Cholesky factor L of B.
+     * If N > 0 and A is positive-semidefinite, the negative spectrum of A is
+     * known to be empty and A is not decomposed beforehand.
+     *
+     * Parameters
+     * ----------
+     * A : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+     *     (M, M) Hermitian matrix.
+     * B : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+     *     (M, M) positive-definite Hermitian matrix.
+     * tau : double
+     *     Normalized energy ratio in (0, 1].
+     * N : size_t
+     *     Number of eigenpairs to output.
+     *     If 0, output the minimum number K of leading eigenpairs that account
+     *     for `tau` percent of the total energy.
+     *     Otherwise the first min(N, K) eigenpairs are output and zero-padded to N.
+     *
+     * Returns
+     * -------
+     * DV : EigenPairs<TT>
+     *     (D, V) eigenpairs, sorted in decreasing eigenvalue order.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/util/math/linalg.hpp"
+     *
+     *    namespace linalg = pypeline::util::math::linalg;
+     *
+     *    MatrixXX_t<cdouble_t> S = ..., G = ...;
+     *    auto DV = linalg::eigh<double>(S, G, 1.0, 12);  // 12 leading eigenpairs
+     *
+     *    // Re-use the Cholesky factor of G across problems.
+     *    MatrixXX_t<cdouble_t> L = G.llt().matrixL();
+     *    auto DV2 = linalg::eigh_chol<double>(S2, L, 1.0, 12);
+     */
+    template <typename TT>
+    EigenPairs<TT> eigh(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A,
+                        const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &B,
+                        const double tau = 1,
+                        const size_t N = 0) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+
+        const MatrixXX_t<std::complex<TT>> L = _detail::cholesky<TT>(B);
+        return _detail::eigh<TT>(A, &L, tau, N);
+    }
+
+    /*
+     * Same as eigh(A, B, tau, N) with B = I.
+     */
+    template <typename TT>
+    EigenPairs<TT> eigh(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A,
+                        const double tau = 1,
+                        const size_t N = 0) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+
+        return _detail::eigh<TT>(A, nullptr, tau, N);
+    }
+
+    /*
+     * Same as eigh(A, B, tau, N), given the lower-triangular Cholesky factor L of B.
+     */
+    template <typename TT>
+    EigenPairs<TT> eigh_chol(const Eigen::Ref<const MatrixXX_t<std::complex<TT>>> &A,
+                             const MatrixXX_t<std::complex<TT>> &L,
+                             const double tau = 1,
+                             const size_t N = 0) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+
+        return _detail::eigh<TT>(A, &L, tau, N);
+    }
+
+    /*
+     * Solve many independent eigh() problems in parallel.
+     *
+     * Parameters
+     * ----------
+     * A : std::vector<MatrixXX_t<std::complex<TT>>>
+     *     (N_problem,) Hermitian matrices.
+     * B : std::vector<MatrixXX_t<std::complex<TT>>>
+     *     (N_problem,) positive-definite Hermitian matrices, or
+     *     (1,) matrix shared by all problems, or
+     *     (0,) if B = I for all problems.
+     *     Consecutive identical B are factorized only once.
+     * tau : double
+     * N : size_t
+     *     See eigh().
+     *
+     * Returns
+     * -------
+     * DV : std::vector<EigenPairs<TT>>
+     *     (N_problem,) eigenpairs.
+     */
+    template <typename TT>
+    std::vector<EigenPairs<TT>> eigh_batch(const std::vector<MatrixXX_t<std::complex<TT>>> &A,
+                                           const std::vector<MatrixXX_t<std::complex<TT>>> &B,
+                                           const double tau = 1,
+                                           const size_t N = 0) {
+        static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+        using cTT = std::complex<TT>;
+
+        const int N_problem = static_cast<int>(A.size());
+        if (!((B.size() == 0) || (B.size() == 1) || (B.size() == A.size()))) {
+            std::string msg = "Parameter[B] must contain 0, 1 or len(A) matrices.";
+            throw std::runtime_error(msg);
+        }
+
+        // Factorize distinct B.
+        std::vector<int> factor_idx(B.size());
+        std::vector<int> to_factor;
+        for (size_t i = 0; i < B.size(); ++i) {
+            const bool same_as_prev = ((i > 0) &&
+                                       (B[i].rows() == B[i - 1].rows()) &&
+                                       (B[i].cols() == B[i - 1].cols()) &&
+                                       (B[i] == B[i - 1]));
+            if (!same_as_prev) {
+                to_factor.push_back(static_cast<int>(i));
+            }
+            factor_idx[i] = static_cast<int>(to_factor.size()) - 1;
+        }
+
+        const int N_factor = static_cast<int>(to_factor.size());
+        std::vector<MatrixXX_t<cTT>> L(N_factor);
+        std::vector<EigenPairs<TT>> DV(N_problem);
+        // `failed` lets threads skip remaining problems without reading
+        // `error`, which is only accessed inside the critical section.
+        std::exception_ptr error = nullptr;
+        std::atomic<bool> failed(false);
+
+        #ifdef _OPENMP
+        #pragma omp parallel
+        #endif
+        {
+            #ifdef _OPENMP
+            #pragma omp for schedule(dynamic)
+            #endif
+            for (int i = 0; i < N_factor; ++i) {
+                try {
+                    L[i] = _detail::cholesky<TT>(B[to_factor[i]]);
+                } catch (...) {
+                    #ifdef _OPENMP
+                    #pragma omp critical
+                    #endif
+                    {
+                        if (error == nullptr) { error = std::current_exception(); }
+                    }
+                    failed = true;
+                }
+            }
+
+            #ifdef _OPENMP
+            #pragma omp for schedule(dynamic)
+            #endif
+            for (int i = 0; i < N_problem; ++i) {
+                if (failed) { continue; }
+                try {
+                    const MatrixXX_t<cTT> *L_i = nullptr;
+                    if (B.size() == 1) {
+                        L_i = &L[0];
+                    } else if (B.size() > 1) {
+                        L_i = &L[factor_idx[i]];
+                    }
+                    DV[i] = _detail::eigh<TT>(A[i], L_i, tau, N);
+                } catch (...) {
+                    #ifdef _OPENMP
+                    #pragma omp critical
+                    #endif
+                    {
+                        if (error == nullptr) { error = std::current_exception(); }
+                    }
+                    failed = true;
+                }
+            }
+        }
+
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+        return DV;
+    }
+
+    /*
+     * Warm-started eigh() for sequences of slowly-varying problems.
+     *
+     * Visibility matrices of adjacent epochs have nearly identical dominant
+     * eigenspaces. Each stream (ex: frequency channel) remembers the
+     * eigenvectors of its previous problem, which seed a block LOBPCG
+     * iteration on C = L^{-1} A L^{-H}. C is never formed: it is applied
+     * through triangular solves with the Cholesky factor L of B, so a warm
+     * solve costs O(M^3 / 3) for the factorization plus O(M^2 N_block) per
+     * iteration instead of a dense O(M^3) eigendecomposition.
+     *
+     * The dense solver is used instead on the first problem of a stream, when
+     * the problem size changes, when M <= N_eig + N_guard, or when LOBPCG does
+     * not converge within `max_iter` iterations.
+     *
+     * The warm path assumes A is positive-semidefinite (ex: sample covariance
+     * matrices) and does not project out its negative spectrum.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/types.hpp"
+     *    #include "pypeline/util/math/linalg.hpp"
+     *
+     *    namespace linalg = pypeline::util::math::linalg;
+     *
+     *    linalg::WarmStartEigh<double> solver(12);  // N_eig = 12
+     *    for (...) {  // epochs
+     *        MatrixXX_t<cdouble_t> S = ..., G = ...;
+     *        auto DV = solver(S, G, 1.0, channel_id);
+     *    }
+     */
+    template <typename TT>
+    class WarmStartEigh {
+        private:
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            using cTT = std::complex<TT>;
+
+            size_t m_N_eig = 0;
+            size_t m_N_guard = 0;
+            double m_tol = 0;
+            size_t m_max_iter = 0;
+            std::unordered_map<int, MatrixXX_t<cTT>> m_V {};  // (M, N_block) generalized eigenvectors per stream.
+            std::unordered_map<int, std::pair<MatrixXX_t<cTT>, MatrixXX_t<cTT>>> m_B_inv {};  // (L, B^{-1}) per stream.
+            size_t m_N_warm = 0;
+            size_t m_N_cold = 0;
+            size_t m_N_fallback = 0;
+
+            size_t N_block(const size_t M) const {
+                return std::min(M, m_N_eig + m_N_guard);
+            }
+
+            /*
+             * Y = C X, with C = L^{-1} A L^{-H}.
+             */
+            static MatrixXX_t<cTT> apply(const Eigen::Ref<const MatrixXX_t<cTT>> &A,
+                                         const MatrixXX_t<cTT> *L,
+                                         const MatrixXX_t<cTT> &X) {
+                MatrixXX_t<cTT> Y = X;
+                if (L != nullptr) {
+                    L->adjoint().template triangularView<Eigen::Upper>().solveInPlace(Y);
+                }
+                Y = A * Y;
+                if (L != nullptr) {
+                    L->template triangularView<Eigen::Lower>().solveInPlace(Y);
+                }
+                return Y;
+            }
+
+            /*
+             * trace(C) = trace(A B^{-1}), with B = L L^{H}.
+             *
+             * B^{-1} is kept per stream and only re-computed when L changes, so
+             * the trace costs O(M^2) on sequences sharing B (ex: fixed Gram).
+             */
+            TT trace(const Eigen::Ref<const MatrixXX_t<cTT>> &A,
+                     const MatrixXX_t<cTT> *L,
+                     const int stream) {
+                if (L == nullptr) {
+                    return A.trace().real();
+                }
+
+                auto it = m_B_inv.find(stream);
+                if ((it == m_B_inv.end()) ||
+                    (it->second.first.rows() != L->rows()) ||
+                    (it->second.first != *L)) {
+                    MatrixXX_t<cTT> L_inv = MatrixXX_t<cTT>::Identity(L->rows(), L->cols());
+                    L->template triangularView<Eigen::Lower>().solveInPlace(L_inv);
+                    MatrixXX_t<cTT> B_inv = L_inv.adjoint() * L_inv;
+                    m_B_inv[stream] = std::make_pair(*L, std::move(B_inv));
+                    it = m_B_inv.find(stream);
+                }
+
+                // B^{-1} is Hermitian: trace(A B^{-1}) = sum_{ij} A_{ij} conj(B^{-1}_{ij}).
+                return (A.array() * it->second.second.array().conjugate()).sum().real();
+            }
+
+            /*
+             * Rayleigh-Ritz on orthonormal basis Q: keep the N_block leading Ritz pairs.
+             */
+            static void rayleigh_ritz(const MatrixXX_t<cTT> &Q,
+                                      const MatrixXX_t<cTT> &AQ,
+                                      const size_t N_block,
+                                      MatrixXX_t<cTT> &Z,
+                                      ArrayX_t<TT> &theta) {
+                MatrixXX_t<cTT> G = Q.adjoint() * AQ;
+                G = ((G + G.adjoint()) / TT(2)).eval();
+                Eigen::SelfAdjointEigenSolver<MatrixXX_t<cTT>> es(G);
+                Z = es.eigenvectors().rightCols(N_block).rowwise().reverse();
+                theta = es.eigenvalues().tail(N_block).reverse().transpose();
+            }
+
+            /*
+             * Block LOBPCG for the N_block largest eigenpairs of C, seeded with X.
+             *
+             * Returns true and standard-form eigenpairs in `DV` on convergence
+             * of the N_eig leading pairs.
+             */
+            bool lobpcg(const Eigen::Ref<const MatrixXX_t<cTT>> &A,
+                        const MatrixXX_t<cTT> *L,
+                        const MatrixXX_t<cTT> &X0,
+                        EigenPairs<TT> &DV) const {
+                const size_t M = X0.rows();
+                const size_t N_b = X0.cols();
+
+                Eigen::HouseholderQR<MatrixXX_t<cTT>> qr_X(X0);
+                MatrixXX_t<cTT> X = qr_X.householderQ() * MatrixXX_t<cTT>::Identity(M, N_b);
+                MatrixXX_t<cTT> AX = apply(A, L, X);
+
+                MatrixXX_t<cTT> Z;
+                ArrayX_t<TT> theta;
+                rayleigh_ritz(X, AX, N_b, Z, theta);
+                X = (X * Z).eval();
+                AX = (AX * Z).eval();
+
+                MatrixXX_t<cTT> P(M, 0);
+                for (size_t it = 0; it < m_max_iter; ++it) {
+                    MatrixXX_t<cTT> R = AX - X * theta.matrix().asDiagonal();
+
+                    const TT scale = std::max(std::abs(theta[0]), std::numeric_limits<TT>::min());
+                    bool converged = true;
+                    for (size_t k = 0; k < std::min(m_N_eig, N_b); ++k) {
+                        converged &= (R.col(k).norm() <= m_tol * scale);
+                    }
+                    if (converged) {
+                        DV.D = theta;
+                        DV.V = X;
+                        return true;
+                    }
+
+                    // Search directions [R, P], orthonormalized against X.
+                    MatrixXX_t<cTT> W(M, R.cols() + P.cols());
+                    W << R, P;
+                    for (int pass = 0; pass < 2; ++pass) {
+                        W -= X * (X.adjoint() * W);
+                    }
+                    Eigen::ColPivHouseholderQR<MatrixXX_t<cTT>> qr_W(W);
+                    qr_W.setThreshold(1e3 * std::numeric_limits<TT>::epsilon());
+                    const size_t N_w = qr_W.rank();
+                    if (N_w == 0) {
+                        return false;
+                    }
+                    MatrixXX_t<cTT> Q_W = qr_W.householderQ() * MatrixXX_t<cTT>::Identity(M, N_w);
+                    for (int pass = 0; pass < 2; ++pass) {
+                        Q_W -= X * (X.adjoint() * Q_W);
+                    }
+                    Eigen::HouseholderQR<MatrixXX_t<cTT>> qr_Q(Q_W);
+                    Q_W = qr_Q.householderQ() * MatrixXX_t<cTT>::Identity(M, N_w);
+
+                    MatrixXX_t<cTT> Q(M, N_b + N_w), AQ(M, N_b + N_w);
+                    Q << X, Q_W;
+                    AQ << AX, apply(A, L, Q_W);
+                    rayleigh_ritz(Q, AQ, N_b, Z, theta);
+
+                    // P = component of the update outside span(X).
+                    P = Q_W * Z.bottomRows(N_w);
+                    X = Q * Z;
+                    AX = AQ * Z;
+                }
+                return false;
+            }
+
+            EigenPairs<TT> solve(const Eigen::Ref<const MatrixXX_t<cTT>> &A,
+                                 const MatrixXX_t<cTT> *L,
+                                 const double tau,
+                                 const int stream) {
+                _detail::validate<TT>(A, L, tau);
+                const size_t M = A.rows();
+                const size_t N_b = N_block(M);
+
+                EigenPairs<TT> DV;
+                TT energy = 1;  // Only relevant if (tau < 1).
+                bool warm = false;
+
+                // If the block spans the whole space (M <= N_eig + N_guard), the
+                // dense solver is exact and cheaper: seeds are not used.
+                auto it = m_V.find(stream);
+                const bool has_seed = ((N_b < M) && (it != m_V.end()) &&
+                                       (static_cast<size_t>(it->second.rows()) == M) &&
+                                       (static_cast<size_t>(it->second.cols()) == N_b));
+                if (has_seed) {
+                    MatrixXX_t<cTT> X0 = it->second;  // generalized -> standard form: w = L^{H} v
+                    if (L != nullptr) {
+                        X0 = (L->adjoint().template triangularView<Eigen::Upper>() * X0).eval();
+                    }
+                    warm = lobpcg(A, L, X0, DV);
+                    if (warm && (tau < 1)) {
+                        energy = trace(A, L, stream);
+                    }
+                }
+
+                if (warm) {
+                    ++m_N_warm;
+                } else {
+                    ++(has_seed ? m_N_fallback : m_N_cold);
+                    DV = _detail::eigh_std<TT>(A, L, N_b, energy);
+                    const size_t N_found = DV.D.size();
+                    if (N_found < N_b) {  // rank-deficient: complete the seed with zeros.
+                        DV.D.conservativeResize(N_b);
+                        DV.V.conservativeResize(M, N_b);
+                        DV.D.tail(N_b - N_found).setZero();
+                        DV.V.rightCols(N_b - N_found).setZero();
+                    }
+                }
+
+                MatrixXX_t<cTT> V = DV.V;
+                if (L != nullptr) {
+                    L->adjoint().template triangularView<Eigen::Upper>().solveInPlace(V);
+                }
+                m_V[stream] = std::move(V);
+
+                return _detail::finalize<TT>(std::move(DV), L, energy, tau, m_N_eig, M);
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * N_eig : size_t
+             *     Number of eigenpairs to output.
+             * N_guard : size_t
+             *     Extra eigenpairs tracked to speed up convergence.
+             * tol : double
+             *     Relative residual tolerance ||C x - theta x|| <= tol * theta_max.
+             * max_iter : size_t
+             *     Maximum number of LOBPCG iterations before falling back to the dense solver.
+             */
+            WarmStartEigh(const size_t N_eig,
+                          const size_t N_guard = 4,
+                          const double tol = std::sqrt(std::numeric_limits<TT>::epsilon()),
+                          const size_t max_iter = 20):
+                m_N_eig(N_eig), m_N_guard(N_guard), m_tol(tol), m_max_iter(max_iter) {
+                if (N_eig == 0) {
+                    std::string msg = "Parameter[N_eig] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+                if (!(tol > 0)) {
+                    std::string msg = "Parameter[tol] must be positive.";
+                    throw std::runtime_error(msg);
+                }
+            }
+
+            /*
+             * Solve A V = B V D for the N_eig leading eigenpairs.
+             *
+             * Parameters
+             * ----------
+             * A : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (M, M) positive-semidefinite Hermitian matrix.
+             * B : Eigen::Ref<const MatrixXX_t<std::complex<TT>>>
+             *     (M, M) positive-definite Hermitian matrix.
+             * tau : double
+             *     Normalized energy ratio in (0, 1].
+             * stream : int
+             *     Identifier of the sequence the problem belongs to.
+             *
+             * Returns
+             * -------
+             * DV : EigenPairs<TT>
+             *     (N_eig,) eigenpairs, as output by eigh(A, B, tau, N_eig).
+             */
+            EigenPairs<TT> operator()(const Eigen::Ref<const MatrixXX_t<cTT>> &A,
+                                      const Eigen::Ref<const MatrixXX_t<cTT>> &B,
+                                      const double tau = 1,
+                                      const int stream = 0) {
+                const MatrixXX_t<cTT> L = _detail::cholesky<TT>(B);
+                return solve(A, &L, tau, stream);
+            }
+
+            /*
+             * Same as operator()(A, B, tau, stream) with B = I.
+             */
+            EigenPairs<TT> operator()(const Eigen::Ref<const MatrixXX_t<cTT>> &A,
+                                      const double tau = 1,
+                                      const int stream = 0) {
+                return solve(A, nullptr, tau, stream);
+            }
+
+            /*
+             * Forget all seeds.
+             */
+            void reset() {
+                m_V.clear();
+                m_B_inv.clear();
+            }
+
+            size_t N_eig() const {
+                return m_N_eig;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Number of problems solved with LOBPCG.
+             */
+            size_t N_warm() const {
+                return m_N_warm;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Number of problems solved densely because no usable seed existed.
+             */
+            size_t N_cold() const {
+                return m_N_cold;
+            }
+
+            /*
+             * Returns
+             * -------
+             * N : size_t
+             *     Number of problems solved densely because LOBPCG did not converge.
+             */
+            size_t N_fallback() const {
+                return m_N_fallback;
+            }
+    };
 }}}}
 
 #endif //PYPELINE_UTIL_MATH_LINALG_HPP
@@ -0,0 +1,235 @@
+// ############################################################################
+// mmap.hpp
+// ========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Memory-mapped file tools.
+ */
+
+#ifndef PYPELINE_UTIL_MMAP_HPP
+#define PYPELINE_UTIL_MMAP_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pypeline { namespace util { namespace mmap {
+    enum class access_mode: unsigned int {
+        READ_ONLY,   // Map existing file, read-only.
+        READ_WRITE,  // Map existing file, changes are written back to disk.
+        CREATE       // Create/truncate file to requested size, then map read-write.
+    };
+
+    /*
+     * RAII wrapper around a memory-mapped file.
+     *
+     * The mapping is released (and changes flushed by the kernel) when the
+     * object goes out of scope.
+     * Objects are move-only.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include <cstring>
+     *    #include "pypeline/util/mmap.hpp"
+     *
+     *    namespace mmap = pypeline::util::mmap;
+     *
+     *    {  // Create 1 MiB file and fill it.
+     *        mmap::MappedFile f("/tmp/test.bin", mmap::access_mode::CREATE, 1 << 20);
+     *        std::memset(f.data(), 0xFF, f.size());
+     *    }
+     *
+     *    mmap::MappedFile g("/tmp/test.bin", mmap::access_mode::READ_ONLY);
+     *    const char *ptr = reinterpret_cast<const char*>(g.data());  // 0xFF everywhere
+     */
+    class MappedFile {
+        private:
+            std::string m_path {};
+            access_mode m_mode = access_mode::READ_ONLY;
+            int m_fd = -1;
+            void *m_data = nullptr;
+            size_t m_size = 0;
+
+            [[noreturn]] void fail(const std::string &what) {
+                std::string msg = (what + " '" + m_path + "': " + std::strerror(errno));
+                release();
+                throw std::runtime_error(msg);
+            }
+
+            void release() {
+                if ((m_data != nullptr) && (m_data != MAP_FAILED)) {
+                    munmap(m_data, m_size);
+                }
+                if (m_fd >= 0) {
+                    close(m_fd);
+                }
+                m_data = nullptr;
+                m_fd = -1;
+                m_size = 0;
+            }
+
+        public:
+            /*
+             * Parameters
+             * ----------
+             * path : std::string
+             *     File to map.
+             * mode : access_mode
+             * size : size_t
+             *     File size [bytes] to allocate if `mode` is CREATE.
+             *     Ignored otherwise: the whole file is mapped.
+             */
+            MappedFile(const std::string &path,
+                       const access_mode mode,
+                       const size_t size = 0):
+                m_path(path), m_mode(mode) {
+                int flags = 0;
+                switch (mode) {
+                    case access_mode::READ_ONLY:  flags = O_RDONLY;                    break;
+                    case access_mode::READ_WRITE: flags = O_RDWR;                      break;
+                    case access_mode::CREATE:     flags = O_RDWR | O_CREAT | O_TRUNC;  break;
+                }
+
+                m_fd = open(path.c_str(), flags, 0644);
+                if (m_fd < 0) {
+                    fail("Could not open file");
+                }
+
+                if (mode == access_mode::CREATE) {
+                    if (size == 0) {
+                        std::string msg = "Parameter[size] must be positive in CREATE mode.";
+                        release();
+                        throw std::runtime_error(msg);
+                    }
+                    if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+                        fail("Could not resize file");
+                    }
+                    m_size = size;
+                } else {
+                    struct stat info;
+                    if (fstat(m_fd, &info) != 0) {
+                        fail("Could not stat file");
+                    }
+                    m_size = static_cast<size_t>(info.st_size);
+                    if (m_size == 0) {
+                        std::string msg = "Cannot map empty file '" + path + "'.";
+                        release();
+                        throw std::runtime_error(msg);
+                    }
+                }
+
+                const int prot = ((mode == access_mode::READ_ONLY) ?
+                                  PROT_READ : (PROT_READ | PROT_WRITE));
+                m_data = ::mmap(nullptr, m_size, prot, MAP_SHARED, m_fd, 0);
+                if (m_data == MAP_FAILED) {
+                    fail("Could not map file");
+                }
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile& operator=(const MappedFile &) = delete;
+
+            MappedFile(MappedFile &&other):
+                m_path(std::move(other.m_path)), m_mode(other.m_mode),
+                m_fd(other.m_fd), m_data(other.m_data), m_size(other.m_size) {
+                other.m_fd = -1;
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+
+            ~MappedFile() {
+                release();
+            }
+
+            /*
+             * Returns
+             * -------
+             * data : void*
+             *     Start of the mapped region.
+             */
+            void* data() {
+                return m_data;
+            }
+
+            const void* data() const {
+                return m_data;
+            }
+
+            /*
+             * Returns
+             * -------
+             * size : size_t
+             *     Size [bytes] of the mapped region.
+             */
+            size_t size() const {
+                return m_size;
+            }
+
+            /*
+             * Returns
+             * -------
+             * path : std::string
+             */
+            const std::string& path() const {
+                return m_path;
+            }
+
+            /*
+             * Returns
+             * -------
+             * writable : bool
+             */
+            bool writable() const {
+                return m_mode != access_mode::READ_ONLY;
+            }
+
+            /*
+             * Synchronously write dirty pages back to disk.
+             */
+            void flush() {
+                if (writable() && (msync(m_data, m_size, MS_SYNC) != 0)) {
+                    fail("Could not flush file");
+                }
+            }
+
+            /*
+             * Hint the kernel that [offset, offset + length) will be read sequentially.
+             *
+             * Parameters
+             * ----------
+             * offset : size_t
+             *     Byte offset from start of mapping.
+             * length : size_t
+             *     Number of bytes.
+             */
+            void advise_sequential(const size_t offset, const size_t length) {
+                const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                const size_t start = (offset / page) * page;
+                if (start < m_size) {
+                    const size_t len = std::min(length + (offset - start), m_size - start);
+                    madvise(reinterpret_cast<char*>(m_data) + start, len, MADV_SEQUENTIAL);
+                }
+            }
+    };
+
+    /*
+     * Round `offset` up to a multiple of `alignment`.
+     */
+    inline size_t align_up(const size_t offset, const size_t alignment) {
+        return ((offset + alignment - 1) / alignment) * alignment;
+    }
+}}}
+
+#endif //PYPELINE_UTIL_MMAP_HPP
@@ -0,0 +1,303 @@
+// ############################################################################
+// runtime.hpp
+// ===========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Thread placement and thread budgets, shared by Pypeline, OpenMP, MKL and FFTW.
+ *
+ * Pypeline threads (scheduler workers, forked processes) are the only
+ * threads created explicitly: OpenMP, MKL (OpenMP threading layer) and FFTW
+ * (libfftw3_omp) parallel regions are all OpenMP teams started by one of
+ * them. Each such thread hence
+ *
+ * * bounds the teams it starts with set_thread_budget(), and
+ * * is pinned to a share of the machine's NUMA domains with bind(): team
+ *   threads inherit the binding when created.
+ *
+ * Memory is placed by the Linux first-touch policy: buffers initialized with
+ * first_touch() by the threads which later use them stay local to them.
+ */
+
+#ifndef PYPELINE_UTIL_RUNTIME_HPP
+#define PYPELINE_UTIL_RUNTIME_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef EIGEN_USE_MKL_ALL
+#include "mkl_service.h"
+#endif
+
+namespace pypeline { namespace util { namespace runtime {
+    namespace _detail {
+        /*
+         * Parse a Linux CPU list, e.g. "0-3,8,10-11".
+         */
+        inline std::vector<int> parse_cpulist(const std::string &list) {
+            std::vector<int> cpu;
+            std::stringstream stream(list);
+            std::string range;
+            while (std::getline(stream, range, ',')) {
+                const size_t dash = range.find('-');
+                try {
+                    const int first = std::stoi(range.substr(0, dash));
+                    const int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+                    for (int c = first; c <= last; ++c) { cpu.push_back(c); }
+                } catch (const std::exception&) {  // Blank line, ...
+                }
+            }
+            return cpu;
+        }
+
+        /*
+         * CPUs the calling thread may run on.
+         */
+        inline std::vector<int> allowed_cpus() {
+            std::vector<int> cpu;
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(cpu_set_t), &mask) == 0) {
+                for (int c = 0; c < CPU_SETSIZE; ++c) {
+                    if (CPU_ISSET(c, &mask)) { cpu.push_back(c); }
+                }
+            }
+            return cpu;
+        }
+    }
+
+    /*
+     * Limit OpenMP/MKL parallel regions started from the calling thread to
+     * `N_thread` threads.
+     *
+     * FFTW plans fix their thread count at creation (see FFTW_FFT's `N_threads`).
+     */
+    inline void set_thread_budget(const size_t N_thread) {
+        #ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(N_thread));
+        #endif
+        #ifdef EIGEN_USE_MKL_ALL
+        mkl_set_num_threads_local(static_cast<int>(N_thread));
+        #endif
+        (void) N_thread;
+    }
+
+    /*
+     * NUMA domains of the CPUs available to the calling thread.
+     *
+     * Domains are read from /sys/devices/system/node and restricted to the
+     * calling thread's affinity mask (taskset, cgroups, enclosing bind(), ...).
+     * Machines without NUMA information are treated as a single domain.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/util/runtime.hpp"
+     *
+     *    namespace runtime = pypeline::util::runtime;
+     *
+     *    runtime::Topology topo;  // Ex: 2 domains of 16 CPUs.
+     *    topo.share(0, 4);        // CPUs {0, ..., 7} of domain 0.
+     *    topo.share(0, 2);        // Domain 0.
+     *    topo.share(0, 1);        // Domains {0, 1}.
+     */
+    class Topology {
+        private:
+            std::vector<std::vector<int>> m_domain {};  // Non-empty, sorted.
+
+        public:
+            Topology() {
+                const std::vector<int> allowed = _detail::allowed_cpus();
+
+                for (size_t node = 0; ; ++node) {
+                    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    if (!file) { break; }
+
+                    std::string list;
+                    std::getline(file, list);
+                    std::vector<int> cpu;
+                    for (const int c : _detail::parse_cpulist(list)) {
+                        if (std::binary_search(allowed.begin(), allowed.end(), c)) { cpu.push_back(c); }
+                    }
+                    if (!cpu.empty()) { m_domain.push_back(cpu); }
+                }
+
+                if (m_domain.empty() && !allowed.empty()) {
+                    m_domain.push_back(allowed);
+                }
+            }
+
+            /*
+             * Topology made of the given domains.
+             *
+             * Empty domains are dropped, CPUs are sorted.
+             */
+            explicit Topology(std::vector<std::vector<int>> domain) {
+                for (auto &d : domain) {
+                    if (d.empty()) { continue; }
+                    std::sort(d.begin(), d.end());
+                    m_domain.push_back(std::move(d));
+                }
+            }
+
+            size_t N_domain() const {
+                return m_domain.size();
+            }
+
+            const std::vector<int>& domain(const size_t i) const {
+                return m_domain.at(i);
+            }
+
+            /*
+             * Returns
+             * -------
+             * cpu : std::vector<int>
+             *     All CPUs of the topology.
+             */
+            std::vector<int> cpus() const {
+                std::vector<int> cpu;
+                for (const auto &d : m_domain) { cpu.insert(cpu.end(), d.begin(), d.end()); }
+                return cpu;
+            }
+
+            /*
+             * CPUs of slot `i` when dividing the topology into `N` slots.
+             *
+             * With N <= N_domain, slots are groups of whole domains.
+             * Otherwise each domain is split into contiguous CPU ranges, one
+             * per slot assigned to it: slots never straddle domains.
+             */
+            std::vector<int> share(const size_t i,
+                                   const size_t N) const {
+                const size_t D = m_domain.size();
+                if ((D == 0) || (i >= N)) { return {}; }
+
+                std::vector<int> cpu;
+                if (N <= D) {
+                    for (size_t d = (i * D) / N; d < ((i + 1) * D) / N; ++d) {
+                        cpu.insert(cpu.end(), m_domain[d].begin(), m_domain[d].end());
+                    }
+                } else {
+                    const size_t d = (i * D) / N;
+                    const size_t slot_start = (d * N + D - 1) / D;  // Slots j with (j * D) / N == d.
+                    const size_t slot_end = ((d + 1) * N + D - 1) / D;
+                    const size_t N_slot = slot_end - slot_start;
+                    const size_t p = i - slot_start;
+
+                    const std::vector<int> &dom = m_domain[d];
+                    const size_t C = dom.size();
+                    const size_t start = (p * C) / N_slot, end = ((p + 1) * C) / N_slot;
+                    if (start < end) {
+                        cpu.assign(dom.begin() + start, dom.begin() + end);
+                    } else {  // More slots than CPUs.
+                        cpu.push_back(dom[p % C]);
+                    }
+                }
+                return cpu;
+            }
+
+            /*
+             * Returns
+             * -------
+             * cpu : std::vector<int>
+             *     CPUs of all domains containing at least one of `cpu`.
+             */
+            std::vector<int> domains_of(const std::vector<int> &cpu) const {
+                std::vector<int> out;
+                for (const auto &d : m_domain) {
+                    const bool hit = std::any_of(cpu.begin(), cpu.end(), [&d](const int c) {
+                        return std::binary_search(d.begin(), d.end(), c);
+                    });
+                    if (hit) { out.insert(out.end(), d.begin(), d.end()); }
+                }
+                return out;
+            }
+    };
+
+    /*
+     * Pin the calling thread to `cpu`.
+     *
+     * Returns
+     * -------
+     * ok : bool
+     *     false if the affinity could not be changed. The thread then keeps its affinity.
+     */
+    inline bool pin(const std::vector<int> &cpu) {
+        if (cpu.empty()) { return false; }
+
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (const int c : cpu) {
+            if ((0 <= c) && (c < CPU_SETSIZE)) { CPU_SET(c, &mask); }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask) == 0;
+    }
+
+    /*
+     * Pin the calling thread to slot `i` out of `N` of `topo`, and limit the
+     * parallel regions it starts to `N_thread` threads.
+     *
+     * If the slot holds fewer than N_thread CPUs, the binding is widened to
+     * the slot's domains, then to the whole topology: a thread given a larger
+     * budget (ex: once other tasks completed) is not confined to a few CPUs.
+     *
+     * Notes
+     * -----
+     * OpenMP threads inherit the binding when created: threads of teams which
+     * already exist keep their previous binding.
+     */
+    inline bool bind(const Topology &topo,
+                     const size_t i,
+                     const size_t N,
+                     const size_t N_thread) {
+        std::vector<int> cpu = topo.share(i, N);
+        if (cpu.size() < N_thread) { cpu = topo.domains_of(cpu); }
+        if (cpu.size() < N_thread) { cpu = topo.cpus(); }
+
+        set_thread_budget(std::max<size_t>(1, N_thread));
+        return pin(cpu);
+    }
+
+    /*
+     * Zero [ptr, ptr + size) with up to N_thread threads.
+     *
+     * Linux places each page on the NUMA node of the thread which first
+     * writes to it: pages of large buffers initialized here are spread over
+     * the (bound) team which later computes on them, instead of all landing
+     * on the allocating thread's node.
+     */
+    inline void first_touch(void *ptr,
+                            const size_t size,
+                            const size_t N_thread) {
+        char *data = static_cast<char*>(ptr);
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const long N_page = static_cast<long>((size + page - 1) / page);
+
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(static) num_threads(std::max<size_t>(1, N_thread))
+        #endif
+        for (long k = 0; k < N_page; ++k) {
+            const size_t start = static_cast<size_t>(k) * page;
+            std::memset(data + start, 0, std::min(page, size - start));
+        }
+        (void) N_thread;
+    }
+}}}
+
+#endif //PYPELINE_UTIL_RUNTIME_HPP
@@ -0,0 +1,454 @@
+// ############################################################################
+// simd.hpp
+// ========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Vectorized kernels, selected at runtime for the host's instruction set.
+ *
+ * Pypeline is built for a portable baseline ISA. The kernels below are
+ * additionally compiled for SSE4.2, AVX2 and AVX-512, and calls are routed
+ * to the best variant supported by the CPU (queried once through CPUID).
+ *
+ * Variants evaluate the same expressions, but AVX2/AVX-512 variants may fuse
+ * multiply-adds: results can differ in the last bits across instruction sets.
+ * The environment variable PYPELINE_ISA = {generic, sse4.2, avx2, avx512}
+ * lowers the selected instruction set, e.g. to obtain bit-identical results
+ * on heterogeneous nodes.
+ */
+
+#ifndef PYPELINE_UTIL_SIMD_HPP
+#define PYPELINE_UTIL_SIMD_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define PYPELINE_SIMD_DISPATCH 1
+    #define PYPELINE_SIMD_TARGET(ISA) __attribute__((target(ISA), flatten))
+#else
+    #define PYPELINE_SIMD_DISPATCH 0
+#endif
+
+namespace pypeline { namespace util { namespace simd {
+    enum class isa: unsigned int {
+        GENERIC = 0,
+        SSE4_2 = 1,
+        AVX2 = 2,
+        AVX512 = 3
+    };
+
+    inline std::string name(const isa level) {
+        switch (level) {
+            case isa::SSE4_2: return "sse4.2";
+            case isa::AVX2:   return "avx2";
+            case isa::AVX512: return "avx512";
+            default:          return "generic";
+        }
+    }
+
+    namespace _detail {
+        inline isa detect() {
+            #if PYPELINE_SIMD_DISPATCH
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+                    return isa::AVX512;
+                } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                    return isa::AVX2;
+                } else if (__builtin_cpu_supports("sse4.2")) {
+                    return isa::SSE4_2;
+                }
+            #endif
+            return isa::GENERIC;
+        }
+
+        inline isa select() {
+            isa level = detect();
+
+            const char *request = std::getenv("PYPELINE_ISA");
+            if (request != nullptr) {
+                for (const isa l : {isa::GENERIC, isa::SSE4_2, isa::AVX2, isa::AVX512}) {
+                    if ((name(l) == request) && (l < level)) {
+                        level = l;
+                    }
+                }
+            }
+            return level;
+        }
+
+        /*
+         * Kernel bodies.
+         *
+         * Complex values are processed as interleaved (real, imag) pairs: the
+         * compiler vectorizes such loops, but not std::complex arithmetic
+         * (which handles NaN/inf operands through library calls).
+         */
+        template <typename TT>
+        inline void multiply(std::complex<TT> *x,
+                             const std::complex<TT> *y,
+                             const size_t N_outer,
+                             const size_t N,
+                             const size_t N_inner) {
+            TT *_x = reinterpret_cast<TT*>(x);
+            const TT *_y = reinterpret_cast<const TT*>(y);
+
+            if (N_inner == 1) {
+                for (size_t o = 0; o < N_outer; ++o) {
+                    TT *row = _x + 2 * o * N;
+                    for (size_t k = 0; k < N; ++k) {
+                        const TT xr = row[2 * k], xi = row[2 * k + 1];
+                        const TT yr = _y[2 * k], yi = _y[2 * k + 1];
+                        row[2 * k] = xr * yr - xi * yi;
+                        row[2 * k + 1] = xr * yi + xi * yr;
+                    }
+                }
+            } else {
+                for (size_t o = 0; o < N_outer; ++o) {
+                    for (size_t k = 0; k < N; ++k) {
+                        TT *row = _x + 2 * (o * N + k) * N_inner;
+                        const TT yr = _y[2 * k], yi = _y[2 * k + 1];
+                        for (size_t i = 0; i < N_inner; ++i) {
+                            const TT xr = row[2 * i], xi = row[2 * i + 1];
+                            row[2 * i] = xr * yr - xi * yi;
+                            row[2 * i + 1] = xr * yi + xi * yr;
+                        }
+                    }
+                }
+            }
+        }
+
+        template <typename TT>
+        inline void scale(std::complex<TT> *x,
+                          const TT *w,
+                          const size_t N_outer,
+                          const size_t N,
+                          const size_t N_inner) {
+            TT *_x = reinterpret_cast<TT*>(x);
+
+            if (N_inner == 1) {
+                for (size_t o = 0; o < N_outer; ++o) {
+                    TT *row = _x + 2 * o * N;
+                    for (size_t k = 0; k < N; ++k) {
+                        row[2 * k] *= w[k];
+                        row[2 * k + 1] *= w[k];
+                    }
+                }
+            } else {
+                for (size_t o = 0; o < N_outer; ++o) {
+                    for (size_t k = 0; k < N; ++k) {
+                        TT *row = _x + 2 * (o * N + k) * N_inner;
+                        for (size_t i = 0; i < 2 * N_inner; ++i) {
+                            row[i] *= w[k];
+                        }
+                    }
+                }
+            }
+        }
+
+        template <typename TT>
+        inline void abs2(std::complex<TT> *x,
+                         const size_t N) {
+            TT *_x = reinterpret_cast<TT*>(x);
+            for (size_t k = 0; k < N; ++k) {
+                const TT xr = _x[2 * k], xi = _x[2 * k + 1];
+                _x[2 * k] = xr * xr + xi * xi;
+            }
+        }
+
+        inline uint64_t to_bits(const double x) {
+            uint64_t bits;
+            std::memcpy(&bits, &x, sizeof(double));
+            return bits;
+        }
+
+        inline double from_bits(const uint64_t bits) {
+            double x;
+            std::memcpy(&x, &bits, sizeof(double));
+            return x;
+        }
+
+        /*
+         * (sin(x), cos(x)) for |x| <= 2^30, within 2 ulp.
+         *
+         * Branch-free (Cody-Waite reduction by pi/2, fdlibm polynomials on
+         * [-pi/4, pi/4], quadrant selected with bit masks): unlike std::sin
+         * and std::cos, loops calling it are vectorized.
+         */
+        inline void sin_cos(const double x, double &s, double &c) {
+            const double round = 6755399441055744.0;  // 1.5 * 2^52: (v + round) - round rounds v to an integer.
+            const double v = (x * 0.63661977236758134308) + round;  // x * (2 / pi)
+            const double q = v - round;
+            const uint64_t n = to_bits(v);  // Low bits hold q mod 4.
+
+            // pi / 2 = P1 + P2 + P3, with P1, P2 holding 22 bits: q * P1 and q * P2 are exact.
+            const double r = ((x - q * 1.570796012878418) - q * 3.139164164167596e-07) - q * 6.223372171896613e-14;
+            const double r2 = r * r;
+
+            const double sr = r + (r * r2) * (-1.66666666666666324348e-01 + r2 * (8.33333333332248946124e-03 +
+                              r2 * (-1.98412698298579493134e-04 + r2 * (2.75573137070700676789e-06 +
+                              r2 * (-2.50507602534068634195e-08 + r2 * 1.58969099521155010221e-10)))));
+            const double cr = (1 - 0.5 * r2) + (r2 * r2) * (4.16666666666666019037e-02 + r2 * (-1.38888888888741095749e-03 +
+                              r2 * (2.48015872894767294178e-05 + r2 * (-2.75573143513906633035e-07 +
+                              r2 * (2.08757232129817482790e-09 + r2 * -1.13596475577881948265e-11)))));
+
+            // Quadrant q mod 4 -> (sin, cos) = {(sr, cr), (cr, -sr), (-sr, -cr), (-cr, sr)}.
+            const uint64_t swap = 0 - (n & 1);
+            const uint64_t bits_s = (to_bits(sr) & ~swap) | (to_bits(cr) & swap);
+            const uint64_t bits_c = (to_bits(cr) & ~swap) | (to_bits(sr) & swap);
+            s = from_bits(bits_s ^ ((n & 2) << 62));
+            c = from_bits(bits_c ^ (((n + 1) & 2) << 62));
+        }
+
+        template <typename TT>
+        inline void exp_imag(std::complex<TT> *x,
+                             const TT *w,
+                             const size_t N_outer,
+                             const size_t N,
+                             const size_t N_inner) {
+            TT *_x = reinterpret_cast<TT*>(x);
+
+            if (N_inner == 1) {
+                for (size_t o = 0; o < N_outer; ++o) {
+                    TT *row = _x + 2 * o * N;
+                    for (size_t k = 0; k < N; ++k) {
+                        double s, c;
+                        sin_cos(row[2 * k + 1], s, c);
+                        row[2 * k] = static_cast<TT>(w[k] * c);
+                        row[2 * k + 1] = static_cast<TT>(w[k] * s);
+                    }
+                }
+            } else {
+                for (size_t o = 0; o < N_outer; ++o) {
+                    for (size_t k = 0; k < N; ++k) {
+                        TT *row = _x + 2 * (o * N + k) * N_inner;
+                        const double wk = w[k];
+                        for (size_t i = 0; i < N_inner; ++i) {
+                            double s, c;
+                            sin_cos(row[2 * i + 1], s, c);
+                            row[2 * i] = static_cast<TT>(wk * c);
+                            row[2 * i + 1] = static_cast<TT>(wk * s);
+                        }
+                    }
+                }
+            }
+        }
+
+        template <typename TT>
+        inline void tukey(const TT *y,
+                          TT *amplitude,
+                          const size_t N,
+                          const double T,
+                          const double alpha) {
+            // Ternaries below compile to blends: the loops are vectorized.
+            if (alpha == 0) {  // Rectangular window.
+                for (size_t k = 0; k < N; ++k) {
+                    const double yk = y[k];
+                    double d = T - yk;
+                    d = (yk < d) ? yk : d;  // Distance to the nearest end of [0, T], negative outside, NaN for NaN.
+                    amplitude[k] = static_cast<TT>((d >= 0) ? 1.0 : 0.0);
+                }
+                return;
+            }
+
+            // sin^2(pi d / (T alpha)) with d the distance to the nearest end of [0, T],
+            // clipped to [0, T alpha / 2]: tapers are 0 outside [0, T] and 1 between them.
+            const double lim = 0.5 * T * alpha;
+            const double a = M_PI / (T * alpha);
+            for (size_t k = 0; k < N; ++k) {
+                const double yk = y[k];
+                double d = T - yk;
+                d = (yk < d) ? yk : d;
+                d = (d > 0) ? d : 0;  // Also maps NaN to 0.
+                d = (d < lim) ? d : lim;
+
+                double s, c;
+                sin_cos(a * d, s, c);
+                amplitude[k] = static_cast<TT>(s * s);
+            }
+        }
+
+        template <typename TT>
+        struct kernel_table {
+            void (*multiply)(std::complex<TT>*, const std::complex<TT>*, size_t, size_t, size_t);
+            void (*scale)(std::complex<TT>*, const TT*, size_t, size_t, size_t);
+            void (*abs2)(std::complex<TT>*, size_t);
+            void (*exp_imag)(std::complex<TT>*, const TT*, size_t, size_t, size_t);
+            void (*tukey)(const TT*, TT*, size_t, double, double);
+        };
+
+        /*
+         * Instantiate kernel bodies for one instruction set.
+         *
+         * flatten inlines the (target-agnostic) bodies into the wrappers, which
+         * are then vectorized for ISA.
+         */
+        #if PYPELINE_SIMD_DISPATCH
+            #define PYPELINE_SIMD_VARIANT(SUFFIX, ISA)                                              \
+                template <typename TT>                                                              \
+                PYPELINE_SIMD_TARGET(ISA)                                                           \
+                void multiply_##SUFFIX(std::complex<TT> *x, const std::complex<TT> *y,              \
+                                       size_t N_outer, size_t N, size_t N_inner) {                  \
+                    multiply<TT>(x, y, N_outer, N, N_inner);                                        \
+                }                                                                                   \
+                                                                                                    \
+                template <typename TT>                                                              \
+                PYPELINE_SIMD_TARGET(ISA)                                                           \
+                void scale_##SUFFIX(std::complex<TT> *x, const TT *w,                               \
+                                    size_t N_outer, size_t N, size_t N_inner) {                     \
+                    scale<TT>(x, w, N_outer, N, N_inner);                                           \
+                }                                                                                   \
+                                                                                                    \
+                template <typename TT>                                                              \
+                PYPELINE_SIMD_TARGET(ISA)                                                           \
+                void abs2_##SUFFIX(std::complex<TT> *x, size_t N) {                                 \
+                    abs2<TT>(x, N);                                                                 \
+                }                                                                                   \
+                                                                                                    \
+                template <typename TT>                                                              \
+                PYPELINE_SIMD_TARGET(ISA)                                                           \
+                void exp_imag_##SUFFIX(std::complex<TT> *x, const TT *w,                            \
+                                       size_t N_outer, size_t N, size_t N_inner) {                  \
+                    exp_imag<TT>(x, w, N_outer, N, N_inner);                                        \
+                }                                                                                   \
+                                                                                                    \
+                template <typename TT>                                                              \
+                PYPELINE_SIMD_TARGET(ISA)                                                           \
+                void tukey_##SUFFIX(const TT *y, TT *amplitude, size_t N, double T, double alpha) { \
+                    tukey<TT>(y, amplitude, N, T, alpha);                                           \
+                }                                                                                   \
+                                                                                                    \
+                template <typename TT>                                                              \
+                kernel_table<TT> table_##SUFFIX() {                                                 \
+                    return {&multiply_##SUFFIX<TT>, &scale_##SUFFIX<TT>, &abs2_##SUFFIX<TT>,        \
+                            &exp_imag_##SUFFIX<TT>, &tukey_##SUFFIX<TT>};                           \
+                }
+
+            PYPELINE_SIMD_VARIANT(sse4_2, "sse4.2")
+            PYPELINE_SIMD_VARIANT(avx2, "avx2,fma")
+            PYPELINE_SIMD_VARIANT(avx512, "avx512f,avx512dq,avx2,fma")
+            #undef PYPELINE_SIMD_VARIANT
+        #endif
+
+        template <typename TT>
+        kernel_table<TT> make_table(const isa level) {
+            #if PYPELINE_SIMD_DISPATCH
+                switch (level) {
+                    case isa::AVX512: return table_avx512<TT>();
+                    case isa::AVX2:   return table_avx2<TT>();
+                    case isa::SSE4_2: return table_sse4_2<TT>();
+                    default:          break;
+                }
+            #endif
+            return {&multiply<TT>, &scale<TT>, &abs2<TT>, &exp_imag<TT>, &tukey<TT>};
+        }
+    }
+
+    /*
+     * Returns
+     * -------
+     * level : isa
+     *     Instruction set used by the kernels of this module.
+     */
+    inline isa active() {
+        static const isa level = _detail::select();
+        return level;
+    }
+
+    namespace _detail {
+        template <typename TT>
+        const kernel_table<TT>& table() {
+            static_assert(std::is_floating_point<TT>::value, "Only {float, double} are allowed for Type[TT].");
+            static const kernel_table<TT> t = make_table<TT>(active());
+            return t;
+        }
+    }
+
+    /*
+     * x[o, k, i] *= y[k] for a contiguous (N_outer, N, N_inner) tensor x.
+     *
+     * Examples
+     * --------
+     * .. literal_block::
+     *
+     *    #include "pypeline/util/simd.hpp"
+     *
+     *    namespace simd = pypeline::util::simd;
+     *
+     *    std::vector<std::complex<float>> x(4 * 100), y(100);
+     *    // ... fill x, y ...
+     *    simd::multiply(x.data(), y.data(), 4, 100, 1);  // Modulate each row of x by y.
+     */
+    template <typename TT>
+    void multiply(std::complex<TT> *x,
+                  const std::complex<TT> *y,
+                  const size_t N_outer,
+                  const size_t N,
+                  const size_t N_inner) {
+        _detail::table<TT>().multiply(x, y, N_outer, N, N_inner);
+    }
+
+    /*
+     * x[o, k, i] *= w[k] for a contiguous (N_outer, N, N_inner) tensor x and real-valued w.
+     */
+    template <typename TT>
+    void scale(std::complex<TT> *x,
+               const TT *w,
+               const size_t N_outer,
+               const size_t N,
+               const size_t N_inner) {
+        _detail::table<TT>().scale(x, w, N_outer, N, N_inner);
+    }
+
+    /*
+     * real(x[k]) = |x[k]|^{2} in place, for k in {0, ..., N - 1}.
+     *
+     * Imaginary parts are left untouched: the result is read through a
+     * real-valued view of x with stride 2.
+     */
+    template <typename TT>
+    void abs2(std::complex<TT> *x,
+              const size_t N) {
+        _detail::table<TT>().abs2(x, N);
+    }
+
+    /*
+     * x[o, k, i] = w[k] * exp(j * imag(x[o, k, i])) for a contiguous (N_outer, N, N_inner)
+     * tensor x and real-valued w.
+     *
+     * Real parts of x are ignored, i.e. x is treated as purely imaginary.
+     * Phases must satisfy |imag(x)| <= 2^30.
+     */
+    template <typename TT>
+    void exp_imag(std::complex<TT> *x,
+                  const TT *w,
+                  const size_t N_outer,
+                  const size_t N,
+                  const size_t N_inner) {
+        _detail::table<TT>().exp_imag(x, w, N_outer, N, N_inner);
+    }
+
+    /*
+     * (N,) samples of a Tukey window of support [0, T] and decay-rate alpha in [0, 1].
+     *
+     * amplitude[k] = sin^2(pi y[k] / (T alpha))        if 0 <= y[k] < T alpha / 2,
+     *                1                                 if T alpha / 2 <= y[k] <= T (1 - alpha / 2),
+     *                sin^2(pi (T - y[k]) / (T alpha))  if T (1 - alpha / 2) < y[k] <= T,
+     *                0                                 otherwise.
+     */
+    template <typename TT>
+    void tukey(const TT *y,
+               TT *amplitude,
+               const size_t N,
+               const double T,
+               const double alpha) {
+        _detail::table<TT>().tukey(y, amplitude, N, T, alpha);
+    }
+}}}
+
+#endif //PYPELINE_UTIL_SIMD_HPP
@@ -0,0 +1,29 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Beamforming-related operations and tools.
+
+*Beamforming* is the process of combining signals from different receiving elements through a linear operator, with the dual role of:
+
+* Reducing data-rates from antennas;
+* Form super-antennas with particular radiation patterns.
+
+Only simple beamformers are included here: more advanced variants can be found in the :py:mod:`pypeline_extras` package.
+"""
+
+import _pypeline_phased_array_beamforming_pybind11 as __cpp
+
+from . import _beamforming as __py
+
+is_beam_index = __py.is_beam_index
+is_mb_beam_config = __py.is_mb_beam_config
+BeamWeights = __py.BeamWeights
+BeamformerBlock = __py.BeamformerBlock
+MatchedBeamformerBlock = __py.MatchedBeamformerBlock
+
+MatchedBeamformerBlock_float32 = __cpp.MatchedBeamformerBlock_float32
+MatchedBeamformerBlock_float64 = __cpp.MatchedBeamformerBlock_float64
@@ -1,6 +1,6 @@
 # #############################################################################
-# beamforming.py
-# ==============
+# _beamforming.py
+# ===============
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -22,6 +22,7 @@ import numpy as np
 import pandas as pd
 import scipy.sparse as sparse
 
+import _pypeline_phased_array_beamforming_pybind11 as bf_cpp
 import pypeline
 import pypeline.core as core
 import pypeline.phased_array.instrument as instrument
@@ -238,15 +239,15 @@ class MatchedBeamformerBlock(BeamformerBlock):
                             .xyz
                             .value)
 
-        station_id = np.array(station_id)
-        beam_id = np.array(beam_id)
-        focus_dir = np.stack(focus_dir, axis=1)
+        self._station_id = np.array(station_id, dtype=np.int64)
+        self._beam_id = np.array(beam_id, dtype=np.int64)
+        self._focus_dir = np.stack(focus_dir, axis=0)
 
-        self._config = pd.DataFrame(dict(STATION_ID=station_id,
-                                         BEAM_ID=beam_id,
-                                         F_X=focus_dir[0],
-                                         F_Y=focus_dir[1],
-                                         F_Z=focus_dir[2]))
+        # Sparsity pattern of the weights, built on first use for a given antenna layout.
+        self._ant_idx = None
+        self._cpp = None
+        self._row_order = None
+        self._row_idx = None
 
     @chk.check(dict(XYZ=chk.is_instance(instrument.InstrumentGeometry),
                     wl=chk.is_real))
@@ -305,18 +306,34 @@ class MatchedBeamformerBlock(BeamformerBlock):
         if wl <= 0:
             raise ValueError('Parameter[wl] must be positive.')
 
-        xyz = XYZ.as_frame()
-        xyz = (xyz - xyz.mean()) / wl
-
-        data = pd.merge(xyz.reset_index(), self._config, on='STATION_ID')
-        XYZ = data.loc[:, ['X', 'Y', 'Z']].values
-        F_XYZ = data.loc[:, ['F_X', 'F_Y', 'F_Z']].values
-        similarity = np.squeeze(XYZ.reshape(-1, 1, 3) @
-                                F_XYZ.reshape(-1, 3, 1), axis=(1, 2))
-        W = np.exp((-1j * 2 * np.pi) * similarity)
-
-        df = pd.DataFrame(dict(STATION_ID=data.STATION_ID,
-                               ANTENNA_ID=data.ANTENNA_ID,
-                               BEAM_ID=data.BEAM_ID,
-                               W=W))
-        return _as_BeamWeights(df)
+        ant_idx = XYZ.index[0]
+        if (self._ant_idx is None) or (not self._ant_idx.equals(ant_idx)):
+            station_id = ant_idx.get_level_values('STATION_ID').values
+            self._cpp = bf_cpp.MatchedBeamformerBlock_float64(station_id.astype(np.int64),
+                                                              self._station_id,
+                                                              self._beam_id,
+                                                              self._focus_dir)
+            self._ant_idx = ant_idx
+
+            # C++ rows follow the input antenna order: sort them by (STATION_ID, ANTENNA_ID).
+            row_idx = ant_idx[self._cpp.antenna_idx]
+            order = np.lexsort((row_idx.get_level_values('ANTENNA_ID').values,
+                                row_idx.get_level_values('STATION_ID').values))
+            self._row_order = None if np.all(order == np.arange(len(order))) else order
+            self._row_idx = row_idx if (self._row_order is None) else row_idx[order]
+
+        W = self._cpp(XYZ.data, wl).tocsr()
+        if self._row_order is not None:
+            W = W[self._row_order]
+        N_antenna, N_beam = W.shape
+
+        sparsity_ratio = W.nnz / (N_antenna * N_beam)
+        max_sparsity_ratio = pypeline.config.getfloat('phased_array.beamforming',
+                                                      'bw_max_sparsity_ratio')
+        if sparsity_ratio > max_sparsity_ratio:  # Use dense matrix
+            W = W.toarray()
+
+        bW = BeamWeights(W,
+                         self._row_idx,
+                         pd.Index(self._cpp.beam_id, name='BEAM_ID'))
+        return bW
@@ -0,0 +1,123 @@
+// ############################################################################
+// _beamforming_pybind11.cpp
+// =========================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/stl.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/beamforming.hpp"
+
+namespace beamforming = pypeline::phased_array::beamforming;
+
+template <typename TT>
+void MatchedBeamformerBlock_bindings(pybind11::module &m,
+                                     const std::string &class_name) {
+    using cTT = std::complex<TT>;
+    using block_t = beamforming::MatchedBeamformerBlock<TT>;
+
+    auto obj = pybind11::class_<block_t>(m,
+                                         class_name.data(),
+                                         R"EOF(
+Compute matched-beamforming (MB) weights.
+
+The sparsity pattern of the weights is built once from station membership and the beam configuration.
+Each call only updates the non-zero values, and outputs a :py:class:`~scipy.sparse.csc_matrix`.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.beamforming import MatchedBeamformerBlock_float64
+
+.. doctest::
+
+   >>> antenna_station_id = np.array([0, 0, 1, 1, 1])
+   >>> mb = MatchedBeamformerBlock_float64(antenna_station_id,
+   ...                                     station_id=np.array([0, 1]),
+   ...                                     beam_id=np.array([0, 1]),
+   ...                                     focus_dir=np.array([[0., 0., 1.], [0., 0., 1.]]))
+
+   >>> XYZ = np.random.randn(5, 3)
+   >>> W = mb(XYZ, wl=2)
+   >>> W.shape, W.nnz
+   ((5, 2), 5)
+)EOF");
+
+    obj.def(pybind11::init([](const std::vector<int64_t> &antenna_station_id,
+                              const std::vector<int64_t> &station_id,
+                              const std::vector<int64_t> &beam_id,
+                              Eigen::Ref<const MatrixXX_t<double>> focus_dir) {
+        return std::make_unique<block_t>(antenna_station_id, station_id, beam_id, focus_dir);
+    }), pybind11::arg("antenna_station_id").none(false),
+        pybind11::arg("station_id").none(false),
+        pybind11::arg("beam_id").none(false),
+        pybind11::arg("focus_dir").none(false),
+        pybind11::doc(R"EOF(
+__init__(antenna_station_id, station_id, beam_id, focus_dir)
+
+Parameters
+----------
+antenna_station_id : :py:class:`~numpy.ndarray`
+    (N_antenna,) STATION_ID of each antenna.
+station_id : :py:class:`~numpy.ndarray`
+    (N_info,) STATION_ID of each beam configuration entry.
+beam_id : :py:class:`~numpy.ndarray`
+    (N_info,) BEAM_ID of each beam configuration entry.
+focus_dir : :py:class:`~numpy.ndarray`
+    (N_info, 3) Cartesian unit vectors pointing at the focus of each beam configuration entry.
+)EOF"));
+
+    obj.def("__call__", [](block_t &block,
+                           Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                           const double wl) {
+        SpMatrixXX_t<cTT> W;
+        {
+            pybind11::gil_scoped_release release;
+            W = block(XYZ, wl);
+        }
+        return W;
+    }, pybind11::arg("XYZ").none(false),
+       pybind11::arg("wl").none(false),
+       pybind11::doc(R"EOF(
+__call__(XYZ, wl)
+
+Determine beamweights to apply to each (antenna, beam) pair.
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) Cartesian antenna coordinates, in the same frame as `focus_dir`.
+wl : float
+    Wave-length [m] at which to generate beamweights.
+
+Returns
+-------
+W : :py:class:`~scipy.sparse.csc_matrix`
+    (N_antenna, N_beam) synthesis beamweights.
+    Rows are the antennas listed in :py:attr:`antenna_idx`; columns are the beams listed in :py:attr:`beam_id`.
+)EOF"));
+
+    obj.def_property_readonly("antenna_idx", &block_t::antenna_idx);
+    obj.def_property_readonly("beam_id", &block_t::beam_id);
+    obj.def_property_readonly("N_antenna", &block_t::N_antenna);
+    obj.def_property_readonly("N_beam", &block_t::N_beam);
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_beamforming_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    MatchedBeamformerBlock_bindings<float>(m, "MatchedBeamformerBlock_float32");
+    MatchedBeamformerBlock_bindings<double>(m, "MatchedBeamformerBlock_float64");
+}
@@ -0,0 +1,22 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Data processors.
+"""
+
+import _pypeline_phased_array_bluebild_data_processor_pybind11 as __cpp
+
+from . import _data_processor as __py
+
+DataProcessorBlock = __py.DataProcessorBlock
+IntensityFieldDataProcessorBlock = __py.IntensityFieldDataProcessorBlock
+SensitivityFieldDataProcessorBlock = __py.SensitivityFieldDataProcessorBlock
+
+IntensityFieldDataProcessorBlock_float32 = __cpp.IntensityFieldDataProcessorBlock_float32
+IntensityFieldDataProcessorBlock_float64 = __cpp.IntensityFieldDataProcessorBlock_float64
+SensitivityFieldDataProcessorBlock_float32 = __cpp.SensitivityFieldDataProcessorBlock_float32
+SensitivityFieldDataProcessorBlock_float64 = __cpp.SensitivityFieldDataProcessorBlock_float64
@@ -1,6 +1,6 @@
 # #############################################################################
-# data_processor.py
-# =================
+# _data_processor.py
+# ==================
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -10,11 +10,11 @@ Data processors.
 
 import numpy as np
 
+import _pypeline_phased_array_bluebild_data_processor_pybind11 as dp_cpp
 import pypeline.core as core
 import pypeline.phased_array.util.data_gen.visibility as vis
 import pypeline.phased_array.util.gram as gram
 import pypeline.util.argcheck as chk
-import pypeline.util.math.linalg as pylinalg
 
 
 class DataProcessorBlock(core.Block):
@@ -48,8 +48,9 @@ class IntensityFieldDataProcessorBlock(DataProcessorBlock):
     """
 
     @chk.check(dict(N_eig=chk.is_integer,
-                    cluster_centroids=chk.has_reals))
-    def __init__(self, N_eig, cluster_centroids):
+                    cluster_centroids=chk.has_reals,
+                    warm_start=chk.is_boolean))
+    def __init__(self, N_eig, cluster_centroids, warm_start=False):
         """
         Parameters
         ----------
@@ -57,6 +58,12 @@ class IntensityFieldDataProcessorBlock(DataProcessorBlock):
             Number of eigenpairs to output after PCA decomposition.
         cluster_centroids : array-like(float)
             Intensity centroids for energy-level clustering.
+        warm_start : bool
+            Seed each fPCA decomposition with the eigenvectors of the previous call.
+            (See :py:class:`~pypeline.util.math.linalg.WarmStartEigh_float64`.)
+
+            Visibility matrices of adjacent epochs have nearly identical dominant eigenspaces: warm-starting cuts fPCA cost several-fold on long observations.
+            Use one instance per frequency channel (or :py:meth:`process_batch`), and only if visibility matrices are positive-semidefinite.
 
         Notes
         -----
@@ -68,6 +75,9 @@ class IntensityFieldDataProcessorBlock(DataProcessorBlock):
         super().__init__()
         self._N_eig = N_eig
         self._cluster_centroids = np.array(cluster_centroids, dtype=float)
+        self._cpp = dp_cpp.IntensityFieldDataProcessorBlock_float64(N_eig,
+                                                                    self._cluster_centroids,
+                                                                    warm_start)
 
     @chk.check(dict(S=chk.is_instance(vis.VisibilityMatrix),
                     G=chk.is_instance(gram.GramMatrix)))
@@ -144,30 +154,46 @@ class IntensityFieldDataProcessorBlock(DataProcessorBlock):
         if not S.is_consistent_with(G, axes=[0, 0]):
             raise ValueError('Parameters[S, G] are inconsistent.')
 
-        # Remove broken BEAM_IDs
-        N_beam = len(G.data)
-        broken_row_id = np.flatnonzero(np.isclose(np.sum(S.data, axis=0),
-                                                  np.sum(S.data, axis=1)))
-        working_row_id = list(set(np.arange(N_beam)) - set(broken_row_id))
-        idx = np.ix_(working_row_id, working_row_id)
-        S, G = S.data[idx], G.data[idx]
+        return self._cpp(S.data, G.data)
 
-        # Functional PCA
-        if not np.allclose(S, 0):
-            D, V = pylinalg.eigh(S, G, tau=1, N=self._N_eig)
-        else:  # S is broken beyond use
-            D, V = np.zeros(self._N_eig), 0
+    @chk.check(dict(S=chk.is_array_like,
+                    G=chk.is_array_like))
+    def process_batch(self, S, G):
+        """
+        Process many frequency channels in parallel.
 
-        # Add broken BEAM_IDs
-        V_aligned = np.zeros((N_beam, self._N_eig), dtype=np.complex)
-        V_aligned[working_row_id] = V
+        Channel `i` re-uses the buffers (and warm-start seeds) of the `i`-th channel of previous calls.
 
-        # Determine energy-level clustering
-        cluster_dist = np.absolute(D.reshape(-1, 1) -
-                                   self._cluster_centroids.reshape(1, -1))
-        cluster_idx = np.argmin(cluster_dist, axis=1)
+        Parameters
+        ----------
+        S : list(:py:class:`~pypeline.phased_array.util.data_gen.visibility.VisibilityMatrix`)
+            (N_channel,) (N_beam, N_beam) visibility matrices.
+        G : list(:py:class:`~pypeline.phased_array.util.gram.GramMatrix`)
+            (N_channel,) (N_beam, N_beam) gram matrices.
 
-        return D, V_aligned, cluster_idx
+        Returns
+        -------
+        D : :py:class:`~numpy.ndarray`
+            (N_channel, N_eig) positive eigenvalues.
+
+        V : :py:class:`~numpy.ndarray`
+            (N_channel, N_beam, N_eig) complex-valued eigenvectors.
+
+        cluster_idx : :py:class:`~numpy.ndarray`
+            (N_channel, N_eig) cluster indices of each eigenpair.
+        """
+        if (len(S) == 0) or (len(S) != len(G)):
+            raise ValueError('Parameters[S, G] are inconsistent.')
+        for (_S, _G) in zip(S, G):
+            if not (chk.is_instance(vis.VisibilityMatrix)(_S) and
+                    chk.is_instance(gram.GramMatrix)(_G)):
+                raise ValueError('Parameters[S, G] must contain VisibilityMatrix and GramMatrix objects respectively.')
+            if not _S.is_consistent_with(_G, axes=[0, 0]):
+                raise ValueError('Parameters[S, G] are inconsistent.')
+
+        S = np.stack([_S.data for _S in S], axis=0)
+        G = np.stack([_G.data for _G in G], axis=0)
+        return self._cpp.process_batch(S, G)
 
 
 class SensitivityFieldDataProcessorBlock(DataProcessorBlock):
@@ -192,6 +218,7 @@ class SensitivityFieldDataProcessorBlock(DataProcessorBlock):
 
         super().__init__()
         self._N_eig = N_eig
+        self._cpp = dp_cpp.SensitivityFieldDataProcessorBlock_float64(N_eig)
 
     @chk.check('G', chk.is_instance(gram.GramMatrix))
     def __call__(self, G):
@@ -248,8 +275,4 @@ class SensitivityFieldDataProcessorBlock(DataProcessorBlock):
            >>> np.around(D, 6)
            array([9.2e-05, 9.4e-05])
         """
-        N_beam = len(G.data)
-        D, V = pylinalg.eigh(G.data, np.eye(N_beam), tau=1, N=self._N_eig)
-        Dg = 1 / (D ** 2)
-
-        return Dg, V
+        return self._cpp(G.data)
@@ -0,0 +1,311 @@
+// ############################################################################
+// _data_processor_pybind11.cpp
+// ============================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/numpy.h"
+#include "pybind11/stl.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/data_processor.hpp"
+
+namespace data_processor = pypeline::phased_array::bluebild::data_processor;
+
+template <typename T>
+using carray_t = pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>;
+
+/*
+ * Extract (N_channel, N_beam) from a (N_channel, N_beam, N_beam) array.
+ */
+template <typename T>
+std::tuple<size_t, size_t> batch_shape(const carray_t<T> &X,
+                                       const std::string &name) {
+    if ((X.ndim() != 3) || (X.shape(1) != X.shape(2))) {
+        std::string msg = "Parameter[" + name + "] must have shape (N_channel, N_beam, N_beam).";
+        throw std::runtime_error(msg);
+    }
+    return std::make_tuple(X.shape(0), X.shape(1));
+}
+
+template <typename TT>
+void IntensityFieldDataProcessorBlock_bindings(pybind11::module &m,
+                                               const std::string &class_name) {
+    using cTT = std::complex<TT>;
+    using block_t = data_processor::IntensityFieldDataProcessorBlock<TT>;
+
+    auto obj = pybind11::class_<block_t>(m,
+                                         class_name.data(),
+                                         R"EOF(
+Data processor for computing intensity fields.
+
+Broken beams are removed through a compacted index map, and outputs are written directly in the layout consumed by :py:class:`~pypeline.phased_array.bluebild.field_synthesizer.fourier_domain.FourierFieldSynthesizerBlock`.
+Frequency channels can be processed concurrently with :py:meth:`process_batch`.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.bluebild.data_processor import IntensityFieldDataProcessorBlock_float64
+
+.. doctest::
+
+   >>> N_beam, N_channel = 5, 3
+   >>> X = np.random.randn(N_channel, N_beam, 2) + 1j * np.random.randn(N_channel, N_beam, 2)
+   >>> S = X @ X.conj().transpose(0, 2, 1)
+   >>> G = np.broadcast_to(np.eye(N_beam, dtype=complex), S.shape)
+
+   >>> I_dp = IntensityFieldDataProcessorBlock_float64(N_eig=2, cluster_centroids=[0., 20.])
+   >>> D, V, cluster_idx = I_dp.process_batch(S, G)
+   >>> D.shape, V.shape, cluster_idx.shape
+   ((3, 2), (3, 5, 2), (3, 2))
+
+   >>> D_0, V_0, cluster_idx_0 = I_dp(S[0], G[0])
+   >>> np.allclose(D_0, D[0])
+   True
+)EOF");
+
+    obj.def(pybind11::init([](const size_t N_eig,
+                              const std::vector<TT> &cluster_centroids,
+                              const bool warm_start) {
+        return std::make_unique<block_t>(N_eig, cluster_centroids, warm_start);
+    }), pybind11::arg("N_eig").none(false),
+        pybind11::arg("cluster_centroids").none(false),
+        pybind11::arg("warm_start") = false,
+        pybind11::doc(R"EOF(
+__init__(N_eig, cluster_centroids, warm_start=False)
+
+Parameters
+----------
+N_eig : int
+    Number of eigenpairs to output after PCA decomposition.
+cluster_centroids : array-like(float)
+    Intensity centroids for energy-level clustering.
+warm_start : bool
+    Seed the fPCA decomposition of each channel with the eigenvectors of its previous call.
+    (See :py:class:`~pypeline.util.math.linalg.WarmStartEigh_float64`.)
+    Only valid if visibility matrices are positive-semidefinite.
+)EOF"));
+
+    obj.def("__call__", [](block_t &block,
+                           Eigen::Ref<const MatrixXX_t<cTT>> S,
+                           Eigen::Ref<const MatrixXX_t<cTT>> G) {
+        const size_t N_eig = block.N_eig();
+        const size_t N_beam = S.rows();
+        pybind11::array_t<TT> D(N_eig);
+        pybind11::array_t<cTT> V({N_beam, N_eig});
+        pybind11::array_t<int64_t> cluster_idx(N_eig);
+
+        TT *D_ptr = D.mutable_data();
+        cTT *V_ptr = V.mutable_data();
+        int64_t *cluster_idx_ptr = cluster_idx.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            block(S, G, D_ptr, V_ptr, cluster_idx_ptr);
+        }
+        return std::make_tuple(D, V, cluster_idx);
+    }, pybind11::arg("S").none(false),
+       pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+__call__(S, G)
+
+fPCA decomposition and data formatting for :py:class:`~pypeline.phased_array.bluebild.field_synthesizer.FieldSynthesizerBlock` objects.
+
+Parameters
+----------
+S : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) visibility matrix.
+G : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) gram matrix.
+
+Returns
+-------
+D : :py:class:`~numpy.ndarray`
+    (N_eig,) positive eigenvalues.
+V : :py:class:`~numpy.ndarray`
+    (N_beam, N_eig) complex-valued eigenvectors.
+    Rows of broken beams are 0.
+cluster_idx : :py:class:`~numpy.ndarray`
+    (N_eig,) cluster indices of each eigenpair.
+)EOF"));
+
+    obj.def("process_batch", [](block_t &block,
+                                carray_t<cTT> S,
+                                carray_t<cTT> G) {
+        size_t N_channel, N_beam;
+        std::tie(N_channel, N_beam) = batch_shape(S, "S");
+        if (batch_shape(G, "G") != std::make_tuple(N_channel, N_beam)) {
+            std::string msg = "Parameters[S, G] are inconsistent.";
+            throw std::runtime_error(msg);
+        }
+
+        const size_t N_eig = block.N_eig();
+        pybind11::array_t<TT> D({N_channel, N_eig});
+        pybind11::array_t<cTT> V({N_channel, N_beam, N_eig});
+        pybind11::array_t<int64_t> cluster_idx({N_channel, N_eig});
+
+        const cTT *S_ptr = S.data();
+        const cTT *G_ptr = G.data();
+        TT *D_ptr = D.mutable_data();
+        cTT *V_ptr = V.mutable_data();
+        int64_t *cluster_idx_ptr = cluster_idx.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            block.process_batch(S_ptr, G_ptr, N_channel, N_beam,
+                                D_ptr, V_ptr, cluster_idx_ptr);
+        }
+        return std::make_tuple(D, V, cluster_idx);
+    }, pybind11::arg("S").none(false),
+       pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+process_batch(S, G)
+
+Process many frequency channels in parallel.
+
+Channel `i` re-uses the buffers (and warm-start seeds) of the `i`-th channel of previous calls.
+
+Parameters
+----------
+S : :py:class:`~numpy.ndarray`
+    (N_channel, N_beam, N_beam) visibility matrices.
+G : :py:class:`~numpy.ndarray`
+    (N_channel, N_beam, N_beam) gram matrices.
+
+Returns
+-------
+D : :py:class:`~numpy.ndarray`
+    (N_channel, N_eig) positive eigenvalues.
+V : :py:class:`~numpy.ndarray`
+    (N_channel, N_beam, N_eig) complex-valued eigenvectors.
+cluster_idx : :py:class:`~numpy.ndarray`
+    (N_channel, N_eig) cluster indices of each eigenpair.
+)EOF"));
+
+    obj.def("reset", &block_t::reset,
+            pybind11::doc(R"EOF(
+reset()
+
+Release per-channel buffers and warm-start seeds.
+)EOF"));
+
+    obj.def_property_readonly("N_eig", &block_t::N_eig);
+    obj.def_property_readonly("cluster_centroids", &block_t::cluster_centroids);
+    obj.def_property_readonly("warm_start", &block_t::warm_start);
+}
+
+template <typename TT>
+void SensitivityFieldDataProcessorBlock_bindings(pybind11::module &m,
+                                                 const std::string &class_name) {
+    using cTT = std::complex<TT>;
+    using block_t = data_processor::SensitivityFieldDataProcessorBlock<TT>;
+
+    auto obj = pybind11::class_<block_t>(m,
+                                         class_name.data(),
+                                         R"EOF(
+Data processor for computing sensitivity fields.
+)EOF");
+
+    obj.def(pybind11::init([](const size_t N_eig) {
+        return std::make_unique<block_t>(N_eig);
+    }), pybind11::arg("N_eig").none(false),
+        pybind11::doc(R"EOF(
+__init__(N_eig)
+
+Parameters
+----------
+N_eig : int
+    Number of eigenpairs to output after PCA decomposition.
+)EOF"));
+
+    obj.def("__call__", [](const block_t &block,
+                           Eigen::Ref<const MatrixXX_t<cTT>> G) {
+        const size_t N_eig = block.N_eig();
+        const size_t N_beam = G.rows();
+        pybind11::array_t<TT> D(N_eig);
+        pybind11::array_t<cTT> V({N_beam, N_eig});
+
+        TT *D_ptr = D.mutable_data();
+        cTT *V_ptr = V.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            block(G, D_ptr, V_ptr);
+        }
+        return std::make_tuple(D, V);
+    }, pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+__call__(G)
+
+fPCA decomposition and data formatting for :py:class:`~pypeline.phased_array.bluebild.field_synthesizer.FieldSynthesizerBlock` objects.
+
+Parameters
+----------
+G : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) gram matrix.
+
+Returns
+-------
+D : :py:class:`~numpy.ndarray`
+    (N_eig,) positive eigenvalues.
+V : :py:class:`~numpy.ndarray`
+    (N_beam, N_eig) complex-valued eigenvectors.
+)EOF"));
+
+    obj.def("process_batch", [](const block_t &block,
+                                carray_t<cTT> G) {
+        size_t N_channel, N_beam;
+        std::tie(N_channel, N_beam) = batch_shape(G, "G");
+
+        const size_t N_eig = block.N_eig();
+        pybind11::array_t<TT> D({N_channel, N_eig});
+        pybind11::array_t<cTT> V({N_channel, N_beam, N_eig});
+
+        const cTT *G_ptr = G.data();
+        TT *D_ptr = D.mutable_data();
+        cTT *V_ptr = V.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            block.process_batch(G_ptr, N_channel, N_beam, D_ptr, V_ptr);
+        }
+        return std::make_tuple(D, V);
+    }, pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+process_batch(G)
+
+Process many frequency channels in parallel.
+
+Parameters
+----------
+G : :py:class:`~numpy.ndarray`
+    (N_channel, N_beam, N_beam) gram matrices.
+
+Returns
+-------
+D : :py:class:`~numpy.ndarray`
+    (N_channel, N_eig) positive eigenvalues.
+V : :py:class:`~numpy.ndarray`
+    (N_channel, N_beam, N_eig) complex-valued eigenvectors.
+)EOF"));
+
+    obj.def_property_readonly("N_eig", &block_t::N_eig);
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_bluebild_data_processor_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    IntensityFieldDataProcessorBlock_bindings<float>(m, "IntensityFieldDataProcessorBlock_float32");
+    IntensityFieldDataProcessorBlock_bindings<double>(m, "IntensityFieldDataProcessorBlock_float64");
+    SensitivityFieldDataProcessorBlock_bindings<float>(m, "SensitivityFieldDataProcessorBlock_float32");
+    SensitivityFieldDataProcessorBlock_bindings<double>(m, "SensitivityFieldDataProcessorBlock_float64");
+}
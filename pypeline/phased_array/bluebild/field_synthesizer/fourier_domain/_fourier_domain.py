@@ -11,7 +11,7 @@ import scipy.linalg as linalg
 import scipy.sparse as sparse
 
 import pypeline.phased_array.bluebild.field_synthesizer as synth
-import pypeline.phased_array.bluebild.field_synthesizer.spatial_domain as fsd
+import pypeline.phased_array.bluebild.field_synthesizer.spatial_domain._spatial_domain as fsd
 import pypeline.util.argcheck as chk
 import pypeline.util.math.fourier as fourier
 import pypeline.util.math.func as func
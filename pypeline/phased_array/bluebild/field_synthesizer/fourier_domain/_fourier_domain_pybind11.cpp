@@ -5,12 +5,15 @@
 // ############################################################################
 
 #include <complex>
+#include <memory>
+#include <string>
 
 #include "pybind11/pybind11.h"
 #include "pybind11/eigen.h"
 
 #include "pypeline/types.hpp"
 #include "pypeline/phased_array/bluebild/field_synthesizer/fourier_domain.hpp"
+#include "pypeline/util/cache.hpp"
 #include "pypeline/util/cpp_py3_interop.hpp"
 
 namespace cpp_py3_interop = pypeline::util::cpp_py3_interop;
@@ -113,7 +116,7 @@ Notes
         xt::xtensor<TT, 2> cpp_XYZ {cpp_py3_interop::numpy_to_xview<TT>(XYZ)};
         xt::xtensor<cTT, 2> cpp_W {cpp_py3_interop::numpy_to_xview<cTT>(W)};
 
-        const auto& stat = field_synth(cpp_V, cpp_XYZ, cpp_W);
+        auto stat = field_synth(cpp_V, cpp_XYZ, cpp_W);
         return cpp_py3_interop::xtensor_to_numpy(std::move(stat));
     }, pybind11::arg("V").none(false),
        pybind11::arg("XYZ").none(false),
@@ -127,18 +130,52 @@ Notes
         xt::xtensor<cTT, 2> cpp_V {cpp_py3_interop::numpy_to_xview<cTT>(V)};
         xt::xtensor<TT, 2> cpp_XYZ {cpp_py3_interop::numpy_to_xview<TT>(XYZ)};
 
-        const auto& stat = field_synth(cpp_V, cpp_XYZ, W);
+        auto stat = field_synth(cpp_V, cpp_XYZ, W);
         return cpp_py3_interop::xtensor_to_numpy(std::move(stat));
     }, pybind11::arg("V").none(false),
        pybind11::arg("XYZ").none(false),
        pybind11::arg("W").none(false),
        pybind11::doc("EOF()EOF"));
 
+    obj.def("set_kernel_cache", [](f_synth::FourierFieldSynthesizerBlock<TT> &field_synth,
+                                   pybind11::object directory,
+                                   const double budget) {
+        if (directory.is_none()) {
+            field_synth.set_kernel_cache(nullptr);
+            return;
+        }
+
+        if (budget <= 0) {
+            std::string msg = "Parameter[budget] must be positive.";
+            throw std::runtime_error(msg);
+        }
+        field_synth.set_kernel_cache(std::make_shared<pypeline::util::cache::FileCache>(
+                                       directory.cast<std::string>(),
+                                       static_cast<size_t>(budget)));
+    }, pybind11::arg("directory"),
+       pybind11::arg("budget") = 4e9,
+       pybind11::doc(R"EOF(
+set_kernel_cache(directory, budget=4e9)
+
+Persist kernels across runs.
+
+After every kernel re-generation, the FS-domain kernel is stored in `directory`.
+Later re-generations with identical inputs (antenna positions, `wl`, `grid_colat`, `N_FS`, `T`) load it from disk instead of recomputing it.
+
+Parameters
+----------
+directory : str
+    Cache directory, shared by all synthesizers and processes using it.
+    If :py:obj:`None`, caching is disabled.
+budget : float
+    Maximum size [bytes] of the cache: least-recently used kernels are deleted beyond that.
+)EOF"));
+
     obj.def("synthesize", [](f_synth::FourierFieldSynthesizerBlock<TT> &field_synth,
                              pybind11::array_t<TT> stat) {
         const auto& stat_view = cpp_py3_interop::numpy_to_xview<TT>(stat);
 
-        const auto& field = field_synth.synthesize(stat_view);
+        auto field = field_synth.synthesize(stat_view);
         return cpp_py3_interop::xtensor_to_numpy(std::move(field));
     }, pybind11::arg("stat").noconvert().none(false),
        pybind11::doc("EOF()EOF"));
@@ -0,0 +1,18 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Field synthesizers that work in the spatial domain.
+"""
+
+import _pypeline_phased_array_bluebild_field_synthesizer_spatial_domain_pybind11 as __cpp
+
+from . import _spatial_domain as __py
+
+SpatialFieldSynthesizerBlock = __py.SpatialFieldSynthesizerBlock
+
+SpatialFieldSynthesizerBlock_float32 = __cpp.SpatialFieldSynthesizerBlock_float32
+SpatialFieldSynthesizerBlock_float64 = __cpp.SpatialFieldSynthesizerBlock_float64
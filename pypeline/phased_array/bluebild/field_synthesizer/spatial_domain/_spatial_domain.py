@@ -1,6 +1,6 @@
 # #############################################################################
-# spatial_domain.py
-# =================
+# _spatial_domain.py
+# ==================
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -8,11 +8,11 @@
 Field synthesizers that work in the spatial domain.
 """
 
-import numexpr as ne
 import numpy as np
 import scipy.linalg as linalg
 import scipy.sparse as sparse
 
+import _pypeline_phased_array_bluebild_field_synthesizer_spatial_domain_pybind11 as ssd_cpp
 import pypeline.phased_array.bluebild.field_synthesizer as synth
 import pypeline.util.argcheck as chk
 
@@ -162,6 +162,14 @@ class SpatialFieldSynthesizerBlock(synth.FieldSynthesizerBlock):
                              'dimensions (3, N_height, N_width).')
         self._grid = pix_grid / linalg.norm(pix_grid, axis=0)
 
+        N_height, N_width = self._grid.shape[1:]
+        cpp_block = (ssd_cpp.SpatialFieldSynthesizerBlock_float32
+                     if (precision == 32) else
+                     ssd_cpp.SpatialFieldSynthesizerBlock_float64)
+        self._synthesizer = cpp_block(wl, (self._grid
+                                           .reshape(3, N_height * N_width)
+                                           .astype(self._fp)))
+
     @chk.check(dict(V=chk.has_complex,
                     XYZ=chk.has_reals,
                     W=chk.is_instance(np.ndarray,
@@ -171,6 +179,8 @@ class SpatialFieldSynthesizerBlock(synth.FieldSynthesizerBlock):
         """
         Compute instantaneous field statistics.
 
+        The pixel grid is processed in cache-sized tiles: memory use does not grow with the grid size.
+
         Parameters
         ----------
         V : :py:class:`~numpy.ndarray`
@@ -195,22 +205,12 @@ class SpatialFieldSynthesizerBlock(synth.FieldSynthesizerBlock):
         XYZ = XYZ.astype(self._fp, copy=False)
         W = W.astype(self._cp, copy=False)
 
-        N_antenna, N_beam = W.shape
-        N_height, N_width = self._grid.shape[1:]
+        if sparse.issparse(W):
+            W = W.tocsc()
 
-        XYZ = XYZ - XYZ.mean(axis=0)
-        P = np.zeros((N_antenna, N_height, N_width), dtype=self._cp)
-        ne.evaluate('exp(A * B)',
-                    dict(A=1j * 2 * np.pi / self._wl,
-                         B=np.tensordot(XYZ, self._grid, axes=1)),
-                    out=P,
-                    casting='same_kind')  # Due to limitations of NumExpr2
-
-        PW = W.T @ P.reshape(N_antenna, N_height * N_width)
-        PW = PW.reshape(N_beam, N_height, N_width)
-
-        E = np.tensordot(V.T, PW, axes=1)
-        I = E.real ** 2 + E.imag ** 2
+        N_height, N_width = self._grid.shape[1:]
+        N_eig = V.shape[1]
+        I = self._synthesizer(V, XYZ, W).reshape(N_eig, N_height, N_width)
         return I
 
     @chk.check('stat', chk.has_reals)
@@ -0,0 +1,117 @@
+// ############################################################################
+// _spatial_domain_pybind11.cpp
+// ============================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <memory>
+#include <string>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/field_synthesizer/spatial_domain.hpp"
+
+namespace s_synth = pypeline::phased_array::bluebild::field_synthesizer::spatial_domain;
+
+template <typename TT>
+void SpatialFieldSynthesizerBlock_bindings(pybind11::module &m,
+                                           const std::string &class_name) {
+    using cTT = std::complex<TT>;
+    using block_t = s_synth::SpatialFieldSynthesizerBlock<TT>;
+
+    auto obj = pybind11::class_<block_t>(m,
+                                         class_name.data(),
+                                         R"EOF(
+Field synthesizer based on StandardSynthesis.
+
+Field statistics are evaluated tile-by-tile over the pixel grid: memory use does not grow with the grid size, and tiles are processed in parallel.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.bluebild.field_synthesizer.spatial_domain import SpatialFieldSynthesizerBlock_float64
+
+.. doctest::
+
+   >>> N_antenna, N_beam, N_eig = 48, 4, 3
+   >>> pix_grid = np.random.randn(3, 512 * 512)
+   >>> synth = SpatialFieldSynthesizerBlock_float64(wl=2, pix_grid=pix_grid)
+
+   >>> V = np.random.randn(N_beam, N_eig) + 1j * np.random.randn(N_beam, N_eig)
+   >>> XYZ = 100 * np.random.randn(N_antenna, 3)
+   >>> W = np.random.randn(N_antenna, N_beam) + 1j * np.random.randn(N_antenna, N_beam)
+   >>> synth(V, XYZ, W).shape
+   (3, 262144)
+)EOF");
+
+    obj.def(pybind11::init([](const double wl,
+                              Eigen::Ref<const MatrixXX_t<TT>> pix_grid) {
+        return std::make_unique<block_t>(wl, pix_grid);
+    }), pybind11::arg("wl").none(false),
+        pybind11::arg("pix_grid").none(false),
+        pybind11::doc(R"EOF(
+__init__(wl, pix_grid)
+
+Parameters
+----------
+wl : float
+    Wave-length [m] of observations.
+pix_grid : :py:class:`~numpy.ndarray`
+    (3, N_pixel) pixel vectors.
+)EOF"));
+
+    obj.def("__call__", [](const block_t &block,
+                           Eigen::Ref<const MatrixXX_t<cTT>> V,
+                           Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                           Eigen::Ref<const MatrixXX_t<cTT>> W) {
+        pybind11::gil_scoped_release release;
+        return block(V, XYZ, W);
+    }, pybind11::arg("V").none(false),
+       pybind11::arg("XYZ").none(false),
+       pybind11::arg("W").none(false));
+
+    obj.def("__call__", [](const block_t &block,
+                           Eigen::Ref<const MatrixXX_t<cTT>> V,
+                           Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                           const SpMatrixXX_t<cTT> &W) {
+        pybind11::gil_scoped_release release;
+        return block(V, XYZ, W);
+    }, pybind11::arg("V").none(false),
+       pybind11::arg("XYZ").none(false),
+       pybind11::arg("W").none(false),
+       pybind11::doc(R"EOF(
+__call__(V, XYZ, W)
+
+Compute instantaneous field statistics.
+
+Parameters
+----------
+V : :py:class:`~numpy.ndarray`
+    (N_beam, N_eig) complex-valued eigenvectors.
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) Cartesian instrument geometry, in the same reference frame as `pix_grid`.
+W : :py:class:`~numpy.ndarray` or :py:class:`~scipy.sparse.csc_matrix`
+    (N_antenna, N_beam) synthesis beamweights.
+
+Returns
+-------
+stat : :py:class:`~numpy.ndarray`
+    (N_eig, N_pixel) field statistics.
+)EOF"));
+
+    obj.def_property_readonly("wl", &block_t::wl);
+    obj.def_property_readonly("N_pixel", &block_t::N_pixel);
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_bluebild_field_synthesizer_spatial_domain_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    SpatialFieldSynthesizerBlock_bindings<float>(m, "SpatialFieldSynthesizerBlock_float32");
+    SpatialFieldSynthesizerBlock_bindings<double>(m, "SpatialFieldSynthesizerBlock_float64");
+}
@@ -17,7 +17,10 @@ Subclasses of :py:class:`~pypeline.phased_array.bluebild.imager.IntegratingMulti
 Integrated images can then be directly output in viewable form by calling :py:meth:`~pypeline.phased_array.bluebild.imager.IntegratingMultiFieldSynthesizerBlock.as_image`.
 """
 
+import numpy as np
+
 import pypeline.core as core
+import pypeline.util.array as array
 
 
 class IntegratingMultiFieldSynthesizerBlock(core.Block):
@@ -31,6 +34,7 @@ class IntegratingMultiFieldSynthesizerBlock(core.Block):
         """
         super().__init__()
         self._statistics = None
+        self._scratch = None
 
     def _update(self, stat):
         if self._statistics is None:
@@ -38,6 +42,42 @@ class IntegratingMultiFieldSynthesizerBlock(core.Block):
         else:
             self._statistics += stat
 
+    def _integrate(self, stat, D, cluster_idx, N_level):
+        """
+        Cluster instantaneous field statistics directly into the integrated statistics.
+
+        The integration and scratch buffers are allocated once, then updated in-place at every call.
+
+        Parameters
+        ----------
+        stat : :py:class:`~numpy.ndarray`
+            (N_eig, ...) instantaneous field statistics.
+        D : :py:class:`~numpy.ndarray`
+            (N_eig,) positive eigenvalues, with the same dtype as `stat`.
+        cluster_idx : :py:class:`~numpy.ndarray`
+            (N_eig,) cluster indices of each eigenpair.
+        N_level : int
+            Number of clustered energy-levels.
+
+        Returns
+        -------
+        stat : :py:class:`~numpy.ndarray`
+            (2, N_level, ...) clustered field statistics of this call for standardized and least-squares estimates.
+            The array is distinct from the integrated statistics, but is overwritten by the next call: copy it to keep it.
+        """
+        stat = np.require(stat, requirements='C')
+        if self._statistics is None:
+            self._statistics = np.zeros((2, N_level) + stat.shape[1:], dtype=stat.dtype)
+            self._scratch = np.zeros_like(self._statistics)
+
+        self._scratch.fill(0)
+        for buffer in [self._statistics, self._scratch]:
+            array.cluster_layers_augment(stat, cluster_idx, N=N_level, axis=0,
+                                         buffer=buffer[0])
+            array.cluster_layers_augment(stat, cluster_idx, N=N_level, axis=0,
+                                         buffer=buffer[1], weights=D)
+        return self._scratch
+
     def __call__(self, *args, **kwargs):
         """
         Compute integrated field statistics for least-squares and standardized estimates.
@@ -15,7 +15,6 @@ import pypeline.phased_array.bluebild.field_synthesizer.fourier_domain as fsfd
 import pypeline.phased_array.bluebild.imager as bim
 import pypeline.phased_array.util.io.image as image
 import pypeline.util.argcheck as chk
-import pypeline.util.array as array
 import pypeline.util.math.sphere as sph
 
 
@@ -197,6 +196,8 @@ class Fourier_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
         """
         Compute (clustered) integrated field statistics for least-squares and standardized estimates.
 
+        Integrated statistics are accumulated in-place.
+
         Parameters
         ----------
         D : :py:class:`~numpy.ndarray`
@@ -219,14 +220,8 @@ class Fourier_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
         """
         D = D.astype(self._fp, copy=False)
 
-        stat_std = self._synthesizer(V, XYZ, W)
-        stat_lsq = stat_std * D.reshape(-1, 1, 1)
-
-        stat = np.stack([stat_std, stat_lsq], axis=0)
-        stat = array.cluster_layers(stat, cluster_idx,
-                                    N=self._N_level, axis=1)
-
-        self._update(stat)
+        stat_std = self._synthesizer(V, XYZ, W).astype(self._fp, copy=False)
+        stat = self._integrate(stat_std, D, cluster_idx, self._N_level)
         return stat
 
     def as_image(self):
@@ -243,6 +238,13 @@ class Fourier_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
 
         lsq_c : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_floatxx`
             (N_level, N_height, N_width) least-squares energy-levels.
+
+        Notes
+        -----
+        Fields are synthesized from the integrated statistics at every call, and containers reference them without
+        copying: unlike :py:meth:`~pypeline.phased_array.bluebild.imager.spatial_domain.Spatial_IMFS_Block.as_image`,
+        further calls to :py:meth:`~pypeline.phased_array.bluebild.imager.fourier_domain.Fourier_IMFS_Block.__call__`
+        do not alter returned containers.
         """
         if self._fp == np.float32:
             container_type = image.SphericalImageContainer_float32
@@ -258,11 +260,11 @@ class Fourier_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
                                  axes=1).astype(self._fp)
 
         stat_std = self._statistics[0]
-        field_std = self._synthesizer.synthesize(stat_std).astype(self._fp)
-        std = container_type(field_std, icrs_grid)
+        field_std = self._synthesizer.synthesize(stat_std).astype(self._fp, copy=False)
+        std = container_type(np.ascontiguousarray(field_std), icrs_grid, copy=False)
 
         stat_lsq = self._statistics[1]
-        field_lsq = self._synthesizer.synthesize(stat_lsq).astype(self._fp)
-        lsq = container_type(field_lsq, icrs_grid)
+        field_lsq = self._synthesizer.synthesize(stat_lsq).astype(self._fp, copy=False)
+        lsq = container_type(np.ascontiguousarray(field_lsq), icrs_grid, copy=False)
 
         return std, lsq
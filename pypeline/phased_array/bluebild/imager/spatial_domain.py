@@ -15,7 +15,6 @@ import pypeline.phased_array.bluebild.field_synthesizer.spatial_domain as ssd
 import pypeline.phased_array.bluebild.imager as bim
 import pypeline.phased_array.util.io.image as image
 import pypeline.util.argcheck as chk
-import pypeline.util.array as array
 
 
 class Spatial_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
@@ -163,6 +162,8 @@ class Spatial_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
         """
         Compute (clustered) integrated field statistics for least-squares and standardized estimates.
 
+        Integrated statistics are accumulated in-place.
+
         Parameters
         ----------
         D : :py:class:`~numpy.ndarray`
@@ -185,14 +186,8 @@ class Spatial_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
         """
         D = D.astype(self._fp, copy=False)
 
-        stat_std = self._synthesizer(V, XYZ, W)
-        stat_lsq = stat_std * D.reshape(-1, 1, 1)
-
-        stat = np.stack([stat_std, stat_lsq], axis=0)
-        stat = array.cluster_layers(stat, cluster_idx,
-                                    N=self._N_level, axis=1)
-
-        self._update(stat)
+        stat_std = self._synthesizer(V, XYZ, W).astype(self._fp, copy=False)
+        stat = self._integrate(stat_std, D, cluster_idx, self._N_level)
         return stat
 
     def as_image(self):
@@ -209,18 +204,24 @@ class Spatial_IMFS_Block(bim.IntegratingMultiFieldSynthesizerBlock):
 
         lsq_c : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_floatxx`
             (N_level, N_height, N_width) least-squares energy-levels.
+
+        Notes
+        -----
+        Containers reference the imager's statistics without copying them: further calls to
+        :py:meth:`~pypeline.phased_array.bluebild.imager.spatial_domain.Spatial_IMFS_Block.__call__`
+        update them in-place.
         """
         if self._fp == np.float32:
             container_type = image.SphericalImageContainer_float32
         else:
             container_type = image.SphericalImageContainer_float64
 
-        grid = self._synthesizer._grid.astype(self._fp)
+        grid = np.ascontiguousarray(self._synthesizer._grid, dtype=self._fp)
 
         stat_std = self._statistics[0]
-        std = container_type(stat_std, grid)
+        std = container_type(stat_std, grid, copy=False)
 
         stat_lsq = self._statistics[1]
-        lsq = container_type(stat_lsq, grid)
+        lsq = container_type(stat_lsq, grid, copy=False)
 
         return std, lsq
@@ -0,0 +1,29 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+r"""
+Parameter estimators.
+
+Bluebild field synthesizers output :math:`N_{\text{beam}}` energy levels, with :math:`N_{\text{beam}}` being the height of the visibility/Gram matrices :math:`\Sigma, G`.
+We are often not interested in such fined-grained energy decompositions but would rather have 4-5 well-separated energy levels as output.
+This is accomplished by clustering energy levels together during the aggregation stage.
+
+As the energy scale depends on the visibilities, it is preferable to infer the cluster centroids (and any other parameters of interest) by scanning a portion of the data stream.
+Subclasses of :py:class:`~pypeline.phased_array.bluebild.parameter_estimator.ParameterEstimator` are specifically tailored for such tasks.
+"""
+
+import _pypeline_phased_array_bluebild_parameter_estimator_pybind11 as __cpp
+
+from . import _parameter_estimator as __py
+
+ParameterEstimator = __py.ParameterEstimator
+IntensityFieldParameterEstimator = __py.IntensityFieldParameterEstimator
+SensitivityFieldParameterEstimator = __py.SensitivityFieldParameterEstimator
+
+IntensityFieldParameterEstimator_float32 = __cpp.IntensityFieldParameterEstimator_float32
+IntensityFieldParameterEstimator_float64 = __cpp.IntensityFieldParameterEstimator_float64
+SensitivityFieldParameterEstimator_float32 = __cpp.SensitivityFieldParameterEstimator_float32
+SensitivityFieldParameterEstimator_float64 = __cpp.SensitivityFieldParameterEstimator_float64
@@ -1,6 +1,6 @@
 # #############################################################################
-# parameter_estimator.py
-# ======================
+# _parameter_estimator.py
+# =======================
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -15,13 +15,11 @@ As the energy scale depends on the visibilities, it is preferable to infer the c
 Subclasses of :py:class:`~pypeline.phased_array.bluebild.parameter_estimator.ParameterEstimator` are specifically tailored for such tasks.
 """
 
-import numpy as np
-import sklearn.cluster as skcl
+import _pypeline_phased_array_bluebild_parameter_estimator_pybind11 as pe_cpp
 
 import pypeline.phased_array.util.data_gen.visibility as vis
 import pypeline.phased_array.util.gram as gr
 import pypeline.util.argcheck as chk
-import pypeline.util.math.linalg as pylinalg
 
 
 class ParameterEstimator:
@@ -64,6 +62,9 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
     """
     Parameter estimator for computing intensity fields.
 
+    Each (S, G) pair is decomposed on collection: only a bounded-size sample of its energy levels is kept in memory, irrespective of the observation length.
+    (See :py:class:`~pypeline.phased_array.bluebild.parameter_estimator.IntensityFieldParameterEstimator_float64`.)
+
     Examples
     --------
     Assume we are imaging a portion of the Bootes field with LOFAR's 24 core stations.
@@ -118,7 +119,7 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
        ...    S = vis(XYZ, W, wl)
        ...    G = gram(XYZ, W, wl)
        ...
-       ...    I_est.collect(S, G)  # Store S, G internally until full 8h interval has been sampled.
+       ...    I_est.collect(S, G)  # Decompose (S, G) and keep a sketch of its energy levels.
        ...
        >>> N_eig, c_centroid = I_est.infer_parameters()  # optimal estimate
 
@@ -133,8 +134,9 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
     """
 
     @chk.check(dict(N_level=chk.is_integer,
-                    sigma=chk.is_real))
-    def __init__(self, N_level, sigma):
+                    sigma=chk.is_real,
+                    N_sketch=chk.is_integer))
+    def __init__(self, N_level, sigma, N_sketch=16384):
         """
         Parameters
         ----------
@@ -142,6 +144,8 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
             Number of clustered energy levels to output.
         sigma : float
             Normalized energy ratio for fPCA decomposition.
+        N_sketch : int
+            Maximum number of energy levels retained for clustering.
         """
         super().__init__()
 
@@ -153,15 +157,15 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
             raise ValueError('Parameter[sigma] must lie in (0,1].')
         self._sigma = sigma
 
-        # Collected data.
-        self._visibilities = []
-        self._grams = []
+        if N_sketch < N_level:
+            raise ValueError('Parameter[N_sketch] must be at least N_level.')
+        self._cpp = pe_cpp.IntensityFieldParameterEstimator_float64(N_level, sigma, N_sketch)
 
     @chk.check(dict(S=chk.is_instance(vis.VisibilityMatrix),
                     G=chk.is_instance(gr.GramMatrix)))
     def collect(self, S, G):
         """
-        Ingest data to internal queue for inference.
+        Decompose (S, G) and add its energy levels to the internal sketch.
 
         Parameters
         ----------
@@ -173,8 +177,7 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
         if not S.is_consistent_with(G, axes=[0, 0]):
             raise ValueError('Parameters[S, G] are inconsistent.')
 
-        self._visibilities.append(S)
-        self._grams.append(G)
+        self._cpp.collect(S.data, G.data)
 
     def infer_parameters(self):
         """
@@ -188,26 +191,8 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
         cluster_centroid : :py:class:`~numpy.ndarray`
             (N_level,) intensity field cluster centroids.
         """
-        N_data = len(self._visibilities)
-        N_beam = N_eig_max = self._visibilities[0].shape[0]
-
-        D_all = np.zeros((N_data, N_eig_max))
-        for i, (S, G) in enumerate(zip(self._visibilities, self._grams)):
-            # Remove broken BEAM_IDs
-            broken_row_id = np.flatnonzero(np.isclose(np.sum(S.data, axis=0),
-                                                      np.sum(S.data, axis=1)))
-            working_row_id = list(set(np.arange(N_beam)) - set(broken_row_id))
-            idx = np.ix_(working_row_id, working_row_id)
-            S, G = S.data[idx], G.data[idx]
-
-            # Functional PCA
-            if not np.allclose(S, 0):
-                D, _ = pylinalg.eigh(S, G, tau=self._sigma)
-                D_all[i, :len(D)] = D
-
-        D_all = D_all[D_all.nonzero()]
-        kmeans = (skcl.KMeans(n_clusters=self._N_level)
-                  .fit(np.log(D_all).reshape(-1, 1)))
+        if self._cpp.N_data == 0:
+            raise ValueError('No data has been collected.')
 
         # For extremely small telescopes or datasets that are mostly 'broken', we can have (N_eig < N_level).
         # In this case we have two options: (N_level = N_eig) or (N_eig = N_level).
@@ -216,9 +201,7 @@ class IntensityFieldParameterEstimator(ParameterEstimator):
         # This has the disadvantage of increasing the computational load of Bluebild, but as the N_eig energy levels
         # are clustered together anyway, the trailing energy levels will be (close to) all-0 and can be discarded
         # on inspection.
-        N_eig = max(int(np.ceil(len(D_all) / N_data)), self._N_level)
-        cluster_centroid = np.sort(np.exp(kmeans.cluster_centers_)[:, 0])[::-1]
-
+        N_eig, cluster_centroid = self._cpp.infer_parameters()
         return N_eig, cluster_centroid
 
 
@@ -240,21 +223,19 @@ class SensitivityFieldParameterEstimator(ParameterEstimator):
         if not (0 < sigma <= 1):
             raise ValueError('Parameter[sigma] must lie in (0,1].')
         self._sigma = sigma
-
-        # Collected data.
-        self._grams = []
+        self._cpp = pe_cpp.SensitivityFieldParameterEstimator_float64(sigma)
 
     @chk.check('G', chk.is_instance(gr.GramMatrix))
     def collect(self, G):
         """
-        Ingest data to internal queue for inference.
+        Decompose G and record its number of energy levels.
 
         Parameters
         ----------
         G : :py:class:`~pypeline.phased_array.util.gram.GramMatrix`
             (N_beam, N_beam) gram matrix.
         """
-        self._grams.append(G)
+        self._cpp.collect(G.data)
 
     def infer_parameters(self):
         """
@@ -265,16 +246,8 @@ class SensitivityFieldParameterEstimator(ParameterEstimator):
         N_eig : int
             Number of eigenpairs to use.
         """
-        N_data = len(self._grams)
-        N_beam = N_eig_max = self._grams[0].shape[0]
-
-        D_all = np.zeros((N_data, N_eig_max))
-        for i, G in enumerate(self._grams):
-            # Functional PCA
-            D, _ = pylinalg.eigh(G.data, np.eye(N_beam), tau=self._sigma)
-            D_all[i, :len(D)] = D
-
-        D_all = D_all[D_all.nonzero()]
+        if self._cpp.N_data == 0:
+            raise ValueError('No data has been collected.')
 
-        N_eig = int(np.ceil(len(D_all) / N_data))
+        N_eig = self._cpp.infer_parameters()
         return N_eig
@@ -0,0 +1,271 @@
+// ############################################################################
+// _parameter_estimator_pybind11.cpp
+// =================================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/numpy.h"
+#include "pybind11/stl.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/parameter_estimator.hpp"
+
+namespace parameter_estimator = pypeline::phased_array::bluebild::parameter_estimator;
+
+template <typename T>
+using carray_t = pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>;
+
+/*
+ * Extract (N_data, N_beam) from a (N_data, N_beam, N_beam) array.
+ */
+template <typename T>
+std::tuple<size_t, size_t> batch_shape(const carray_t<T> &X,
+                                       const std::string &name) {
+    if ((X.ndim() != 3) || (X.shape(1) != X.shape(2))) {
+        std::string msg = "Parameter[" + name + "] must have shape (N_data, N_beam, N_beam).";
+        throw std::runtime_error(msg);
+    }
+    return std::make_tuple(X.shape(0), X.shape(1));
+}
+
+template <typename TT>
+void IntensityFieldParameterEstimator_bindings(pybind11::module &m,
+                                               const std::string &class_name) {
+    using cTT = std::complex<TT>;
+    using estimator_t = parameter_estimator::IntensityFieldParameterEstimator<TT>;
+
+    auto obj = pybind11::class_<estimator_t>(m,
+                                             class_name.data(),
+                                             R"EOF(
+Streaming parameter estimator for computing intensity fields.
+
+Each (S, G) pair is decomposed on collection: only a uniform sample of at most `N_sketch` log-eigenvalues is kept in memory.
+Cluster centroids are obtained by exact 1-D k-means on the sample.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.bluebild.parameter_estimator import IntensityFieldParameterEstimator_float64
+
+.. doctest::
+
+   >>> N_beam, N_data = 10, 30
+   >>> X = np.random.randn(N_data, N_beam, 3) + 1j * np.random.randn(N_data, N_beam, 3)
+   >>> S = X @ X.conj().transpose(0, 2, 1)
+   >>> G = np.broadcast_to(np.eye(N_beam, dtype=complex), S.shape)
+
+   >>> I_est = IntensityFieldParameterEstimator_float64(N_level=2, sigma=1)
+   >>> I_est.collect_batch(S, G)
+   >>> N_eig, c_centroid = I_est.infer_parameters()
+   >>> N_eig
+   3
+)EOF");
+
+    obj.def(pybind11::init([](const size_t N_level,
+                              const double sigma,
+                              const size_t N_sketch,
+                              const uint64_t seed) {
+        return std::make_unique<estimator_t>(N_level, sigma, N_sketch, seed);
+    }), pybind11::arg("N_level").none(false),
+        pybind11::arg("sigma").none(false),
+        pybind11::arg("N_sketch") = 16384,
+        pybind11::arg("seed") = 0,
+        pybind11::doc(R"EOF(
+__init__(N_level, sigma, N_sketch=16384, seed=0)
+
+Parameters
+----------
+N_level : int
+    Number of clustered energy levels to output.
+sigma : float
+    Normalized energy ratio for fPCA decomposition.
+N_sketch : int
+    Maximum number of energy levels retained for clustering.
+seed : int
+    Seed of the reservoir sampler.
+)EOF"));
+
+    obj.def("collect", [](estimator_t &estimator,
+                          Eigen::Ref<const MatrixXX_t<cTT>> S,
+                          Eigen::Ref<const MatrixXX_t<cTT>> G) {
+        pybind11::gil_scoped_release release;
+        estimator.collect(S, G);
+    }, pybind11::arg("S").none(false),
+       pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+collect(S, G)
+
+Decompose a (S, G) pair and add its energy levels to the sketch.
+
+Parameters
+----------
+S : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) visibility matrix.
+G : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) gram matrix.
+)EOF"));
+
+    obj.def("collect_batch", [](estimator_t &estimator,
+                                carray_t<cTT> S,
+                                carray_t<cTT> G) {
+        size_t N_data, N_beam;
+        std::tie(N_data, N_beam) = batch_shape(S, "S");
+        if (batch_shape(G, "G") != std::make_tuple(N_data, N_beam)) {
+            std::string msg = "Parameters[S, G] are inconsistent.";
+            throw std::runtime_error(msg);
+        }
+
+        const cTT *S_ptr = S.data();
+        const cTT *G_ptr = G.data();
+        pybind11::gil_scoped_release release;
+        estimator.collect_batch(S_ptr, G_ptr, N_data, N_beam);
+    }, pybind11::arg("S").none(false),
+       pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+collect_batch(S, G)
+
+Decompose many (S, G) pairs in parallel.
+
+Parameters
+----------
+S : :py:class:`~numpy.ndarray`
+    (N_data, N_beam, N_beam) visibility matrices.
+G : :py:class:`~numpy.ndarray`
+    (N_data, N_beam, N_beam) gram matrices.
+)EOF"));
+
+    obj.def("infer_parameters", [](const estimator_t &estimator) {
+        size_t N_eig;
+        std::vector<double> centroid;
+        std::tie(N_eig, centroid) = estimator.infer_parameters();
+
+        Eigen::Map<const ArrayX_t<double>> c_centroid(centroid.data(), centroid.size());
+        return std::make_tuple(N_eig, ArrayX_t<double>(c_centroid));
+    }, pybind11::doc(R"EOF(
+infer_parameters()
+
+Estimate parameters given collected data.
+
+Returns
+-------
+N_eig : int
+    Number of eigenpairs to use.
+cluster_centroid : :py:class:`~numpy.ndarray`
+    (N_level,) intensity field cluster centroids, in decreasing order.
+)EOF"));
+
+    obj.def("reset", &estimator_t::reset,
+            pybind11::doc(R"EOF(
+reset()
+
+Forget all collected data.
+)EOF"));
+
+    obj.def_property_readonly("N_level", &estimator_t::N_level);
+    obj.def_property_readonly("sigma", &estimator_t::sigma);
+    obj.def_property_readonly("N_data", &estimator_t::N_data);
+    obj.def_property_readonly("N_sketch", &estimator_t::N_sketch);
+}
+
+template <typename TT>
+void SensitivityFieldParameterEstimator_bindings(pybind11::module &m,
+                                                 const std::string &class_name) {
+    using cTT = std::complex<TT>;
+    using estimator_t = parameter_estimator::SensitivityFieldParameterEstimator<TT>;
+
+    auto obj = pybind11::class_<estimator_t>(m,
+                                             class_name.data(),
+                                             R"EOF(
+Streaming parameter estimator for computing sensitivity fields.
+
+Only the number of collected epochs and energy levels are kept in memory.
+)EOF");
+
+    obj.def(pybind11::init([](const double sigma) {
+        return std::make_unique<estimator_t>(sigma);
+    }), pybind11::arg("sigma").none(false),
+        pybind11::doc(R"EOF(
+__init__(sigma)
+
+Parameters
+----------
+sigma : float
+    Normalized energy ratio for fPCA decomposition.
+)EOF"));
+
+    obj.def("collect", [](estimator_t &estimator,
+                          Eigen::Ref<const MatrixXX_t<cTT>> G) {
+        pybind11::gil_scoped_release release;
+        estimator.collect(G);
+    }, pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+collect(G)
+
+Parameters
+----------
+G : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) gram matrix.
+)EOF"));
+
+    obj.def("collect_batch", [](estimator_t &estimator,
+                                carray_t<cTT> G) {
+        size_t N_data, N_beam;
+        std::tie(N_data, N_beam) = batch_shape(G, "G");
+
+        const cTT *G_ptr = G.data();
+        pybind11::gil_scoped_release release;
+        estimator.collect_batch(G_ptr, N_data, N_beam);
+    }, pybind11::arg("G").none(false),
+       pybind11::doc(R"EOF(
+collect_batch(G)
+
+Decompose many gram matrices in parallel.
+
+Parameters
+----------
+G : :py:class:`~numpy.ndarray`
+    (N_data, N_beam, N_beam) gram matrices.
+)EOF"));
+
+    obj.def("infer_parameters", &estimator_t::infer_parameters,
+            pybind11::doc(R"EOF(
+infer_parameters()
+
+Returns
+-------
+N_eig : int
+    Number of eigenpairs to use.
+)EOF"));
+
+    obj.def("reset", &estimator_t::reset,
+            pybind11::doc(R"EOF(
+reset()
+
+Forget all collected data.
+)EOF"));
+
+    obj.def_property_readonly("sigma", &estimator_t::sigma);
+    obj.def_property_readonly("N_data", &estimator_t::N_data);
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_bluebild_parameter_estimator_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    IntensityFieldParameterEstimator_bindings<float>(m, "IntensityFieldParameterEstimator_float32");
+    IntensityFieldParameterEstimator_bindings<double>(m, "IntensityFieldParameterEstimator_float64");
+    SensitivityFieldParameterEstimator_bindings<float>(m, "SensitivityFieldParameterEstimator_float32");
+    SensitivityFieldParameterEstimator_bindings<double>(m, "SensitivityFieldParameterEstimator_float64");
+}
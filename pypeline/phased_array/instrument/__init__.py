@@ -0,0 +1,35 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Instrument-related operations.
+
+Phased-arrays are collections of receiving elements (i.e., antennas or microphones) that sense a random field around them.
+These instruments are characterized by the properties of their receiving elements, such as position, sensitivity, etc.
+
+Only positional information is modeled at the moment, and can be accessed through 2 objects:
+
+ * :py:class:`~pypeline.phased_array.instrument.InstrumentGeometryBlock` : compute positional information.
+ * :py:class:`~pypeline.phased_array.instrument.InstrumentGeometry` : container for positional information.
+"""
+
+import _pypeline_phased_array_instrument_pybind11 as __cpp
+
+from . import _instrument as __py
+
+is_antenna_index = __py.is_antenna_index
+InstrumentGeometry = __py.InstrumentGeometry
+InstrumentGeometryBlock = __py.InstrumentGeometryBlock
+StationaryInstrumentGeometryBlock = __py.StationaryInstrumentGeometryBlock
+PyramicBlock = __py.PyramicBlock
+CompactSixBlock = __py.CompactSixBlock
+EarthBoundInstrumentGeometryBlock = __py.EarthBoundInstrumentGeometryBlock
+LofarBlock = __py.LofarBlock
+MwaBlock = __py.MwaBlock
+
+max_baseline = __cpp.max_baseline
+EarthBoundInstrumentGeometryBlock_float32 = __cpp.EarthBoundInstrumentGeometryBlock_float32
+EarthBoundInstrumentGeometryBlock_float64 = __cpp.EarthBoundInstrumentGeometryBlock_float64
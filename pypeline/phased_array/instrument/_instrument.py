@@ -1,6 +1,6 @@
 # #############################################################################
-# instrument.py
-# =============
+# _instrument.py
+# ==============
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -18,14 +18,18 @@ Only positional information is modeled at the moment, and can be accessed throug
 
 import pathlib
 
+import astropy._erfa as erfa
 import astropy.coordinates as coord
+import astropy.coordinates.builtin_frames.utils as coord_utils
 import astropy.time as time
+import astropy.units as u
 import numpy as np
 import pandas as pd
 import pkg_resources as pkg
 import plotly.graph_objs as go
 import scipy.linalg as linalg
 
+import _pypeline_phased_array_instrument_pybind11 as instrument_cpp
 import pypeline.core as core
 import pypeline.util.argcheck as chk
 import pypeline.util.array as array
@@ -294,11 +298,9 @@ class InstrumentGeometryBlock(core.Block):
         if wl <= 0:
             raise ValueError('Parameter[wl] must be positive.')
 
-        XYZ = self._layout.values
-        baseline = linalg.norm(XYZ[:, np.newaxis, :] -
-                               XYZ[np.newaxis, :, :], axis=-1)
+        baseline = instrument_cpp.max_baseline(self._layout.values)
 
-        N = sp.spherical_jn_series_threshold((2 * np.pi / wl) * baseline.max())
+        N = sp.spherical_jn_series_threshold((2 * np.pi / wl) * baseline)
         return N
 
 
@@ -355,7 +357,7 @@ class StationaryInstrumentGeometryBlock(InstrumentGeometryBlock):
 
     @chk.check('wl', chk.is_real)
     def bfsf_kernel_bandwidth(self, wl):
-        """
+        r"""
         Bandwidth of :math:`2 \pi`-periodic complex plane-wave kernel in BFSF coordinates.
 
         Parameters
@@ -391,12 +393,9 @@ class StationaryInstrumentGeometryBlock(InstrumentGeometryBlock):
 
         icrs_XYZ = self.__call__().data
         bfsf_XYZ = icrs_XYZ @ R.T
-        bfsf_XYZ -= np.mean(bfsf_XYZ, axis=0)
-        bfsf_XY = bfsf_XYZ[:, :2]
-        XY_baseline = linalg.norm(bfsf_XY[:, np.newaxis, :] -
-                                  bfsf_XY[np.newaxis, :, :], axis=-1)
+        XY_baseline = instrument_cpp.max_baseline(bfsf_XYZ[:, :2])
 
-        N = sp.jv_series_threshold((2 * np.pi / wl) * XY_baseline.max())
+        N = sp.jv_series_threshold((2 * np.pi / wl) * XY_baseline)
         return 2 * N + 1
 
 
@@ -566,6 +565,81 @@ class EarthBoundInstrumentGeometryBlock(InstrumentGeometryBlock):
                                    columns=('X', 'Y', 'Z'))
         return _as_InstrumentGeometry(icrs_layout)
 
+    @chk.check('time', chk.is_instance(time.Time))
+    def batch(self, time):
+        """
+        Determine instrument antenna positions in ICRS at many epochs.
+
+        Precession, nutation and polar motion are only evaluated at a few anchor epochs spanning `time`: positions at each epoch are then obtained as a single :math:`3 \times 3` rotation of the ITRS layout, computed in parallel.
+        Contrary to :py:meth:`~pypeline.phased_array.instrument.EarthBoundInstrumentGeometryBlock.__call__`, antenna positions are not subject to aberration.
+
+        Parameters
+        ----------
+        time : :py:class:`~astropy.time.Time`
+            (N_time,) moments at which the coordinates are wanted.
+
+        Returns
+        -------
+        XYZ : :py:class:`~numpy.ndarray`
+            (N_time, N_antenna, 3) ICRS antenna positions, in the same antenna order as :py:meth:`~pypeline.phased_array.instrument.EarthBoundInstrumentGeometryBlock.__call__`.
+
+        Examples
+        --------
+        .. testsetup::
+
+           from pypeline.phased_array.instrument import LofarBlock
+           import astropy.time as atime
+           import astropy.units as u
+
+        .. doctest::
+
+           >>> instr = LofarBlock()
+
+           >>> time = atime.Time('J2000') + np.linspace(0, 4, 2000) * u.h
+           >>> xyz = instr.batch(time)
+           >>> xyz.shape
+           (2000, 1396, 3)
+        """
+        time = time.reshape(-1)
+        obs_start, obs_end = time.min(), time.max()
+
+        engine = self._geometry_engine(obs_start, obs_end)
+        XYZ = engine.process_batch((time - obs_start).to_value(u.s))
+        return XYZ
+
+    def _geometry_engine(self, obs_start, obs_end):
+        """
+        Batched ITRS -> ICRS geometry engine for an observation period.
+
+        The IAU 2006/2000A celestial-to-terrestrial rotation is evaluated every 10 minutes of the observation period.
+
+        Parameters
+        ----------
+        obs_start : :py:class:`~astropy.time.Time`
+            Start of the observation period.
+        obs_end : :py:class:`~astropy.time.Time`
+            End of the observation period.
+
+        Returns
+        -------
+        engine : :py:class:`~pypeline.phased_array.instrument.EarthBoundInstrumentGeometryBlock_float64`
+            Geometry engine, with epochs expressed in seconds w.r.t. `obs_start`.
+        """
+        duration = (obs_end - obs_start).to_value(u.s)
+        N_anchor = 1 if (duration == 0) else int(np.ceil(duration / 600)) + 1
+        anchor_time = np.linspace(0, duration, N_anchor)
+
+        anchors = obs_start + anchor_time * u.s
+        xp, yp = coord_utils.get_polar_motion(anchors)
+        c2t = erfa.c2t06a(anchors.tt.jd1, anchors.tt.jd2,
+                          anchors.ut1.jd1, anchors.ut1.jd2,
+                          xp, yp)  # GCRS -> ITRS
+        anchor_rot = np.swapaxes(c2t, 1, 2)
+
+        XYZ = self._layout.loc[:, ['X', 'Y', 'Z']].values
+        engine = instrument_cpp.EarthBoundInstrumentGeometryBlock_float64(XYZ, anchor_time, anchor_rot)
+        return engine
+
     @chk.check(dict(obs_start=chk.is_instance(time.Time),
                     obs_end=chk.is_instance(time.Time)))
     def icrs2bfsf_rot(self, obs_start, obs_end):
@@ -608,41 +682,16 @@ class EarthBoundInstrumentGeometryBlock(InstrumentGeometryBlock):
             raise ValueError('Parameter[obs_start] must precede '
                              'Parameter[obs_end].')
 
-        # Find the position of the antennas at several time-instants
-        # during `period`.
-        N_interval = 20
-        sampling_times = (obs_start +
-                          ((obs_end - obs_start) / (N_interval - 1)) *
-                          np.arange(N_interval))
-        icrs_layouts = [self.__call__(t).data for t in sampling_times]
-        icrs_layouts = np.stack(icrs_layouts, axis=1)  # (N_antenna, N_time, 3)
-
-        # For each antenna `i`, find a normal vector `n_{i}` to the
-        # rotation plane.
-        N_antenna = len(icrs_layouts)
-        abc = np.zeros((N_antenna, 3))
-        for i, xyz in enumerate(icrs_layouts):
-            a = np.concatenate([xyz[:, :2], np.ones((len(xyz), 1))], axis=-1)
-            b = xyz[:, 2]
-            coeffs, *_ = linalg.lstsq(a, b)
-            abc[i] = coeffs
-
-        # Average vectors `n_{i}` to obtain the global normal vector `n`.
-        # Construct rotation matrix R using 3 basis vectors Ex, Ey, Ez.
-        #    Ez must be co-linear to the plane's normal vector.
-        a, b, c = np.mean(abc, axis=0)
-        z_ax = np.r_[a, b, -1]
-        y_ax = np.r_[b, -a, 0]
-        x_ax = np.cross(z_ax, y_ax)
-        R = np.stack([x_ax, y_ax, z_ax], axis=0)
-        R /= linalg.norm(R, axis=1, keepdims=True)
+        duration = (obs_end - obs_start).to_value(u.s)
+        engine = self._geometry_engine(obs_start, obs_end)
+        R = engine.icrs2bfsf_rot(0, duration)
         return R
 
     @chk.check(dict(wl=chk.is_real,
                     obs_start=chk.is_instance(time.Time),
                     obs_end=chk.is_instance(time.Time)))
     def bfsf_kernel_bandwidth(self, wl, obs_start, obs_end):
-        """
+        r"""
         Bandwidth of :math:`2 \pi`-periodic complex plane-wave kernel in BFSF coordinates.
 
         Parameters
@@ -687,12 +736,9 @@ class EarthBoundInstrumentGeometryBlock(InstrumentGeometryBlock):
 
         icrs_XYZ = self.__call__(obs_mid).data
         bfsf_XYZ = icrs_XYZ @ R.T
-        bfsf_XYZ -= np.mean(bfsf_XYZ, axis=0)
-        bfsf_XY = bfsf_XYZ[:, :2]
-        XY_baseline = linalg.norm(bfsf_XY[:, np.newaxis, :] -
-                                  bfsf_XY[np.newaxis, :, :], axis=-1)
+        XY_baseline = instrument_cpp.max_baseline(bfsf_XYZ[:, :2])
 
-        N = sp.jv_series_threshold((2 * np.pi / wl) * XY_baseline.max())
+        N = sp.jv_series_threshold((2 * np.pi / wl) * XY_baseline)
         return 2 * N + 1
 
 
@@ -0,0 +1,237 @@
+// ############################################################################
+// _instrument_pybind11.cpp
+// ========================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/numpy.h"
+#include "pybind11/stl.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/instrument.hpp"
+
+namespace instrument = pypeline::phased_array::instrument;
+
+template <typename TT>
+double _max_baseline(Eigen::Ref<const MatrixXX_t<TT>> XYZ) {
+    pybind11::gil_scoped_release release;
+    return instrument::max_baseline<TT>(XYZ);
+}
+
+template <typename TT>
+void EarthBoundInstrumentGeometryBlock_bindings(pybind11::module &m,
+                                                const std::string &class_name) {
+    using block_t = instrument::EarthBoundInstrumentGeometryBlock<TT>;
+
+    auto obj = pybind11::class_<block_t>(m,
+                                         class_name.data(),
+                                         R"EOF(
+Batched ITRS -> ICRS antenna positions over an observation window.
+
+The ITRS -> ICRS rotation is factored as :math:`R(t) = Q(t) R_{z}(\omega t)`, where :math:`R_{z}(\omega t)` is the Earth rotation at the IAU 2000 ERA rate, and :math:`Q(t)` gathers precession, nutation and polar motion.
+:math:`Q(t)` varies slowly: it is interpolated between anchor epochs whose full rotations are supplied at construction.
+Positions at any epoch in the window are then a single :math:`3 \times 3` rotation of the ITRS layout.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.instrument import EarthBoundInstrumentGeometryBlock_float64
+
+.. doctest::
+
+   >>> XYZ = np.random.randn(10, 3)
+   >>> geom = EarthBoundInstrumentGeometryBlock_float64(XYZ,
+   ...                                                 anchor_time=np.r_[0., 600.],
+   ...                                                 anchor_rot=np.stack([np.eye(3)] * 2))
+
+   >>> geom.process_batch(np.linspace(0, 600, 50)).shape
+   (50, 10, 3)
+)EOF");
+
+    obj.def(pybind11::init([](Eigen::Ref<const MatrixXX_t<double>> XYZ,
+                              const std::vector<double> &anchor_time,
+                              pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast> anchor_rot) {
+        if ((anchor_rot.ndim() != 3) ||
+            (static_cast<size_t>(anchor_rot.shape(0)) != anchor_time.size()) ||
+            (anchor_rot.shape(1) != 3) || (anchor_rot.shape(2) != 3)) {
+            std::string msg = "Parameter[anchor_rot] must have shape (N_anchor, 3, 3).";
+            throw std::runtime_error(msg);
+        }
+        Eigen::Map<const MatrixXX_t<double>> R(anchor_rot.data(), 3 * anchor_rot.shape(0), 3);
+
+        return std::make_unique<block_t>(XYZ, anchor_time, R);
+    }), pybind11::arg("XYZ").none(false),
+        pybind11::arg("anchor_time").none(false),
+        pybind11::arg("anchor_rot").none(false),
+        pybind11::doc(R"EOF(
+__init__(XYZ, anchor_time, anchor_rot)
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) ITRS antenna positions [m].
+anchor_time : :py:class:`~numpy.ndarray`
+    (N_anchor,) strictly increasing anchor epochs [s], w.r.t. an arbitrary UT1 reference.
+anchor_rot : :py:class:`~numpy.ndarray`
+    (N_anchor, 3, 3) ITRS -> ICRS rotation matrices at each anchor epoch.
+)EOF"));
+
+    obj.def("__call__", [](const block_t &block,
+                           const double t) {
+        MatrixXX_t<TT> XYZ;
+        {
+            pybind11::gil_scoped_release release;
+            XYZ = block(t);
+        }
+        return XYZ;
+    }, pybind11::arg("t").none(false),
+       pybind11::doc(R"EOF(
+__call__(t)
+
+Determine antenna positions in ICRS.
+
+Parameters
+----------
+t : float
+    Epoch [s], in the same reference as `anchor_time`.
+
+Returns
+-------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) ICRS antenna positions [m].
+)EOF"));
+
+    obj.def("process_batch", [](const block_t &block,
+                                pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast> t) {
+        if (t.ndim() != 1) {
+            std::string msg = "Parameter[t] must have shape (N_time,).";
+            throw std::runtime_error(msg);
+        }
+        const size_t N_time = t.shape(0);
+        const size_t N_antenna = block.N_antenna();
+        pybind11::array_t<TT> XYZ({N_time, N_antenna, static_cast<size_t>(3)});
+
+        const double *t_ptr = t.data();
+        TT *XYZ_ptr = XYZ.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            block.process_batch(t_ptr, N_time, XYZ_ptr);
+        }
+        return XYZ;
+    }, pybind11::arg("t").none(false),
+       pybind11::doc(R"EOF(
+process_batch(t)
+
+Determine antenna positions in ICRS at several epochs in parallel.
+
+Parameters
+----------
+t : :py:class:`~numpy.ndarray`
+    (N_time,) epochs [s], in the same reference as `anchor_time`.
+
+Returns
+-------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_time, N_antenna, 3) ICRS antenna positions [m].
+)EOF"));
+
+    obj.def("rotation", &block_t::rotation,
+            pybind11::arg("t").none(false),
+            pybind11::doc(R"EOF(
+rotation(t)
+
+Parameters
+----------
+t : float
+    Epoch [s], in the same reference as `anchor_time`.
+
+Returns
+-------
+R : :py:class:`~numpy.ndarray`
+    (3, 3) ITRS -> ICRS rotation matrix.
+)EOF"));
+
+    obj.def("icrs2bfsf_rot", [](const block_t &block,
+                                const double t_start,
+                                const double t_end) {
+        pybind11::gil_scoped_release release;
+        return block.icrs2bfsf_rot(t_start, t_end);
+    }, pybind11::arg("t_start").none(false),
+       pybind11::arg("t_end").none(false),
+       pybind11::doc(R"EOF(
+icrs2bfsf_rot(t_start, t_end)
+
+Rotation matrix from ICRS to the local *Bluebild FastSynthesis Frame* (BFSF).
+
+Parameters
+----------
+t_start : float
+    Start of the observation period [s].
+t_end : float
+    End of the observation period [s].
+
+Returns
+-------
+R : :py:class:`~numpy.ndarray`
+    (3, 3) ICRS -> BFSF rotation matrix.
+)EOF"));
+
+    obj.def_property_readonly("N_antenna", &block_t::N_antenna);
+    obj.def_property_readonly("N_anchor", &block_t::N_anchor);
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_instrument_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    m.def("max_baseline",
+          &_max_baseline<float>,
+          pybind11::arg("XYZ").noconvert().none(false));
+
+    m.def("max_baseline",
+          &_max_baseline<double>,
+          pybind11::arg("XYZ").none(false),
+          pybind11::doc(R"EOF(
+max_baseline(XYZ)
+
+Maximum distance between two points of a point cloud.
+
+2D point clouds are reduced to their convex hull, whose diameter is then found in linear time with rotating calipers.
+3D point clouds are scanned pairwise without forming the (N_point, N_point) distance matrix.
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_point, 2) or (N_point, 3) Cartesian coordinates.
+
+Returns
+-------
+baseline : float
+    Largest pairwise distance.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.instrument import max_baseline
+
+.. doctest::
+
+   >>> XY = np.array([[0, 0], [1, 0], [1, 1], [0.5, 0.5]])
+   >>> np.around(max_baseline(XY), 3)
+   1.414
+)EOF"));
+
+    EarthBoundInstrumentGeometryBlock_bindings<float>(m, "EarthBoundInstrumentGeometryBlock_float32");
+    EarthBoundInstrumentGeometryBlock_bindings<double>(m, "EarthBoundInstrumentGeometryBlock_float64");
+}
@@ -0,0 +1,27 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Visibility generation utilities.
+
+Due to the high data-rates emanating from antennas, raw antenna time-series are rarely archived.
+Instead, signals from different antennas are correlated together to form *visibility* matrices.
+"""
+
+import _pypeline_phased_array_util_data_gen_visibility_pybind11 as __cpp
+
+from . import _visibility as __py
+
+VisibilityMatrix = __py.VisibilityMatrix
+VisibilityGeneratorBlock = __py.VisibilityGeneratorBlock
+ts2vs = __py.ts2vs
+
+sky_visibility = __cpp.sky_visibility
+wishart = __cpp.wishart
+VisibilityGeneratorBlock_float32 = __cpp.VisibilityGeneratorBlock_float32
+VisibilityGeneratorBlock_float64 = __cpp.VisibilityGeneratorBlock_float64
+FXCorrelator_float32 = __cpp.FXCorrelator_float32
+FXCorrelator_float64 = __cpp.FXCorrelator_float64
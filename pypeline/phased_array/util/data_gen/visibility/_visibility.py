@@ -1,6 +1,6 @@
 # #############################################################################
-# visibility.py
-# =============
+# _visibility.py
+# ==============
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -13,15 +13,16 @@ Instead, signals from different antennas are correlated together to form *visibi
 
 import numpy as np
 import scipy.fftpack as fftpack
+import scipy.sparse as sparse
 import skimage.util as sku
 
+import _pypeline_phased_array_util_data_gen_visibility_pybind11 as vis_cpp
 import pypeline.core as core
 import pypeline.phased_array.beamforming as beamforming
 import pypeline.phased_array.instrument as instrument
 import pypeline.phased_array.util.data_gen.sky as sky
 import pypeline.util.argcheck as chk
 import pypeline.util.array as array
-import pypeline.util.math.stat as stat
 import pypeline.util.math.func as func
 
 
@@ -77,13 +78,17 @@ class VisibilityMatrix(array.LabeledMatrix):
 class VisibilityGeneratorBlock(core.Block):
     """
     Generate synthetic visibility matrices.
+
+    Visibilities are drawn from a Wishart distribution centered on the sky + noise covariance.
+    Sources are processed in tiles and the full (N_src, N_antenna) steering matrix is never formed.
     """
 
     @chk.check(dict(sky_model=chk.is_instance(sky.SkyEmission),
                     T=chk.is_real,
                     fs=chk.is_real,
-                    SNR=chk.is_real))
-    def __init__(self, sky_model, T, fs, SNR):
+                    SNR=chk.is_real,
+                    seed=chk.allow_None(chk.is_integer)))
+    def __init__(self, sky_model, T, fs, SNR, seed=None):
         """
         Parameters
         ----------
@@ -95,6 +100,9 @@ class VisibilityGeneratorBlock(core.Block):
             Sampling rate [Hz].
         SNR : float
             Signal-to-Noise-Ratio (dB).
+        seed : int
+            Random seed.
+            If :py:obj:`None`, a seed is drawn from :py:mod:`numpy.random`.
         """
         super().__init__()
 
@@ -107,6 +115,15 @@ class VisibilityGeneratorBlock(core.Block):
         self._SNR = 10 ** (SNR / 10)
         self._sky_model = sky_model
 
+        if seed is None:
+            seed = np.random.randint(np.iinfo(np.int64).max)
+        elif seed < 0:
+            raise ValueError('Parameter[seed] must be non-negative.')
+        self._generator = vis_cpp.VisibilityGeneratorBlock_float64(
+            np.require(sky_model.xyz, np.float64, 'C'),
+            np.require(sky_model.intensity, np.float64, 'C'),
+            self._N_sample, self._SNR, seed)
+
     @chk.check(dict(XYZ=chk.is_instance(instrument.InstrumentGeometry),
                     W=chk.is_instance(beamforming.BeamWeights),
                     wl=chk.is_real))
@@ -177,16 +194,9 @@ class VisibilityGeneratorBlock(core.Block):
         if not XYZ.is_consistent_with(W, axes=[0, 0]):
             raise ValueError('Parameters[XYZ, W] are inconsistent.')
 
-        A = np.exp((1j * 2 * np.pi / wl) *
-                   (self._sky_model.xyz @ XYZ.data.T))
-        S_sky = ((W.data.conj().T @ (A.conj().T * self._sky_model.intensity)) @
-                 (A @ W.data))
-
-        noise_var = np.sum(self._sky_model.intensity) / (2 * self._SNR)
-        S_noise = W.data.conj().T @ (noise_var * W.data)
-
-        wishart = stat.Wishart(V=S_sky + S_noise, n=self._N_sample)
-        S = wishart()[0] / self._N_sample
+        S = self._generator(np.require(XYZ.data, np.float64, 'C'),
+                            sparse.csc_matrix(W.data, dtype=np.complex128),
+                            wl)
         return VisibilityMatrix(data=S, beam_idx=W.index[1])
 
 
@@ -270,36 +280,46 @@ def ts2vs(data, T, fs, channel_boundaries, stft_window_alpha):
     data = np.array(data, copy=False)
     channel_boundaries = np.array(channel_boundaries, dtype=np.float64)
 
-    # Partition data into time-slots.
     N_samples = int(fs * T)
     N_stream = data.shape[1]
-    block_data = (sku.view_as_blocks(data[:((len(data) // N_samples) * N_samples)],
-                                     (N_samples, N_stream))
-                  .squeeze(axis=1))
-    N_time_slot = block_data.shape[0]
+    N_band = len(channel_boundaries)
 
-    # Apply windowing
+    # Windowing
     tukey = func.Tukey(N_samples / fs,
                        N_samples / (fs * 2),
                        stft_window_alpha)
     window = tukey(np.arange(N_samples) / fs)
-    block_data *= window.reshape(1, N_samples, 1)
+
+    # Map every STFT bin to the band it belongs to (-1 if none).
+    frequency = np.linspace(0, fs, N_samples)
+    idx = np.digitize(frequency, np.sort(channel_boundaries, axis=-1).flatten())
+    bin_band = np.where((0 < idx) & (idx < 2 * N_band) & (idx % 2 == 1),
+                        (idx - 1) // 2, -1).astype(np.int32)
+
+    if chk.has_reals(data):  # Streaming FX correlator
+        if data.dtype == np.float32:
+            fx = vis_cpp.FXCorrelator_float32(N_stream, window, bin_band, N_band)
+        else:
+            fx = vis_cpp.FXCorrelator_float64(N_stream, window, bin_band, N_band)
+
+        fx.push(data)
+        S = fx.drain().astype(np.complex64)
+        return N_samples, S
+
+    # Partition data into time-slots.
+    block_data = (sku.view_as_blocks(data[:((len(data) // N_samples) * N_samples)],
+                                     (N_samples, N_stream))
+                  .squeeze(axis=1))
+    N_time_slot = block_data.shape[0]
+    block_data = block_data * window.reshape(1, N_samples, 1)
 
     # Block-level STFT
     stft_data = fftpack.fft(block_data, axis=1)
-    frequency = np.linspace(0, fs, N_samples)
 
     # Visibility formation for frequency bands of interest only.
-    N_band = len(channel_boundaries)
     S = np.zeros((N_time_slot, N_band, N_stream, N_stream), dtype=np.complex64)
-
-    idx = np.digitize(frequency, np.sort(channel_boundaries, axis=-1).flatten())
-    for _idx in idx:
-        if (0 < _idx < 2 * N_band) and chk.is_odd(_idx):
-            mask = (idx == _idx)
-            freq_data = stft_data[:, mask]
-            S[:, (_idx - 1) // 2] += np.sum(freq_data[:, :, :, np.newaxis] *
-                                            freq_data[:, :, np.newaxis, :].conj(),
-                                            axis=1) / np.sum(mask)
+    for b in range(N_band):
+        freq_data = stft_data[:, bin_band == b]
+        S[:, b] = np.einsum('tki,tkj->tij', freq_data, freq_data.conj())
 
     return N_samples, S
@@ -0,0 +1,411 @@
+// ############################################################################
+// _visibility_pybind11.cpp
+// ========================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/numpy.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/data_gen/correlator.hpp"
+#include "pypeline/phased_array/util/data_gen/visibility.hpp"
+#include "pypeline/util/math/fourier.hpp"
+
+namespace correlator = pypeline::phased_array::util::data_gen::correlator;
+namespace fourier = pypeline::util::math::fourier;
+namespace vis = pypeline::phased_array::util::data_gen::visibility;
+
+template <typename TT>
+void VisibilityGeneratorBlock_bindings(pybind11::module &m,
+                                       const std::string &class_name) {
+    using cTT = std::complex<TT>;
+
+    auto obj = pybind11::class_<vis::VisibilityGeneratorBlock<TT>>(m,
+                                                                   class_name.data(),
+                                                                   R"EOF(
+Generate synthetic visibility matrices.
+
+Visibilities are drawn from :math:`\mathcal{W}(S_{\text{sky}} + S_{\text{noise}}, N_{\text{sample}}) / N_{\text{sample}}`, with :math:`S_{\text{noise}} = \frac{\sum I}{2 \text{SNR}} W^{H} W`.
+Successive calls draw from distinct random streams derived from `seed`: a run is fully reproducible from its seed.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   import scipy.sparse as sparse
+   from pypeline.phased_array.util.data_gen.visibility import VisibilityGeneratorBlock_float64
+
+.. doctest::
+
+   >>> src_xyz = np.array([[0, 0, 1.0]])
+   >>> intensity = np.array([1.0])
+   >>> S_gen = VisibilityGeneratorBlock_float64(src_xyz, intensity,
+   ...                                          N_sample=1568001, SNR=np.inf, seed=0)
+
+   >>> XYZ = np.random.rand(10, 3)
+   >>> W = sparse.identity(10, dtype=np.complex128, format='csc')
+   >>> S = S_gen(XYZ, W, 2.0)
+   >>> np.linalg.matrix_rank(S) <= 1
+   True
+)EOF");
+
+    obj.def(pybind11::init([](Eigen::Ref<const MatrixXX_t<TT>> src_xyz,
+                              Eigen::Ref<const ArrayX_t<TT>> intensity,
+                              const int N_sample,
+                              const double SNR,
+                              const uint64_t seed,
+                              const int N_tile) {
+        if (N_sample <= 0) {
+            std::string msg = "Parameter[N_sample] must be positive.";
+            throw std::runtime_error(msg);
+        }
+        if (N_tile <= 0) {
+            std::string msg = "Parameter[N_tile] must be positive.";
+            throw std::runtime_error(msg);
+        }
+
+        return std::make_unique<vis::VisibilityGeneratorBlock<TT>>(src_xyz, intensity,
+                                                                   N_sample, SNR, seed, N_tile);
+    }), pybind11::arg("src_xyz").none(false),
+        pybind11::arg("intensity").none(false),
+        pybind11::arg("N_sample").none(false),
+        pybind11::arg("SNR").none(false),
+        pybind11::arg("seed").none(false),
+        pybind11::arg("N_tile") = 256,
+        pybind11::doc(R"EOF(
+__init__(src_xyz, intensity, N_sample, SNR, seed, N_tile=256)
+
+Parameters
+----------
+src_xyz : :py:class:`~numpy.ndarray`
+    (N_src, 3) Cartesian ICRS source directions.
+intensity : :py:class:`~numpy.ndarray`
+    (N_src,) non-negative source intensities.
+N_sample : int
+    Number of time-samples integrated per visibility matrix.
+SNR : float
+    Signal-to-Noise-Ratio (linear scale). Can be infinite.
+seed : int
+    Random seed.
+N_tile : int
+    Number of sources processed at once.
+)EOF"));
+
+    obj.def("__call__", [](vis::VisibilityGeneratorBlock<TT> &S_gen,
+                           Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                           const SpMatrixXX_t<cTT> &W,
+                           const double wl) {
+        return S_gen(XYZ, W, wl);
+    }, pybind11::arg("XYZ").none(false),
+       pybind11::arg("W").none(false),
+       pybind11::arg("wl").none(false),
+       pybind11::call_guard<pybind11::gil_scoped_release>(),
+       pybind11::doc(R"EOF(
+__call__(XYZ, W, wl)
+
+Compute visibility matrix.
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) ICRS instrument geometry.
+W : :py:class:`~scipy.sparse.csc_matrix`
+    (N_antenna, N_beam) synthesis beamweights.
+wl : float
+    Wave-length [m] at which to generate visibilities.
+
+Returns
+-------
+S : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) visibility matrix.
+)EOF"));
+}
+
+template <typename TT>
+MatrixXX_t<std::complex<TT>> _sky_visibility(Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                                             const SpMatrixXX_t<std::complex<TT>> &W,
+                                             Eigen::Ref<const MatrixXX_t<TT>> src_xyz,
+                                             Eigen::Ref<const ArrayX_t<TT>> intensity,
+                                             const double wl,
+                                             const int N_tile) {
+    if (N_tile <= 0) {
+        std::string msg = "Parameter[N_tile] must be positive.";
+        throw std::runtime_error(msg);
+    }
+
+    return vis::sky_visibility<TT>(XYZ, W, src_xyz, intensity, wl, N_tile);
+}
+
+template <typename TT>
+MatrixXX_t<std::complex<TT>> _wishart(const MatrixXX_t<std::complex<TT>> &V,
+                                      const int n,
+                                      const uint64_t seed) {
+    if (n <= 0) {
+        std::string msg = "Parameter[n] must be positive.";
+        throw std::runtime_error(msg);
+    }
+
+    return vis::wishart<TT>(V, n, seed);
+}
+
+void sky_visibility_bindings(pybind11::module &m) {
+    m.def("sky_visibility",
+          &_sky_visibility<float>,
+          pybind11::arg("XYZ").noconvert().none(false),
+          pybind11::arg("W").none(false),
+          pybind11::arg("src_xyz").noconvert().none(false),
+          pybind11::arg("intensity").noconvert().none(false),
+          pybind11::arg("wl").none(false),
+          pybind11::arg("N_tile") = 256,
+          pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    m.def("sky_visibility",
+          &_sky_visibility<double>,
+          pybind11::arg("XYZ").noconvert().none(false),
+          pybind11::arg("W").none(false),
+          pybind11::arg("src_xyz").noconvert().none(false),
+          pybind11::arg("intensity").noconvert().none(false),
+          pybind11::arg("wl").none(false),
+          pybind11::arg("N_tile") = 256,
+          pybind11::call_guard<pybind11::gil_scoped_release>(),
+          pybind11::doc(R"EOF(
+sky_visibility(XYZ, W, src_xyz, intensity, wl, N_tile=256)
+
+Compute noiseless visibility matrix.
+
+:math:`S = W^{H} A^{H} \text{diag}(I) A W`, with :math:`A[k, i] = \exp(j \frac{2 \pi}{\lambda} \langle s_{k}, p_{i} \rangle)`.
+
+Sources are processed in tiles of `N_tile` rows: the (N_src, N_antenna) steering matrix is never formed in full.
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) Cartesian antenna coordinates.
+W : :py:class:`~scipy.sparse.csc_matrix`
+    (N_antenna, N_beam) synthesis beamweights.
+src_xyz : :py:class:`~numpy.ndarray`
+    (N_src, 3) Cartesian source directions (same frame as `XYZ`).
+intensity : :py:class:`~numpy.ndarray`
+    (N_src,) non-negative source intensities.
+wl : float
+    Wave-length [m] at which to generate visibilities.
+N_tile : int
+    Number of sources processed at once.
+
+Returns
+-------
+S : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) visibility matrix.
+)EOF"));
+}
+
+void wishart_bindings(pybind11::module &m) {
+    m.def("wishart",
+          &_wishart<float>,
+          pybind11::arg("V").noconvert().none(false),
+          pybind11::arg("n").none(false),
+          pybind11::arg("seed").none(false),
+          pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    m.def("wishart",
+          &_wishart<double>,
+          pybind11::arg("V").noconvert().none(false),
+          pybind11::arg("n").none(false),
+          pybind11::arg("seed").none(false),
+          pybind11::call_guard<pybind11::gil_scoped_release>(),
+          pybind11::doc(R"EOF(
+wishart(V, n, seed)
+
+Draw a sample from the Wishart distribution.
+
+The sample is obtained using the `Bartlett Decomposition`_.
+Each row of the Bartlett factor is drawn from its own generator seeded by (`seed`, row): results do not depend on the number of threads.
+
+.. _Bartlett Decomposition: https://en.wikipedia.org/wiki/Wishart_distribution#Bartlett_decomposition
+
+Parameters
+----------
+V : :py:class:`~numpy.ndarray`
+    (p, p) positive-semidefinite Hermitian scale matrix.
+n : int
+    Degrees of freedom. (n > p)
+seed : int
+    Random seed.
+
+Returns
+-------
+X : :py:class:`~numpy.ndarray`
+    (p, p) sample.
+)EOF"));
+}
+
+template <typename TT>
+void FXCorrelator_bindings(pybind11::module &m,
+                           const std::string &class_name) {
+    using cTT = std::complex<TT>;
+
+    auto obj = pybind11::class_<correlator::FXCorrelator<TT>>(m,
+                                                              class_name.data(),
+                                                              R"EOF(
+Streaming FX correlator: transform real-valued antenna time-series to visibility matrices.
+
+Samples are buffered until a block of N_fft time-samples is available.
+Each block is windowed, Fourier-transformed with a batched real->complex FFT, and correlated per frequency band as :math:`S_{b} = \sum_{k \in b} X[k] X[k]^{H}`.
+Only the upper triangle of each :math:`S_{b}` is accumulated.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.util.data_gen.visibility import FXCorrelator_float64
+
+.. doctest::
+
+   >>> N_stream, N_fft = 6, 2400
+   >>> window = np.ones(N_fft)
+   >>> bin_band = np.full(N_fft, -1, dtype=np.int32)
+   >>> bin_band[70:80] = 0
+
+   >>> fx = FXCorrelator_float64(N_stream, window, bin_band, N_band=1)
+   >>> fx.push(np.random.randn(10 * N_fft + 5, N_stream))
+   >>> fx.N_ready
+   10
+   >>> fx.drain().shape
+   (10, 1, 6, 6)
+)EOF");
+
+    obj.def(pybind11::init([](const int N_stream,
+                              pybind11::array_t<TT, pybind11::array::c_style | pybind11::array::forcecast> window,
+                              pybind11::array_t<int, pybind11::array::c_style | pybind11::array::forcecast> bin_band,
+                              const int N_band,
+                              fourier::planning_effort effort) {
+        if (N_stream <= 0) {
+            std::string msg = "Parameter[N_stream] must be positive.";
+            throw std::runtime_error(msg);
+        }
+        if (N_band < 0) {
+            std::string msg = "Parameter[N_band] must be non-negative.";
+            throw std::runtime_error(msg);
+        }
+        if ((window.ndim() != 1) || (bin_band.ndim() != 1)) {
+            std::string msg = "Parameters[window, bin_band] must be 1D.";
+            throw std::runtime_error(msg);
+        }
+
+        std::vector<TT> _window(window.data(), window.data() + window.size());
+        std::vector<int> _bin_band(bin_band.data(), bin_band.data() + bin_band.size());
+        return std::make_unique<correlator::FXCorrelator<TT>>(N_stream, _window, _bin_band, N_band,
+                                                              static_cast<unsigned int>(effort));
+    }), pybind11::arg("N_stream").none(false),
+        pybind11::arg("window").none(false),
+        pybind11::arg("bin_band").none(false),
+        pybind11::arg("N_band").none(false),
+        pybind11::arg("effort") = fourier::planning_effort::NONE,
+        pybind11::doc(R"EOF(
+__init__(N_stream, window, bin_band, N_band, effort=planning_effort.NONE)
+
+Parameters
+----------
+N_stream : int
+    Number of antenna streams.
+window : :py:class:`~numpy.ndarray`
+    (N_fft,) window applied to each block prior to the FFT.
+    N_fft determines the block length.
+bin_band : :py:class:`~numpy.ndarray`
+    (N_fft,) band index of every FFT bin, or -1 if the bin is unused.
+N_band : int
+    Number of frequency bands.
+effort : :py:class:`~pypeline.util.math.fourier.planning_effort`
+    Amount of time spent finding best transform.
+)EOF"));
+
+    obj.def("push", [](correlator::FXCorrelator<TT> &fx,
+                       pybind11::array_t<TT, pybind11::array::c_style | pybind11::array::forcecast> x) {
+        if (!((x.ndim() == 2) && (static_cast<size_t>(x.shape(1)) == fx.N_stream()))) {
+            std::string msg = "Parameter[x] must have shape (N_sample, N_stream).";
+            throw std::runtime_error(msg);
+        }
+
+        const TT *data = x.data();
+        const size_t N_sample = x.shape(0);
+        pybind11::gil_scoped_release release;
+        fx.push(data, N_sample);
+    }, pybind11::arg("x").none(false),
+       pybind11::doc(R"EOF(
+push(x)
+
+Ingest antenna samples.
+
+Complete blocks are correlated immediately; a trailing partial block is kept until the next call.
+
+Parameters
+----------
+x : :py:class:`~numpy.ndarray`
+    (N_sample, N_stream) real-valued samples.
+)EOF"));
+
+    obj.def("drain", [](correlator::FXCorrelator<TT> &fx) {
+        const size_t N_ready = fx.N_ready();
+        const size_t N_band = fx.N_band();
+        const size_t N_stream = fx.N_stream();
+
+        pybind11::array_t<cTT> S({N_ready, N_band, N_stream, N_stream});
+        cTT *out = S.mutable_data();
+        for (size_t t = 0; t < N_ready; ++t) {
+            const std::vector<MatrixXX_t<cTT>> S_t = fx.pop();
+            for (size_t b = 0; b < N_band; ++b, out += N_stream * N_stream) {
+                std::memcpy(out, S_t[b].data(), sizeof(cTT) * N_stream * N_stream);
+            }
+        }
+        return S;
+    }, pybind11::doc(R"EOF(
+drain()
+
+Pop all pending visibility matrices.
+
+Returns
+-------
+S : :py:class:`~numpy.ndarray`
+    (N_ready, N_band, N_stream, N_stream) visibility matrices, oldest first.
+)EOF"));
+
+    obj.def_property_readonly("N_ready", &correlator::FXCorrelator<TT>::N_ready,
+                              R"EOF(
+Returns
+-------
+N_ready : int
+    Number of visibility sets waiting to be drained.
+)EOF");
+
+    obj.def("reset", &correlator::FXCorrelator<TT>::reset,
+            pybind11::doc(R"EOF(
+reset()
+
+Drop buffered samples and pending visibility matrices.
+)EOF"));
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_util_data_gen_visibility_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    VisibilityGeneratorBlock_bindings<float>(m, "VisibilityGeneratorBlock_float32");
+    VisibilityGeneratorBlock_bindings<double>(m, "VisibilityGeneratorBlock_float64");
+    sky_visibility_bindings(m);
+    wishart_bindings(m);
+
+    FXCorrelator_bindings<float>(m, "FXCorrelator_float32");
+    FXCorrelator_bindings<double>(m, "FXCorrelator_float64");
+}
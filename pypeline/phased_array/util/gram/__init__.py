@@ -0,0 +1,20 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Gram-related operations and tools.
+"""
+
+import _pypeline_phased_array_util_gram_pybind11 as __cpp
+
+from . import _gram as __py
+
+GramMatrix = __py.GramMatrix
+GramBlock = __py.GramBlock
+
+gram = __cpp.gram
+GramBlock_float32 = __cpp.GramBlock_float32
+GramBlock_float64 = __cpp.GramBlock_float64
@@ -1,6 +1,6 @@
 # #############################################################################
-# gram.py
-# =======
+# _gram.py
+# ========
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -9,8 +9,9 @@ Gram-related operations and tools.
 """
 
 import numpy as np
-import scipy.linalg as linalg
+import scipy.sparse as sparse
 
+import _pypeline_phased_array_util_gram_pybind11 as gram_cpp
 import pypeline.core as core
 import pypeline.phased_array.beamforming as beamforming
 import pypeline.phased_array.instrument as instrument
@@ -70,14 +71,28 @@ class GramMatrix(array.LabeledMatrix):
 class GramBlock(core.Block):
     """
     Compute Gram matrices.
+
+    Gram matrices only depend on the instrument geometry through its baseline lengths.
+    The last few results are therefore cached and re-used whenever the beamweights and wavelength match exactly and the geometry differs from a cached one by a rigid rotation (e.g. Earth rotation between epochs).
     """
 
-    def __init__(self):
+    @chk.check(dict(N_entry=chk.is_integer,
+                    tol=chk.is_real))
+    def __init__(self, N_entry=16, tol=1e-6):
         """
-
+        Parameters
+        ----------
+        N_entry : int
+            Number of Gram matrices to cache. (0 disables caching.)
+        tol : float
+            Largest antenna displacement [wl] tolerated between geometries considered identical.
         """
         super().__init__()
 
+        if N_entry < 0:
+            raise ValueError('Parameter[N_entry] must be non-negative.')
+        self._engine = gram_cpp.GramBlock_float64(N_entry, tol)
+
     @chk.check(dict(XYZ=chk.is_instance(instrument.InstrumentGeometry),
                     W=chk.is_instance(beamforming.BeamWeights),
                     wl=chk.is_real))
@@ -140,11 +155,8 @@ class GramBlock(core.Block):
         if not XYZ.is_consistent_with(W, axes=[0, 0]):
             raise ValueError('Parameters[XYZ, W] are inconsistent.')
 
-        N_antenna = XYZ.shape[0]
-        baseline = linalg.norm(XYZ.data.reshape(N_antenna, 1, 3) -
-                               XYZ.data.reshape(1, N_antenna, 3), axis=-1)
-
-        G_1 = (4 * np.pi) * np.sinc((2 / wl) * baseline)
-        G_2 = W.data.conj().T @ G_1 @ W.data
+        G = self._engine(np.require(XYZ.data, np.float64, 'C'),
+                         sparse.csc_matrix(W.data, dtype=np.complex128),
+                         wl)
 
-        return GramMatrix(data=G_2, beam_idx=W.index[1])
+        return GramMatrix(data=G, beam_idx=W.index[1])
@@ -0,0 +1,198 @@
+// ############################################################################
+// _gram_pybind11.cpp
+// ==================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/gram.hpp"
+
+namespace gram = pypeline::phased_array::util::gram;
+
+template <typename TT>
+void GramBlock_bindings(pybind11::module &m,
+                        const std::string &class_name) {
+    using cTT = std::complex<TT>;
+
+    auto obj = pybind11::class_<gram::GramBlock<TT>>(m,
+                                                     class_name.data(),
+                                                     R"EOF(
+Compute Gram matrices, re-using previous results when possible.
+
+The Gram matrix only depends on antenna positions through baseline lengths, which are invariant to rotations of the array.
+The last `N_entry` results are cached: a cached result is re-used if `W` and `wl` match exactly and the query geometry can be rigidly aligned onto the cached one to within `tol * wl` [m] per antenna.
+
+Beamweights that track a fixed sky direction change with every epoch and never hit the cache.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   import scipy.sparse as sparse
+   from scipy.spatial.transform import Rotation
+   from pypeline.phased_array.util.gram import GramBlock_float64
+
+.. doctest::
+
+   >>> XYZ = np.random.rand(100, 3)
+   >>> W = sparse.identity(100, dtype=np.complex128, format='csc')
+
+   >>> gr = GramBlock_float64(N_entry=4, tol=1e-6)
+   >>> G1 = gr(XYZ, W, 2.0)  # computed
+
+   >>> R = Rotation.from_rotvec([0, 0, 0.3]).as_matrix()
+   >>> G2 = gr(XYZ @ R.T, W, 2.0)  # fetched from cache
+   >>> np.allclose(G1, G2), gr.size()
+   (True, 1)
+)EOF");
+
+    obj.def(pybind11::init([](const int N_entry,
+                              const double tol) {
+        if (N_entry < 0) {
+            std::string msg = "Parameter[N_entry] must be non-negative.";
+            throw std::runtime_error(msg);
+        }
+
+        return std::make_unique<gram::GramBlock<TT>>(N_entry, tol);
+    }), pybind11::arg("N_entry") = 16,
+        pybind11::arg("tol") = 1e-6,
+        pybind11::doc(R"EOF(
+__init__(N_entry=16, tol=1e-6)
+
+Parameters
+----------
+N_entry : int
+    Number of Gram matrices to cache. (0 disables caching.)
+tol : float
+    Largest antenna displacement [wl] tolerated between geometries considered identical.
+)EOF"));
+
+    obj.def("__call__", [](gram::GramBlock<TT> &gr,
+                           Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                           const SpMatrixXX_t<cTT> &W,
+                           const double wl) {
+        return gr(XYZ, W, wl);
+    }, pybind11::arg("XYZ").none(false),
+       pybind11::arg("W").none(false),
+       pybind11::arg("wl").none(false),
+       pybind11::call_guard<pybind11::gil_scoped_release>(),
+       pybind11::doc(R"EOF(
+__call__(XYZ, W, wl)
+
+Compute Gram matrix.
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) Cartesian antenna coordinates in any reference frame.
+W : :py:class:`~scipy.sparse.csc_matrix`
+    (N_antenna, N_beam) synthesis beamweights.
+wl : float
+    Wave-length [m] at which to compute the Gram.
+
+Returns
+-------
+G : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) Gram matrix.
+)EOF"));
+
+    obj.def("size", &gram::GramBlock<TT>::size,
+            pybind11::doc(R"EOF(
+size()
+
+Returns
+-------
+N : int
+    Number of cached Gram matrices.
+)EOF"));
+
+    obj.def("clear", &gram::GramBlock<TT>::clear,
+            pybind11::doc(R"EOF(
+clear()
+
+Drop all cached Gram matrices.
+)EOF"));
+}
+
+template <typename TT>
+MatrixXX_t<std::complex<TT>> _gram(Eigen::Ref<const MatrixXX_t<TT>> XYZ,
+                                   const SpMatrixXX_t<std::complex<TT>> &W,
+                                   const double wl) {
+    return gram::gram<TT>(XYZ, W, wl);
+}
+
+void gram_bindings(pybind11::module &m) {
+    m.def("gram",
+          &_gram<float>,
+          pybind11::arg("XYZ").noconvert().none(false),
+          pybind11::arg("W").none(false),
+          pybind11::arg("wl").none(false),
+          pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    m.def("gram",
+          &_gram<double>,
+          pybind11::arg("XYZ").noconvert().none(false),
+          pybind11::arg("W").none(false),
+          pybind11::arg("wl").none(false),
+          pybind11::call_guard<pybind11::gil_scoped_release>(),
+          pybind11::doc(R"EOF(
+gram(XYZ, W, wl)
+
+Compute Gram matrix.
+
+:math:`G = W^{H} G_{1} W`, with :math:`G_{1}[i, j] = 4 \pi \text{sinc}(2 \| p_{i} - p_{j} \| / \lambda)`.
+
+Only the non-zero entries of `W` are visited and :math:`G_{1}` is never formed: memory usage is :math:`O(N_{\text{antenna}} + N_{\text{beam}}^{2})`.
+Only the upper-triangular half of `G` is evaluated.
+
+Parameters
+----------
+XYZ : :py:class:`~numpy.ndarray`
+    (N_antenna, 3) Cartesian antenna coordinates in any reference frame.
+W : :py:class:`~scipy.sparse.csc_matrix`
+    (N_antenna, N_beam) synthesis beamweights.
+    Must have the complex counterpart of `XYZ`'s dtype.
+wl : float
+    Wave-length [m] at which to compute the Gram.
+
+Returns
+-------
+G : :py:class:`~numpy.ndarray`
+    (N_beam, N_beam) Gram matrix.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   import scipy.sparse as sparse
+   from pypeline.phased_array.util.gram import gram
+
+.. doctest::
+
+   >>> XYZ = np.random.rand(100, 3)
+   >>> W = sparse.identity(100, dtype=np.complex128, format='csc')
+
+   >>> G = gram(XYZ, W, 2.0)
+   >>> G.shape
+   (100, 100)
+)EOF"));
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_util_gram_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    GramBlock_bindings<float>(m, "GramBlock_float32");
+    GramBlock_bindings<double>(m, "GramBlock_float64");
+    gram_bindings(m);
+}
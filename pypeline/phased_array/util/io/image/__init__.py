@@ -13,8 +13,13 @@ import _pypeline_phased_array_util_io_image_pybind11 as __cpp
 from . import _image as __py
 
 from_fits = __py.from_fits
+from_archive = __py.from_archive
 SphericalImage = __py.SphericalImage
+ArchivedSphericalImage = __py.ArchivedSphericalImage
 # EqualAngleImage = __py.EqualAngleImage
 
 SphericalImageContainer_float32 = __cpp.SphericalImageContainer_float32
 SphericalImageContainer_float64 = __cpp.SphericalImageContainer_float64
+SphericalImageArchive_float32 = __cpp.SphericalImageArchive_float32
+SphericalImageArchive_float64 = __cpp.SphericalImageArchive_float64
+open_archive = __cpp.open_archive
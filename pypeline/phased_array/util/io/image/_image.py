@@ -38,7 +38,21 @@ def from_fits(file_name):
     Returns
     -------
     I : :py:class:`~pypeline.phased_array.util.io.image.SphericalImage`
+
+    Notes
+    -----
+    Unless `IMG_TYPE` overrides :py:meth:`~pypeline.phased_array.util.io.image.SphericalImage._from_fits`,
+    the file is parsed natively in a single pass. Data is returned in double precision, as with
+    :py:meth:`~pypeline.phased_array.util.io.image.SphericalImage._from_fits`.
     """
+    native_types = [name for (name, k) in globals().items()
+                    if (isinstance(k, type) and issubclass(k, SphericalImage) and
+                        (k._from_fits.__func__ is SphericalImage._from_fits.__func__))]
+    img_type, I_container = im_cpp.from_fits(file_name, native_types)
+    if I_container is not None:
+        I = globals()[img_type](I_container)
+        return I
+
     with fits.open(file_name, mode='readonly',
                    memmap=True, lazy_load_hdus=True) as hdulist:
         # PrimaryHDU: grid / class info
@@ -50,6 +64,29 @@ def from_fits(file_name):
         return I
 
 
+@chk.check(dict(file_name=chk.is_instance(str),
+                plane=chk.is_integer))
+def from_archive(file_name, plane):
+    """
+    Load image lazily from archive.
+
+    Parameters
+    ----------
+    file_name : str
+        Archive created with :py:meth:`~pypeline.phased_array.util.io.image.SphericalImageArchive_float32.create`
+        or :py:meth:`~pypeline.phased_array.util.io.image.SphericalImageArchive_float64.create`.
+    plane : int
+        Index of the plane to load.
+
+    Returns
+    -------
+    I : :py:class:`~pypeline.phased_array.util.io.image.ArchivedSphericalImage`
+    """
+    archive = im_cpp.open_archive(file_name)
+    I = ArchivedSphericalImage(archive, plane)
+    return I
+
+
 class SphericalImage:
     """
     Wrapper around :py:class:`SphericalImageContainer_float32` and
@@ -132,15 +169,19 @@ class SphericalImage:
     .. image:: _img/sphericalimage_lcc_example.png
     """
 
-    @chk.check('container', chk.is_instance(im_cpp.SphericalImageContainer_float32,
-                                            im_cpp.SphericalImageContainer_float64))
+    @chk.check('container', chk.allow_None(chk.is_instance(im_cpp.SphericalImageContainer_float32,
+                                                           im_cpp.SphericalImageContainer_float64)))
     def __init__(self, container):
         """
         Parameters
         ----------
         container: :py:class:`~pypeline_phased_array_util_io_image_pybind11.SphericalImageContainer_float32` or :py:class:`~pypeline_phased_array_util_io_image_pybind11.SphericalImageContainer_float64`
             Bare container holding spherical image data.
+            :py:obj:`None` is reserved to subclasses which load the container lazily through a `_container` property.
         """
+        if (container is None) and not isinstance(getattr(type(self), '_container', None), property):
+            raise ValueError('Parameter[container] must be specified.')
+
         self._container = container
 
     @property
@@ -183,7 +224,16 @@ class SphericalImage:
               $ ds9 <FITS_file>.fits[IMAGE]
 
           WCS information is only available in external FITS viewers if using :py:class:`~pypeline.phased_array.util.io.image.EqualAngleImage`.
+
+        * Subclasses which do not customize the HDUs are written natively by streaming the data cube to disk:
+          memory usage does not depend on the image size.
         """
+        klass = type(self)
+        if ((klass._PrimaryHDU is SphericalImage._PrimaryHDU) and
+                (klass._ImageHDU is SphericalImage._ImageHDU)):
+            self._container.to_fits(file_name, klass.__name__)
+            return
+
         primary_hdu = self._PrimaryHDU()
         image_hdu = self._ImageHDU()
 
@@ -245,12 +295,12 @@ class SphericalImage:
         # ImageHDU: extract data cube.
         image = image_hdu.data
         # Make sure (image, grid) have the same dtype to work with SphericalImageContainer_floatxx().
-        image = image.astype(grid.dtype)
+        image = np.ascontiguousarray(image, dtype=grid.dtype)
 
         if grid.dtype == np.dtype(np.float32):
-            I_container = im_cpp.SphericalImageContainer_float32(image, grid)
+            I_container = im_cpp.SphericalImageContainer_float32(image, grid, copy=False)
         else:  # float64 mode
-            I_container = im_cpp.SphericalImageContainer_float64(image, grid)
+            I_container = im_cpp.SphericalImageContainer_float64(image, grid, copy=False)
         I = cls(I_container)
         return I
 
@@ -719,6 +769,108 @@ class SphericalImage:
         ax.axis('equal')
 
 
+class ArchivedSphericalImage(SphericalImage):
+    """
+    :py:class:`~pypeline.phased_array.util.io.image.SphericalImage` backed by one plane of a
+    :py:class:`~pypeline.phased_array.util.io.image.SphericalImageArchive_floatxx`.
+
+    The grid is read directly from the archive's memory-mapped file.
+    Image data is only decoded on first access to :py:attr:`image`: use :py:meth:`tile` to inspect sub-regions without decoding the full plane.
+    """
+
+    @chk.check(dict(archive=chk.is_instance(im_cpp.SphericalImageArchive_float32,
+                                            im_cpp.SphericalImageArchive_float64),
+                    plane=chk.is_integer))
+    def __init__(self, archive, plane):
+        """
+        Parameters
+        ----------
+        archive : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageArchive_float32` or :py:class:`~pypeline.phased_array.util.io.image.SphericalImageArchive_float64`
+            Archive holding the image.
+        plane : int
+            Index of the plane to load.
+        """
+        N_plane = archive.N_plane
+        if not (-N_plane <= plane < N_plane):
+            raise ValueError(f'Parameter[plane] must lie in {{-{N_plane}, ..., {N_plane - 1}}}.')
+
+        self._archive = archive
+        self._plane = plane % N_plane
+        super().__init__(None)  # Plane is decoded on first access.
+
+    @property
+    def _container(self):
+        if self.__container is None:
+            self.__container = self._archive.read_plane(self._plane)
+        return self.__container
+
+    @_container.setter
+    def _container(self, container):
+        self.__container = container
+
+    @property
+    def grid(self):
+        """
+        Returns
+        -------
+        :py:class:`~numpy.ndarray`
+            (3, ...) Cartesian coordinates of the sky on which the data points are defined.
+        """
+        return self._archive.grid
+
+    @property
+    def shape(self):
+        """
+        Returns
+        -------
+        tuple
+            Shape of data cube.
+        """
+        return (self._archive.N_level,) + self._archive.grid.shape[1:]
+
+    @property
+    def tag(self):
+        """
+        Returns
+        -------
+        float
+            Label of the plane (ex: time, frequency).
+        """
+        return self._archive.tags[self._plane]
+
+    @chk.check('file_name', chk.is_instance(str))
+    def to_fits(self, file_name):
+        """
+        Save image to FITS file.
+
+        The file is loaded back as a plain :py:class:`~pypeline.phased_array.util.io.image.SphericalImage`.
+
+        Parameters
+        ----------
+        file_name : str
+            Name of file.
+        """
+        SphericalImage(self._container).to_fits(file_name)
+
+    @chk.check(dict(level=chk.is_integer,
+                    band=chk.is_integer))
+    def tile(self, level, band):
+        """
+        Decode one (level, colatitude-band) tile of the image.
+
+        Parameters
+        ----------
+        level : int
+        band : int
+
+        Returns
+        -------
+        :py:class:`~numpy.ndarray`
+            (N_row_band, N_width) or (N_point_band,) samples.
+        """
+        return self._archive.read_tile(self._plane, level, band)
+
+
 # class EqualAngleImage(SphericalImage):
 #     """
 #     Specialized container for Equal-Angle sampled images on :math:`\mathbb{S}^{2}.`
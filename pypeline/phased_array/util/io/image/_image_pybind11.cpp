@@ -4,14 +4,25 @@
 // Author : Sepand KASHANI [sep@zurich.ibm.com]
 // ############################################################################
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "pybind11/pybind11.h"
+#include "pybind11/numpy.h"
 
+#include "pypeline/phased_array/util/io/archive.hpp"
+#include "pypeline/phased_array/util/io/fits.hpp"
 #include "pypeline/phased_array/util/io/image.hpp"
 #include "pypeline/util/cpp_py3_interop.hpp"
 
+namespace archive = pypeline::phased_array::util::io::archive;
 namespace cpp_py3_interop = pypeline::util::cpp_py3_interop;
+namespace fits = pypeline::phased_array::util::io::fits;
 namespace image = pypeline::phased_array::util::io::image;
 
 template <typename T>
@@ -81,15 +92,47 @@ Examples
 )EOF");
 
     obj.def(pybind11::init([](pybind11::array_t<T> image,
-                              pybind11::array_t<T> grid) {
-        const auto& image_view = cpp_py3_interop::numpy_to_xview<T>(image);
-        const auto& grid_view = cpp_py3_interop::numpy_to_xview<T>(grid);
+                              pybind11::array_t<T> grid,
+                              const bool copy) {
+        if (copy) {
+            const auto& image_view = cpp_py3_interop::numpy_to_xview<T>(image);
+            const auto& grid_view = cpp_py3_interop::numpy_to_xview<T>(grid);
+
+            return std::make_unique<image::SphericalImageContainer<T>>(image_view, grid_view);
+        }
+
+        const int c_contiguous = pybind11::array::c_style;
+        if (!((image.flags() & c_contiguous) && (grid.flags() & c_contiguous))) {
+            std::string msg = "Parameters[image, grid] must be C-contiguous when copy=False.";
+            throw std::runtime_error(msg);
+        }
+        const bool writable = (image.writeable() && grid.writeable());
 
-        return std::make_unique<image::SphericalImageContainer<T>>(image_view, grid_view);
+        std::vector<size_t> shape_image(image.shape(), image.shape() + image.ndim());
+        std::vector<size_t> shape_grid(grid.shape(), grid.shape() + grid.ndim());
+        T *image_data = const_cast<T*>(image.data());
+        T *grid_data = const_cast<T*>(grid.data());
+
+        /*
+         * The container keeps references to the NumPy arrays to prevent them
+         * from being garbage-collected.
+         * Copies of the container (ex: held by C++ code which released the
+         * GIL) can drop the last reference from any thread: the deleter
+         * re-acquires the GIL before decrementing reference counts.
+         */
+        using owner_t = std::pair<pybind11::object, pybind11::object>;
+        std::shared_ptr<owner_t> owner(new owner_t(image, grid), [](owner_t *o) {
+            pybind11::gil_scoped_acquire gil;
+            delete o;
+        });
+        return std::make_unique<image::SphericalImageContainer<T>>(image_data, shape_image,
+                                                                   grid_data, shape_grid,
+                                                                   owner, writable);
     }), pybind11::arg("image").noconvert().none(false),
         pybind11::arg("grid").noconvert().none(false),
+        pybind11::arg("copy") = true,
         pybind11::doc(R"EOF(
-__init__(image, grid)
+__init__(image, grid, copy=True)
 
 Parameters
 ----------
@@ -109,30 +152,130 @@ grid : :py:class:`~numpy.ndarray`
 
     * (3, N_height, N_width);
     * (3, N_points).
+copy : bool
+    If :py:obj:`True` (default), (`image`, `grid`) are copied.
+    If :py:obj:`False`, the container references (`image`, `grid`) directly and keeps them alive: both arrays must then be C-contiguous.
+    Modifying (`image`, `grid`) afterwards is reflected in the container.
 
 Notes
 -----
 It is mandatory for `image` and `grid` to have the same dtype.
 )EOF"));
 
-    obj.def_property_readonly("image", [](image::SphericalImageContainer<T> &sic) {
-        const auto& image = sic.image();
-        return cpp_py3_interop::xtensor_to_numpy(image, false);
+    obj.def_static("create_mmap", [](const std::string &file_name,
+                                     const size_t N_image,
+                                     pybind11::array_t<T> grid) {
+        const auto& grid_view = cpp_py3_interop::numpy_to_xview<T>(grid);
+        return image::SphericalImageContainer<T>::create_mapped(file_name, N_image, grid_view);
+    }, pybind11::arg("file_name").none(false),
+       pybind11::arg("N_image").none(false),
+       pybind11::arg("grid").noconvert().none(false),
+       pybind11::doc(R"EOF(
+create_mmap(file_name, N_image, grid)
+
+Create container backed by a memory-mapped file.
+
+The data cube is zero-initialized and can be filled in-place through :py:attr:`image`.
+Only pages in use are kept in memory.
+
+Parameters
+----------
+file_name : str
+    File to create. Existing files are overwritten.
+N_image : int
+    Number of images in the data cube.
+grid : :py:class:`~numpy.ndarray`
+    (3, ...) Cartesian coordinates of the sky on which the data points are defined.
+
+Returns
+-------
+I : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_floatxx`
+    (N_image, ...) writable container.
+)EOF"));
+
+    obj.def_static("from_mmap", [](const std::string &file_name,
+                                   const bool writable) {
+        return image::SphericalImageContainer<T>::open_mapped(file_name, writable);
+    }, pybind11::arg("file_name").none(false),
+       pybind11::arg("writable") = false,
+       pybind11::doc(R"EOF(
+from_mmap(file_name, writable=False)
+
+Map container previously created with :py:meth:`create_mmap`.
+
+Parameters
+----------
+file_name : str
+writable : bool
+    If :py:obj:`True`, in-place modifications to :py:attr:`image` are written back to disk.
+
+Returns
+-------
+I : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_floatxx`
+)EOF"));
+
+    obj.def("flush", [](image::SphericalImageContainer<T> &sic) {
+        sic.flush();
+    }, pybind11::doc(R"EOF(
+flush()
+
+Write memory-mapped data to disk.
+No-op for in-memory containers.
+)EOF"));
+
+    obj.def("to_fits", [](image::SphericalImageContainer<T> &sic,
+                          const std::string &file_name,
+                          const std::string &img_type) {
+        pybind11::gil_scoped_release release;
+        fits::write(file_name, sic, img_type);
+    }, pybind11::arg("file_name").none(false),
+       pybind11::arg("img_type") = std::string("SphericalImage"),
+       pybind11::doc(R"EOF(
+to_fits(file_name, img_type='SphericalImage')
+
+Save container to FITS file.
+
+Data is streamed to disk by fixed-size chunks: memory usage does not depend on the image size.
+Files can be read back with :py:func:`~pypeline.phased_array.util.io.image.from_fits`.
+
+Parameters
+----------
+file_name : str
+    Name of file.
+img_type : str
+    :py:class:`~pypeline.phased_array.util.io.image.SphericalImage` subclass name used to interpret the file when loaded.
+)EOF"));
+
+    obj.def_property_readonly("image", [](pybind11::object self) {
+        const auto& sic = self.cast<const image::SphericalImageContainer<T>&>();
+        return cpp_py3_interop::xtensor_to_numpy(sic.image(), self, sic.is_writable());
     }, pybind11::doc(R"EOF(
 Returns
 -------
 :py:class:`~numpy.ndarray`
     (N_image, ...) data cube.
+    The array references the container's memory: no copies are made.
 )EOF"));
 
-    obj.def_property_readonly("grid", [](image::SphericalImageContainer<T> &sic) {
-        const auto& grid = sic.grid();
-        return cpp_py3_interop::xtensor_to_numpy(grid, false);
+    obj.def_property_readonly("grid", [](pybind11::object self) {
+        const auto& sic = self.cast<const image::SphericalImageContainer<T>&>();
+        return cpp_py3_interop::xtensor_to_numpy(sic.grid(), self, sic.is_writable());
     }, pybind11::doc(R"EOF(
 Returns
 -------
 grid : :py:class:`~numpy.ndarray`
     (3, ...) Cartesian coordinates of the sky on which the data points are defined.
+    The array references the container's memory: no copies are made.
+)EOF"));
+
+    obj.def_property_readonly("file_name", [](image::SphericalImageContainer<T> &sic) {
+        const std::string& path = sic.path();
+        return (path.empty() ? pybind11::object(pybind11::none()) : pybind11::object(pybind11::str(path)));
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+file_name : str or None
+    Backing file if the container is memory-mapped, :py:obj:`None` otherwise.
 )EOF"));
 
     obj.def_property_readonly("is_gridded", [](image::SphericalImageContainer<T> &sic) {
@@ -145,10 +288,292 @@ is_gridded : bool
 )EOF"));
 }
 
+template <typename T>
+void SphericalImageArchive_bindings(pybind11::module &m,
+                                    const std::string &class_name) {
+    auto obj = pybind11::class_<archive::SphericalImageArchive<T>>(m,
+                                                                   class_name.data(),
+                                                                   R"EOF(
+Append-only archive of (N_level, ...) image planes defined on a common grid.
+
+Planes typically index time intervals or frequency channels.
+Each plane is split into (level, band) tiles stored as independent, optionally compressed, chunks:
+bands are groups of `band_size` consecutive grid rows (colatitudes), or points if the grid has shape (3, N_point).
+Tiles are decoded on demand from a memory-mapped view of the file.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.util.math.sphere import pol2cart
+   from pypeline.phased_array.util.io.image import SphericalImageContainer_float32, SphericalImageArchive_float32
+
+.. doctest::
+
+   >>> N_level, N_height, N_width = 2, 6, 7
+   >>> grid = np.stack(pol2cart(1,
+   ...                          np.linspace(0, np.pi, N_height).reshape(-1, 1),
+   ...                          np.linspace(0, 2 * np.pi, N_width).reshape(1, -1)),
+   ...                 axis=0).astype(np.float32)
+   >>> A = SphericalImageArchive_float32.create('/tmp/archive.pia', grid, N_level, band_size=4)
+
+   >>> for t in range(3):
+   ...     image = np.full((N_level, N_height, N_width), t, dtype=np.float32)
+   ...     _ = A.append(SphericalImageContainer_float32(image, grid, copy=False), tag=t)
+
+   >>> A.N_plane, A.N_band
+   (3, 2)
+   >>> A.read_tile(2, 1, 1)  # (plane, level, band)
+   array([[2., 2., 2., 2., 2., 2., 2.],
+          [2., 2., 2., 2., 2., 2., 2.]], dtype=float32)
+)EOF");
+
+    obj.def(pybind11::init([](const std::string &file_name) {
+        return std::make_unique<archive::SphericalImageArchive<T>>(file_name);
+    }), pybind11::arg("file_name").none(false),
+        pybind11::doc(R"EOF(
+__init__(file_name)
+
+Open existing archive.
+
+Parameters
+----------
+file_name : str
+)EOF"));
+
+    obj.def_static("create", [](const std::string &file_name,
+                                pybind11::array_t<T> grid,
+                                const size_t N_level,
+                                const size_t band_size,
+                                const bool compress) {
+        const auto& grid_view = cpp_py3_interop::numpy_to_xview<T>(grid);
+        return archive::SphericalImageArchive<T>::create(file_name, grid_view, N_level, band_size, compress);
+    }, pybind11::arg("file_name").none(false),
+       pybind11::arg("grid").noconvert().none(false),
+       pybind11::arg("N_level").none(false),
+       pybind11::arg("band_size") = 64,
+       pybind11::arg("compress") = true,
+       pybind11::doc(R"EOF(
+create(file_name, grid, N_level, band_size=64, compress=True)
+
+Create empty archive.
+
+Parameters
+----------
+file_name : str
+    File to create. Existing files are overwritten.
+grid : :py:class:`~numpy.ndarray`
+    (3, N_height, N_width) or (3, N_point) Cartesian coordinates of the sky.
+N_level : int
+    Number of images per plane.
+band_size : int
+    Number of grid rows (or points) per tile.
+compress : bool
+    If :py:obj:`True`, tiles are compressed losslessly when it reduces their size.
+
+Returns
+-------
+A : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageArchive_floatxx`
+)EOF"));
+
+    obj.def("append", [](archive::SphericalImageArchive<T> &A,
+                         image::SphericalImageContainer<T> &I,
+                         const double tag) {
+        pybind11::gil_scoped_release release;
+        return A.append(I, tag);
+    }, pybind11::arg("I").none(false),
+       pybind11::arg("tag") = std::numeric_limits<double>::quiet_NaN(),
+       pybind11::doc(R"EOF(
+append(I, tag=nan)
+
+Append plane to the archive.
+
+Parameters
+----------
+I : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_floatxx`
+    (N_level, ...) images defined on the archive's grid.
+tag : float
+    Label of the plane (ex: time, frequency).
+
+Returns
+-------
+plane : int
+    Index of the new plane.
+)EOF"));
+
+    obj.def("read_tile", [](archive::SphericalImageArchive<T> &A,
+                            const int plane, const int level, const int band) {
+        const size_t p = cpp_py3_interop::cpp_index_convention(A.N_plane(), plane);
+        const size_t l = cpp_py3_interop::cpp_index_convention(A.N_level(), level);
+        const size_t b = cpp_py3_interop::cpp_index_convention(A.N_band(), band);
+
+        const std::vector<size_t> shape = A.tile_shape(b);
+        pybind11::array_t<T> tile(std::vector<ssize_t>(shape.begin(), shape.end()));
+        T *out = tile.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            A.read_tile(p, l, b, out);
+        }
+        return tile;
+    }, pybind11::arg("plane").none(false),
+       pybind11::arg("level").none(false),
+       pybind11::arg("band").none(false),
+       pybind11::doc(R"EOF(
+read_tile(plane, level, band)
+
+Decode one tile.
+
+Parameters
+----------
+plane : int
+level : int
+band : int
+
+Returns
+-------
+tile : :py:class:`~numpy.ndarray`
+    (N_row_band, N_width) or (N_point_band,) samples.
+)EOF"));
+
+    obj.def("read_plane", [](archive::SphericalImageArchive<T> &A,
+                             const int plane) {
+        const size_t p = cpp_py3_interop::cpp_index_convention(A.N_plane(), plane);
+
+        pybind11::gil_scoped_release release;
+        return A.read_plane(p);
+    }, pybind11::arg("plane").none(false),
+       pybind11::doc(R"EOF(
+read_plane(plane)
+
+Decode a full plane.
+
+Parameters
+----------
+plane : int
+
+Returns
+-------
+I : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_floatxx`
+    (N_level, ...) in-memory container.
+)EOF"));
+
+    obj.def_property_readonly("grid", [](archive::SphericalImageArchive<T> &A) {
+        /*
+         * The view keeps the current mapping alive: it stays valid after
+         * append() remaps the file.
+         */
+        const std::vector<size_t> shape = A.grid_shape();
+        std::vector<ssize_t> strides(shape.size(), sizeof(T));
+        for (size_t i = shape.size() - 1; i-- > 0;) {
+            strides[i] = strides[i + 1] * shape[i + 1];
+        }
+
+        auto *mapping = new std::shared_ptr<void>(A.mapping());
+        pybind11::capsule dealloc_handle(mapping, [](void *capsule) {
+            delete reinterpret_cast<std::shared_ptr<void> *>(capsule);
+        });
+
+        auto grid = pybind11::array_t<T>(std::vector<ssize_t>(shape.begin(), shape.end()),
+                                         strides, A.grid_data(), dealloc_handle);
+        grid.attr("setflags")(pybind11::arg("write") = false);
+        return grid;
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+grid : :py:class:`~numpy.ndarray`
+    (3, ...) read-only Cartesian coordinates of the sky, referencing the archive's memory-mapped file.
+)EOF"));
+
+    obj.def_property_readonly("tags", [](archive::SphericalImageArchive<T> &A) {
+        const std::vector<double>& tags = A.tags();
+        return pybind11::array_t<double>(tags.size(), tags.data());
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+tags : :py:class:`~numpy.ndarray`
+    (N_plane,) labels of each plane.
+)EOF"));
+
+    obj.def_property_readonly("N_plane", &archive::SphericalImageArchive<T>::N_plane);
+    obj.def_property_readonly("N_level", &archive::SphericalImageArchive<T>::N_level);
+    obj.def_property_readonly("N_band", &archive::SphericalImageArchive<T>::N_band);
+    obj.def_property_readonly("band_size", &archive::SphericalImageArchive<T>::band_size);
+    obj.def_property_readonly("is_gridded", &archive::SphericalImageArchive<T>::is_gridded);
+    obj.def_property_readonly("file_name", &archive::SphericalImageArchive<T>::path);
+}
+
+void archive_bindings(pybind11::module &m) {
+    m.def("open_archive", [](const std::string &file_name) {
+        if (archive::itemsize(file_name) == sizeof(float)) {
+            return pybind11::cast(archive::SphericalImageArchive<float>(file_name));
+        } else {
+            return pybind11::cast(archive::SphericalImageArchive<double>(file_name));
+        }
+    }, pybind11::arg("file_name").none(false),
+       pybind11::doc(R"EOF(
+open_archive(file_name)
+
+Open existing archive with the precision it was created with.
+
+Parameters
+----------
+file_name : str
+
+Returns
+-------
+A : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageArchive_floatxx`
+)EOF"));
+}
+
+void fits_bindings(pybind11::module &m) {
+    m.def("from_fits", [](const std::string &file_name,
+                          pybind11::list native_types) {
+        const auto hdus = fits::scan(file_name);
+        const std::string img_type = hdus.first.get("IMG_TYPE");
+        const bool is_native = std::any_of(native_types.begin(), native_types.end(), [&img_type](pybind11::handle t) {
+            return t.cast<std::string>() == img_type;
+        });
+        if (!is_native) {
+            return pybind11::make_tuple(img_type, pybind11::none());
+        }
+
+        auto I = fits::read<double>(file_name, hdus);
+        return pybind11::make_tuple(img_type, pybind11::cast(std::move(I)));
+    }, pybind11::arg("file_name").none(false),
+       pybind11::arg("native_types").none(false),
+       pybind11::doc(R"EOF(
+from_fits(file_name, native_types)
+
+Load container from FITS file.
+
+The file's headers are parsed once.
+
+Parameters
+----------
+file_name : str
+    Name of file.
+native_types : list(str)
+    :py:class:`~pypeline.phased_array.util.io.image.SphericalImage` subclass names whose data can be loaded natively.
+
+Returns
+-------
+img_type : str
+    :py:class:`~pypeline.phased_array.util.io.image.SphericalImage` subclass name stored in the primary header.
+I : :py:class:`~pypeline.phased_array.util.io.image.SphericalImageContainer_float64`
+    Data of the file, or None if `img_type` is not in `native_types`.
+)EOF"));
+}
+
 PYBIND11_MODULE(_pypeline_phased_array_util_io_image_pybind11, m) {
     pybind11::options options;
     options.disable_function_signatures();
 
     SphericalImageContainer_bindings<float>(m, "SphericalImageContainer_float32");
     SphericalImageContainer_bindings<double>(m, "SphericalImageContainer_float64");
+    fits_bindings(m);
+
+    SphericalImageArchive_bindings<float>(m, "SphericalImageArchive_float32");
+    SphericalImageArchive_bindings<double>(m, "SphericalImageArchive_float64");
+    archive_bindings(m);
 }
@@ -0,0 +1,23 @@
+# #############################################################################
+# __init__.py
+# ===========
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+Measurement Set (MS) readers and tools.
+"""
+
+import _pypeline_phased_array_util_io_ms_pybind11 as __cpp
+
+from . import _ms as __py
+
+filter_data = __py.filter_data
+MeasurementSet = __py.MeasurementSet
+LofarMeasurementSet = __py.LofarMeasurementSet
+MwaMeasurementSet = __py.MwaMeasurementSet
+VisibilityCache = __py.VisibilityCache
+
+open_cache = __cpp.open_cache
+VisibilityCache_float32 = __cpp.VisibilityCache_float32
+VisibilityCache_float64 = __cpp.VisibilityCache_float64
@@ -1,6 +1,6 @@
 # #############################################################################
-# ms.py
-# =====
+# _ms.py
+# ======
 # Author : Sepand KASHANI [sep@zurich.ibm.com]
 # #############################################################################
 
@@ -18,6 +18,7 @@ import numpy as np
 import pandas as pd
 import scipy.sparse as sparse
 
+import _pypeline_phased_array_util_io_ms_pybind11 as ms_cpp
 import pypeline.phased_array.beamforming as beamforming
 import pypeline.phased_array.instrument as instrument
 import pypeline.phased_array.util.data_gen.visibility as vis
@@ -328,6 +329,67 @@ class MeasurementSet:
                 visibility = vis.VisibilityMatrix(v, beam_idx)
                 yield t_idx, f_idx, visibility
 
+    @chk.check(dict(file_name=chk.is_instance(str),
+                    column=chk.is_instance(str),
+                    double_precision=chk.is_boolean))
+    def to_cache(self, file_name, column, double_precision=False):
+        """
+        Convert visibilities to a memory-mapped cache.
+
+        The MAIN table is traversed once: every (time, channel) visibility matrix of the beams returned by :py:attr:`~pypeline.phased_array.util.io.ms.MeasurementSet.instrument` is stored densely on disk, together with flag bitmaps.
+        Subsequent imaging passes should read from the cache instead of the MS file.
+
+        Parameters
+        ----------
+        file_name : str
+            Cache file to create. Existing files are overwritten.
+        column : str
+            Column name from MAIN table where visibility data resides.
+        double_precision : bool
+            Store visibilities as complex128 instead of complex64.
+
+        Returns
+        -------
+        :py:class:`~pypeline.phased_array.util.io.ms.VisibilityCache`
+            Cache of all visibilities in the MS file.
+        """
+        if column not in ct.taql(f'select * from {self._msf}').colnames():
+            raise ValueError(f'column={column} does not exist '
+                             f'in {self._msf}::MAIN.')
+
+        beam_id = np.unique(self.instrument
+                            ._layout
+                            .index
+                            .get_level_values('STATION_ID'))
+        cache_cls = (ms_cpp.VisibilityCache_float64 if double_precision
+                     else ms_cpp.VisibilityCache_float32)
+        dtype = np.complex128 if double_precision else np.complex64
+        cache = cache_cls.create(file_name,
+                                 self.time.mjd,
+                                 self.channels,
+                                 beam_id.astype(np.int64))
+
+        # See visibilities() for why all columns are queried.
+        table = ct.taql(f'select * from {self._msf}')
+        for t_idx, sub_table in enumerate(table.iter('TIME', sort=True)):
+            beam_id_0 = sub_table.getcol('ANTENNA1')  # (N_entry,)
+            beam_id_1 = sub_table.getcol('ANTENNA2')  # (N_entry,)
+            data_flag = sub_table.getcol('FLAG')  # (N_entry, N_channel, 4)
+            data = sub_table.getcol(column)  # (N_entry, N_channel, 4)
+
+            # We only want XX and YY correlations
+            data = np.average(data[:, :, [0, 3]], axis=2)
+            data_flag = np.any(data_flag[:, :, [0, 3]], axis=2)
+
+            cache.write(t_idx,
+                        beam_id_0.astype(np.int64),
+                        beam_id_1.astype(np.int64),
+                        np.require(data, dtype, 'C'),
+                        np.require(data_flag, bool, 'C'))
+        cache.flush()
+
+        return VisibilityCache(file_name)
+
 
 def _series2array(visibility: pd.Series) -> np.ndarray:
     b_idx_0 = visibility.index.get_level_values('B_0').to_series()
@@ -354,6 +416,123 @@ def _series2array(visibility: pd.Series) -> np.ndarray:
     return S
 
 
+class VisibilityCache:
+    """
+    Memory-mapped visibility cache.
+
+    Caches are created with :py:meth:`~pypeline.phased_array.util.io.ms.MeasurementSet.to_cache` and store a dense (N_time, N_channel, N_beam * (N_beam + 1) / 2) array of upper-triangular visibilities.
+    Visibility matrices are gathered straight from the page cache: no table queries or DataFrame manipulations are involved.
+
+    Examples
+    --------
+    .. testsetup::
+
+       from pypeline.phased_array.util.io.ms import LofarMeasurementSet, VisibilityCache
+
+    .. doctest::
+
+       >>> ms = LofarMeasurementSet('/path/to/file.ms', N_station=24)
+       >>> _ = ms.to_cache('/tmp/file.pvc', column='DATA')  # once
+
+       >>> cache = VisibilityCache('/tmp/file.pvc')
+       >>> for t, f, S in cache.visibilities(channel_id=4, time_id=slice(0, None, 100)):
+       ...     pass  # S.data has shape (24, 24)
+    """
+
+    @chk.check('file_name', chk.is_instance(str))
+    def __init__(self, file_name):
+        """
+        Parameters
+        ----------
+        file_name : str
+            Name of the cache file.
+        """
+        self._cache = ms_cpp.open_cache(file_name)
+
+    @property
+    def time(self):
+        """
+        Visibility acquisition times.
+
+        Returns
+        -------
+        :py:class:`~astropy.time.Time`
+            (N_time,) observation times.
+        """
+        return time.Time(self._cache.time, format='mjd', scale='utc')
+
+    @property
+    def channels(self):
+        """
+        Frequency channels available.
+
+        Returns
+        -------
+        :py:class:`~numpy.ndarray`
+            (N_channel,) frequencies given in [Hz].
+        """
+        return self._cache.channels
+
+    @property
+    def beam_idx(self):
+        """
+        Returns
+        -------
+        :py:class:`~pandas.Index`
+            (N_beam,) beam identifiers, in visibility matrix order.
+        """
+        return pd.Index(self._cache.beam_id, name='BEAM_ID')
+
+    @chk.check(dict(channel_id=chk.accept_any(chk.is_integer,
+                                              chk.is_instance(slice)),
+                    time_id=chk.accept_any(chk.is_integer,
+                                           chk.is_instance(slice)),
+                    beam_id=chk.allow_None(chk.has_integers)))
+    def visibilities(self, channel_id, time_id, beam_id=None):
+        """
+        Extract visibility matrices.
+
+        Parameters
+        ----------
+        channel_id : int or slice
+            Indices of channels from :py:attr:`~pypeline.phased_array.util.io.ms.VisibilityCache.channels`.
+        time_id : int or slice
+            Indices of observation times from :py:attr:`~pypeline.phased_array.util.io.ms.VisibilityCache.time`.
+        beam_id : array-like(int)
+            (N_beam_sel,) beams to extract. (Default = all)
+
+        Returns
+        -------
+        iterable
+
+            Generator object returning (t_idx, freq_idx, S) triplets with:
+
+            * t_idx (int): index such that ``self.time[t_idx]`` gives the moment the visibility was formed;
+            * f_idx (int): index such that ``self.channels[f_idx]`` gives the center frequency of the visibility;
+            * S (:py:class:`~pypeline.phased_array.util.data_gen.visibility.VisibilityMatrix`)
+        """
+        if chk.is_integer(channel_id):
+            channel_id = slice(channel_id, channel_id + 1, 1)
+        channel_id = np.arange(self._cache.N_channel)[channel_id]
+
+        if chk.is_integer(time_id):
+            time_id = slice(time_id, time_id + 1, 1)
+        time_idx = np.arange(self._cache.N_time)[time_id]
+
+        if beam_id is None:
+            beam_idx = self.beam_idx
+            beam_id = []
+        else:
+            beam_id = np.array(beam_id, dtype=np.int64)
+            beam_idx = pd.Index(beam_id, name='BEAM_ID')
+
+        for t_idx in time_idx:
+            for f_idx in channel_id:
+                v = self._cache.visibility(t_idx, f_idx, beam_id)
+                visibility = vis.VisibilityMatrix(v, beam_idx)
+                yield t_idx, f_idx, visibility
+
+
 class LofarMeasurementSet(MeasurementSet):
     """
     LOw-Frequency ARray (LOFAR) Measurement Set reader.
@@ -0,0 +1,329 @@
+// ############################################################################
+// _ms_pybind11.cpp
+// ================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/numpy.h"
+#include "pybind11/stl.h"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/io/ms.hpp"
+#include "pypeline/util/cpp_py3_interop.hpp"
+
+namespace cpp_py3_interop = pypeline::util::cpp_py3_interop;
+namespace ms = pypeline::phased_array::util::io::ms;
+
+/*
+ * Read-only numpy view of `N` elements at `ptr`, keeping the cache's file mapping alive.
+ */
+template <typename T>
+pybind11::array_t<T> mapped_view(const std::shared_ptr<void> &mapping,
+                                 const T *ptr,
+                                 const size_t N) {
+    auto *handle = new std::shared_ptr<void>(mapping);
+    pybind11::capsule dealloc_handle(handle, [](void *capsule) {
+        delete reinterpret_cast<std::shared_ptr<void> *>(capsule);
+    });
+
+    auto view = pybind11::array_t<T>({static_cast<ssize_t>(N)}, {static_cast<ssize_t>(sizeof(T))},
+                                     ptr, dealloc_handle);
+    view.attr("setflags")(pybind11::arg("write") = false);
+    return view;
+}
+
+template <typename TT>
+void VisibilityCache_bindings(pybind11::module &m,
+                              const std::string &class_name) {
+    using cTT = std::complex<TT>;
+
+    auto obj = pybind11::class_<ms::VisibilityCache<TT>>(m,
+                                                         class_name.data(),
+                                                         R"EOF(
+Dense, memory-mapped cache of visibilities.
+
+Visibilities of N_beam beams are stored as a (N_time, N_channel, N_pair) array, where N_pair = N_beam * (N_beam + 1) / 2 enumerates the upper-triangular beam pairs (i <= j) in row-major order.
+Each (time, channel) slab has a bitmap marking flagged or missing pairs: these visibilities are stored as 0.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.phased_array.util.io.ms import VisibilityCache_float32
+
+.. doctest::
+
+   >>> beam_id = np.array([3, 1, 7], dtype=np.int64)
+   >>> C = VisibilityCache_float32.create('/tmp/obs.pvc', time=np.arange(2.0), channels=np.array([1e8]), beam_id=beam_id)
+
+   >>> C.write(0,
+   ...         beam_1=np.array([3, 1, 7, 3], dtype=np.int64),
+   ...         beam_2=np.array([1, 7, 7, 3], dtype=np.int64),
+   ...         data=np.array([[1j], [2], [3], [4]], dtype=np.complex64),
+   ...         flag=np.array([[False], [False], [False], [True]]))
+   >>> C.flush()
+
+   >>> C.visibility(0, 0)
+   array([[0.+0.j, 0.+1.j, 0.+0.j],
+          [0.-1.j, 0.+0.j, 2.+0.j],
+          [0.+0.j, 2.+0.j, 3.+0.j]], dtype=complex64)
+   >>> C.visibility(0, 0, beam_id=[7, 1])
+   array([[3.+0.j, 2.+0.j],
+          [2.+0.j, 0.+0.j]], dtype=complex64)
+)EOF");
+
+    obj.def(pybind11::init([](const std::string &file_name,
+                              const bool writable) {
+        return std::make_unique<ms::VisibilityCache<TT>>(file_name, writable);
+    }), pybind11::arg("file_name").none(false),
+        pybind11::arg("writable") = false,
+        pybind11::doc(R"EOF(
+__init__(file_name, writable=False)
+
+Open existing cache.
+
+Parameters
+----------
+file_name : str
+writable : bool
+    If :py:obj:`True`, the cache can be modified with :py:meth:`write`.
+)EOF"));
+
+    obj.def_static("create", [](const std::string &file_name,
+                                const std::vector<double> &time,
+                                const std::vector<double> &channels,
+                                const std::vector<int64_t> &beam_id) {
+        return ms::VisibilityCache<TT>::create(file_name, time, channels, beam_id);
+    }, pybind11::arg("file_name").none(false),
+       pybind11::arg("time").none(false),
+       pybind11::arg("channels").none(false),
+       pybind11::arg("beam_id").none(false),
+       pybind11::doc(R"EOF(
+create(file_name, time, channels, beam_id)
+
+Create empty cache. All visibilities are initially 0 and flagged.
+
+Parameters
+----------
+file_name : str
+    File to create. Existing files are overwritten.
+time : :py:class:`~numpy.ndarray`
+    (N_time,) observation times [MJD].
+channels : :py:class:`~numpy.ndarray`
+    (N_channel,) channel center frequencies [Hz].
+beam_id : :py:class:`~numpy.ndarray`
+    (N_beam,) distinct beam identifiers, in visibility matrix order.
+
+Returns
+-------
+C : :py:class:`~pypeline.phased_array.util.io.ms.VisibilityCache_floatxx`
+    Writable cache.
+)EOF"));
+
+    obj.def("write", [](ms::VisibilityCache<TT> &C,
+                        const int time,
+                        pybind11::array_t<int64_t, pybind11::array::c_style> beam_1,
+                        pybind11::array_t<int64_t, pybind11::array::c_style> beam_2,
+                        pybind11::array_t<cTT, pybind11::array::c_style> data,
+                        pybind11::array_t<bool, pybind11::array::c_style> flag) {
+        const size_t t = cpp_py3_interop::cpp_index_convention(C.N_time(), time);
+        const size_t N_entry = beam_1.size();
+        if ((beam_2.size() != static_cast<ssize_t>(N_entry)) ||
+            (data.ndim() != 2) || (data.shape(0) != static_cast<ssize_t>(N_entry)) ||
+            (data.shape(1) != static_cast<ssize_t>(C.N_channel())) ||
+            (flag.ndim() != 2) || (flag.shape(0) != data.shape(0)) || (flag.shape(1) != data.shape(1))) {
+            std::string msg = "Parameters[beam_1, beam_2, data, flag] must have shapes (N_entry,), (N_entry,), (N_entry, N_channel), (N_entry, N_channel).";
+            throw std::runtime_error(msg);
+        }
+
+        pybind11::gil_scoped_release release;
+        C.write(t, N_entry, beam_1.data(), beam_2.data(), data.data(), flag.data());
+    }, pybind11::arg("time").none(false),
+       pybind11::arg("beam_1").noconvert().none(false),
+       pybind11::arg("beam_2").noconvert().none(false),
+       pybind11::arg("data").noconvert().none(false),
+       pybind11::arg("flag").noconvert().none(false),
+       pybind11::doc(R"EOF(
+write(time, beam_1, beam_2, data, flag)
+
+Store the visibilities of one time slot.
+
+Rows referencing beams outside the cache are ignored.
+Rows with (beam_1 > beam_2) are stored conjugated at (beam_2, beam_1).
+Flagged visibilities are stored as 0.
+
+Parameters
+----------
+time : int
+    Time index.
+beam_1 : :py:class:`~numpy.ndarray`
+    (N_entry,) int64 first beam identifier of each row.
+beam_2 : :py:class:`~numpy.ndarray`
+    (N_entry,) int64 second beam identifier of each row.
+data : :py:class:`~numpy.ndarray`
+    (N_entry, N_channel) visibilities.
+flag : :py:class:`~numpy.ndarray`
+    (N_entry, N_channel) boolean flags.
+)EOF"));
+
+    obj.def("flush", &ms::VisibilityCache<TT>::flush,
+            pybind11::doc(R"EOF(
+flush()
+
+Synchronously write pending changes to disk.
+)EOF"));
+
+    obj.def("visibility", [](const ms::VisibilityCache<TT> &C,
+                             const int time,
+                             const int channel,
+                             const std::vector<int64_t> &beam_id) {
+        const size_t t = cpp_py3_interop::cpp_index_convention(C.N_time(), time);
+        const size_t c = cpp_py3_interop::cpp_index_convention(C.N_channel(), channel);
+
+        pybind11::gil_scoped_release release;
+        return C.visibility(t, c, beam_id);
+    }, pybind11::arg("time").none(false),
+       pybind11::arg("channel").none(false),
+       pybind11::arg("beam_id") = std::vector<int64_t>(),
+       pybind11::doc(R"EOF(
+visibility(time, channel, beam_id=[])
+
+Gather a visibility matrix.
+
+Parameters
+----------
+time : int
+channel : int
+beam_id : array-like(int)
+    (N_beam_sel,) beams to extract, in output order.
+    If empty, all beams are extracted in cache order.
+
+Returns
+-------
+S : :py:class:`~numpy.ndarray`
+    (N_beam_sel, N_beam_sel) Hermitian visibility matrix.
+)EOF"));
+
+    obj.def("data", [](const ms::VisibilityCache<TT> &C,
+                       const int time,
+                       const int channel) {
+        const size_t t = cpp_py3_interop::cpp_index_convention(C.N_time(), time);
+        const size_t c = cpp_py3_interop::cpp_index_convention(C.N_channel(), channel);
+        return mapped_view<cTT>(C.mapping(), C.data(t, c), C.N_pair());
+    }, pybind11::arg("time").none(false),
+       pybind11::arg("channel").none(false),
+       pybind11::doc(R"EOF(
+data(time, channel)
+
+Parameters
+----------
+time : int
+channel : int
+
+Returns
+-------
+data : :py:class:`~numpy.ndarray`
+    (N_pair,) read-only upper-triangular visibilities, referencing the cache's memory-mapped file.
+)EOF"));
+
+    obj.def("flag", [](const ms::VisibilityCache<TT> &C,
+                       const int time,
+                       const int channel) {
+        const size_t t = cpp_py3_interop::cpp_index_convention(C.N_time(), time);
+        const size_t c = cpp_py3_interop::cpp_index_convention(C.N_channel(), channel);
+        return mapped_view<uint64_t>(C.mapping(), C.flag(t, c), C.N_word());
+    }, pybind11::arg("time").none(false),
+       pybind11::arg("channel").none(false),
+       pybind11::doc(R"EOF(
+flag(time, channel)
+
+Parameters
+----------
+time : int
+channel : int
+
+Returns
+-------
+flag : :py:class:`~numpy.ndarray`
+    (N_word,) read-only uint64 bitmap, referencing the cache's memory-mapped file.
+    Bit (p % 64) of word (p // 64) is set if pair p is flagged or missing.
+)EOF"));
+
+    obj.def_property_readonly("time", [](const ms::VisibilityCache<TT> &C) {
+        const std::vector<double>& time = C.time();
+        return pybind11::array_t<double>(time.size(), time.data());
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+time : :py:class:`~numpy.ndarray`
+    (N_time,) observation times [MJD].
+)EOF"));
+
+    obj.def_property_readonly("channels", [](const ms::VisibilityCache<TT> &C) {
+        const std::vector<double>& channels = C.channel();
+        return pybind11::array_t<double>(channels.size(), channels.data());
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+channels : :py:class:`~numpy.ndarray`
+    (N_channel,) channel center frequencies [Hz].
+)EOF"));
+
+    obj.def_property_readonly("beam_id", [](const ms::VisibilityCache<TT> &C) {
+        const std::vector<int64_t>& beam_id = C.beam_id();
+        return pybind11::array_t<int64_t>(beam_id.size(), beam_id.data());
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+beam_id : :py:class:`~numpy.ndarray`
+    (N_beam,) beam identifiers, in visibility matrix order.
+)EOF"));
+
+    obj.def_property_readonly("N_time", &ms::VisibilityCache<TT>::N_time);
+    obj.def_property_readonly("N_channel", &ms::VisibilityCache<TT>::N_channel);
+    obj.def_property_readonly("N_beam", &ms::VisibilityCache<TT>::N_beam);
+    obj.def_property_readonly("N_pair", &ms::VisibilityCache<TT>::N_pair);
+    obj.def_property_readonly("file_name", &ms::VisibilityCache<TT>::path);
+}
+
+void cache_bindings(pybind11::module &m) {
+    m.def("open_cache", [](const std::string &file_name) {
+        if (ms::itemsize(file_name) == sizeof(float)) {
+            return pybind11::cast(ms::VisibilityCache<float>(file_name));
+        } else {
+            return pybind11::cast(ms::VisibilityCache<double>(file_name));
+        }
+    }, pybind11::arg("file_name").none(false),
+       pybind11::doc(R"EOF(
+open_cache(file_name)
+
+Open existing cache read-only, with the precision it was created with.
+
+Parameters
+----------
+file_name : str
+
+Returns
+-------
+C : :py:class:`~pypeline.phased_array.util.io.ms.VisibilityCache_floatxx`
+)EOF"));
+}
+
+PYBIND11_MODULE(_pypeline_phased_array_util_io_ms_pybind11, m) {
+    pybind11::options options;
+    options.disable_function_signatures();
+
+    VisibilityCache_bindings<float>(m, "VisibilityCache_float32");
+    VisibilityCache_bindings<double>(m, "VisibilityCache_float64");
+    cache_bindings(m);
+}
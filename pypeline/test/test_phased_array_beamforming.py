@@ -0,0 +1,129 @@
+# #############################################################################
+# test_phased_array_beamforming.py
+# ================================
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+import astropy.coordinates as coord
+import astropy.units as u
+import numpy as np
+import pandas as pd
+import pytest
+import scipy.sparse as sparse
+
+import pypeline
+import pypeline.phased_array.beamforming as beamforming
+import pypeline.phased_array.instrument as instrument
+
+N_station, N_antenna_per_station = 24, 3
+
+
+def _geometry(shuffle):
+    """
+    (N_station * N_antenna_per_station, 3) geometry, optionally not sorted by (STATION_ID, ANTENNA_ID).
+    """
+    rng = np.random.RandomState(0)
+    ant_idx = pd.MultiIndex.from_product([range(N_station), range(N_antenna_per_station)],
+                                         names=['STATION_ID', 'ANTENNA_ID'])
+    xyz = 1e3 * rng.randn(len(ant_idx), 3)
+    if shuffle:
+        order = rng.permutation(len(ant_idx))
+        ant_idx, xyz = ant_idx[order], xyz[order]
+    return instrument.InstrumentGeometry(xyz, ant_idx)
+
+
+def _beam_config():
+    """
+    One beam per station, except for the last station which is not beamformed.
+    Beams are declared in decreasing BEAM_ID order.
+    """
+    rng = np.random.RandomState(1)
+    cfg = []
+    for s_id in reversed(range(N_station - 1)):
+        focus = coord.SkyCoord(rng.uniform(0, 360) * u.deg, rng.uniform(-90, 90) * u.deg, frame='icrs')
+        cfg.append((s_id, 2 * s_id + 1, focus))
+    return cfg
+
+
+def _reference(beam_config, XYZ, wl):
+    """
+    pandas implementation of :py:meth:`~pypeline.phased_array.beamforming.MatchedBeamformerBlock.__call__`.
+
+    Returns (W, ant_idx, beam_idx), with W dense.
+    """
+    config = pd.DataFrame([(s_id, b_id, *f.cartesian.xyz.value) for (s_id, b_id, f) in beam_config],
+                          columns=['STATION_ID', 'BEAM_ID', 'F_X', 'F_Y', 'F_Z'])
+
+    xyz = XYZ.as_frame()
+    xyz = (xyz - xyz.mean()) / wl
+    data = pd.merge(xyz.reset_index(), config, on='STATION_ID')
+    F_XYZ = data.loc[:, ['F_X', 'F_Y', 'F_Z']].values
+    similarity = np.sum(data.loc[:, ['X', 'Y', 'Z']].values * F_XYZ, axis=1)
+    data = data.assign(W=np.exp((-1j * 2 * np.pi) * similarity))
+
+    row_map = (data
+               .loc[:, ['STATION_ID', 'ANTENNA_ID']]
+               .drop_duplicates()
+               .sort_values(['STATION_ID', 'ANTENNA_ID'])
+               .assign(ROW_ID=lambda df: np.arange(len(df))))
+    col_map = (data
+               .loc[:, ['BEAM_ID']]
+               .drop_duplicates()
+               .sort_values('BEAM_ID')
+               .assign(COL_ID=lambda df: np.arange(len(df))))
+    data = (data
+            .merge(row_map, on=['STATION_ID', 'ANTENNA_ID'])
+            .merge(col_map, on='BEAM_ID'))
+
+    W = np.zeros((len(row_map), len(col_map)), dtype=complex)
+    W[data.ROW_ID.values, data.COL_ID.values] = data.W.values
+    ant_idx = pd.MultiIndex.from_arrays([row_map.STATION_ID, row_map.ANTENNA_ID],
+                                        names=['STATION_ID', 'ANTENNA_ID'])
+    beam_idx = pd.Index(col_map.BEAM_ID, name='BEAM_ID')
+    return W, ant_idx, beam_idx
+
+
+class TestMatchedBeamformerBlock:
+    """
+    Test :py:class:`~pypeline.phased_array.beamforming.MatchedBeamformerBlock` against the pandas implementation.
+    """
+
+    @pytest.mark.parametrize('shuffle', [False, True])
+    def test_matches_pandas(self, shuffle):
+        beam_config = _beam_config()
+        XYZ = _geometry(shuffle)
+        mb = beamforming.MatchedBeamformerBlock(beam_config)
+
+        # Repeated calls on the same layout re-use the sparsity pattern and row order.
+        for wl in [2.0, 3.5]:
+            W = mb(XYZ, wl)
+            W_ref, ant_idx_ref, beam_idx_ref = _reference(beam_config, XYZ, wl)
+
+            assert W.index[0].equals(ant_idx_ref)
+            assert W.index[1].equals(beam_idx_ref)
+            assert sparse.isspmatrix_csr(W.data)
+            assert W.data.nnz == np.count_nonzero(W_ref)
+            assert np.allclose(W.data.toarray(), W_ref)
+
+    def test_layout_change(self):
+        beam_config = _beam_config()
+        mb = beamforming.MatchedBeamformerBlock(beam_config)
+        mb(_geometry(False), 2.0)
+
+        XYZ = _geometry(True)
+        W = mb(XYZ, 2.0)
+        W_ref, ant_idx_ref, _ = _reference(beam_config, XYZ, 2.0)
+        assert W.index[0].equals(ant_idx_ref)
+        assert np.allclose(W.data.toarray(), W_ref)
+
+    def test_dense_fallback(self, monkeypatch):
+        monkeypatch.setitem(pypeline.config['phased_array.beamforming'], 'bw_max_sparsity_ratio', '0')
+
+        beam_config = _beam_config()
+        XYZ = _geometry(True)
+        W = beamforming.MatchedBeamformerBlock(beam_config)(XYZ, 2.0)
+        W_ref, ant_idx_ref, _ = _reference(beam_config, XYZ, 2.0)
+
+        assert isinstance(W.data, np.ndarray)
+        assert W.index[0].equals(ant_idx_ref)
+        assert np.allclose(W.data, W_ref)
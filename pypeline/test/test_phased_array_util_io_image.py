@@ -0,0 +1,54 @@
+# #############################################################################
+# test_phased_array_util_io_image.py
+# ==================================
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+import numpy as np
+
+import pypeline.phased_array.util.io.image as image
+
+
+def _container(dtype):
+    N_height, N_width = 4, 5
+    colat = np.linspace(0.1, 0.9, N_height).reshape(-1, 1) * np.pi
+    lon = np.linspace(0, 1.5, N_width).reshape(1, -1) * np.pi
+    grid = np.stack([np.sin(colat) * np.cos(lon),
+                     np.sin(colat) * np.sin(lon),
+                     np.cos(colat) * np.ones_like(lon)], axis=0).astype(dtype)
+    data = np.arange(2 * N_height * N_width, dtype=dtype).reshape(2, N_height, N_width)
+
+    if dtype == np.float32:
+        return image.SphericalImageContainer_float32(data, grid)
+    return image.SphericalImageContainer_float64(data, grid)
+
+
+class TestFromFits:
+    """
+    Test :py:func:`~pypeline.phased_array.util.io.image.from_fits`.
+    """
+
+    def test_float32_loads_as_float64(self, tmpdir):
+        """
+        BITPIX=-32 files are returned in double precision, as with astropy.
+        """
+        I = image.SphericalImage(_container(np.float32))
+        file_name = str(tmpdir.join('img.fits'))
+        I.to_fits(file_name)
+
+        J = image.from_fits(file_name)
+        assert type(J) is image.SphericalImage
+        assert J.image.dtype == np.float64
+        assert J.grid.dtype == np.float64
+        assert np.allclose(J.image, I.image)
+        assert np.allclose(J.grid, I.grid)
+
+    def test_float64_roundtrip(self, tmpdir):
+        I = image.SphericalImage(_container(np.float64))
+        file_name = str(tmpdir.join('img.fits'))
+        I.to_fits(file_name)
+
+        J = image.from_fits(file_name)
+        assert J.image.dtype == np.float64
+        assert np.array_equal(J.image, I.image)
+        assert np.array_equal(J.grid, I.grid)
@@ -0,0 +1,118 @@
+# #############################################################################
+# test_phased_array_util_io_ms.py
+# ===============================
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+import types
+
+import numpy as np
+import pandas as pd
+import pytest
+
+ct = pytest.importorskip('casacore.tables')
+
+import pypeline.phased_array.util.io.ms as ms  # noqa: E402
+
+N_station_ms, N_channel, N_time = 5, 3, 4
+station_id = np.array([4, 0, 2])  # Subset of the MS' stations, imaged in sorted order.
+
+
+class _MeasurementSet(ms.MeasurementSet):
+    """
+    Synthetic MS: only the instrument's station IDs are needed.
+    """
+
+    @property
+    def instrument(self):
+        layout = pd.DataFrame(index=pd.MultiIndex.from_arrays((np.repeat(station_id, 2),
+                                                               np.tile([0, 1], len(station_id))),
+                                                              names=('STATION_ID', 'ANTENNA_ID')))
+        return types.SimpleNamespace(_layout=layout)
+
+
+@pytest.fixture(scope='module')
+def ms_file(tmpdir_factory):
+    """
+    (N_time, N_channel) visibilities of N_station_ms stations.
+
+    * some (ANTENNA1, ANTENNA2) rows are missing;
+    * some XX/YY entries are flagged, as well as XY entries which must be ignored.
+    """
+    path = str(tmpdir_factory.mktemp('ms').join('test.ms'))
+    desc = ct.maketabdesc(ct.makearrcoldesc('DATA', 0j, ndim=2, shape=[N_channel, 4],
+                                            valuetype='complex'))
+    table = ct.default_ms(path, desc)
+
+    rng = np.random.RandomState(0)
+    i, j = np.triu_indices(N_station_ms)
+    time, a1, a2 = [], [], []
+    for t in range(N_time):
+        keep = rng.rand(len(i)) > 0.2
+        time.append(np.full(keep.sum(), (58000 + t / 1440) * 86400))
+        a1.append(i[keep])
+        a2.append(j[keep])
+    time, a1, a2 = map(np.concatenate, (time, a1, a2))
+
+    N_row = len(time)
+    data = (rng.randn(N_row, N_channel, 4) + 1j * rng.randn(N_row, N_channel, 4)).astype(np.complex64)
+    flag = rng.rand(N_row, N_channel, 4) > 0.9
+
+    table.addrows(N_row)
+    table.putcol('TIME', time)
+    table.putcol('ANTENNA1', a1.astype(np.int32))
+    table.putcol('ANTENNA2', a2.astype(np.int32))
+    table.putcol('DATA', data)
+    table.putcol('FLAG', flag)
+    table.close()
+
+    spw = ct.table(f'{path}::SPECTRAL_WINDOW', readonly=False, ack=False)
+    spw.addrows(1)
+    spw.putcell('NUM_CHAN', 0, N_channel)
+    spw.putcell('CHAN_FREQ', 0, 1.4e8 + 1e5 * np.arange(N_channel))
+    spw.putcell('CHAN_WIDTH', 0, np.full(N_channel, 1e5))
+    spw.close()
+    return path
+
+
+class TestVisibilityCache:
+    """
+    Test :py:class:`~pypeline.phased_array.util.io.ms.VisibilityCache` against :py:meth:`~pypeline.phased_array.util.io.ms.MeasurementSet.visibilities`.
+    """
+
+    @pytest.mark.parametrize('double_precision', [False, True])
+    def test_matches_measurement_set(self, ms_file, tmpdir, double_precision):
+        MS = _MeasurementSet(ms_file)
+        cache = MS.to_cache(str(tmpdir.join('test.pvc')), column='DATA',
+                            double_precision=double_precision)
+
+        assert np.allclose(cache.time.mjd, MS.time.mjd)
+        assert np.array_equal(cache.channels, MS.channels)
+        assert np.array_equal(cache.beam_idx, np.sort(station_id))
+
+        tol = 0 if double_precision else 1e-6
+        expected = list(MS.visibilities(slice(None), slice(None), 'DATA'))
+        actual = list(cache.visibilities(slice(None), slice(None)))
+        assert len(actual) == len(expected) == N_time * N_channel
+        for (t, f, S), (t_ref, f_ref, S_ref) in zip(actual, expected):
+            assert (t, f) == (t_ref, f_ref)
+            assert np.array_equal(S.index[0], S_ref.index[0])
+            assert np.allclose(S.data, S_ref.data, rtol=tol, atol=tol)
+
+    def test_slices_and_beam_subsets(self, ms_file, tmpdir):
+        MS = _MeasurementSet(ms_file)
+        cache = MS.to_cache(str(tmpdir.join('test.pvc')), column='DATA', double_precision=True)
+
+        expected = {(t, f): S for (t, f, S) in MS.visibilities(slice(1, None, 2), 2, 'DATA')}
+        actual = list(cache.visibilities(2, slice(1, None, 2)))
+        assert [(t, f) for (t, f, _) in actual] == sorted(expected.keys())
+        for (t, f, S) in actual:
+            assert np.array_equal(S.data, expected[t, f].data)
+
+        # Beams are returned in the requested order.
+        beam_id = [4, 0]
+        order = np.searchsorted(np.sort(station_id), beam_id)
+        for (t, f, S), (_, _, S_full) in zip(cache.visibilities(0, slice(None), beam_id=beam_id),
+                                             cache.visibilities(0, slice(None))):
+            assert np.array_equal(S.index[0], beam_id)
+            assert np.array_equal(S.data, S_full.data[np.ix_(order, order)])
@@ -0,0 +1,145 @@
+# #############################################################################
+# test_util_cpp_py3_interop.py
+# ============================
+# Author : Sepand KASHANI [sep@zurich.ibm.com]
+# #############################################################################
+
+"""
+dtype and stride handling of C++ bindings (cpp_py3_interop.hpp).
+"""
+
+import gc
+
+import numpy as np
+import pytest
+
+import pypeline.util.array as array
+import pypeline.util.math.fourier as fourier
+import pypeline.util.math.sphere as sphere
+
+
+def _cluster_layers(x, idx, N, axis):
+    """
+    NumPy reference of :py:func:`~pypeline.util.array.cluster_layers`.
+    """
+    x = np.moveaxis(x, axis, 0)
+    y = np.zeros((N,) + x.shape[1:], dtype=x.dtype)
+    np.add.at(y, idx, x)
+    return np.moveaxis(y, 0, axis)
+
+
+class TestDefDtypes:
+    """
+    Bindings registered once per dtype with def_dtypes().
+    """
+
+    @pytest.mark.parametrize('dtype', [np.int32, np.int64, np.uint32, np.uint64,
+                                       np.float32, np.float64, np.complex64, np.complex128])
+    def test_cluster_layers_dtype(self, dtype):
+        """
+        Every dtype is served by its own overload: no up-cast, no copy.
+        """
+        x = np.arange(5 * 3).reshape(5, 3).astype(dtype)
+        idx = [0, 0, 1, 3, 5]
+
+        y = array.cluster_layers(x, idx, N=10, axis=0)
+        assert y.dtype == dtype
+        assert np.array_equal(y, _cluster_layers(x, idx, 10, 0))
+
+    @pytest.mark.parametrize('order', ['C', 'F'])
+    def test_cluster_layers_strides(self, order):
+        """
+        Non-contiguous views are read through their strides.
+        """
+        x_full = np.arange(6 * 8 * 4, dtype=np.float64).reshape(6, 8, 4)
+        x = np.asarray(x_full, order=order)[::2, 1::3, :]
+        idx = [1, 0, 1]
+
+        y = array.cluster_layers(x, idx, N=2, axis=0)
+        assert np.array_equal(y, _cluster_layers(x, idx, 2, 0))
+
+        y = array.cluster_layers(x.T, [2, 0, 0], N=3, axis=1)
+        assert np.array_equal(y, _cluster_layers(x.T, [2, 0, 0], 3, 1))
+
+    def test_cluster_layers_reject_unsupported_dtype(self):
+        with pytest.raises(TypeError):
+            array.cluster_layers(np.zeros((3, 2), dtype=np.int8), [0, 1, 1], N=2, axis=0)
+
+    @pytest.mark.parametrize('dtype', [np.float32, np.float64])
+    def test_pol2cart_strides(self, dtype):
+        colat_full = np.linspace(0, np.pi, 20, dtype=dtype)
+        lon_full = np.linspace(-np.pi, np.pi, 20, dtype=dtype)
+        colat, lon = colat_full[::2], lon_full[::-2]
+
+        x, y, z = sphere.pol2cart(1, colat, lon)
+        tol = 1e-6 if (dtype == np.float32) else 1e-12
+        assert np.allclose(x, np.sin(colat) * np.cos(lon), atol=tol)
+        assert np.allclose(y, np.sin(colat) * np.sin(lon), atol=tol)
+        assert np.allclose(z, np.cos(colat), atol=tol)
+
+
+class TestDispatchDtype:
+    """
+    Runtime dtype dispatch of :py:meth:`~pypeline.util.math.fourier.FFTW_FS_INTERP.input`.
+    """
+
+    T, a, b, M = np.pi, 0.5, 2.5, 40
+
+    def _interp(self, x, axis):
+        transform = fourier.FFTW_FS_INTERP(x.shape, axis, self.T, self.a, self.b, self.M,
+                                           real_valued_output=False, N_threads=1,
+                                           effort=fourier.planning_effort.NONE)
+        transform.input(x)
+        transform.fs_interp()
+        return transform.output.copy()
+
+    @pytest.mark.parametrize('dtype', [np.float32, np.float64, np.complex64, np.complex128])
+    def test_dtypes(self, dtype):
+        rng = np.random.RandomState(0)
+        x = rng.randn(15) + 1j * rng.randn(15)
+        x = (x if np.iscomplexobj(np.zeros(1, dtype=dtype)) else x.real).astype(dtype)
+
+        y = self._interp(x, 0)
+        y_ref = fourier.fs_interp(x.astype(np.complex128), self.T, self.a, self.b, self.M)
+        assert np.allclose(y, y_ref)
+
+    def test_strides(self):
+        rng = np.random.RandomState(1)
+        x_full = rng.randn(30, 8) + 1j * rng.randn(30, 8)
+
+        for x in [x_full[::2, 0],                      # 1D, strided.
+                  x_full[::2, ::3],                    # 2D, strided along both axes.
+                  np.asfortranarray(x_full[:15, :])]:  # Column-major.
+            y = self._interp(x, 0)
+            y_ref = fourier.fs_interp(x, self.T, self.a, self.b, self.M, axis=0)
+            assert np.allclose(y, y_ref)
+
+    def test_reject_unsupported_dtype(self):
+        with pytest.raises(RuntimeError):
+            self._interp(np.arange(15, dtype=np.int64), 0)
+
+
+class TestBufferView:
+    """
+    Buffer-protocol access to C++ memory.
+    """
+
+    def test_fill_in_place(self):
+        transform = fourier.FFTW_FFS((16,), 0, 1, 0.5, 15, inplace=False,
+                                     N_threads=1, effort=fourier.planning_effort.NONE)
+        buffer = memoryview(transform.input_buffer)
+        assert buffer.shape == (16,)
+        assert not buffer.readonly
+
+        x = np.arange(16) * (1 + 2j)
+        np.asarray(transform.input_buffer)[:] = x
+        assert np.array_equal(transform.input, x)
+
+    def test_views_keep_owner_alive(self):
+        transform = fourier.FFTW_FFS((16,), 0, 1, 0.5, 15, inplace=False,
+                                     N_threads=1, effort=fourier.planning_effort.NONE)
+        x = transform.input
+        x[:] = np.arange(16)
+        del transform
+        gc.collect()
+        assert np.array_equal(x, np.arange(16))
@@ -16,3 +16,4 @@ LabeledMatrix = __py.LabeledMatrix
 index = __py.index
 
 cluster_layers = __cpp.cluster_layers
+cluster_layers_augment = __cpp.cluster_layers_augment
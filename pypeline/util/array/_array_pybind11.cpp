@@ -13,7 +13,6 @@
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
-#include "pypeline/types.hpp"
 #include "pypeline/util/array.hpp"
 #include "pypeline/util/cpp_py3_interop.hpp"
 
@@ -34,67 +33,34 @@ pybind11::array_t<T> _cluster_layers(pybind11::array_t<T> x,
     const auto& cpp_idx = cpp_py3_interop::cpp_index_convention(cpp_N, idx);
     const auto& cpp_axis = cpp_py3_interop::cpp_index_convention(xview.dimension(), axis);
 
-    const auto& y = array::cluster_layers(xview, cpp_idx, cpp_N, cpp_axis);
+    auto y = array::cluster_layers(xview, cpp_idx, cpp_N, cpp_axis);
     return cpp_py3_interop::xtensor_to_numpy(std::move(y));
 }
 
+template <typename T>
+void _cluster_layers_augment(pybind11::array_t<T> x,
+                             std::vector<int> idx,
+                             const int N,
+                             const int axis,
+                             pybind11::array_t<T> buffer,
+                             std::vector<T> weights) {
+    const auto& xview = cpp_py3_interop::numpy_to_xview<T>(x);
+    auto buffer_view = cpp_py3_interop::numpy_to_xview<T>(buffer);
+    if (N <= 0) {
+        std::string msg = "Parameter[N] must be positive.";
+        throw std::runtime_error(msg);
+    }
+    size_t cpp_N = N;
+    const auto& cpp_idx = cpp_py3_interop::cpp_index_convention(cpp_N, idx);
+    const auto& cpp_axis = cpp_py3_interop::cpp_index_convention(xview.dimension(), axis);
+
+    array::cluster_layers_augment(xview, cpp_idx, cpp_N, cpp_axis, &buffer_view, weights);
+}
+
 void cluster_layers_bindings(pybind11::module &m) {
-    m.def("cluster_layers",
-          &_cluster_layers<int32_t>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<int64_t>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<uint32_t>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<uint64_t>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<float>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<double>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<cfloat_t>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false));
-
-    m.def("cluster_layers",
-          &_cluster_layers<cdouble_t>,
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("idx").none(false),
-          pybind11::arg("N").none(false),
-          pybind11::arg("axis").none(false),
-          pybind11::doc(R"EOF(
+    cpp_py3_interop::def_dtypes(m, "cluster_layers", cpp_py3_interop::all_dtypes(),
+                                [](auto tag) { return &_cluster_layers<typename decltype(tag)::type>; },
+                                R"EOF(
 cluster_layers(x, idx, N, axis)
 
 Additive tensor compression along an axis.
@@ -139,7 +105,70 @@ Examples
           [ 0,  0,  0],
           [ 0,  0,  0]], dtype=int64)
 
-)EOF"));
+)EOF",
+                                pybind11::arg("x").noconvert().none(false),
+                                pybind11::arg("idx").none(false),
+                                pybind11::arg("N").none(false),
+                                pybind11::arg("axis").none(false));
+}
+
+void cluster_layers_augment_bindings(pybind11::module &m) {
+    cpp_py3_interop::def_dtypes(m, "cluster_layers_augment", cpp_py3_interop::all_dtypes(),
+                                [](auto tag) { return &_cluster_layers_augment<typename decltype(tag)::type>; },
+                                R"EOF(
+cluster_layers_augment(x, idx, N, axis, buffer, weights=None)
+
+In-place additive tensor compression along an axis.
+
+Parameters
+----------
+x : :py:class:`~numpy.ndarray`
+    (..., K, ...) array.
+idx : array-like(int)
+    (K,) cluster indices.
+N : int
+    Total number of levels along compression axis.
+axis : int
+    Dimension along which to compress.
+buffer : :py:class:`~numpy.ndarray`
+    (..., N, ...) array to increment in-place.
+
+    `buffer` must have the same dtype as `x`.
+weights : array-like
+    (K,) per-layer weights applied to `x` before compression.
+    (Default: no scaling.)
+
+Notes
+-----
+Compression is multi-threaded and allocation-free when `x` and `buffer` are C-contiguous.
+This is the preferred way to integrate statistics into a persistent buffer.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.util.array import cluster_layers_augment
+
+.. doctest::
+
+   >>> A = np.arange(5*3, dtype=np.float64).reshape(5, 3)
+   >>> B = np.zeros((3, 3))
+   >>> cluster_layers_augment(A, [0, 0, 1, 1, 2], N=3, axis=0, buffer=B)
+   >>> cluster_layers_augment(A, [0, 0, 1, 1, 2], N=3, axis=0, buffer=B,
+   ...                        weights=[1, 1, 0, 0, 0])
+
+   >>> B
+   array([[ 6., 10., 14.],
+          [15., 17., 19.],
+          [12., 13., 14.]])
+)EOF",
+                                pybind11::arg("x").noconvert().none(false),
+                                pybind11::arg("idx").none(false),
+                                pybind11::arg("N").none(false),
+                                pybind11::arg("axis").none(false),
+                                pybind11::arg("buffer").noconvert().none(false),
+                                pybind11::arg("weights") = pybind11::list());
 }
 
 PYBIND11_MODULE(_pypeline_util_array_pybind11, m) {
@@ -147,4 +176,5 @@ PYBIND11_MODULE(_pypeline_util_array_pybind11, m) {
     options.disable_function_signatures();
 
     cluster_layers_bindings(m);
+    cluster_layers_augment_bindings(m);
 }
@@ -26,3 +26,4 @@ FFTW_FFT = __cpp.FFTW_FFT
 FFTW_FFS = __cpp.FFTW_FFS
 FFTW_CZT = __cpp.FFTW_CZT
 FFTW_FS_INTERP = __cpp.FFTW_FS_INTERP
+BufferView = __cpp.BufferView
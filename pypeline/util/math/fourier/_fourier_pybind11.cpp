@@ -36,7 +36,7 @@ void ffs_sample_bindings(pybind11::module &m) {
               }
               size_t cpp_N_s = N_s;
 
-              const auto& sample_points = fourier::ffs_sample(T, cpp_N_FS, T_c, cpp_N_s);
+              auto sample_points = fourier::ffs_sample(T, cpp_N_FS, T_c, cpp_N_s);
               return cpp_py3_interop::xtensor_to_numpy(std::move(sample_points));
           },
           pybind11::arg("T").none(false),
@@ -210,8 +210,9 @@ shape : tuple(int)
     Dimensions of input/output buffers.
 )EOF"));
 
-    obj.def_property_readonly("input", [](fourier::FFTW_FFT<T> &fftw_fft) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_fft.view_in(), false);
+    obj.def_property_readonly("input", [](pybind11::object self) {
+        auto& fftw_fft = self.cast<fourier::FFTW_FFT<T>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_fft.view_in(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -219,8 +220,9 @@ input : :py:class:`~numpy.ndarray`
     T-valued complex array.
 )EOF"));
 
-    obj.def_property_readonly("output", [](fourier::FFTW_FFT<T> &fftw_fft) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_fft.view_out(), false);
+    obj.def_property_readonly("output", [](pybind11::object self) {
+        auto& fftw_fft = self.cast<fourier::FFTW_FFT<T>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_fft.view_out(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -429,8 +431,9 @@ shape : tuple(int)
     Dimensions of input/output buffers.
 )EOF"));
 
-    obj.def_property_readonly("input", [](fourier::FFTW_FFS<TT> &fftw_ffs) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_ffs.view_in(), false);
+    obj.def_property_readonly("input", [](pybind11::object self) {
+        auto& fftw_ffs = self.cast<fourier::FFTW_FFS<TT>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_ffs.view_in(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -438,8 +441,9 @@ input : :py:class:`~numpy.ndarray`
     T-valued complex array.
 )EOF"));
 
-    obj.def_property_readonly("output", [](fourier::FFTW_FFS<TT> &fftw_ffs) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_ffs.view_out(), false);
+    obj.def_property_readonly("output", [](pybind11::object self) {
+        auto& fftw_ffs = self.cast<fourier::FFTW_FFS<TT>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_ffs.view_out(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -447,6 +451,27 @@ output : :py:class:`~numpy.ndarray`
     T-valued complex array.
 )EOF"));
 
+    obj.def_property_readonly("input_buffer", [](pybind11::object self) {
+        auto& fftw_ffs = self.cast<fourier::FFTW_FFS<TT>&>();
+        return cpp_py3_interop::make_buffer_view(fftw_ffs.view_in(), self);
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+input_buffer : :py:class:`~pypeline.util.math.fourier.BufferView`
+    Buffer-protocol handle on :py:attr:`~pypeline.util.math.fourier.FFTW_FFS.input`.
+    Can be filled in-place from any producer supporting the buffer protocol, ex: ``memoryview(transform.input_buffer)``.
+)EOF"));
+
+    obj.def_property_readonly("output_buffer", [](pybind11::object self) {
+        auto& fftw_ffs = self.cast<fourier::FFTW_FFS<TT>&>();
+        return cpp_py3_interop::make_buffer_view(fftw_ffs.view_out(), self);
+    }, pybind11::doc(R"EOF(
+Returns
+-------
+output_buffer : :py:class:`~pypeline.util.math.fourier.BufferView`
+    Buffer-protocol handle on :py:attr:`~pypeline.util.math.fourier.FFTW_FFS.output`.
+)EOF"));
+
     obj.def("ffs", [](fourier::FFTW_FFS<TT> &fftw_ffs) {
         fftw_ffs.ffs();
     }, pybind11::doc(R"EOF(
@@ -636,8 +661,9 @@ shape_output : tuple(int)
     Dimensions of the output.
 )EOF"));
 
-    obj.def_property_readonly("input", [](fourier::FFTW_CZT<T> &fftw_czt) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_czt.view_in(), false);
+    obj.def_property_readonly("input", [](pybind11::object self) {
+        auto& fftw_czt = self.cast<fourier::FFTW_CZT<T>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_czt.view_in(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -645,8 +671,9 @@ input : :py:class:`~numpy.ndarray`
     T-valued complex array.
 )EOF"));
 
-    obj.def_property_readonly("output", [](fourier::FFTW_CZT<T> &fftw_czt) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_czt.view_out(), false);
+    obj.def_property_readonly("output", [](pybind11::object self) {
+        auto& fftw_czt = self.cast<fourier::FFTW_CZT<T>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_czt.view_out(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -882,15 +909,14 @@ shape_output : tuple(int)
     Dimensions of the output.
 )EOF"));
 
-    obj.def("input", &_fs_interp_input<TT, float>,
-            pybind11::arg("x").noconvert().none(false));
-    obj.def("input", &_fs_interp_input<TT, double>,
-            pybind11::arg("x").noconvert().none(false));
-    obj.def("input", &_fs_interp_input<TT, std::complex<float>>,
-            pybind11::arg("x").noconvert().none(false));
-    obj.def("input", &_fs_interp_input<TT, std::complex<double>>,
-            pybind11::arg("x").noconvert().none(false),
-            pybind11::doc(R"EOF(
+    obj.def("input", [](fourier::FFTW_FS_INTERP<TT> &fftw_fs_interp,
+                        pybind11::array x) {
+        cpp_py3_interop::dispatch_dtype(x, [&fftw_fs_interp](auto x_typed) {
+            using T_array = typename decltype(x_typed)::value_type;
+            _fs_interp_input<TT, T_array>(fftw_fs_interp, x_typed);
+        });
+    }, pybind11::arg("x").none(false),
+       pybind11::doc(R"EOF(
 input(x)
 
 Fill input buffer.
@@ -899,6 +925,7 @@ Parameters
 ----------
 x : :py:class:`~numpy.ndarray`
     (..., N_FS, ...) FS coefficients in the order :math:`\left[ x_{-N}^{FS}, \ldots, x_{N}^{FS}\right]` along dimension `axis`.
+    Any dtype in {float32, float64, complex64, complex128} and any memory layout is accepted without intermediate copies.
 
 Notes
 -----
@@ -906,8 +933,9 @@ if `real_valued_output` was set to :py:obj:`True`, only the FS coefficients
 corresponding to non-negative frequencies are stored.
 )EOF"));
 
-    obj.def_property_readonly("output", [](fourier::FFTW_FS_INTERP<TT> &fftw_fs_interp) {
-        return cpp_py3_interop::xtensor_to_numpy(fftw_fs_interp.view_out(), false);
+    obj.def_property_readonly("output", [](pybind11::object self) {
+        auto& fftw_fs_interp = self.cast<fourier::FFTW_FS_INTERP<TT>&>();
+        return cpp_py3_interop::xtensor_to_numpy(fftw_fs_interp.view_out(), self, true);
     }, pybind11::doc(R"EOF(
 Returns
 -------
@@ -937,6 +965,7 @@ PYBIND11_MODULE(_pypeline_util_math_fourier_pybind11, m) {
     pybind11::options options;
     options.disable_function_signatures();
 
+    cpp_py3_interop::buffer_view_bindings(m);
     ffs_sample_bindings(m);
     planning_effort_bindings(m);
     FFTW_FFT_bindings<double>(m, "FFTW_FFT");
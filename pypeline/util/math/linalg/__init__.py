@@ -13,6 +13,9 @@ import _pypeline_util_math_linalg_pybind11 as __cpp
 from . import _linalg as __py
 
 eigh = __py.eigh
+eigh_batch = __py.eigh_batch
 
 rot = __cpp.rot
 z_rot2angle = __cpp.z_rot2angle
+WarmStartEigh_float32 = __cpp.WarmStartEigh_float32
+WarmStartEigh_float64 = __cpp.WarmStartEigh_float64
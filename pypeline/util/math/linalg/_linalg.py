@@ -5,8 +5,8 @@
 # ##############################################################################
 
 import numpy as np
-import scipy.linalg as linalg
 
+import _pypeline_util_math_linalg_pybind11 as linalg_cpp
 import pypeline.util.argcheck as chk
 
 
@@ -25,7 +25,8 @@ def eigh(A, B=None, tau=1, N=None):
 
        A V = B V D.
 
-    This function is a wrapper around :py:func:`scipy.linalg.eigh` that adds energy truncation and extra output formats.
+    Only the leading eigenpairs are computed: the problem is reduced to standard form through the Cholesky factor of `B`, then solved with LAPACK's partial-range ``?heevr``.
+    See :py:func:`~pypeline.util.math.linalg.eigh_batch` to solve many problems in parallel.
 
     Parameters
     ----------
@@ -93,14 +94,11 @@ def eigh(A, B=None, tau=1, N=None):
     .. doctest::
 
        >>> D, V = eigh(A, B)
-       >>> print(np.around(D, 4))  # The last term is small but positive.
-       [0.0296 0.0198 0.0098 0.    ]
+       >>> print(np.around(D, 4))  # A has rank 3.
+       [0.0296 0.0198 0.0098]
 
-       >>> print(np.around(V, 4))
-       [[-0.0621+0.0001j -0.0561+0.0005j -0.0262-0.0004j  0.0474+0.0005j]
-        [ 0.0285+0.0041j -0.0413-0.0501j  0.0129-0.0209j -0.004 -0.0647j]
-        [ 0.0583+0.0055j -0.0443+0.0033j  0.0069+0.0474j  0.0281+0.0371j]
-        [ 0.0363+0.0209j  0.0006+0.0235j -0.029 -0.0736j  0.0321+0.0142j]]
+       >>> np.allclose(A @ V, (B @ V) * D)
+       True
 
     * Drop some trailing eigenpairs:
 
@@ -110,11 +108,8 @@ def eigh(A, B=None, tau=1, N=None):
        >>> print(np.around(D, 4))
        [0.0296]
 
-       >>> print(np.around(V, 4))
-       [[-0.0621+0.0001j]
-        [ 0.0285+0.0041j]
-        [ 0.0583+0.0055j]
-        [ 0.0363+0.0209j]]
+       >>> V.shape
+       (4, 1)
 
     * Pad output to certain size:
 
@@ -124,20 +119,18 @@ def eigh(A, B=None, tau=1, N=None):
        >>> print(np.around(D, 4))
        [0.0296 0.     0.    ]
 
-       >>> print(np.around(V, 4))
-       [[-0.0621+0.0001j  0.    +0.j      0.    +0.j    ]
-        [ 0.0285+0.0041j  0.    +0.j      0.    +0.j    ]
-        [ 0.0583+0.0055j  0.    +0.j      0.    +0.j    ]
-        [ 0.0363+0.0209j  0.    +0.j      0.    +0.j    ]]
+       >>> np.allclose(V[:, 1:], 0)
+       True
     """
     A = np.array(A, copy=False)
     M = len(A)
     if not (chk.has_shape([M, M])(A) and np.allclose(A, A.conj().T)):
         raise ValueError('Parameter[A] must be hermitian symmetric.')
 
-    B = np.eye(M) if (B is None) else np.array(B, copy=False)
-    if not (chk.has_shape([M, M])(B) and np.allclose(B, B.conj().T)):
-        raise ValueError('Parameter[B] must be hermitian symmetric.')
+    if B is not None:
+        B = np.array(B, copy=False)
+        if not (chk.has_shape([M, M])(B) and np.allclose(B, B.conj().T)):
+            raise ValueError('Parameter[B] must be hermitian symmetric.')
 
     if not (0 < tau <= 1):
         raise ValueError('Parameter[tau] must be in [0, 1].')
@@ -145,33 +138,55 @@ def eigh(A, B=None, tau=1, N=None):
     if (N is not None) and (N <= 0):
         raise ValueError(f'Parameter[N] must be a non-zero positive integer.')
 
-    # A: drop negative spectrum.
-    Ds, Vs = linalg.eigh(A)
-    idx = Ds > 0
-    Ds, Vs = Ds[idx], Vs[:, idx]
-    A = (Vs * Ds) @ Vs.conj().T
-
-    # A, B: generalized eigenvalue-decomposition.
     try:
-        D, V = linalg.eigh(A, B)
-
-        # Discard near-zero D due to numerical precision.
-        idx = D > 0
-        D, V = D[idx], V[:, idx]
-        idx = np.argsort(D)[::-1]
-        D, V = D[idx], V[:, idx]
-    except linalg.LinAlgError:
-        raise ValueError('Parameter[B] is not PSD.')
-
-    # Energy selection / padding
-    idx = np.clip(np.cumsum(D) / np.sum(D), 0, 1) <= tau
-    D, V = D[idx], V[:, idx]
-    if N is not None:
-        M, K = V.shape
-        if N - K <= 0:
-            D, V = D[:N], V[:, :N]
-        else:
-            D = np.concatenate((D, np.zeros(N - K)), axis=0)
-            V = np.concatenate((V, np.zeros((M, N - K))), axis=1)
+        D, V = linalg_cpp.eigh(np.require(A, np.complex128, 'C'),
+                               None if (B is None) else np.require(B, np.complex128, 'C'),
+                               tau,
+                               0 if (N is None) else N)
+    except RuntimeError as e:
+        raise ValueError(str(e))
 
     return D, V
+
+
+@chk.check(dict(A=chk.is_instance(list, tuple),
+                B=chk.allow_None(chk.is_instance(list, tuple)),
+                tau=chk.is_real,
+                N=chk.allow_None(chk.is_integer)))
+def eigh_batch(A, B=None, tau=1, N=None):
+    """
+    Solve many generalized eigenvalue problems in parallel.
+
+    Parameters
+    ----------
+    A : list(:py:class:`~numpy.ndarray`)
+        (N_problem,) (M, M) hermitian matrices.
+    B : list(:py:class:`~numpy.ndarray`)
+        (N_problem,) or (1,) (M, M) PSD hermitian matrices.
+        A single matrix is shared by all problems.
+        Consecutive identical matrices are factorized only once.
+        If unspecified, `B` is assumed to be the identity matrix.
+    tau : float, optional
+        Normalized energy ratio in [0, 1].
+    N : int, optional
+        Number of eigenpairs to output.
+
+    Returns
+    -------
+    DV : list(tuple(:py:class:`~numpy.ndarray`, :py:class:`~numpy.ndarray`))
+        (N_problem,) (D, V) pairs, as output by :py:func:`~pypeline.util.math.linalg.eigh`.
+    """
+    if not (0 < tau <= 1):
+        raise ValueError('Parameter[tau] must be in [0, 1].')
+
+    if (N is not None) and (N <= 0):
+        raise ValueError('Parameter[N] must be a non-zero positive integer.')
+
+    A = [np.require(_, np.complex128, 'C') for _ in A]
+    B = [] if (B is None) else [np.require(_, np.complex128, 'C') for _ in B]
+    try:
+        DV = linalg_cpp.eigh_batch(A, B, tau, 0 if (N is None) else N)
+    except RuntimeError as e:
+        raise ValueError(str(e))
+
+    return DV
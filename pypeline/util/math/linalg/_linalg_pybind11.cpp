@@ -4,10 +4,21 @@
 // Author : Sepand KASHANI [sep@zurich.ibm.com]
 // ############################################################################
 
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "pybind11/pybind11.h"
+#include "pybind11/eigen.h"
+#include "pybind11/stl.h"
 
+#include "pypeline/types.hpp"
 #include "pypeline/util/cpp_py3_interop.hpp"
 #include "pypeline/util/math/linalg.hpp"
 
@@ -110,10 +121,260 @@ Examples
 )EOF"));
 }
 
+template <typename TT>
+std::tuple<ArrayX_t<TT>, MatrixXX_t<std::complex<TT>>> _eigh(Eigen::Ref<const MatrixXX_t<std::complex<TT>>> A,
+                                                             pybind11::object B,
+                                                             const double tau,
+                                                             const size_t N) {
+    using cTT = std::complex<TT>;
+
+    linalg::EigenPairs<TT> DV;
+    if (B.is_none()) {
+        pybind11::gil_scoped_release release;
+        DV = linalg::eigh<TT>(A, tau, N);
+    } else {
+        const MatrixXX_t<cTT> B_mat = B.cast<MatrixXX_t<cTT>>();
+        pybind11::gil_scoped_release release;
+        DV = linalg::eigh<TT>(A, B_mat, tau, N);
+    }
+    return std::make_tuple(std::move(DV.D), std::move(DV.V));
+}
+
+template <typename TT>
+std::vector<std::tuple<ArrayX_t<TT>, MatrixXX_t<std::complex<TT>>>> _eigh_batch(const std::vector<MatrixXX_t<std::complex<TT>>> &A,
+                                                                                const std::vector<MatrixXX_t<std::complex<TT>>> &B,
+                                                                                const double tau,
+                                                                                const size_t N) {
+    std::vector<linalg::EigenPairs<TT>> DV;
+    {
+        pybind11::gil_scoped_release release;
+        DV = linalg::eigh_batch<TT>(A, B, tau, N);
+    }
+
+    std::vector<std::tuple<ArrayX_t<TT>, MatrixXX_t<std::complex<TT>>>> out;
+    out.reserve(DV.size());
+    for (auto &dv : DV) {
+        out.emplace_back(std::move(dv.D), std::move(dv.V));
+    }
+    return out;
+}
+
+void eigh_bindings(pybind11::module &m) {
+    m.def("eigh",
+          &_eigh<float>,
+          pybind11::arg("A").noconvert().none(false),
+          pybind11::arg("B").none(true),
+          pybind11::arg("tau") = 1.0,
+          pybind11::arg("N") = 0);
+
+    m.def("eigh",
+          &_eigh<double>,
+          pybind11::arg("A").noconvert().none(false),
+          pybind11::arg("B").none(true),
+          pybind11::arg("tau") = 1.0,
+          pybind11::arg("N") = 0,
+          pybind11::doc(R"EOF(
+eigh(A, B, tau=1, N=0)
+
+Solve a generalized eigenvalue problem, keeping only the leading eigenpairs.
+
+Finds :math:`(D, V)`, solution of :math:`A_{+} V = B V D`, where :math:`A_{+}` is the positive-semidefinite part of `A`.
+Only the requested eigenpairs are computed, using LAPACK's partial-range ``?heevr`` after reduction to standard form.
+
+Parameters
+----------
+A : :py:class:`~numpy.ndarray`
+    (M, M) hermitian matrix (complex64/128).
+B : :py:class:`~numpy.ndarray`
+    (M, M) positive-definite hermitian matrix with the same dtype as `A`.
+    If :py:obj:`None`, `B` is assumed to be the identity matrix.
+tau : float
+    Normalized energy ratio in (0, 1].
+N : int
+    Number of eigenpairs to output. (0: minimum number of leading eigenpairs that account for `tau` percent of the total energy.)
+
+Returns
+-------
+D : :py:class:`~numpy.ndarray`
+    (N,) positive eigenvalues in decreasing order, zero-padded if needed.
+V : :py:class:`~numpy.ndarray`
+    (M, N) eigenvectors.
+)EOF"));
+}
+
+void eigh_batch_bindings(pybind11::module &m) {
+    m.def("eigh_batch",
+          &_eigh_batch<float>,
+          pybind11::arg("A").none(false),
+          pybind11::arg("B").none(false),
+          pybind11::arg("tau") = 1.0,
+          pybind11::arg("N") = 0);
+
+    m.def("eigh_batch",
+          &_eigh_batch<double>,
+          pybind11::arg("A").none(false),
+          pybind11::arg("B").none(false),
+          pybind11::arg("tau") = 1.0,
+          pybind11::arg("N") = 0,
+          pybind11::doc(R"EOF(
+eigh_batch(A, B, tau=1, N=0)
+
+Solve many :py:func:`eigh` problems in parallel.
+
+Parameters
+----------
+A : list(:py:class:`~numpy.ndarray`)
+    (N_problem,) (M, M) hermitian matrices.
+B : list(:py:class:`~numpy.ndarray`)
+    (N_problem,) or (1,) positive-definite hermitian matrices, or an empty list if `B` is the identity.
+    Consecutive identical matrices are factorized only once.
+tau : float
+    Normalized energy ratio in (0, 1].
+N : int
+    Number of eigenpairs to output.
+
+Returns
+-------
+DV : list(tuple(:py:class:`~numpy.ndarray`, :py:class:`~numpy.ndarray`))
+    (N_problem,) (D, V) pairs.
+)EOF"));
+}
+
+template <typename TT>
+void WarmStartEigh_bindings(pybind11::module &m,
+                            const std::string &class_name) {
+    using cTT = std::complex<TT>;
+
+    auto obj = pybind11::class_<linalg::WarmStartEigh<TT>>(m,
+                                                           class_name.data(),
+                                                           R"EOF(
+Warm-started :py:func:`~pypeline.util.math.linalg.eigh` for sequences of slowly-varying problems.
+
+Each stream (ex: frequency channel) remembers the eigenvectors of its previous problem, which seed a block LOBPCG iteration.
+The dense solver is used on the first problem of a stream, when the problem size changes, or when LOBPCG does not converge.
+
+`A` is assumed positive-semidefinite: its negative spectrum is not projected out on the warm path.
+
+Examples
+--------
+.. testsetup::
+
+   import numpy as np
+   from pypeline.util.math.linalg import eigh, WarmStartEigh_float64
+
+.. doctest::
+
+   >>> X = np.random.randn(50, 50) + 1j * np.random.randn(50, 50)
+   >>> A, B = X @ X.conj().T, np.eye(50)
+
+   >>> solver = WarmStartEigh_float64(N_eig=4)
+   >>> for t in range(5):
+   ...     A_t = A + 1e-3 * t * np.eye(50)
+   ...     D, V = solver(A_t, B)
+   >>> solver.N_cold, solver.N_warm
+   (1, 4)
+
+   >>> np.allclose(D, eigh(A_t, B, N=4)[0])
+   True
+)EOF");
+
+    obj.def(pybind11::init([](const size_t N_eig,
+                              const size_t N_guard,
+                              const double tol,
+                              const size_t max_iter) {
+        if (N_eig == 0) {
+            std::string msg = "Parameter[N_eig] must be positive.";
+            throw std::runtime_error(msg);
+        }
+
+        return std::make_unique<linalg::WarmStartEigh<TT>>(N_eig, N_guard, tol, max_iter);
+    }), pybind11::arg("N_eig").none(false),
+        pybind11::arg("N_guard") = 4,
+        pybind11::arg("tol") = std::sqrt(std::numeric_limits<TT>::epsilon()),
+        pybind11::arg("max_iter") = 20,
+        pybind11::doc(R"EOF(
+__init__(N_eig, N_guard=4, tol=sqrt(eps), max_iter=20)
+
+Parameters
+----------
+N_eig : int
+    Number of eigenpairs to output.
+N_guard : int
+    Extra eigenpairs tracked to speed up convergence.
+tol : float
+    Relative residual tolerance of LOBPCG.
+max_iter : int
+    Maximum number of LOBPCG iterations before falling back to the dense solver.
+)EOF"));
+
+    obj.def("__call__", [](linalg::WarmStartEigh<TT> &solver,
+                           Eigen::Ref<const MatrixXX_t<cTT>> A,
+                           pybind11::object B,
+                           const double tau,
+                           const int stream) {
+        linalg::EigenPairs<TT> DV;
+        if (B.is_none()) {
+            pybind11::gil_scoped_release release;
+            DV = solver(A, tau, stream);
+        } else {
+            const MatrixXX_t<cTT> B_mat = B.cast<MatrixXX_t<cTT>>();
+            pybind11::gil_scoped_release release;
+            DV = solver(A, B_mat, tau, stream);
+        }
+        return std::make_tuple(std::move(DV.D), std::move(DV.V));
+    }, pybind11::arg("A").noconvert().none(false),
+       pybind11::arg("B") = pybind11::none(),
+       pybind11::arg("tau") = 1.0,
+       pybind11::arg("stream") = 0,
+       pybind11::doc(R"EOF(
+__call__(A, B=None, tau=1, stream=0)
+
+Solve :math:`A V = B V D` for the `N_eig` leading eigenpairs.
+
+Parameters
+----------
+A : :py:class:`~numpy.ndarray`
+    (M, M) positive-semidefinite hermitian matrix.
+B : :py:class:`~numpy.ndarray`
+    (M, M) positive-definite hermitian matrix with the same dtype as `A`.
+    If :py:obj:`None`, `B` is assumed to be the identity matrix.
+tau : float
+    Normalized energy ratio in (0, 1].
+stream : int
+    Identifier of the sequence the problem belongs to.
+
+Returns
+-------
+D : :py:class:`~numpy.ndarray`
+    (N_eig,) positive eigenvalues in decreasing order, zero-padded if needed.
+V : :py:class:`~numpy.ndarray`
+    (M, N_eig) eigenvectors.
+)EOF"));
+
+    obj.def("reset", &linalg::WarmStartEigh<TT>::reset,
+            pybind11::doc(R"EOF(
+reset()
+
+Forget the eigenvectors of previous problems.
+)EOF"));
+
+    obj.def_property_readonly("N_eig", &linalg::WarmStartEigh<TT>::N_eig);
+    obj.def_property_readonly("N_warm", &linalg::WarmStartEigh<TT>::N_warm,
+                              pybind11::doc("Number of problems solved with LOBPCG."));
+    obj.def_property_readonly("N_cold", &linalg::WarmStartEigh<TT>::N_cold,
+                              pybind11::doc("Number of problems solved densely because no usable seed existed."));
+    obj.def_property_readonly("N_fallback", &linalg::WarmStartEigh<TT>::N_fallback,
+                              pybind11::doc("Number of problems solved densely because LOBPCG did not converge."));
+}
+
 PYBIND11_MODULE(_pypeline_util_math_linalg_pybind11, m) {
     pybind11::options options;
     options.disable_function_signatures();
 
     rot2angle_bindings(m);
     rot_bindings(m);
+    eigh_bindings(m);
+    eigh_batch_bindings(m);
+    WarmStartEigh_bindings<float>(m, "WarmStartEigh_float32");
+    WarmStartEigh_bindings<double>(m, "WarmStartEigh_float64");
 }
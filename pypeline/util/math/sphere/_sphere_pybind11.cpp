@@ -70,37 +70,29 @@ std::tuple<double,
 }
 
 void pol2cart_bindings(pybind11::module &m) {
-   m.def("pol2cart",
-          pybind11::overload_cast<pybind11::array_t<float>,
-                                  pybind11::array_t<float>,
-                                  pybind11::array_t<float>>(&_pol2cart<float>),
-          pybind11::arg("r").noconvert().none(false),
-          pybind11::arg("colat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
-
-    m.def("pol2cart",
-          pybind11::overload_cast<pybind11::array_t<double>,
-                                  pybind11::array_t<double>,
-                                  pybind11::array_t<double>>(&_pol2cart<double>),
-          pybind11::arg("r").noconvert().none(false),
-          pybind11::arg("colat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
-
-    m.def("pol2cart",
-          pybind11::overload_cast<double,
-                                  pybind11::array_t<float>,
-                                  pybind11::array_t<float>>(&_pol2cart<float>),
-          pybind11::arg("r").none(false),
-          pybind11::arg("colat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
-
-    m.def("pol2cart",
-          pybind11::overload_cast<double,
-                                  pybind11::array_t<double>,
-                                  pybind11::array_t<double>>(&_pol2cart<double>),
-          pybind11::arg("r").none(false),
-          pybind11::arg("colat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
+    cpp_py3_interop::def_dtypes(m, "pol2cart", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>>(&_pol2cart<T>);
+                                },
+                                "",
+                                pybind11::arg("r").noconvert().none(false),
+                                pybind11::arg("colat").noconvert().none(false),
+                                pybind11::arg("lon").noconvert().none(false));
+
+    cpp_py3_interop::def_dtypes(m, "pol2cart", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<double,
+                                                                   pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>>(&_pol2cart<T>);
+                                },
+                                "",
+                                pybind11::arg("r").none(false),
+                                pybind11::arg("colat").noconvert().none(false),
+                                pybind11::arg("lon").noconvert().none(false));
 
     m.def("pol2cart",
           pybind11::overload_cast<double,
@@ -197,37 +189,29 @@ std::tuple<double,
 }
 
 void eq2cart_bindings(pybind11::module &m) {
-    m.def("eq2cart",
-          pybind11::overload_cast<pybind11::array_t<float>,
-                                  pybind11::array_t<float>,
-                                  pybind11::array_t<float>>(&_eq2cart<float>),
-          pybind11::arg("r").noconvert().none(false),
-          pybind11::arg("lat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
-
-    m.def("eq2cart",
-          pybind11::overload_cast<pybind11::array_t<double>,
-                                  pybind11::array_t<double>,
-                                  pybind11::array_t<double>>(&_eq2cart<double>),
-          pybind11::arg("r").noconvert().none(false),
-          pybind11::arg("lat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
-
-    m.def("eq2cart",
-          pybind11::overload_cast<double,
-                                  pybind11::array_t<float>,
-                                  pybind11::array_t<float>>(&_eq2cart<float>),
-          pybind11::arg("r").none(false),
-          pybind11::arg("lat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
-
-    m.def("eq2cart",
-          pybind11::overload_cast<double,
-                                  pybind11::array_t<double>,
-                                  pybind11::array_t<double>>(&_eq2cart<double>),
-          pybind11::arg("r").none(false),
-          pybind11::arg("lat").noconvert().none(false),
-          pybind11::arg("lon").noconvert().none(false));
+    cpp_py3_interop::def_dtypes(m, "eq2cart", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>>(&_eq2cart<T>);
+                                },
+                                "",
+                                pybind11::arg("r").noconvert().none(false),
+                                pybind11::arg("lat").noconvert().none(false),
+                                pybind11::arg("lon").noconvert().none(false));
+
+    cpp_py3_interop::def_dtypes(m, "eq2cart", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<double,
+                                                                   pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>>(&_eq2cart<T>);
+                                },
+                                "",
+                                pybind11::arg("r").none(false),
+                                pybind11::arg("lat").noconvert().none(false),
+                                pybind11::arg("lon").noconvert().none(false));
 
     m.def("eq2cart",
           pybind11::overload_cast<double,
@@ -306,21 +290,17 @@ std::tuple<double,
 }
 
 void cart2pol_bindings(pybind11::module &m) {
-    m.def("cart2pol",
-          pybind11::overload_cast<pybind11::array_t<float>,
-                                  pybind11::array_t<float>,
-                                  pybind11::array_t<float>>(&_cart2pol<float>),
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("y").noconvert().none(false),
-          pybind11::arg("z").noconvert().none(false));
-
-    m.def("cart2pol",
-          pybind11::overload_cast<pybind11::array_t<double>,
-                                  pybind11::array_t<double>,
-                                  pybind11::array_t<double>>(&_cart2pol<double>),
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("y").noconvert().none(false),
-          pybind11::arg("z").noconvert().none(false));
+    cpp_py3_interop::def_dtypes(m, "cart2pol", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>>(&_cart2pol<T>);
+                                },
+                                "",
+                                pybind11::arg("x").noconvert().none(false),
+                                pybind11::arg("y").noconvert().none(false),
+                                pybind11::arg("z").noconvert().none(false));
 
     m.def("cart2pol",
           pybind11::overload_cast<double,
@@ -400,21 +380,17 @@ std::tuple<double,
 }
 
 void cart2eq_bindings(pybind11::module &m) {
-    m.def("cart2eq",
-          pybind11::overload_cast<pybind11::array_t<float>,
-                                  pybind11::array_t<float>,
-                                  pybind11::array_t<float>>(&_cart2eq<float>),
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("y").noconvert().none(false),
-          pybind11::arg("z").noconvert().none(false));
-
-    m.def("cart2eq",
-          pybind11::overload_cast<pybind11::array_t<double>,
-                                  pybind11::array_t<double>,
-                                  pybind11::array_t<double>>(&_cart2eq<double>),
-          pybind11::arg("x").noconvert().none(false),
-          pybind11::arg("y").noconvert().none(false),
-          pybind11::arg("z").noconvert().none(false));
+    cpp_py3_interop::def_dtypes(m, "cart2eq", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>,
+                                                                   pybind11::array_t<T>>(&_cart2eq<T>);
+                                },
+                                "",
+                                pybind11::arg("x").noconvert().none(false),
+                                pybind11::arg("y").noconvert().none(false),
+                                pybind11::arg("z").noconvert().none(false));
 
     m.def("cart2eq",
           pybind11::overload_cast<double,
@@ -463,7 +439,7 @@ template <typename T>
 pybind11::array_t<T> _colat2lat(pybind11::array_t<T> colat) {
     const auto& colat_view = cpp_py3_interop::numpy_to_xview<T>(colat);
 
-    const auto& lat = sphere::colat2lat(colat_view);
+    auto lat = sphere::colat2lat(colat_view);
     return cpp_py3_interop::xtensor_to_numpy(std::move(lat));
 }
 
@@ -471,18 +447,18 @@ template <typename T>
 double _colat2lat(double colat) {
     xt::xtensor<double, 1> _colat {colat};
 
-    const auto& lat = sphere::colat2lat(_colat);
+    auto lat = sphere::colat2lat(_colat);
     return lat(0);
 }
 
 void colat2lat_bindings(pybind11::module &m) {
-    m.def("colat2lat",
-          pybind11::overload_cast<pybind11::array_t<float>>(&_colat2lat<float>),
-          pybind11::arg("colat").noconvert().none(false));
-
-    m.def("colat2lat",
-          pybind11::overload_cast<pybind11::array_t<double>>(&_colat2lat<double>),
-          pybind11::arg("colat").noconvert().none(false));
+    cpp_py3_interop::def_dtypes(m, "colat2lat", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<pybind11::array_t<T>>(&_colat2lat<T>);
+                                },
+                                "",
+                                pybind11::arg("colat").noconvert().none(false));
 
     m.def("colat2lat",
           pybind11::overload_cast<double>(&_colat2lat<double>),
@@ -508,7 +484,7 @@ template <typename T>
 pybind11::array_t<T> _lat2colat(pybind11::array_t<T> lat) {
     const auto& lat_view = cpp_py3_interop::numpy_to_xview<T>(lat);
 
-    const auto& colat = sphere::lat2colat(lat_view);
+    auto colat = sphere::lat2colat(lat_view);
     return cpp_py3_interop::xtensor_to_numpy(std::move(colat));
 }
 
@@ -516,18 +492,18 @@ template <typename T>
 double _lat2colat(double lat) {
     xt::xtensor<double, 1> _lat {lat};
 
-    const auto& colat = sphere::lat2colat(_lat);
+    auto colat = sphere::lat2colat(_lat);
     return colat(0);
 }
 
 void lat2colat_bindings(pybind11::module &m) {
-    m.def("lat2colat",
-          pybind11::overload_cast<pybind11::array_t<float>>(&_lat2colat<float>),
-          pybind11::arg("lat").noconvert().none(false));
-
-    m.def("lat2colat",
-          pybind11::overload_cast<pybind11::array_t<double>>(&_lat2colat<double>),
-          pybind11::arg("lat").noconvert().none(false));
+    cpp_py3_interop::def_dtypes(m, "lat2colat", cpp_py3_interop::real_dtypes(),
+                                [](auto tag) {
+                                    using T = typename decltype(tag)::type;
+                                    return pybind11::overload_cast<pybind11::array_t<T>>(&_lat2colat<T>);
+                                },
+                                "",
+                                pybind11::arg("lat").noconvert().none(false));
 
     m.def("lat2colat",
           pybind11::overload_cast<double>(&_lat2colat<double>),
@@ -21,7 +21,10 @@ cmds = dict(pytest=[f'source "{project_root_dir}/pypeline.sh" --no_shell',
             flake8=[f'source "{project_root_dir}/pypeline.sh" --no_shell',
                     f'flake8 --ignore=E122,E128,E501,E731,E741 "{project_root_dir}/pypeline"'],
             doctest=[f'source "{project_root_dir}/pypeline.sh" --no_shell',
-                     f'sphinx-build -b doctest "{project_root_dir}/doc" "{project_root_dir}/build/doctest"'])
+                     f'sphinx-build -b doctest "{project_root_dir}/doc" "{project_root_dir}/build/doctest"'],
+            ctest=[f'source "{project_root_dir}/pypeline.sh" --no_shell',
+                   f'cd "{project_root_dir}/build/pypeline"',
+                   'ctest --output-on-failure'])
 for k in cmds:
     cmds[k].insert(0, 'export PYPELINE_RUNNING_TESTS=1')
 
@@ -0,0 +1,76 @@
+// ############################################################################
+// test.hpp
+// ========
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+/*
+ * Assertion helpers shared by C++ unit tests.
+ *
+ * Each test_<module>.cpp is a standalone executable registered with CTest:
+ * failed checks are reported on std::cerr, and main() returns
+ * `test::report()`, i.e. non-zero if any check failed.
+ */
+
+#ifndef PYPELINE_TEST_TEST_HPP
+#define PYPELINE_TEST_TEST_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <string>
+
+namespace test {
+    inline size_t& N_failure() {
+        static size_t N = 0;
+        return N;
+    }
+
+    inline void fail(const char *file, const int line, const std::string &what) {
+        std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+        ++N_failure();
+    }
+
+    /*
+     * Run one test case, turning uncaught exceptions into failures.
+     */
+    template <typename F>
+    void run(const std::string &name, F &&f) {
+        const size_t N_before = N_failure();
+        try {
+            f();
+        } catch (const std::exception &e) {
+            std::cerr << name << ": unexpected exception: " << e.what() << std::endl;
+            ++N_failure();
+        }
+        std::cout << ((N_failure() == N_before) ? "[ OK ] " : "[FAIL] ") << name << std::endl;
+    }
+
+    inline int report() {
+        return (N_failure() == 0) ? 0 : 1;
+    }
+}
+
+#define PYPELINE_CHECK(cond)                                                   \
+    do {                                                                       \
+        if (!(cond)) { test::fail(__FILE__, __LINE__, #cond); }                \
+    } while (false)
+
+#define PYPELINE_CHECK_CLOSE(a, b, tol)                                        \
+    do {                                                                       \
+        const double _a = (a), _b = (b);                                       \
+        if (!(std::abs(_a - _b) <= (tol))) {                                   \
+            test::fail(__FILE__, __LINE__, std::string(#a " ~= " #b " (") +    \
+                       std::to_string(_a) + " vs " + std::to_string(_b) + ")"); \
+        }                                                                      \
+    } while (false)
+
+#define PYPELINE_CHECK_THROWS(expr)                                            \
+    do {                                                                       \
+        bool _thrown = false;                                                  \
+        try { expr; } catch (const std::exception&) { _thrown = true; }        \
+        if (!_thrown) { test::fail(__FILE__, __LINE__, #expr " throws"); }     \
+    } while (false)
+
+#endif //PYPELINE_TEST_TEST_HPP
@@ -0,0 +1,150 @@
+// ############################################################################
+// test_archive.cpp
+// ================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "xtensor/xadapt.hpp"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/io/archive.hpp"
+#include "pypeline/phased_array/util/io/image.hpp"
+#include "test.hpp"
+
+namespace archive = pypeline::phased_array::util::io::archive;
+namespace image = pypeline::phased_array::util::io::image;
+
+namespace {
+    std::string temp_path(const std::string &name) {
+        return "/tmp/pypeline_test_archive_" + std::to_string(getpid()) + "_" + name;
+    }
+
+    /*
+     * (N_level, N_px) planes: even planes are mostly zero (compressible),
+     * odd planes are noise (stored raw).
+     */
+    template <typename T>
+    std::vector<std::vector<T>> make_planes(const size_t N_plane, const size_t N_level, const size_t N_px) {
+        std::mt19937 gen(0);
+        std::uniform_real_distribution<double> U(-1, 1);
+        std::vector<std::vector<T>> planes(N_plane, std::vector<T>(N_level * N_px, 0));
+        for (size_t p = 0; p < N_plane; ++p) {
+            for (size_t i = 0; i < planes[p].size(); ++i) {
+                planes[p][i] = ((p % 2 == 0) && (i % 17 != 0)) ? 0 : static_cast<T>(U(gen));
+            }
+        }
+        return planes;
+    }
+
+    /*
+     * Round-trip planes through an archive on `shape_grid`, with bands of `band_size` rows (or points).
+     */
+    template <typename T>
+    void check_round_trip(const std::string &path,
+                          const std::vector<size_t> &shape_grid,
+                          const size_t band_size,
+                          const bool compress) {
+        const size_t N_level = 3, N_plane = 4;
+        size_t N_px = 1;
+        for (size_t d = 1; d < shape_grid.size(); ++d) { N_px *= shape_grid[d]; }
+        const size_t N_col = (shape_grid.size() == 3) ? shape_grid[2] : 1;
+
+        std::vector<T> grid(3 * N_px);
+        for (size_t i = 0; i < grid.size(); ++i) { grid[i] = std::cos(0.1 * i); }
+        std::vector<size_t> shape_image(shape_grid);
+        shape_image[0] = N_level;
+        const auto planes = make_planes<T>(N_plane, N_level, N_px);
+
+        {
+            auto A = archive::SphericalImageArchive<T>::create(
+                         path, xt::adapt(grid.data(), grid.size(), xt::no_ownership(), shape_grid),
+                         N_level, band_size, compress);
+            for (size_t p = 0; p < N_plane; ++p) {
+                std::vector<T> data(planes[p]);
+                image::SphericalImageContainer<T> I(data.data(), shape_image, grid.data(), shape_grid, nullptr);
+                PYPELINE_CHECK(A.append(I, 10.0 * p) == p);
+            }
+        }
+
+        archive::SphericalImageArchive<T> A(path);
+        PYPELINE_CHECK((A.N_plane() == N_plane) && (A.N_level() == N_level));
+        PYPELINE_CHECK(A.N_band() == (shape_grid[1] + band_size - 1) / band_size);
+        PYPELINE_CHECK(archive::itemsize(path) == sizeof(T));
+        for (size_t p = 0; p < N_plane; ++p) {
+            PYPELINE_CHECK(A.tags()[p] == 10.0 * p);
+        }
+        PYPELINE_CHECK(std::vector<T>(A.grid_data(), A.grid_data() + grid.size()) == grid);
+
+        for (size_t p = 0; p < N_plane; ++p) {
+            const image::SphericalImageContainer<T> I = A.read_plane(p);
+            const auto im = I.image();
+            PYPELINE_CHECK(std::vector<T>(im.data(), im.data() + im.size()) == planes[p]);
+        }
+
+        // Random access: tiles decode independently of their neighbours.
+        std::mt19937 gen(1);
+        for (int k = 0; k < 50; ++k) {
+            const size_t p = gen() % N_plane, level = gen() % N_level, band = gen() % A.N_band();
+            std::vector<T> tile(A.tile_size(band));
+            A.read_tile(p, level, band, tile.data());
+
+            const size_t start = level * N_px + band * band_size * N_col;
+            const std::vector<T> expected(planes[p].begin() + start, planes[p].begin() + start + tile.size());
+            PYPELINE_CHECK(tile == expected);
+        }
+        PYPELINE_CHECK_THROWS(A.read_tile(N_plane, 0, 0, nullptr));
+        PYPELINE_CHECK_THROWS(A.read_tile(0, N_level, 0, nullptr));
+    }
+}
+
+int main() {
+    test::run("SphericalImageArchive round-trip", []() {
+        const std::string path = temp_path("rt.pia");
+        for (const bool compress : {false, true}) {
+            check_round_trip<double>(path, {3, 10, 7}, 4, compress);  // Last band holds 2 rows.
+            check_round_trip<float>(path, {3, 10, 7}, 16, compress);  // Single band.
+            check_round_trip<float>(path, {3, 45}, 8, compress);
+        }
+        std::remove(path.c_str());
+    });
+
+    test::run("SphericalImageArchive interrupted append", []() {
+        const std::string path = temp_path("cut.pia");
+        check_round_trip<double>(path, {3, 10, 7}, 4, true);
+
+        // Drop the end of the last plane: it is ignored, then overwritten.
+        archive::SphericalImageArchive<double> A(path);
+        const std::vector<size_t> shape_grid = A.grid_shape();
+        std::vector<double> grid(A.grid_data(), A.grid_data() + 3 * 10 * 7);
+        struct stat info;
+        PYPELINE_CHECK(stat(path.c_str(), &info) == 0);
+        PYPELINE_CHECK(truncate(path.c_str(), info.st_size - 8) == 0);
+
+        archive::SphericalImageArchive<double> B(path);
+        PYPELINE_CHECK(B.N_plane() == A.N_plane() - 1);
+
+        std::vector<double> data(A.N_level() * 10 * 7, 1.5);
+        image::SphericalImageContainer<double> I(data.data(), {A.N_level(), 10, 7},
+                                                 grid.data(), shape_grid, nullptr);
+        PYPELINE_CHECK(B.append(I, -1) == A.N_plane() - 1);
+
+        archive::SphericalImageArchive<double> C(path);
+        PYPELINE_CHECK((C.N_plane() == A.N_plane()) && (C.tags().back() == -1));
+        const image::SphericalImageContainer<double> J = C.read_plane(C.N_plane() - 1);
+        const auto im = J.image();
+        PYPELINE_CHECK(std::vector<double>(im.data(), im.data() + im.size()) == data);
+        std::remove(path.c_str());
+    });
+
+    return test::report();
+}
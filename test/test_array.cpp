@@ -0,0 +1,49 @@
+// ############################################################################
+// test_array.cpp
+// ==============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <vector>
+
+#include "pypeline/util/array.hpp"
+#include "test.hpp"
+
+namespace array = pypeline::util::array;
+
+int main() {
+    test::run("LayerClusterer::augment", []() {
+        const std::vector<size_t> idx {2, 0, 2, 1, 0};
+        const size_t N = 4, K = idx.size(), N_outer = 3, N_inner = 5;
+        const std::vector<double> weights {0.5, 1.0, 2.0, -1.0, 3.0};
+
+        std::vector<double> x(N_outer * K * N_inner);
+        for (size_t i = 0; i < x.size(); ++i) { x[i] = 0.25 * i - 3.0; }
+
+        for (const bool weighted : {false, true}) {
+            std::vector<double> buffer(N_outer * N * N_inner, 1.0), expected(buffer);
+            for (size_t o = 0; o < N_outer; ++o) {
+                for (size_t k = 0; k < K; ++k) {
+                    for (size_t i = 0; i < N_inner; ++i) {
+                        const double w = weighted ? weights[k] : 1.0;
+                        expected[(o * N + idx[k]) * N_inner + i] += w * x[(o * K + k) * N_inner + i];
+                    }
+                }
+            }
+
+            array::LayerClusterer clusterer(idx, N);
+            clusterer.augment(x.data(), buffer.data(), N_outer, N_inner,
+                              weighted ? weights.data() : nullptr);
+            for (size_t i = 0; i < buffer.size(); ++i) {
+                PYPELINE_CHECK_CLOSE(buffer[i], expected[i], 1e-12);
+            }
+        }
+    });
+
+    test::run("LayerClusterer rejects out-of-bound indices", []() {
+        PYPELINE_CHECK_THROWS(array::LayerClusterer({0, 3}, 3));
+        PYPELINE_CHECK_THROWS(array::LayerClusterer({}, 0));
+    });
+
+    return test::report();
+}
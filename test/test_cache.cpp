@@ -0,0 +1,201 @@
+// ############################################################################
+// test_cache.cpp
+// ==============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "pypeline/types.hpp"
+#include "pypeline/util/cache.hpp"
+#include "test.hpp"
+
+namespace cache = pypeline::util::cache;
+
+namespace {
+    std::string temp_dir(const std::string &name) {
+        return "/tmp/pypeline_test_cache_" + std::to_string(getpid()) + "_" + name;
+    }
+
+    std::vector<std::string> list(const std::string &dir) {
+        std::vector<std::string> path;
+        DIR *d = opendir(dir.c_str());
+        for (struct dirent *e = readdir(d); e != nullptr; e = readdir(d)) {
+            const std::string name(e->d_name);
+            if ((name != ".") && (name != "..")) { path.push_back(dir + "/" + name); }
+        }
+        closedir(d);
+        return path;
+    }
+
+    void remove_all(const std::string &dir) {
+        for (const std::string &p : list(dir)) { std::remove(p.c_str()); }
+        rmdir(dir.c_str());
+    }
+
+    std::vector<char> read(const std::string &path) {
+        std::ifstream f(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+
+    void write(const std::string &path, const std::vector<char> &bytes) {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write(bytes.data(), bytes.size());
+    }
+}
+
+int main() {
+    test::run("FileCache store/load", []() {
+        const std::string dir = temp_dir("rw");
+        cache::FileCache C(dir, size_t(1) << 20);
+
+        std::vector<double> x(1000), y(1000, -1);
+        for (size_t i = 0; i < x.size(); ++i) { x[i] = 0.5 * i; }
+        PYPELINE_CHECK(!C.load("x", y.data(), y.size() * sizeof(double)));
+        PYPELINE_CHECK(y[0] == -1);  // Misses leave the output unchanged.
+
+        PYPELINE_CHECK(C.store("x", x.data(), x.size() * sizeof(double)));
+        PYPELINE_CHECK(C.load("x", y.data(), y.size() * sizeof(double)));
+        PYPELINE_CHECK(x == y);
+        PYPELINE_CHECK(!C.load("y", y.data(), y.size() * sizeof(double)));
+        PYPELINE_CHECK(!C.load("x", y.data(), 10 * sizeof(double)));  // Size mismatch.
+
+        // Keys hold arbitrary bytes.
+        const std::string key("a\0b", 3);
+        PYPELINE_CHECK(C.store(key, x.data(), sizeof(double)));
+        PYPELINE_CHECK(!C.load(std::string("a"), y.data(), sizeof(double)));
+        remove_all(dir);
+    });
+
+    test::run("FileCache mapped load", []() {
+        const std::string dir = temp_dir("map");
+        cache::FileCache C(dir, size_t(1) << 20);
+
+        std::vector<double> x(1000), z(1000, 7);
+        for (size_t i = 0; i < x.size(); ++i) { x[i] = 0.5 * i; }
+        PYPELINE_CHECK(!C.load("x", x.size() * sizeof(double)));
+        PYPELINE_CHECK(C.store("x", x.data(), x.size() * sizeof(double)));
+        PYPELINE_CHECK(!C.load("x", 10 * sizeof(double)));  // Size mismatch.
+
+        const cache::Blob blob = C.load("x", x.size() * sizeof(double));
+        PYPELINE_CHECK(blob && (blob.size() == x.size() * sizeof(double)));
+        const double *y = reinterpret_cast<const double*>(blob.data());
+        PYPELINE_CHECK(std::vector<double>(y, y + x.size()) == x);
+
+        // Overwritten, then deleted: the view keeps the blob it mapped.
+        PYPELINE_CHECK(C.store("x", z.data(), z.size() * sizeof(double)));
+        PYPELINE_CHECK(std::vector<double>(y, y + x.size()) == x);
+        remove_all(dir);
+        PYPELINE_CHECK(std::vector<double>(y, y + x.size()) == x);
+    });
+
+    test::run("FileCache temporary files", []() {
+        const std::string dir = temp_dir("tmp");
+        cache::FileCache C(dir, 4 * 4096);
+        const std::vector<char> blob(4096, 't');
+
+        pid_t dead = fork();  // PID of a terminated process.
+        if (dead == 0) { _exit(0); }
+        waitpid(dead, nullptr, 0);
+
+        int N_tmp = 0;
+        auto make_tmp = [&](const pid_t pid, const long age) {
+            const std::string path = (dir + "/0123456789abcdef.pcache.tmp" + std::to_string(pid) +
+                                      "_" + std::to_string(N_tmp++));
+            write(path, blob);
+            struct timeval t[2];
+            gettimeofday(&t[0], nullptr);
+            t[0].tv_sec -= age;
+            t[1] = t[0];
+            utimes(path.c_str(), t);
+            return path;
+        };
+        const std::string live = make_tmp(getpid(), 120);  // In flight.
+        const std::string crashed = make_tmp(dead, 120);   // Writer died.
+        const std::string fresh = make_tmp(dead, 0);       // Writer died, or another host's PID.
+        const std::string abandoned = make_tmp(getpid(), 7200);
+
+        PYPELINE_CHECK(C.size() == 4 * blob.size());  // Counted, not deleted.
+        PYPELINE_CHECK(list(dir).size() == 4);
+
+        C.evict();
+        PYPELINE_CHECK(access(live.c_str(), F_OK) == 0);
+        PYPELINE_CHECK(access(fresh.c_str(), F_OK) == 0);
+        PYPELINE_CHECK(access(crashed.c_str(), F_OK) != 0);
+        PYPELINE_CHECK(access(abandoned.c_str(), F_OK) != 0);
+        PYPELINE_CHECK(C.size() == 2 * blob.size());
+
+        // In-flight files count towards the budget: room for 1 more page-aligned blob only.
+        PYPELINE_CHECK(C.store("a", blob.data(), 100));
+        PYPELINE_CHECK(C.store("b", blob.data(), 100));
+        PYPELINE_CHECK(C.size() <= C.budget());
+        PYPELINE_CHECK(list(dir).size() == 3);
+        remove_all(dir);
+    });
+
+    test::run("FileCache invalid files", []() {
+        const std::string dir = temp_dir("bad");
+        cache::FileCache C(dir, size_t(1) << 20);
+        const std::vector<float> x(100, 2.5f);
+        std::vector<float> y(100, 0);
+        PYPELINE_CHECK(C.store("x", x.data(), x.size() * sizeof(float)));
+        PYPELINE_CHECK(list(dir).size() == 1);
+        const std::string path = list(dir)[0];
+        const std::vector<char> bytes = read(path);
+
+        // file_header: magic[8], version, reserved, N_key, N_data, offset_key, offset_data.
+        const size_t at_N_key = 16, at_N_data = 24, at_offset_key = 32, at_offset_data = 40;
+        auto corrupt = [&](const size_t at, const uint64_t value) {
+            std::vector<char> b(bytes);
+            std::memcpy(b.data() + at, &value, sizeof(value));
+            write(path, b);
+            const bool hit = C.load("x", y.data(), y.size() * sizeof(float));
+            const bool deleted = (access(path.c_str(), F_OK) != 0);
+            return !hit && deleted;
+        };
+
+        PYPELINE_CHECK(corrupt(at_offset_data, bytes.size()));           // Data past EOF.
+        PYPELINE_CHECK(corrupt(at_offset_key, bytes.size() - 1));        // Key past EOF.
+        PYPELINE_CHECK(corrupt(at_N_key, ~uint64_t(0)));                 // offset_key + N_key overflows.
+        PYPELINE_CHECK(corrupt(at_N_data, ~uint64_t(0) - 4095));         // offset_data + N_data overflows.
+        PYPELINE_CHECK(corrupt(at_offset_data, ~uint64_t(0)));
+        PYPELINE_CHECK(corrupt(at_offset_key, 0));                       // Key overlaps the header.
+
+        write(path, std::vector<char>(bytes.begin(), bytes.end() - 1));  // Truncated.
+        PYPELINE_CHECK(!C.load("x", y.data(), y.size() * sizeof(float)));
+        PYPELINE_CHECK(access(path.c_str(), F_OK) != 0);
+
+        write(path, bytes);
+        PYPELINE_CHECK(C.load("x", y.data(), y.size() * sizeof(float)) && (x == y));
+        remove_all(dir);
+    });
+
+    test::run("FileCache budget", []() {
+        const std::string dir = temp_dir("budget");
+        const std::vector<char> blob(3 * 4096, 'b');
+        cache::FileCache C(dir, 10 * 4096);
+        PYPELINE_CHECK(!C.store("huge", blob.data(), 4 * blob.size()));
+
+        for (int i = 0; i < 5; ++i) {
+            PYPELINE_CHECK(C.store(std::to_string(i), blob.data(), blob.size()));
+            PYPELINE_CHECK(C.size() <= C.budget());
+        }
+        PYPELINE_CHECK(list(dir).size() == 2);  // 4 pages per blob.
+        remove_all(dir);
+
+        PYPELINE_CHECK_THROWS(cache::FileCache("/proc/version", 1));
+    });
+
+    return test::report();
+}
@@ -0,0 +1,94 @@
+// ############################################################################
+// test_correlator.cpp
+// ===================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/data_gen/correlator.hpp"
+#include "test.hpp"
+
+namespace correlator = pypeline::phased_array::util::data_gen::correlator;
+
+int main() {
+    const size_t N_stream = 3, N_fft = 16, N_band = 2;
+    std::vector<double> window(N_fft);
+    for (size_t t = 0; t < N_fft; ++t) { window[t] = 0.5 - 0.5 * std::cos(2 * M_PI * t / N_fft); }
+    std::vector<int> bin_band(N_fft, -1);
+    bin_band[2] = bin_band[3] = 0;
+    bin_band[5] = bin_band[13] = 1;  // Bin 13 lies above N_fft / 2.
+
+    const size_t N_block = 3;
+    std::vector<double> x(N_block * N_fft * N_stream);
+    for (size_t i = 0; i < x.size(); ++i) { x[i] = std::sin(0.7 * i) + 0.1 * std::cos(3.1 * i * i); }
+
+    // Naive DFT reference of block `blk`.
+    auto reference = [&](const size_t blk) {
+        std::vector<MatrixXX_t<cdouble_t>> S(N_band, MatrixXX_t<cdouble_t>::Zero(N_stream, N_stream));
+        for (size_t k = 0; k < N_fft; ++k) {
+            if (bin_band[k] < 0) { continue; }
+            Eigen::Matrix<cdouble_t, Eigen::Dynamic, 1> X(N_stream);
+            for (size_t i = 0; i < N_stream; ++i) {
+                X(i) = 0;
+                for (size_t t = 0; t < N_fft; ++t) {
+                    const double v = window[t] * x[(blk * N_fft + t) * N_stream + i];
+                    X(i) += v * std::polar(1.0, -2 * M_PI * k * t / N_fft);
+                }
+            }
+            S[bin_band[k]] += X * X.adjoint();
+        }
+        return S;
+    };
+
+    test::run("FXCorrelator", [&]() {
+        correlator::FXCorrelator<double> fx(N_stream, window, bin_band, N_band);
+        PYPELINE_CHECK((fx.N_stream() == N_stream) && (fx.N_fft() == N_fft) && (fx.N_band() == N_band));
+
+        // Uneven pushes: partial blocks are carried over.
+        const size_t split[] = {5, 20, 23};
+        size_t n = 0;
+        for (const size_t N_sample : split) {
+            fx.push(x.data() + n * N_stream, N_sample);
+            n += N_sample;
+        }
+        PYPELINE_CHECK(fx.N_ready() == N_block);
+
+        for (size_t blk = 0; blk < N_block; ++blk) {
+            const auto S = fx.pop();
+            const auto S_ref = reference(blk);
+            PYPELINE_CHECK(S.size() == N_band);
+            for (size_t b = 0; b < N_band; ++b) {
+                PYPELINE_CHECK_CLOSE((S[b] - S_ref[b]).norm(), 0, 1e-9 * S_ref[b].norm());
+            }
+        }
+        PYPELINE_CHECK_THROWS(fx.pop());
+    });
+
+    test::run("FXCorrelator reset", [&]() {
+        correlator::FXCorrelator<double> fx(N_stream, window, bin_band, N_band);
+        fx.push(x.data(), N_fft + 3);
+        PYPELINE_CHECK(fx.N_ready() == 1);
+
+        fx.reset();  // Drops the pending set and the 3 buffered samples.
+        PYPELINE_CHECK(fx.N_ready() == 0);
+        fx.push(x.data() + N_fft * N_stream, N_fft);
+        PYPELINE_CHECK(fx.N_ready() == 1);
+        const auto S = fx.pop();
+        const auto S_ref = reference(1);
+        PYPELINE_CHECK_CLOSE((S[0] - S_ref[0]).norm(), 0, 1e-9 * S_ref[0].norm());
+    });
+
+    test::run("FXCorrelator invalid", [&]() {
+        using fx_t = correlator::FXCorrelator<double>;
+        PYPELINE_CHECK_THROWS(fx_t(0, window, bin_band, N_band));
+        PYPELINE_CHECK_THROWS(fx_t(N_stream, std::vector<double>(), std::vector<int>(), N_band));
+        PYPELINE_CHECK_THROWS(fx_t(N_stream, window, std::vector<int>(N_fft - 1, -1), N_band));
+        PYPELINE_CHECK_THROWS(fx_t(N_stream, window, bin_band, 1));
+    });
+
+    return test::report();
+}
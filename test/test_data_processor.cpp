@@ -0,0 +1,198 @@
+// ############################################################################
+// test_data_processor.cpp
+// =======================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/data_processor.hpp"
+#include "test.hpp"
+
+namespace data_processor = pypeline::phased_array::bluebild::data_processor;
+
+namespace {
+    const int N_beam = 8, N_eig = 3;
+    const std::vector<int> broken {2, 5};
+
+    // (N_beam, N_beam) positive-semidefinite visibilities of rank `K`, with zero rows/columns at `broken`.
+    MatrixXX_t<cdouble_t> make_S(const int K) {
+        MatrixXX_t<cdouble_t> X = MatrixXX_t<cdouble_t>::Random(N_beam, K);
+        for (const int i : broken) { X.row(i).setZero(); }
+        return X * X.adjoint();
+    }
+
+    // (N_beam, N_beam) positive-definite Gram matrix.
+    MatrixXX_t<cdouble_t> make_G() {
+        const MatrixXX_t<cdouble_t> X = MatrixXX_t<cdouble_t>::Random(N_beam, N_beam);
+        return X * X.adjoint() + N_beam * MatrixXX_t<cdouble_t>::Identity(N_beam, N_beam);
+    }
+
+    std::vector<Eigen::Index> working_beams() {
+        std::vector<Eigen::Index> idx;
+        for (int i = 0; i < N_beam; ++i) {
+            if ((i != broken[0]) && (i != broken[1])) { idx.push_back(i); }
+        }
+        return idx;
+    }
+
+    /*
+     * Naive reference: drop broken beams, solve the dense problem, scatter back.
+     *
+     * Returns V diag(D) V^{H}, which does not depend on the phase of eigenvectors.
+     */
+    MatrixXX_t<cdouble_t> reference(const MatrixXX_t<cdouble_t> &S,
+                                    const MatrixXX_t<cdouble_t> &G,
+                                    ArrayX_t<double> &D) {
+        const std::vector<Eigen::Index> idx = working_beams();
+        const Eigen::Index N_work = idx.size();
+        Eigen::MatrixXcd S_w(N_work, N_work), G_w(N_work, N_work);
+        for (Eigen::Index i = 0; i < N_work; ++i) {
+            for (Eigen::Index j = 0; j < N_work; ++j) {
+                S_w(i, j) = S(idx[i], idx[j]);
+                G_w(i, j) = G(idx[i], idx[j]);
+            }
+        }
+
+        // Eigenvalues in ascending order, V^{H} G V = I.
+        Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXcd> solver(S_w, G_w);
+        D = solver.eigenvalues().tail(N_eig).reverse();
+        MatrixXX_t<cdouble_t> V = MatrixXX_t<cdouble_t>::Zero(N_beam, N_eig);
+        for (Eigen::Index i = 0; i < N_work; ++i) {
+            V.row(idx[i]) = solver.eigenvectors().row(i).tail(N_eig).reverse();
+        }
+        return V * D.matrix().cast<cdouble_t>().asDiagonal() * V.adjoint();
+    }
+
+    MatrixXX_t<cdouble_t> reconstruct(const ArrayX_t<double> &D, const MatrixXX_t<cdouble_t> &V) {
+        return V * D.matrix().cast<cdouble_t>().asDiagonal() * V.adjoint();
+    }
+}
+
+int main() {
+    const std::vector<double> centroids {0, 1, 1e3};
+
+    test::run("IntensityFieldDataProcessorBlock broken beams", [&]() {
+        const MatrixXX_t<cdouble_t> S = make_S(4), G = make_G();
+        ArrayX_t<double> D_ref;
+        const MatrixXX_t<cdouble_t> SV_ref = reference(S, G, D_ref);
+
+        for (const bool warm_start : {false, true}) {
+            data_processor::IntensityFieldDataProcessorBlock<double> I_dp(N_eig, centroids, warm_start);
+            ArrayX_t<double> D(N_eig);
+            MatrixXX_t<cdouble_t> V(N_beam, N_eig);
+            ArrayX_t<int64_t> cluster_idx(N_eig);
+
+            // Twice: the second call re-uses the compacted buffers (and warm-start seeds).
+            for (int k = 0; k < 2; ++k) {
+                V.setConstant(cdouble_t(7, 7));
+                I_dp(S, G, D.data(), V.data(), cluster_idx.data());
+
+                PYPELINE_CHECK_CLOSE((D - D_ref).abs().maxCoeff(), 0, 1e-9 * D_ref[0]);
+                PYPELINE_CHECK_CLOSE((reconstruct(D, V) - SV_ref).cwiseAbs().maxCoeff(), 0, 1e-9 * D_ref[0]);
+                for (const int i : broken) { PYPELINE_CHECK(V.row(i).norm() == 0); }
+                for (int e = 0; e < N_eig; ++e) {
+                    PYPELINE_CHECK(cluster_idx[e] == ((D[e] < 0.5) ? 0 : ((D[e] < 500) ? 1 : 2)));
+                }
+            }
+        }
+    });
+
+    test::run("IntensityFieldDataProcessorBlock degenerate inputs", [&]() {
+        data_processor::IntensityFieldDataProcessorBlock<double> I_dp(N_eig, centroids);
+        const MatrixXX_t<cdouble_t> G = make_G();
+        ArrayX_t<double> D(N_eig);
+        MatrixXX_t<cdouble_t> V(N_beam, N_eig);
+        ArrayX_t<int64_t> cluster_idx(N_eig);
+
+        // Rank-deficient visibilities: trailing eigenvalues vanish.
+        const MatrixXX_t<cdouble_t> S = make_S(2);
+        ArrayX_t<double> D_ref;
+        const MatrixXX_t<cdouble_t> SV_ref = reference(S, G, D_ref);
+        I_dp(S, G, D.data(), V.data(), cluster_idx.data());
+        PYPELINE_CHECK((D.head(2) > 0).all() && (std::abs(D[2]) < 1e-9 * D[0]));
+        PYPELINE_CHECK_CLOSE((reconstruct(D, V) - SV_ref).cwiseAbs().maxCoeff(), 0, 1e-9 * D_ref[0]);
+
+        // All beams broken.
+        I_dp(MatrixXX_t<cdouble_t>::Zero(N_beam, N_beam), G, D.data(), V.data(), cluster_idx.data());
+        PYPELINE_CHECK((D == 0).all() && (V.norm() == 0));
+
+        PYPELINE_CHECK_THROWS(I_dp(MatrixXX_t<cdouble_t>::Zero(N_beam, N_beam - 1), G,
+                                   D.data(), V.data(), cluster_idx.data()));
+        PYPELINE_CHECK_THROWS(data_processor::IntensityFieldDataProcessorBlock<double>(0, centroids));
+        PYPELINE_CHECK_THROWS(data_processor::IntensityFieldDataProcessorBlock<double>(N_eig, {}));
+    });
+
+    test::run("IntensityFieldDataProcessorBlock process_batch", [&]() {
+        const int N_channel = 5;
+        std::vector<MatrixXX_t<cdouble_t>> S(N_channel), G(N_channel);
+        std::vector<cdouble_t> S_batch, G_batch;
+        for (int i = 0; i < N_channel; ++i) {
+            // Channel 1 has no broken beam: exercises the fast path next to compacted ones.
+            S[i] = (i == 1) ? make_G() : make_S(4);
+            G[i] = make_G();
+            S_batch.insert(S_batch.end(), S[i].data(), S[i].data() + S[i].size());
+            G_batch.insert(G_batch.end(), G[i].data(), G[i].data() + G[i].size());
+        }
+
+        data_processor::IntensityFieldDataProcessorBlock<double> I_dp(N_eig, centroids);
+        std::vector<double> D(N_channel * N_eig);
+        std::vector<cdouble_t> V(N_channel * N_beam * N_eig);
+        std::vector<int64_t> cluster_idx(N_channel * N_eig);
+        I_dp.process_batch(S_batch.data(), G_batch.data(), N_channel, N_beam,
+                           D.data(), V.data(), cluster_idx.data());
+
+        data_processor::IntensityFieldDataProcessorBlock<double> I_ref(N_eig, centroids);
+        for (int i = 0; i < N_channel; ++i) {
+            ArrayX_t<double> D_i(N_eig);
+            MatrixXX_t<cdouble_t> V_i(N_beam, N_eig);
+            ArrayX_t<int64_t> cluster_i(N_eig);
+            I_ref(S[i], G[i], D_i.data(), V_i.data(), cluster_i.data());
+
+            const Eigen::Map<const ArrayX_t<double>> D_b(D.data() + i * N_eig, N_eig);
+            const Eigen::Map<const MatrixXX_t<cdouble_t>> V_b(V.data() + i * N_beam * N_eig, N_beam, N_eig);
+            PYPELINE_CHECK_CLOSE((D_b - D_i).abs().maxCoeff(), 0, 1e-9 * D_i[0]);
+            PYPELINE_CHECK_CLOSE((reconstruct(D_b, V_b) - reconstruct(D_i, V_i)).cwiseAbs().maxCoeff(), 0, 1e-9 * D_i[0]);
+            for (int e = 0; e < N_eig; ++e) { PYPELINE_CHECK(cluster_idx[i * N_eig + e] == cluster_i[e]); }
+        }
+
+        // Errors in any channel are re-thrown.
+        std::vector<cdouble_t> G_bad(G_batch);
+        G_bad[3 * N_beam * N_beam] = -1e6;
+        PYPELINE_CHECK_THROWS(I_dp.process_batch(S_batch.data(), G_bad.data(), N_channel, N_beam,
+                                                 D.data(), V.data(), cluster_idx.data()));
+    });
+
+    test::run("SensitivityFieldDataProcessorBlock", [&]() {
+        const int N_channel = 3;
+        std::vector<MatrixXX_t<cdouble_t>> G(N_channel);
+        std::vector<cdouble_t> G_batch;
+        for (int i = 0; i < N_channel; ++i) {
+            G[i] = make_G();
+            G_batch.insert(G_batch.end(), G[i].data(), G[i].data() + G[i].size());
+        }
+
+        const data_processor::SensitivityFieldDataProcessorBlock<double> S_dp(N_eig);
+        std::vector<double> D(N_channel * N_eig);
+        std::vector<cdouble_t> V(N_channel * N_beam * N_eig);
+        S_dp.process_batch(G_batch.data(), N_channel, N_beam, D.data(), V.data());
+
+        for (int i = 0; i < N_channel; ++i) {
+            Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> solver(G[i]);
+            const ArrayX_t<double> D_ref = solver.eigenvalues().tail(N_eig).reverse().array().square().inverse();
+
+            const Eigen::Map<const ArrayX_t<double>> D_b(D.data() + i * N_eig, N_eig);
+            const Eigen::Map<const MatrixXX_t<cdouble_t>> V_b(V.data() + i * N_beam * N_eig, N_beam, N_eig);
+            PYPELINE_CHECK_CLOSE((D_b - D_ref).abs().maxCoeff(), 0, 1e-9 * D_ref.maxCoeff());
+            const MatrixXX_t<cdouble_t> R = G[i] * V_b - V_b * D_b.rsqrt().matrix().cast<cdouble_t>().asDiagonal();
+            PYPELINE_CHECK_CLOSE(R.cwiseAbs().maxCoeff(), 0, 1e-9 * G[i].norm());
+            PYPELINE_CHECK_CLOSE((V_b.adjoint() * V_b - MatrixXX_t<cdouble_t>::Identity(N_eig, N_eig)).norm(), 0, 1e-9);
+        }
+        PYPELINE_CHECK_THROWS(data_processor::SensitivityFieldDataProcessorBlock<double>(0));
+    });
+
+    return test::report();
+}
@@ -0,0 +1,193 @@
+// ############################################################################
+// test_fourier_domain.cpp
+// =======================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "xtensor/xtensor.hpp"
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/field_synthesizer/fourier_domain.hpp"
+#include "test.hpp"
+
+namespace fd = pypeline::phased_array::bluebild::field_synthesizer::fourier_domain;
+namespace fourier = pypeline::util::math::fourier;
+
+// Heap allocations made by the calling thread while `counting` is set.
+namespace {
+    thread_local bool counting = false;
+    std::atomic<size_t> N_alloc {0};
+}
+
+void* operator new(size_t size) {
+    if (counting) { ++N_alloc; }
+    void *ptr = std::malloc((size > 0) ? size : 1);
+    if (ptr == nullptr) { throw std::bad_alloc(); }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+    using Block = fd::FourierFieldSynthesizerBlock<double>;
+
+    const size_t N_height = 4, N_width = 8, N_FS = 31, N_eig = 2, N_antenna = 6, N_beam = 5, N_time = 8;
+    const double wl = 2, T = 1;
+
+    Block make_block() {
+        xt::xtensor<double, 2> grid_colat = xt::zeros<double>({N_height, size_t(1)});
+        for (size_t i = 0; i < N_height; ++i) { grid_colat(i, 0) = 1.2 + 0.05 * i; }
+        xt::xtensor<double, 2> grid_lon = xt::zeros<double>({size_t(1), N_width});
+        for (size_t j = 0; j < N_width; ++j) { grid_lon(0, j) = -0.2 + (0.4 * j) / (N_width - 1); }
+        xt::xtensor<double, 2> R = xt::zeros<double>({size_t(3), size_t(3)});
+        for (size_t i = 0; i < 3; ++i) { R(i, i) = 1; }  // BFSF = ICRS.
+
+        return Block(wl, grid_colat, grid_lon, N_FS, T, R, N_eig, N_antenna, 1,
+                     fourier::planning_effort::NONE);
+    }
+
+    // XYZ rotated by `angle` [rad] around the z-axis.
+    xt::xtensor<double, 2> rotate(const xt::xtensor<double, 2> &XYZ, const double angle) {
+        xt::xtensor<double, 2> out {XYZ};
+        for (size_t i = 0; i < N_antenna; ++i) {
+            out(i, 0) = std::cos(angle) * XYZ(i, 0) - std::sin(angle) * XYZ(i, 1);
+            out(i, 1) = std::sin(angle) * XYZ(i, 0) + std::cos(angle) * XYZ(i, 1);
+        }
+        return out;
+    }
+
+    /*
+     * N_time epochs: antenna positions rotating around the z-axis, all
+     * within reach of the kernel evaluated at XYZ[0].
+     */
+    struct Epochs {
+        std::vector<xt::xtensor<cdouble_t, 2>> V;
+        std::vector<xt::xtensor<double, 2>> XYZ;
+        std::vector<xt::xtensor<cdouble_t, 2>> W;
+    };
+
+    Epochs make_epochs(Block &bb) {
+        std::mt19937 gen(0);
+        std::uniform_real_distribution<double> U(-1, 1);
+
+        xt::xtensor<double, 2> XYZ = xt::zeros<double>({N_antenna, size_t(3)});
+        for (auto &x : XYZ) { x = 20 * U(gen); }
+
+        Epochs e;
+        for (size_t t = 0; t < N_time; ++t) {
+            xt::xtensor<cdouble_t, 2> V = xt::zeros<cdouble_t>({N_beam, N_eig});
+            for (auto &v : V) { v = cdouble_t(U(gen), U(gen)); }
+            xt::xtensor<cdouble_t, 2> W = xt::zeros<cdouble_t>({N_antenna, N_beam});
+            for (auto &w : W) { w = cdouble_t(U(gen), U(gen)); }
+
+            e.V.push_back(V);
+            e.W.push_back(W);
+        }
+
+        // Rotation direction in which the kernel is phase-shifted, not re-generated.
+        bb(e.V[0], XYZ, e.W[0]);
+        const auto kernel = bb.kernel();
+        xt::xtensor<double, 2> XYZ_probe {rotate(XYZ, 0.05)};
+        bb(e.V[0], XYZ_probe, e.W[0]);
+        const double sign = (bb.kernel() != kernel) ? -1 : 1;
+        bb(e.V[0], XYZ, e.W[0]);  // Kernel evaluated at XYZ.
+
+        for (size_t t = 0; t < N_time; ++t) {
+            e.XYZ.push_back(rotate(XYZ, sign * 0.01 * t));
+        }
+        return e;
+    }
+}
+
+int main() {
+    test::run("FourierFieldSynthesizerBlock concurrent Workspaces", []() {
+        Block bb = make_block();
+        Epochs e = make_epochs(bb);
+        const auto kernel = bb.kernel();
+
+        // Serial reference.
+        std::vector<xt::xtensor<double, 3>> expected;
+        auto ws = bb.workspace();
+        for (size_t t = 0; t < N_time; ++t) {
+            expected.push_back(bb(e.V[t], e.XYZ[t], e.W[t], ws));
+        }
+
+        // Same block, one Workspace per thread. Inputs are copied: operator() takes them by non-const reference.
+        const size_t N_thread = 4;
+        std::vector<xt::xtensor<double, 3>> stat(N_time);
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < N_thread; ++i) {
+            pool.emplace_back([&, i]() {
+                auto ws_i = bb.workspace(N_beam);
+                for (size_t t = i; t < N_time; t += N_thread) {
+                    xt::xtensor<cdouble_t, 2> V {e.V[t]}, W {e.W[t]};
+                    xt::xtensor<double, 2> XYZ {e.XYZ[t]};
+                    stat[t] = bb(V, XYZ, W, ws_i);
+                }
+            });
+        }
+        for (auto &th : pool) { th.join(); }
+
+        PYPELINE_CHECK(bb.kernel() == kernel);  // Phase-shifted only, never re-generated.
+        for (size_t t = 0; t < N_time; ++t) {
+            PYPELINE_CHECK(stat[t].shape() == expected[t].shape());
+            double err = 0, scale = 0;
+            for (size_t k = 0; k < expected[t].size(); ++k) {
+                err = std::max(err, std::abs(stat[t].data()[k] - expected[t].data()[k]));
+                scale = std::max(scale, std::abs(expected[t].data()[k]));
+            }
+            PYPELINE_CHECK(scale > 0);
+            PYPELINE_CHECK_CLOSE(err, 0, 1e-12 * scale);
+        }
+    });
+
+    test::run("FourierFieldSynthesizerBlock allocation-free calls", []() {
+        Block bb = make_block();
+        Epochs e = make_epochs(bb);
+
+        auto ws = bb.workspace(N_beam);
+        const xt::xtensor<double, 3> first = bb(e.V[1], e.XYZ[1], e.W[1], ws);
+        const cdouble_t *FST = ws.FST->data_in();
+        const cdouble_t *WFSK = ws.WFSK.data();
+        const auto N_WFSK = ws.WFSK.size();
+
+        // Only operator() is counted: copying its output allocates.
+        const double *out = nullptr;
+        N_alloc = 0;
+        for (size_t t = 0; t < N_time; ++t) {
+            counting = true;
+            auto stat = bb(e.V[t], e.XYZ[t], e.W[t], ws);
+            counting = false;
+            out = stat.data();
+        }
+        PYPELINE_CHECK(N_alloc == 0);
+        PYPELINE_CHECK(out == reinterpret_cast<const double*>(ws.FST->data_out()));  // View into ws.
+        PYPELINE_CHECK((ws.FST->data_in() == FST) && (ws.WFSK.data() == WFSK) && (ws.WFSK.size() == N_WFSK));
+
+        // Repeat calls reproduce the first one.
+        const xt::xtensor<double, 3> again = bb(e.V[1], e.XYZ[1], e.W[1], ws);
+        double err = 0;
+        for (size_t k = 0; k < first.size(); ++k) {
+            err = std::max(err, std::abs(again.data()[k] - first.data()[k]));
+        }
+        PYPELINE_CHECK(err == 0);
+    });
+
+    return test::report();
+}
@@ -0,0 +1,99 @@
+// ############################################################################
+// test_gram.cpp
+// =============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cmath>
+#include <complex>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/gram.hpp"
+#include "test.hpp"
+
+namespace gram = pypeline::phased_array::util::gram;
+
+namespace {
+    // Dense reference: W^{H} G_{1} W.
+    MatrixXX_t<cdouble_t> gram_dense(const MatrixXX_t<double> &XYZ,
+                                     const SpMatrixXX_t<cdouble_t> &W,
+                                     const double wl) {
+        const int N = static_cast<int>(XYZ.rows());
+        MatrixXX_t<cdouble_t> G1(N, N);
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                const double r = (2 * M_PI / wl) * (XYZ.row(i) - XYZ.row(j)).norm();
+                G1(i, j) = 4 * M_PI * ((r > 0) ? (std::sin(r) / r) : 1.0);
+            }
+        }
+        const MatrixXX_t<cdouble_t> Wd = W;
+        return Wd.adjoint() * G1 * Wd;
+    }
+
+    // 3 stations of 4 antennas, one beam per station.
+    SpMatrixXX_t<cdouble_t> block_weights() {
+        MatrixXX_t<cdouble_t> W = MatrixXX_t<cdouble_t>::Zero(12, 3);
+        for (int i = 0; i < 12; ++i) {
+            W(i, i / 4) = std::polar(0.5, 0.3 * i);
+        }
+        return W.sparseView();
+    }
+}
+
+int main() {
+    const MatrixXX_t<double> XYZ = 10 * MatrixXX_t<double>::Random(12, 3);
+    const SpMatrixXX_t<cdouble_t> W = block_weights();
+    const double wl = 2.0;
+
+    test::run("gram", [&]() {
+        const MatrixXX_t<cdouble_t> G = gram::gram<double>(XYZ, W, wl);
+        const MatrixXX_t<cdouble_t> G_ref = gram_dense(XYZ, W, wl);
+        PYPELINE_CHECK((G.rows() == 3) && (G.cols() == 3));
+        PYPELINE_CHECK_CLOSE((G - G_ref).norm(), 0, 1e-10 * G_ref.norm());
+        PYPELINE_CHECK_CLOSE((G - G.adjoint()).norm(), 0, 1e-12);
+
+        // Dense beamformer covers all antenna pairs.
+        const SpMatrixXX_t<cdouble_t> I = MatrixXX_t<cdouble_t>::Identity(12, 12).sparseView();
+        PYPELINE_CHECK_CLOSE((gram::gram<double>(XYZ, I, wl) - gram_dense(XYZ, I, wl)).norm(), 0, 1e-9);
+    });
+
+    test::run("gram invalid", [&]() {
+        PYPELINE_CHECK_THROWS(gram::gram<double>(XYZ, W, 0.0));
+        PYPELINE_CHECK_THROWS(gram::gram<double>(XYZ.topRows(6), W, wl));
+    });
+
+    test::run("GramBlock cache", [&]() {
+        gram::GramBlock<double> gr(2);
+        const MatrixXX_t<cdouble_t> G1 = gr(XYZ, W, wl);
+        PYPELINE_CHECK(gr.size() == 1);
+
+        // Rigid motions of the array hit the cache.
+        const Eigen::Matrix3d R = Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+        MatrixXX_t<double> XYZ_rot = XYZ * R.transpose();
+        XYZ_rot.rowwise() += Eigen::RowVector3d(1e3, -2e3, 5e2);
+        const MatrixXX_t<cdouble_t> G2 = gr(XYZ_rot, W, wl);
+        PYPELINE_CHECK(gr.size() == 1);
+        PYPELINE_CHECK(G2 == G1);
+
+        // Different wavelength or deformed array miss it.
+        gr(XYZ, W, 2 * wl);
+        PYPELINE_CHECK(gr.size() == 2);
+        MatrixXX_t<double> XYZ_def = XYZ;
+        XYZ_def(0, 0) += 0.1;
+        const MatrixXX_t<cdouble_t> G3 = gr(XYZ_def, W, wl);
+        PYPELINE_CHECK(gr.size() == 2);  // LRU eviction.
+        PYPELINE_CHECK_CLOSE((G3 - gram_dense(XYZ_def, W, wl)).norm(), 0, 1e-9);
+
+        gr.clear();
+        PYPELINE_CHECK(gr.size() == 0);
+    });
+
+    test::run("GramBlock disabled", [&]() {
+        gram::GramBlock<double> gr(0);
+        gr(XYZ, W, wl);
+        PYPELINE_CHECK(gr.size() == 0);
+        PYPELINE_CHECK_THROWS(gram::GramBlock<double>(4, -1.0));
+    });
+
+    return test::report();
+}
@@ -0,0 +1,113 @@
+// ############################################################################
+// test_instrument.cpp
+// ===================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/instrument.hpp"
+#include "test.hpp"
+
+namespace instrument = pypeline::phased_array::instrument;
+
+namespace {
+    double max_baseline_brute(const MatrixXX_t<double> &XYZ) {
+        double d_max = 0;
+        for (int i = 0; i < XYZ.rows(); ++i) {
+            for (int j = i + 1; j < XYZ.rows(); ++j) {
+                d_max = std::max(d_max, (XYZ.row(i) - XYZ.row(j)).norm());
+            }
+        }
+        return d_max;
+    }
+
+    // Slowly-varying Q(t) = Rx(1e-6 t) Ry(0.3).
+    Eigen::Matrix3d slow(const double t) {
+        return (Eigen::AngleAxisd(1e-6 * t, Eigen::Vector3d::UnitX()) *
+                Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitY())).toRotationMatrix();
+    }
+
+    Eigen::Matrix3d full(const double t) {
+        return slow(t) * instrument::_detail::Rz(instrument::_detail::EARTH_ROTATION_RATE * t);
+    }
+}
+
+int main() {
+    test::run("convex_hull", []() {
+        std::vector<Eigen::Vector2d> p {{0, 0}, {2, 0}, {1, 0}, {2, 2}, {0, 2}, {1, 1}, {0.5, 1.5}, {0, 1}};
+        const std::vector<Eigen::Vector2d> hull = instrument::_detail::convex_hull(p);
+        PYPELINE_CHECK(hull.size() == 4);  // Collinear and interior points dropped.
+        for (size_t i = 0; i < hull.size(); ++i) {  // Counter-clockwise.
+            PYPELINE_CHECK(instrument::_detail::cross(hull[i], hull[(i + 1) % 4], hull[(i + 2) % 4]) > 0);
+        }
+        PYPELINE_CHECK_CLOSE(instrument::_detail::polygon_diameter(hull), std::sqrt(8.0), 1e-12);
+    });
+
+    test::run("max_baseline", []() {
+        for (const int N : {1, 2, 3, 50}) {
+            const MatrixXX_t<double> XY = 100 * MatrixXX_t<double>::Random(N, 2);
+            PYPELINE_CHECK_CLOSE(instrument::max_baseline<double>(XY), max_baseline_brute(XY), 1e-9);
+            const MatrixXX_t<double> XYZ = 100 * MatrixXX_t<double>::Random(N, 3);
+            PYPELINE_CHECK_CLOSE(instrument::max_baseline<double>(XYZ), max_baseline_brute(XYZ), 1e-9);
+        }
+
+        // Degenerate 2D cloud: all points collinear.
+        MatrixXX_t<double> line(5, 2);
+        line << 0, 0, 1, 1, 3, 3, 2, 2, -1, -1;
+        PYPELINE_CHECK_CLOSE(instrument::max_baseline<double>(line), 4 * std::sqrt(2.0), 1e-12);
+
+        PYPELINE_CHECK_THROWS(instrument::max_baseline<double>(MatrixXX_t<double>::Zero(4, 4)));
+    });
+
+    const MatrixXX_t<double> XYZ = 1e3 * MatrixXX_t<double>::Random(10, 3);
+    const std::vector<double> anchor_time {0, 1800, 3600};
+    MatrixXX_t<double> anchor_rot(9, 3);
+    for (size_t k = 0; k < anchor_time.size(); ++k) {
+        anchor_rot.block<3, 3>(3 * k, 0) = full(anchor_time[k]);
+    }
+
+    test::run("EarthBoundInstrumentGeometryBlock SLERP", [&]() {
+        instrument::EarthBoundInstrumentGeometryBlock<double> geom(XYZ, anchor_time, anchor_rot);
+        PYPELINE_CHECK((geom.N_antenna() == 10) && (geom.N_anchor() == 3));
+
+        // Exact at anchors, and Q(t) interpolated to well below 1 mm in between.
+        for (const double t : {0.0, 450.0, 1800.0, 2000.0, 3600.0}) {
+            PYPELINE_CHECK_CLOSE((geom.rotation(t) - full(t)).norm(), 0, 1e-9);
+            PYPELINE_CHECK_CLOSE((geom(t) - XYZ * full(t).transpose()).cwiseAbs().maxCoeff(), 0, 1e-6);
+        }
+
+        // Outside the anchor range: nearest anchor's Q(t), exact Earth rotation.
+        const Eigen::Matrix3d R_late = slow(3600) * instrument::_detail::Rz(instrument::_detail::EARTH_ROTATION_RATE * 5000);
+        PYPELINE_CHECK_CLOSE((geom.rotation(5000) - R_late).norm(), 0, 1e-9);
+
+        // Batched evaluation matches per-epoch evaluation.
+        const std::vector<double> t {-10, 0, 900, 2700, 4000};
+        std::vector<double> batch(t.size() * 10 * 3);
+        geom.process_batch(t.data(), t.size(), batch.data());
+        for (size_t i = 0; i < t.size(); ++i) {
+            const Eigen::Map<const MatrixXX_t<double>> out(batch.data() + i * 30, 10, 3);
+            PYPELINE_CHECK(out == geom(t[i]));
+        }
+    });
+
+    test::run("EarthBoundInstrumentGeometryBlock BFSF", [&]() {
+        instrument::EarthBoundInstrumentGeometryBlock<double> geom(XYZ, anchor_time, anchor_rot);
+        const Eigen::Matrix3d R = geom.icrs2bfsf_rot(0, 3600);
+        PYPELINE_CHECK_CLOSE((R * R.transpose() - Eigen::Matrix3d::Identity()).norm(), 0, 1e-12);
+        PYPELINE_CHECK_THROWS(geom.icrs2bfsf_rot(3600, 0));
+    });
+
+    test::run("EarthBoundInstrumentGeometryBlock invalid", [&]() {
+        using geom_t = instrument::EarthBoundInstrumentGeometryBlock<double>;
+        PYPELINE_CHECK_THROWS(geom_t(XYZ.leftCols(2), anchor_time, anchor_rot));
+        PYPELINE_CHECK_THROWS(geom_t(XYZ, std::vector<double>(), anchor_rot.topRows(0)));
+        PYPELINE_CHECK_THROWS(geom_t(XYZ, std::vector<double> {0, 3600, 1800}, anchor_rot));
+        PYPELINE_CHECK_THROWS(geom_t(XYZ, anchor_time, anchor_rot.topRows(6)));
+    });
+
+    return test::report();
+}
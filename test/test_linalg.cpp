@@ -0,0 +1,190 @@
+// ############################################################################
+// test_linalg.cpp
+// ===============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/util/math/linalg.hpp"
+#include "test.hpp"
+
+namespace linalg = pypeline::util::math::linalg;
+
+namespace {
+    // (M, M) positive-semidefinite matrix of rank `K`.
+    MatrixXX_t<cdouble_t> psd(const int M, const int K) {
+        const MatrixXX_t<cdouble_t> X = MatrixXX_t<cdouble_t>::Random(M, K);
+        return X * X.adjoint();
+    }
+
+    // Hermitian matrix with eigenvectors `Q` and spectrum `d`.
+    MatrixXX_t<cdouble_t> hermitian(const MatrixXX_t<cdouble_t> &Q, const ArrayX_t<double> &d) {
+        return Q * d.matrix().cast<cdouble_t>().asDiagonal() * Q.adjoint();
+    }
+
+    // (M, M) positive-definite matrix.
+    MatrixXX_t<cdouble_t> pd(const int M) {
+        return psd(M, M) + M * MatrixXX_t<cdouble_t>::Identity(M, M);
+    }
+
+    // max |A V - B V D| over non-padded eigenpairs.
+    double residual(const MatrixXX_t<cdouble_t> &A,
+                    const MatrixXX_t<cdouble_t> &B,
+                    const linalg::EigenPairs<double> &DV) {
+        const MatrixXX_t<cdouble_t> R = A * DV.V - B * DV.V * DV.D.matrix().cast<cdouble_t>().asDiagonal();
+        return R.cwiseAbs().maxCoeff();
+    }
+}
+
+int main() {
+    const int M = 12;
+
+    test::run("eigh", [&]() {
+        ArrayX_t<double> d = -ArrayX_t<double>::Ones(M);
+        d.head(5) << 5, 4, 3, 2, 1;
+        const MatrixXX_t<cdouble_t> Q = MatrixXX_t<cdouble_t>::Random(M, M).householderQr().householderQ();
+        const MatrixXX_t<cdouble_t> A = hermitian(Q, d), A_pos = hermitian(Q, d.max(0)), B = pd(M);
+
+        const linalg::EigenPairs<double> DV = linalg::eigh<double>(A, B);
+        PYPELINE_CHECK(DV.D.size() == 5);  // Negative spectrum dropped.
+        PYPELINE_CHECK(residual(A_pos, B, DV) < 1e-9);
+        for (int k = 1; k < DV.D.size(); ++k) { PYPELINE_CHECK(DV.D[k - 1] >= DV.D[k]); }
+        const MatrixXX_t<cdouble_t> VhBV = DV.V.adjoint() * B * DV.V;
+        PYPELINE_CHECK_CLOSE((VhBV - MatrixXX_t<cdouble_t>::Identity(5, 5)).norm(), 0, 1e-9);
+
+        // Zero-padding to N.
+        const linalg::EigenPairs<double> DV8 = linalg::eigh<double>(A, B, 1, 8);
+        PYPELINE_CHECK((DV8.D.size() == 8) && (DV8.V.cols() == 8));
+        PYPELINE_CHECK_CLOSE((DV8.D.head(5) - DV.D).abs().maxCoeff(), 0, 1e-9);
+        PYPELINE_CHECK((DV8.D.tail(3) == 0).all() && (DV8.V.rightCols(3).norm() == 0));
+
+        // Energy selection: leading eigenpairs whose cumulative energy fits in tau.
+        const double tau = (DV.D[0] + DV.D[1]) / DV.D.sum() + 1e-9;
+        PYPELINE_CHECK(linalg::eigh<double>(A, B, tau).D.size() == 2);
+
+        // B = I and pre-factorized B.
+        PYPELINE_CHECK(residual(A_pos, MatrixXX_t<cdouble_t>::Identity(M, M), linalg::eigh<double>(A)) < 1e-9);
+        const MatrixXX_t<cdouble_t> L = B.llt().matrixL();
+        PYPELINE_CHECK_CLOSE((linalg::eigh_chol<double>(A, L).D - DV.D).abs().maxCoeff(), 0, 1e-9);
+    });
+
+    test::run("eigh N > 0", [&]() {
+        // PSD A: range-limited solve, no decomposition of A beforehand.
+        const MatrixXX_t<cdouble_t> B = pd(M);
+        for (const int K : {3, M}) {
+            const MatrixXX_t<cdouble_t> A = psd(M, K);
+            for (const MatrixXX_t<cdouble_t> &B_ : {MatrixXX_t<cdouble_t>(MatrixXX_t<cdouble_t>::Identity(M, M)), B}) {
+                const linalg::EigenPairs<double> DV_all = linalg::eigh<double>(A, B_);
+                for (const double tau : {1.0, 0.6}) {
+                    const linalg::EigenPairs<double> DV = linalg::eigh<double>(A, B_, tau, 5);
+                    const linalg::EigenPairs<double> DV_ref = linalg::eigh<double>(A, B_, tau);
+                    const int N_keep = std::min<int>(5, DV_ref.D.size());
+                    PYPELINE_CHECK(DV.D.size() == 5);
+                    PYPELINE_CHECK_CLOSE((DV.D.head(N_keep) - DV_ref.D.head(N_keep)).abs().maxCoeff(), 0, 1e-9 * DV_all.D[0]);
+                    PYPELINE_CHECK((DV.D.tail(5 - N_keep).abs() < 1e-9 * DV_all.D[0]).all());
+                    PYPELINE_CHECK(residual(A, B_, DV) < 1e-9 * DV_all.D[0]);
+                }
+            }
+        }
+
+        // Indefinite A: negative spectrum still dropped.
+        ArrayX_t<double> d = ArrayX_t<double>::LinSpaced(M, 6, -5);
+        const MatrixXX_t<cdouble_t> Q = MatrixXX_t<cdouble_t>::Random(M, M).householderQr().householderQ();
+        const MatrixXX_t<cdouble_t> A = hermitian(Q, d), A_pos = hermitian(Q, d.max(0));
+        const linalg::EigenPairs<double> DV = linalg::eigh<double>(A, B, 1, 4);
+        const linalg::EigenPairs<double> DV_ref = linalg::eigh<double>(A_pos, B, 1, 4);
+        PYPELINE_CHECK_CLOSE((DV.D - DV_ref.D).abs().maxCoeff(), 0, 1e-9);
+        PYPELINE_CHECK(residual(A_pos, B, DV) < 1e-9);
+    });
+
+    test::run("eigh invalid", [&]() {
+        const MatrixXX_t<cdouble_t> A = psd(M, 5), B = pd(M);
+        PYPELINE_CHECK_THROWS(linalg::eigh<double>(A, B, 0.0));
+        PYPELINE_CHECK_THROWS(linalg::eigh<double>(A, -B));
+        PYPELINE_CHECK_THROWS(linalg::eigh<double>(A, pd(M - 1)));
+    });
+
+    test::run("eigh_batch", [&]() {
+        std::vector<MatrixXX_t<cdouble_t>> A, B;
+        for (int i = 0; i < 6; ++i) {
+            A.push_back(psd(M, 3 + i));
+            B.push_back(pd(M));
+        }
+        B[2] = B[1];  // Consecutive duplicates share one factorization.
+
+        for (const size_t N_B : {0, 1, 6}) {
+            const std::vector<MatrixXX_t<cdouble_t>> B_(B.begin(), B.begin() + N_B);
+            const auto DV = linalg::eigh_batch<double>(A, B_, 1, 4);
+            PYPELINE_CHECK(DV.size() == A.size());
+            for (size_t i = 0; i < A.size(); ++i) {
+                const linalg::EigenPairs<double> DV_ref =
+                    (N_B == 0) ? linalg::eigh<double>(A[i], 1, 4) :
+                                 linalg::eigh<double>(A[i], B_[(N_B == 1) ? 0 : i], 1, 4);
+                PYPELINE_CHECK_CLOSE((DV[i].D - DV_ref.D).abs().maxCoeff(), 0, 1e-9);
+            }
+        }
+
+        // Failures are re-thrown once all threads are done.
+        std::vector<MatrixXX_t<cdouble_t>> B_bad(B);
+        B_bad[4] = -B_bad[4];
+        PYPELINE_CHECK_THROWS(linalg::eigh_batch<double>(A, B_bad));
+        PYPELINE_CHECK_THROWS(linalg::eigh_batch<double>(A, std::vector<MatrixXX_t<cdouble_t>>(2, B[0])));
+    });
+
+    test::run("WarmStartEigh", [&]() {
+        const int N_eig = 3;
+        const MatrixXX_t<cdouble_t> A0 = psd(M, 6), dA = psd(M, M), B = pd(M);
+        linalg::WarmStartEigh<double> solver(N_eig, 2, 1e-10, 50);
+
+        for (const double tau : {1.0, 0.7}) {
+            solver.reset();
+            for (int t = 0; t < 5; ++t) {  // Slowly-varying sequence.
+                const MatrixXX_t<cdouble_t> A = A0 + (1e-3 * t) * dA;
+                const linalg::EigenPairs<double> DV = solver(A, B, tau, 7);
+                const linalg::EigenPairs<double> DV_ref = linalg::eigh<double>(A, B, tau, N_eig);
+                PYPELINE_CHECK((DV.D.size() == N_eig) && (DV.V.rows() == M));
+                PYPELINE_CHECK_CLOSE((DV.D - DV_ref.D).abs().maxCoeff(), 0, 1e-8);
+
+                // Eigenvectors up to a phase.
+                for (int k = 0; k < N_eig; ++k) {
+                    if (DV_ref.D[k] == 0) { continue; }
+                    PYPELINE_CHECK_CLOSE(std::abs(DV.V.col(k).dot(B * DV_ref.V.col(k))), 1, 1e-6);
+                }
+            }
+        }
+        PYPELINE_CHECK(solver.N_warm() >= 8);
+        PYPELINE_CHECK(solver.N_cold() == 2);
+
+        // B = I, independent streams.
+        const linalg::EigenPairs<double> DV_0 = solver(A0, 1, 0);
+        const linalg::EigenPairs<double> DV_1 = solver(A0 + dA, 1, 1);
+        PYPELINE_CHECK_CLOSE((solver(A0, 1, 0).D - DV_0.D).abs().maxCoeff(), 0, 1e-8);
+        PYPELINE_CHECK_CLOSE((solver(A0 + dA, 1, 1).D - DV_1.D).abs().maxCoeff(), 0, 1e-8);
+    });
+
+    test::run("WarmStartEigh M < N_eig", [&]() {
+        const int M_small = 4, N_eig = 6;
+        const MatrixXX_t<cdouble_t> A0 = psd(M_small, M_small), dA = psd(M_small, 2), B = pd(M_small);
+        linalg::WarmStartEigh<double> solver(N_eig);
+
+        for (int t = 0; t < 4; ++t) {
+            const MatrixXX_t<cdouble_t> A = A0 + (1e-3 * t) * dA;
+            for (const double tau : {1.0, 0.5}) {
+                const linalg::EigenPairs<double> DV = solver(A, B, tau);
+                const linalg::EigenPairs<double> DV_ref = linalg::eigh<double>(A, B, tau, N_eig);
+                PYPELINE_CHECK((DV.D.size() == N_eig) && (DV.V.cols() == N_eig) && (DV.V.rows() == M_small));
+                PYPELINE_CHECK_CLOSE((DV.D - DV_ref.D).abs().maxCoeff(), 0, 1e-10);
+            }
+        }
+        PYPELINE_CHECK(solver.N_warm() == 0);  // Dense solver is exact here.
+
+        PYPELINE_CHECK_THROWS(linalg::WarmStartEigh<double>(0));
+        PYPELINE_CHECK_THROWS(solver(A0, B, 0.0));
+    });
+
+    return test::report();
+}
@@ -0,0 +1,126 @@
+// ############################################################################
+// test_parameter_estimator.cpp
+// ============================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/parameter_estimator.hpp"
+#include "test.hpp"
+
+namespace pe = pypeline::phased_array::bluebild::parameter_estimator;
+
+namespace {
+    double sse(const std::vector<double> &x, const size_t i, const size_t j) {
+        double m = 0;
+        for (size_t l = i; l < j; ++l) { m += x[l]; }
+        m /= (j - i);
+        double e = 0;
+        for (size_t l = i; l < j; ++l) { e += (x[l] - m) * (x[l] - m); }
+        return e;
+    }
+
+    // Brute-force 1-D k-means: best of all contiguous partitions of sorted `x`.
+    double kmeans_brute(const std::vector<double> &x, const size_t start, const size_t k) {
+        if (k == 1) { return sse(x, start, x.size()); }
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t end = start + 1; end + (k - 1) <= x.size(); ++end) {
+            best = std::min(best, sse(x, start, end) + kmeans_brute(x, end, k - 1));
+        }
+        return best;
+    }
+
+    double cost(std::vector<double> x, const std::vector<double> &centroid) {
+        double e = 0;
+        for (const double v : x) {
+            double d = std::numeric_limits<double>::infinity();
+            for (const double c : centroid) { d = std::min(d, (v - c) * (v - c)); }
+            e += d;
+        }
+        return e;
+    }
+}
+
+int main() {
+    test::run("kmeans_1d", []() {
+        std::vector<double> x;
+        for (int i = 0; i < 14; ++i) { x.push_back(std::sin(1.7 * i * i) + ((i % 3 == 0) ? 4 : 0)); }
+        std::vector<double> x_sorted(x);
+        std::sort(x_sorted.begin(), x_sorted.end());
+
+        for (size_t k = 1; k <= 5; ++k) {
+            const std::vector<double> centroid = pe::_detail::kmeans_1d(x, k);
+            PYPELINE_CHECK(centroid.size() == k);
+            PYPELINE_CHECK(std::is_sorted(centroid.begin(), centroid.end()));
+            PYPELINE_CHECK_CLOSE(cost(x, centroid), kmeans_brute(x_sorted, 0, k), 1e-9);
+        }
+
+        // Well-separated clusters are recovered exactly.
+        const std::vector<double> y {10, 0, 10, 0, 5, 5, 0};
+        const std::vector<double> c = pe::_detail::kmeans_1d(y, 3);
+        PYPELINE_CHECK((c[0] == 0) && (c[1] == 5) && (c[2] == 10));
+
+        PYPELINE_CHECK_THROWS(pe::_detail::kmeans_1d(y, 8));
+    });
+
+    test::run("Reservoir", []() {
+        pe::_detail::Reservoir r(100, 1);
+        for (int i = 0; i < 50; ++i) { r.push(i); }
+        PYPELINE_CHECK((r.sample().size() == 50) && (r.N_seen() == 50));
+
+        double mean = 0;
+        for (int i = 50; i < 100000; ++i) { r.push(i); }
+        for (const double v : r.sample()) { mean += v / r.sample().size(); }
+        PYPELINE_CHECK((r.sample().size() == 100) && (r.N_seen() == 100000));
+        PYPELINE_CHECK_CLOSE(mean, 50000, 10000);  // Uniform over the stream.
+
+        r.clear();
+        PYPELINE_CHECK((r.sample().size() == 0) && (r.N_seen() == 0));
+    });
+
+    test::run("IntensityFieldParameterEstimator", []() {
+        const int N_beam = 6, N_data = 5, N_level = 3;
+        std::vector<cdouble_t> S(N_data * N_beam * N_beam), G(S.size());
+        for (int i = 0; i < N_data; ++i) {
+            const MatrixXX_t<cdouble_t> X = MatrixXX_t<cdouble_t>::Random(N_beam, 4);
+            const MatrixXX_t<cdouble_t> Y = MatrixXX_t<cdouble_t>::Random(N_beam, N_beam);
+            Eigen::Map<MatrixXX_t<cdouble_t>>(S.data() + i * N_beam * N_beam, N_beam, N_beam) = X * X.adjoint();
+            Eigen::Map<MatrixXX_t<cdouble_t>>(G.data() + i * N_beam * N_beam, N_beam, N_beam) =
+                Y * Y.adjoint() + N_beam * MatrixXX_t<cdouble_t>::Identity(N_beam, N_beam);
+        }
+
+        pe::IntensityFieldParameterEstimator<double> est_seq(N_level, 1), est_batch(N_level, 1);
+        for (int i = 0; i < N_data; ++i) {
+            est_seq.collect(Eigen::Map<const MatrixXX_t<cdouble_t>>(S.data() + i * N_beam * N_beam, N_beam, N_beam),
+                            Eigen::Map<const MatrixXX_t<cdouble_t>>(G.data() + i * N_beam * N_beam, N_beam, N_beam));
+        }
+        est_batch.collect_batch(S.data(), G.data(), N_data, N_beam);
+
+        size_t N_eig_seq, N_eig_batch;
+        std::vector<double> c_seq, c_batch;
+        std::tie(N_eig_seq, c_seq) = est_seq.infer_parameters();
+        std::tie(N_eig_batch, c_batch) = est_batch.infer_parameters();
+        PYPELINE_CHECK(est_batch.N_data() == N_data);
+        PYPELINE_CHECK(N_eig_seq == N_eig_batch);
+        PYPELINE_CHECK(c_seq == c_batch);  // Batches update the sketch in input order.
+        PYPELINE_CHECK(c_seq.size() == N_level);
+        PYPELINE_CHECK(std::is_sorted(c_seq.rbegin(), c_seq.rend()));
+
+        // Failures inside the parallel region are re-thrown.
+        std::vector<cdouble_t> G_bad(G);
+        for (int k = 0; k < N_beam * N_beam; ++k) { G_bad[3 * N_beam * N_beam + k] *= -1; }
+        PYPELINE_CHECK_THROWS(est_batch.collect_batch(S.data(), G_bad.data(), N_data, N_beam));
+
+        est_seq.reset();
+        PYPELINE_CHECK_THROWS(est_seq.infer_parameters());
+    });
+
+    return test::report();
+}
@@ -0,0 +1,118 @@
+// ############################################################################
+// test_runtime.cpp
+// ================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "pypeline/types.hpp"
+#include "pypeline/util/runtime.hpp"
+#include "test.hpp"
+
+namespace runtime = pypeline::util::runtime;
+
+namespace {
+    std::vector<int> range(const int first, const int last) {
+        std::vector<int> cpu;
+        for (int c = first; c < last; ++c) { cpu.push_back(c); }
+        return cpu;
+    }
+
+    /*
+     * Slots of `topo` split N ways cover all CPUs, are non-empty and never
+     * straddle domains when N > N_domain.
+     */
+    bool check_share(const runtime::Topology &topo, const size_t N) {
+        std::vector<int> seen;
+        for (size_t i = 0; i < N; ++i) {
+            const std::vector<int> cpu = topo.share(i, N);
+            if (cpu.empty()) { return false; }
+            if ((N > topo.N_domain()) && (topo.domains_of(cpu).size() != topo.domains_of({cpu[0]}).size())) {
+                return false;
+            }
+            seen.insert(seen.end(), cpu.begin(), cpu.end());
+        }
+        std::sort(seen.begin(), seen.end());
+        seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+
+        std::vector<int> all = topo.cpus();
+        std::sort(all.begin(), all.end());
+        return seen == all;
+    }
+}
+
+int main() {
+    test::run("parse_cpulist", []() {
+        PYPELINE_CHECK(runtime::_detail::parse_cpulist("0-3,8,10-11") == std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+        PYPELINE_CHECK(runtime::_detail::parse_cpulist("5") == std::vector<int>({5}));
+        PYPELINE_CHECK(runtime::_detail::parse_cpulist("").empty());
+        PYPELINE_CHECK(runtime::_detail::parse_cpulist("0-1,,x,4") == std::vector<int>({0, 1, 4}));
+    });
+
+    test::run("Topology", []() {
+        runtime::Topology host;
+        PYPELINE_CHECK(host.N_domain() >= 1);
+        PYPELINE_CHECK(!host.cpus().empty());
+
+        const runtime::Topology topo({range(0, 8), {}, {15, 14, 13, 12, 11, 10, 9, 8}});
+        PYPELINE_CHECK(topo.N_domain() == 2);
+        PYPELINE_CHECK(topo.domain(1) == range(8, 16));
+        PYPELINE_CHECK_THROWS(topo.domain(2));
+
+        PYPELINE_CHECK(topo.share(0, 1) == range(0, 16));
+        PYPELINE_CHECK(topo.share(1, 2) == range(8, 16));
+        PYPELINE_CHECK(topo.share(0, 4) == range(0, 4));
+        PYPELINE_CHECK(topo.share(3, 4) == range(12, 16));
+        PYPELINE_CHECK(topo.share(4, 4).empty());
+        for (const size_t N : {1, 2, 3, 4, 5, 7, 16, 40}) {
+            PYPELINE_CHECK(check_share(topo, N));
+        }
+
+        PYPELINE_CHECK(topo.domains_of({3}) == range(0, 8));
+        PYPELINE_CHECK(topo.domains_of({3, 9}) == range(0, 16));
+        PYPELINE_CHECK(topo.domains_of({99}).empty());
+        PYPELINE_CHECK(runtime::Topology(std::vector<std::vector<int>>()).share(0, 1).empty());
+    });
+
+    test::run("set_thread_budget/pin", []() {
+        runtime::set_thread_budget(3);
+        #ifdef _OPENMP
+        PYPELINE_CHECK(omp_get_max_threads() == 3);
+        #endif
+
+        const std::vector<int> allowed = runtime::_detail::allowed_cpus();
+        PYPELINE_CHECK(!runtime::pin({}));
+        PYPELINE_CHECK(runtime::pin({allowed[0]}));
+        PYPELINE_CHECK(runtime::_detail::allowed_cpus() == std::vector<int>({allowed[0]}));
+        PYPELINE_CHECK(runtime::pin(allowed));
+        PYPELINE_CHECK(runtime::_detail::allowed_cpus() == allowed);
+
+        runtime::Topology topo;
+        PYPELINE_CHECK(runtime::bind(topo, 0, 1, 2));
+        #ifdef _OPENMP
+        PYPELINE_CHECK(omp_get_max_threads() == 2);
+        #endif
+        runtime::pin(allowed);
+    });
+
+    test::run("first_touch", []() {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        for (const size_t size : {size_t(0), size_t(1), page, 5 * page + 17}) {
+            std::vector<char> buffer(size + 1, 'x');
+            runtime::first_touch(buffer.data(), size, 4);
+            PYPELINE_CHECK(std::all_of(buffer.begin(), buffer.begin() + size, [](const char c) { return c == 0; }));
+            PYPELINE_CHECK(buffer[size] == 'x');  // Nothing past the end.
+        }
+    });
+
+    return test::report();
+}
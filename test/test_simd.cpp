@@ -0,0 +1,174 @@
+// ############################################################################
+// test_simd.cpp
+// =============
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "pypeline/types.hpp"
+#include "pypeline/util/simd.hpp"
+#include "test.hpp"
+
+namespace simd = pypeline::util::simd;
+
+namespace {
+    template <typename TT>
+    std::vector<std::complex<TT>> random_complex(const size_t N, const double scale, const unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> U(-scale, scale);
+        std::vector<std::complex<TT>> x(N);
+        for (auto &v : x) { v = std::complex<TT>(U(gen), U(gen)); }
+        return x;
+    }
+
+    template <typename TT>
+    double max_error(const std::vector<std::complex<TT>> &x, const std::vector<std::complex<TT>> &y) {
+        double err = 0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            err = std::max<double>(err, std::abs(x[i] - y[i]) / std::max<double>(1, std::abs(y[i])));
+        }
+        return err;
+    }
+
+    double tukey(const double y, const double T, const double alpha) {
+        const double lim_left = 0.5 * T * alpha, lim_right = T - lim_left;
+        if ((0 <= y) && (y < lim_left)) {
+            return std::pow(std::sin(M_PI / (T * alpha) * y), 2);
+        } else if ((lim_left <= y) && (y <= lim_right)) {
+            return 1;
+        } else if ((lim_right < y) && (y <= T)) {
+            return std::pow(std::sin(M_PI / (T * alpha) * (T - y)), 2);
+        }
+        return 0;
+    }
+
+    /*
+     * Compare all kernels against std::complex / <cmath> evaluations.
+     *
+     * Returns
+     * -------
+     * ok : bool
+     */
+    template <typename TT>
+    bool check_kernels(const double tol) {
+        const size_t N_outer = 3, N = 37, N_inner = 5;
+        const std::vector<std::complex<TT>> x = random_complex<TT>(N_outer * N * N_inner, 2, 0);
+        const std::vector<std::complex<TT>> y = random_complex<TT>(N, 2, 1);
+        std::vector<TT> w(N);
+        for (size_t k = 0; k < N; ++k) { w[k] = 0.5 + 0.01 * k; }
+
+        bool ok = true;
+        for (const size_t inner : {size_t(1), N_inner}) {
+            const size_t outer = (N_outer * N_inner) / inner;
+            auto at = [&](const size_t o, const size_t k, const size_t i) { return (o * N + k) * inner + i; };
+
+            std::vector<std::complex<TT>> out(x), ref(x);
+            simd::multiply(out.data(), y.data(), outer, N, inner);
+            for (size_t o = 0; o < outer; ++o) for (size_t k = 0; k < N; ++k) for (size_t i = 0; i < inner; ++i) {
+                ref[at(o, k, i)] *= y[k];
+            }
+            ok = ok && (max_error(out, ref) <= tol);
+
+            out = x; ref = x;
+            simd::scale(out.data(), w.data(), outer, N, inner);
+            for (size_t o = 0; o < outer; ++o) for (size_t k = 0; k < N; ++k) for (size_t i = 0; i < inner; ++i) {
+                ref[at(o, k, i)] *= w[k];
+            }
+            ok = ok && (max_error(out, ref) <= tol);
+
+            // Phases up to 1e4 [rad], as in synthesis kernels; real parts are ignored.
+            out = random_complex<TT>(x.size(), 1e4, 2);
+            out[0] = std::complex<TT>(5, 0);
+            out[1] = std::complex<TT>(0, M_PI / 2);
+            out[2] = std::complex<TT>(0, -M_PI);
+            ref = out;
+            simd::exp_imag(out.data(), w.data(), outer, N, inner);
+            for (size_t o = 0; o < outer; ++o) for (size_t k = 0; k < N; ++k) for (size_t i = 0; i < inner; ++i) {
+                const std::complex<double> phase(0, std::imag(ref[at(o, k, i)]));
+                ref[at(o, k, i)] = std::complex<TT>(static_cast<double>(w[k]) * std::exp(phase));
+            }
+            ok = ok && (max_error(out, ref) <= tol);
+        }
+
+        {
+            std::vector<std::complex<TT>> out(x);
+            simd::abs2(out.data(), out.size());
+            for (size_t i = 0; i < x.size(); ++i) {
+                ok = ok && (std::abs(std::real(out[i]) - std::norm(x[i])) <= tol * std::norm(x[i]));
+                ok = ok && (std::imag(out[i]) == std::imag(x[i]));
+            }
+        }
+
+        for (const double alpha : {0.0, 0.3, 1.0}) {
+            const double T = 2.5;
+            std::vector<TT> y_smpl, amplitude(203);
+            for (size_t k = 0; k < amplitude.size(); ++k) { y_smpl.push_back(-0.5 + 0.0175 * k); }
+            y_smpl.push_back(0.5 * T * alpha);  // Boundaries.
+            y_smpl.push_back(T);
+            y_smpl.push_back(std::nan(""));
+            amplitude.resize(y_smpl.size());
+
+            simd::tukey(y_smpl.data(), amplitude.data(), y_smpl.size(), T, alpha);
+            for (size_t k = 0; k < y_smpl.size(); ++k) {
+                ok = ok && (std::abs(amplitude[k] - tukey(y_smpl[k], T, alpha)) <= tol);
+            }
+        }
+        return ok;
+    }
+
+    /*
+     * Run the kernels in a child process with PYPELINE_ISA = `level`.
+     *
+     * The selected instruction set is fixed on first use, hence the parent never calls them.
+     */
+    bool check_isa(const simd::isa level) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            setenv("PYPELINE_ISA", simd::name(level).c_str(), 1);
+            const simd::isa expected = std::min(level, simd::_detail::detect());
+            bool ok = false;
+            try {
+                ok = (simd::active() == expected) && check_kernels<float>(1e-5) && check_kernels<double>(1e-13);
+            } catch (...) {}
+            _exit(ok ? 0 : 1);
+        }
+
+        int status = 0;
+        return (waitpid(pid, &status, 0) == pid) && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+    }
+}
+
+int main() {
+    test::run("kernels per instruction set", []() {
+        for (const simd::isa level : {simd::isa::GENERIC, simd::isa::SSE4_2, simd::isa::AVX2, simd::isa::AVX512}) {
+            const bool ok = check_isa(level);
+            if (!ok) { test::fail(__FILE__, __LINE__, "PYPELINE_ISA=" + simd::name(level)); }
+        }
+    });
+
+    test::run("sin_cos", []() {
+        double err = 0;
+        for (double x = -1e4; x <= 1e4; x += 0.37) {
+            double s, c;
+            simd::_detail::sin_cos(x, s, c);
+            err = std::max({err, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+        }
+        for (const double x : {0.0, -0.0, M_PI / 4, M_PI / 2, M_PI, 1e8, -1e9}) {
+            double s, c;
+            simd::_detail::sin_cos(x, s, c);
+            err = std::max({err, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+        }
+        PYPELINE_CHECK(err <= 1e-15);
+    });
+
+    return test::report();
+}
@@ -0,0 +1,111 @@
+// ############################################################################
+// test_spatial_domain.cpp
+// =======================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/bluebild/field_synthesizer/spatial_domain.hpp"
+#include "test.hpp"
+
+namespace spatial_domain = pypeline::phased_array::bluebild::field_synthesizer::spatial_domain;
+
+namespace {
+    // Pixels spread over several tiles, the last of which is partial. (N_tile = 336 for 48 antennas.)
+    const int N_antenna = 48, N_beam = 6, N_eig = 3, N_pixel = 1000;
+    const double wl = 2;
+
+    // (3, N_pixel) pixel vectors of varying norm: the synthesizer normalizes them.
+    MatrixXX_t<double> make_grid() {
+        MatrixXX_t<double> grid = MatrixXX_t<double>::Random(3, N_pixel);
+        grid.row(2).array() += 2;
+        return grid;
+    }
+
+    // Each antenna belongs to a single beam.
+    SpMatrixXX_t<cdouble_t> make_W() {
+        const MatrixXX_t<cdouble_t> X = MatrixXX_t<cdouble_t>::Random(N_antenna, N_beam);
+        std::vector<Eigen::Triplet<cdouble_t>> nz;
+        for (int a = 0; a < N_antenna; ++a) {
+            nz.emplace_back(a, a % N_beam, X(a, a % N_beam));
+        }
+        SpMatrixXX_t<cdouble_t> W(N_antenna, N_beam);
+        W.setFromTriplets(nz.begin(), nz.end());
+        return W;
+    }
+
+    /*
+     * Dense reference: full (N_antenna, N_pixel) steering matrix, evaluated in double precision.
+     */
+    MatrixXX_t<double> reference(const MatrixXX_t<cdouble_t> &V,
+                                 const MatrixXX_t<double> &XYZ,
+                                 const MatrixXX_t<cdouble_t> &W,
+                                 const MatrixXX_t<double> &grid) {
+        const MatrixXX_t<double> XYZ_c = XYZ.rowwise() - XYZ.colwise().mean();
+        MatrixXX_t<double> r = grid;
+        r.colwise().normalize();
+
+        MatrixXX_t<cdouble_t> P(N_antenna, N_pixel);
+        for (int a = 0; a < N_antenna; ++a) {
+            for (int p = 0; p < N_pixel; ++p) {
+                P(a, p) = std::exp(cdouble_t(0, 2 * M_PI * XYZ_c.row(a).dot(r.col(p)) / wl));
+            }
+        }
+        return (V.transpose() * W.transpose() * P).cwiseAbs2();
+    }
+
+    template <typename TT>
+    double max_rel_error(const MatrixXX_t<TT> &stat, const MatrixXX_t<double> &stat_ref) {
+        return (stat.template cast<double>() - stat_ref).cwiseAbs().maxCoeff() / stat_ref.maxCoeff();
+    }
+}
+
+int main() {
+    const MatrixXX_t<double> grid = make_grid();
+    const MatrixXX_t<cdouble_t> V = MatrixXX_t<cdouble_t>::Random(N_beam, N_eig);
+    const MatrixXX_t<double> XYZ = 1e3 * MatrixXX_t<double>::Random(N_antenna, 3);  // Long baselines: ~500 cycles.
+    const SpMatrixXX_t<cdouble_t> W_sp = make_W();
+    const MatrixXX_t<cdouble_t> W = W_sp;
+    const MatrixXX_t<double> stat_ref = reference(V, XYZ, W, grid);
+
+    test::run("SpatialFieldSynthesizerBlock tiled vs dense (double)", [&]() {
+        const spatial_domain::SpatialFieldSynthesizerBlock<double> synth(wl, grid);
+        PYPELINE_CHECK(synth.N_pixel() == N_pixel);
+
+        const MatrixXX_t<double> stat = synth(V, XYZ, W);
+        PYPELINE_CHECK((stat.rows() == N_eig) && (stat.cols() == N_pixel));
+        PYPELINE_CHECK_CLOSE(max_rel_error(stat, stat_ref), 0, 1e-9);
+
+        const MatrixXX_t<double> stat_sp = synth(V, XYZ, W_sp);
+        PYPELINE_CHECK_CLOSE(max_rel_error(stat_sp, stat_ref), 0, 1e-9);
+    });
+
+    test::run("SpatialFieldSynthesizerBlock tiled vs dense (float)", [&]() {
+        const spatial_domain::SpatialFieldSynthesizerBlock<float> synth(wl, grid.cast<float>());
+        const MatrixXX_t<cfloat_t> V_f = V.cast<cfloat_t>();
+        const MatrixXX_t<float> XYZ_f = XYZ.cast<float>();
+
+        const MatrixXX_t<float> stat = synth(V_f, XYZ_f, W.cast<cfloat_t>());
+        PYPELINE_CHECK_CLOSE(max_rel_error(stat, stat_ref), 0, 1e-3);
+
+        const SpMatrixXX_t<cfloat_t> W_sp_f = W_sp.cast<cfloat_t>();
+        const MatrixXX_t<float> stat_sp = synth(V_f, XYZ_f, W_sp_f);
+        PYPELINE_CHECK_CLOSE(max_rel_error(stat_sp, stat_ref), 0, 1e-3);
+    });
+
+    test::run("SpatialFieldSynthesizerBlock invalid", [&]() {
+        PYPELINE_CHECK_THROWS(spatial_domain::SpatialFieldSynthesizerBlock<double>(0, grid));
+        PYPELINE_CHECK_THROWS(spatial_domain::SpatialFieldSynthesizerBlock<double>(wl, grid.topRows(2)));
+
+        const spatial_domain::SpatialFieldSynthesizerBlock<double> synth(wl, grid);
+        PYPELINE_CHECK_THROWS(synth(V, XYZ.leftCols(2), W));
+        PYPELINE_CHECK_THROWS(synth(V, XYZ.topRows(N_antenna - 1), W));
+        PYPELINE_CHECK_THROWS(synth(V.topRows(N_beam - 1), XYZ, W));
+    });
+
+    return test::report();
+}
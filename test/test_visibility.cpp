@@ -0,0 +1,93 @@
+// ############################################################################
+// test_visibility.cpp
+// ===================
+// Author : Sepand KASHANI [sep@zurich.ibm.com]
+// ############################################################################
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "pypeline/types.hpp"
+#include "pypeline/phased_array/util/data_gen/visibility.hpp"
+#include "test.hpp"
+
+namespace vis = pypeline::phased_array::util::data_gen::visibility;
+
+int main() {
+    test::run("cis", []() {
+        std::vector<double> phase;
+        for (double p = -1e3; p < 1e3; p += 0.37) { phase.push_back(p); }
+        std::vector<cdouble_t> a(phase.size());
+        vis::_detail::cis<double>(phase.data(), a.data(), phase.size(), 2.0);
+        for (size_t k = 0; k < phase.size(); ++k) {
+            PYPELINE_CHECK_CLOSE(std::abs(a[k] - std::polar(2.0, phase[k])), 0, 1e-12);
+        }
+    });
+
+    const MatrixXX_t<double> XYZ = 20 * MatrixXX_t<double>::Random(8, 3);
+    const SpMatrixXX_t<cdouble_t> W = MatrixXX_t<cdouble_t>::Random(8, 3).sparseView();
+    MatrixXX_t<double> src_xyz = MatrixXX_t<double>::Random(5, 3);
+    src_xyz.rowwise().normalize();
+    ArrayX_t<double> intensity(5);
+    intensity << 1, 0.5, 2, 0, 3;
+    const double wl = 2.0;
+
+    test::run("sky_visibility", [&]() {
+        // Dense reference: W^{H} A^{H} diag(I) A W, A[k, i] = exp(1j 2pi/wl <s_k, p_i>).
+        MatrixXX_t<cdouble_t> A(5, 8);
+        for (int k = 0; k < 5; ++k) {
+            for (int i = 0; i < 8; ++i) {
+                A(k, i) = std::polar(1.0, (2 * M_PI / wl) * src_xyz.row(k).dot(XYZ.row(i)));
+            }
+        }
+        const MatrixXX_t<cdouble_t> Wd = W;
+        const MatrixXX_t<cdouble_t> S_ref = Wd.adjoint() * A.adjoint() *
+                                            intensity.matrix().asDiagonal() * A * Wd;
+
+        for (const size_t N_tile : {1, 2, 256}) {
+            const MatrixXX_t<cdouble_t> S = vis::sky_visibility<double>(XYZ, W, src_xyz, intensity, wl, N_tile);
+            PYPELINE_CHECK_CLOSE((S - S_ref).norm(), 0, 1e-10 * S_ref.norm());
+        }
+
+        PYPELINE_CHECK_THROWS(vis::sky_visibility<double>(XYZ, W, src_xyz, intensity, -1.0));
+        PYPELINE_CHECK_THROWS(vis::sky_visibility<double>(XYZ, W, src_xyz, -intensity, wl));
+    });
+
+    test::run("wishart", []() {
+        const MatrixXX_t<cdouble_t> B = MatrixXX_t<cdouble_t>::Random(4, 4);
+        const MatrixXX_t<cdouble_t> V = B * B.adjoint();
+
+        const MatrixXX_t<cdouble_t> X1 = vis::wishart<double>(V, 100, 7);
+        const MatrixXX_t<cdouble_t> X2 = vis::wishart<double>(V, 100, 7);
+        const MatrixXX_t<cdouble_t> X3 = vis::wishart<double>(V, 100, 8);
+        PYPELINE_CHECK(X1 == X2);
+        PYPELINE_CHECK(X1 != X3);
+        PYPELINE_CHECK_CLOSE((X1 - X1.adjoint()).norm(), 0, 1e-12);
+        PYPELINE_CHECK(Eigen::SelfAdjointEigenSolver<MatrixXX_t<cdouble_t>>(X1).eigenvalues().minCoeff() > 0);
+
+        // E[X] = n V.
+        MatrixXX_t<cdouble_t> mean = MatrixXX_t<cdouble_t>::Zero(4, 4);
+        const size_t N_draw = 500, n = 20;
+        for (size_t d = 0; d < N_draw; ++d) {
+            mean += vis::wishart<double>(V, n, d) / static_cast<double>(N_draw * n);
+        }
+        PYPELINE_CHECK_CLOSE((mean - V).norm(), 0, 0.1 * V.norm());
+
+        PYPELINE_CHECK_THROWS(vis::wishart<double>(V, 4, 0));
+    });
+
+    test::run("VisibilityGeneratorBlock", [&]() {
+        vis::VisibilityGeneratorBlock<double> gen_a(src_xyz, intensity, 1000, 10, 3);
+        vis::VisibilityGeneratorBlock<double> gen_b(src_xyz, intensity, 1000, 10, 3);
+        const MatrixXX_t<cdouble_t> S1 = gen_a(XYZ, W, wl);
+        const MatrixXX_t<cdouble_t> S2 = gen_a(XYZ, W, wl);
+        PYPELINE_CHECK(S1 != S2);                 // Successive epochs use distinct streams.
+        PYPELINE_CHECK(gen_b(XYZ, W, wl) == S1);  // Reproducible from the seed.
+
+        PYPELINE_CHECK_THROWS(vis::VisibilityGeneratorBlock<double>(src_xyz, intensity, 0, 10, 3));
+        PYPELINE_CHECK_THROWS(vis::VisibilityGeneratorBlock<double>(src_xyz, intensity, 10, 0, 3));
+    });
+
+    return test::report();
+}